@@ -0,0 +1,196 @@
+/*
+ *
+ *   benchgen.c
+ *
+ *   Generates the definition files of a benchmark network
+ *   (perseo.ini, modules.ini, connectivity.ini and
+ *   protocol.ini) in the directory <dir>.
+ *
+ *      benchgen <dir> <N> <populations> <SPARSE|DENSE> <FIXED|AF|TWAM> <delays> [<life>]
+ *
+ *   The <N> VIF neurons are 80% excitatory and 20% inhibitory,
+ *   split in <populations> populations (at least 2, one fifth
+ *   of them inhibitory). The network is the one of modules.ini
+ *   and connectivity.ini, scaled so that the mean synaptic
+ *   input of a neuron does not depend on <N>: with SPARSE
+ *   connectivity the number of synapses per neuron is fixed,
+ *   with DENSE the connection probabilities are fixed and the
+ *   efficacies scale as the inverse of the synapses per neuron.
+ *   Up to MAX_PRE_E excitatory and MAX_PRE_I inhibitory
+ *   populations project on each population, the nearest ones
+ *   on a ring. The excitatory-to-excitatory synapses are of
+ *   the given type, the other ones are fixed. The delays are
+ *   uniform in [1, 1 + 0.1 <delays>] ms, sampled on <delays>
+ *   layers. The simulation lasts <life> ms (1000 by default)
+ *   with fixed seeds, and the protocol steps the external rate
+ *   of the first population at half of it.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define MAX_PRE_E    32    /* Maximum excitatory populations projecting on a population. */
+#define MAX_PRE_I     8    /* Maximum inhibitory populations projecting on a population. */
+#define DELAY_STEP  0.1    /* Width of a delay layer in ms. */
+#define SEED  878918202    /* Seed of the neurons and of the synapses. */
+#define BUFFER_DIM  256    /* Maximum static string size. */
+
+/*** Reference network (modules.ini and connectivity.ini). ***/
+static const double K[2]    = {112.0, 200.0};   /* Synapses per neuron from E and I. */
+static const double C[2]    = {0.07, 0.5};      /* Connection probabilities from E and I. */
+static const double J[2][2] = {{0.005, -0.00506866},  /* Efficacies on E from E and I... */
+                               {0.028, -0.00985592}}; /* ...and on I. */
+static const double Jext[2] = {0.005, 0.028};   /* External efficacies on E and I. */
+static const double Beta[2] = {0.050, 0.400};   /* Leakages of E and I. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------*
+ *  openFile  *
+ *------------*/
+
+/**
+ *  Opens for writing the file <Name> in the directory <Dir>,
+ *  exiting on error.
+ */
+
+static FILE *openFile(char *Dir,
+                      char *Name)
+{
+   char Path[BUFFER_DIM];
+   FILE *f;
+
+   snprintf(Path, BUFFER_DIM, "%s/%s", Dir, Name);
+   if ((f = fopen(Path, "wt")) == NULL) {
+      fprintf(stderr, "ERROR (benchgen): unable to open '%s'.\n", Path);
+      exit(EXIT_FAILURE);
+   }
+   return f;
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   FILE *f;
+   long N, NT[2], Size;
+   int P, PT[2], First[2], Dense, Type, Delays;
+   int a, b, r, s, t, u, m, M;
+   double Life, DMax, Kin, c, Jab;
+   char *Types[3] = {"Fixed", "AF", "TWAM"};
+
+   if (ArgC < 7 || ArgC > 8) {
+      fprintf(stderr, "Usage: %s <dir> <N> <populations> <SPARSE|DENSE> <FIXED|AF|TWAM> <delays> [<life>]\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+   N      = atol(ArgV[2]);
+   P      = atoi(ArgV[3]);
+   Dense  = strcasecmp(ArgV[4], "DENSE") == 0;
+   Delays = atoi(ArgV[6]);
+   Life   = ArgC == 8 ? atof(ArgV[7]) : 1000.0;
+   for (Type=0; Type<3 && strcasecmp(ArgV[5], Types[Type]) != 0; Type++);
+   if (P < 2 || N < 5 * P || Delays < 1 || Type == 3 || Life <= 0.0 ||
+       (!Dense && strcasecmp(ArgV[4], "SPARSE") != 0)) {
+      fprintf(stderr, "ERROR (benchgen): bad parameters (populations >= 2, N >= 5 populations, delays >= 1).\n");
+      return EXIT_FAILURE;
+   }
+
+   /*** Excitatory (t = 0) and inhibitory (t = 1) populations. ***/
+   PT[1] = P / 5 > 0 ? P / 5 : 1;
+   PT[0] = P - PT[1];
+   NT[0] = N * 4 / 5;
+   NT[1] = N - NT[0];
+   First[0] = 0;
+   First[1] = PT[0];
+   DMax = 1.0 + DELAY_STEP * Delays;
+
+   f = openFile(ArgV[1], "perseo.ini");
+   fprintf(f, "# Benchmark: %ld neurons, %d populations, %s connectivity, %s synapses, %d delays.\n",
+           N, P, Dense ? "dense" : "sparse", Types[Type], Delays);
+   fprintf(f, "NeuronType             = 'VIF'\n");
+   fprintf(f, "ModuleFile             = 'modules.ini'\n");
+   fprintf(f, "DelayDistribType       = 'Uniform'\n");
+   fprintf(f, "DelayNumber            = %d\n", Delays);
+   fprintf(f, "ConnectivityFile       = 'connectivity.ini'\n");
+   fprintf(f, "Life                   = %g\n", Life);
+   fprintf(f, "LogFile                = 'perseo.log'\n");
+   fprintf(f, "CommandFile            = 'protocol.ini'\n");
+   fprintf(f, "SynapticExtractionType = 'RANDOM'\n");
+   fprintf(f, "NeuronsSeed            = %d\n", SEED);
+   fprintf(f, "SynapsesSeed           = %d\n", SEED);
+   fprintf(f, "OutRates               = NO\n");
+   fclose(f);
+
+   /*** The remainder of the neurons goes to the first populations. ***/
+   f = openFile(ArgV[1], "modules.ini");
+   fprintf(f, "#   N  Jext DJext   Cext NuExt  Beta Theta   H Tarp  NeuronInitType\n");
+   for (t=0; t<2; t++)
+      for (r=0; r<PT[t]; r++)
+         fprintf(f, "%ld %g 0.25 1488.0 10.0 %g 1.0 0.0 0.0 0\n",
+                 NT[t] / PT[t] + (r < NT[t] % PT[t]), Jext[t], Beta[t]);
+   fclose(f);
+
+   /*** The population a (of type t) receives from the M populations ***
+    *** of type u nearest to it on a ring, each with Kin/M synapses  ***
+    *** per neuron.                                                  ***/
+   f = openFile(ArgV[1], "connectivity.ini");
+   fprintf(f, "#   Post Pre   c DMin DMax SynapseType J DJ (or the parameters of AF and TWAM)\n");
+   for (t=0; t<2; t++)
+      for (r=0; r<PT[t]; r++) {
+         a = First[t] + r;
+         for (u=0; u<2; u++) {
+            M = PT[u] < (u == 0 ? MAX_PRE_E : MAX_PRE_I) ? PT[u] : (u == 0 ? MAX_PRE_E : MAX_PRE_I);
+            Kin = Dense ? C[u] * NT[u] : K[u];
+            Jab = J[t][u] * K[u] / Kin;
+            s = (int)((long)r * PT[u] / PT[t]) - M / 2;
+            for (m=0; m<M; m++) {
+               b = First[u] + ((s + m) % PT[u] + PT[u]) % PT[u];
+               Size = NT[u] / PT[u] + ((b - First[u]) < NT[u] % PT[u]);
+               c = Kin / M / Size;
+               if (c > 1.0)
+                  c = 1.0;
+               fprintf(f, "%d %d %.6g 1.0 %g '%s' ", a, b, c, DMax, t == 0 && u == 0 ? Types[Type] : "Fixed");
+               if (t == 0 && u == 0 && Type == 1)
+                  fprintf(f, "%.6g %.6g 0.25 0.25 0.02 0.02 0.5 0.5 0.2 0.2 1.0 0.0 0.5\n", 0.6 * Jab, 1.6 * Jab);
+               else if (t == 0 && u == 0 && Type == 2)
+                  fprintf(f, "%.6g %.6g 0.25 0.25 0.02 0.02 0.5 5.0 0.2 0.2 1.0 0.0 0.5\n", 0.6 * Jab, 1.6 * Jab);
+               else
+                  fprintf(f, "%.6g 0.25\n", Jab);
+            }
+         }
+      }
+   fclose(f);
+
+   f = openFile(ArgV[1], "protocol.ini");
+   fprintf(f, "# Step of the external rate of the first population from half to three quarters of the run.\n");
+   fprintf(f, "SET_PARAM %g 0 4 12.0\n", Life / 2);
+   fprintf(f, "SET_PARAM %g 0 4 10.0\n", Life / 4);
+   fclose(f);
+
+   return 0;
+}
+
+
+
+#undef MAX_PRE_E
+#undef MAX_PRE_I
+#undef DELAY_STEP
+#undef SEED
+#undef BUFFER_DIM
@@ -0,0 +1,290 @@
+/*
+ *
+ *   benchrun.c
+ *
+ *   Runs the benchmark cases listed in <matrix_file>, a row
+ *   per case, with the columns:
+ *
+ *      <name> <N> <populations> <SPARSE|DENSE> <FIXED|AF|TWAM> <delays> <life>
+ *
+ *   ('#' starts a comment). For each case the network is
+ *   generated by benchgen (see benchgen.c) in <work_dir>/<name>
+ *   and simulated there by perseo. A row is appended to
+ *   <csv_file> with the time spent before the simulation loop
+ *   (reading the definitions and building the network), the
+ *   time of the loop, the peak resident memory, the spikes
+ *   managed per second, the ns per delivered synapse and the
+ *   mean emission rate, these ones taken from the profile in
+ *   the LogFile of the run (see profile.h).
+ *
+ *      benchrun [-p <perseo>] [-g <benchgen>] [-d <work_dir>] [-o <csv_file>] <matrix_file>
+ *
+ *   By default perseo and benchgen are in the working
+ *   directory, <work_dir> is 'runs' and <csv_file> is
+ *   'bench.csv'.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM 1024 /* Maximum static string size. */
+
+/**
+ *  The profile of a run, read from its LogFile.
+ */
+
+typedef struct {
+   double          WallTime; /* Time of the simulation loop in s. */
+   double   SpikesPerSecond; /* Spikes managed per second. */
+   double      NsPerSynapse; /* Time of the loop per delivered synapse in ns. */
+   double SynapsesDelivered; /* Synapses delivered. */
+   double     EmittedSpikes; /* Spikes emitted by the network. */
+} run_profile;
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-------------*
+ *  wallClock  *
+ *-------------*/
+
+/**
+ *  Returns a monotonic wall-clock time in s.
+ */
+
+static double wallClock()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/*-----------*
+ *  execute  *
+ *-----------*/
+
+/**
+ *  Runs the program <ArgV>[0] with the arguments <ArgV> in
+ *  the directory <Dir> (the present one if NULL), with the
+ *  standard output and error in the file <Output> (if not
+ *  NULL). Its peak resident memory in Kbytes is returned in
+ *  <MaxRSS> (if not NULL). Returns the exit status, -1 if
+ *  the program could not be run.
+ */
+
+static int execute(char **ArgV,
+                   char   *Dir,
+                   char *Output,
+                   long *MaxRSS)
+{
+   struct rusage Usage;
+   pid_t Pid;
+   int Status, Fd;
+
+   if ((Pid = fork()) < 0)
+      return -1;
+
+   if (Pid == 0) {
+      if (Dir != NULL && chdir(Dir) != 0)
+         _exit(127);
+      if ((Fd = open("/dev/null", O_RDONLY)) >= 0)
+         dup2(Fd, STDIN_FILENO);
+      if (Output != NULL && (Fd = open(Output, O_WRONLY | O_CREAT | O_TRUNC, 0644)) >= 0) {
+         dup2(Fd, STDOUT_FILENO);
+         dup2(Fd, STDERR_FILENO);
+      }
+      execv(ArgV[0], ArgV);
+      _exit(127);
+   }
+
+   while (wait4(Pid, &Status, 0, &Usage) < 0)
+      if (errno != EINTR)
+         return -1;
+   if (MaxRSS != NULL)
+      *MaxRSS = Usage.ru_maxrss;
+   return WIFEXITED(Status) ? WEXITSTATUS(Status) : -1;
+}
+
+
+/*---------------*
+ *  readProfile  *
+ *---------------*/
+
+/**
+ *  Reads in <p> the profile printed in the LogFile <FileName>
+ *  at the end of a run. Returns 1 if it is missing, 0
+ *  otherwise.
+ */
+
+static int readProfile(char *FileName,
+                       run_profile *p)
+{
+   char Line[BUFFER_DIM], Name[BUFFER_DIM];
+   double Value;
+   int Found = 0;
+   FILE *f;
+
+   if ((f = fopen(FileName, "rt")) == NULL)
+      return 1;
+   memset(p, 0, sizeof(run_profile));
+   while (fgets(Line, BUFFER_DIM, f) != NULL) {
+      if (sscanf(Line, "# PROFILE %255s %lf", Name, &Value) != 2)
+         continue;
+      if (strcmp(Name, "WallTime") == 0) {
+         p->WallTime = Value;
+         Found = 1;
+      } else if (strcmp(Name, "SpikesPerSecond") == 0)
+         p->SpikesPerSecond = Value;
+      else if (strcmp(Name, "NsPerSynapse") == 0)
+         p->NsPerSynapse = Value;
+      else if (strcmp(Name, "SynapsesDelivered") == 0)
+         p->SynapsesDelivered = Value;
+      else if (strcmp(Name, "EmittedSpikes") == 0)
+         p->EmittedSpikes = Value;
+   }
+   fclose(f);
+
+   return !Found;
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   char *Perseo, *BenchGen, *WorkDir, *CsvName;
+   char PerseoPath[PATH_MAX], BenchGenPath[PATH_MAX];
+   char Line[BUFFER_DIM], Name[BUFFER_DIM], Conn[BUFFER_DIM], Syn[BUFFER_DIM];
+   char NStr[BUFFER_DIM], PStr[BUFFER_DIM], DStr[BUFFER_DIM], LifeStr[BUFFER_DIM];
+   char Dir[BUFFER_DIM], Output[BUFFER_DIM], Log[BUFFER_DIM];
+   char *Args[9];
+   FILE *Matrix, *Csv;
+   run_profile p;
+   double Start, Wall;
+   long N, MaxRSS;
+   int Opt, NumCases, NumFailed;
+   struct stat st;
+
+   Perseo   = "perseo";
+   BenchGen = "benchgen";
+   WorkDir  = "runs";
+   CsvName  = "bench.csv";
+   while ((Opt = getopt(ArgC, ArgV, "p:g:d:o:")) != -1)
+      switch (Opt) {
+         case 'p': Perseo = optarg; break;
+         case 'g': BenchGen = optarg; break;
+         case 'd': WorkDir = optarg; break;
+         case 'o': CsvName = optarg; break;
+         default:
+            optind = ArgC;
+      }
+   if (optind != ArgC - 1) {
+      fprintf(stderr, "Usage: %s [-p <perseo>] [-g <benchgen>] [-d <work_dir>] [-o <csv_file>] <matrix_file>\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+
+   /*** The programs run in the directories of the cases. ***/
+   if (realpath(Perseo, PerseoPath) == NULL || realpath(BenchGen, BenchGenPath) == NULL) {
+      fprintf(stderr, "ERROR (benchrun): '%s' or '%s' not found.\n", Perseo, BenchGen);
+      return EXIT_FAILURE;
+   }
+   if ((Matrix = fopen(ArgV[optind], "rt")) == NULL) {
+      fprintf(stderr, "ERROR (benchrun): unable to open '%s'.\n", ArgV[optind]);
+      return EXIT_FAILURE;
+   }
+   mkdir(WorkDir, 0755);
+
+   /*** The header is written only in a new file. ***/
+   if ((Csv = fopen(CsvName, "at")) == NULL) {
+      fprintf(stderr, "ERROR (benchrun): unable to open '%s'.\n", CsvName);
+      fclose(Matrix);
+      return EXIT_FAILURE;
+   }
+   if (ftell(Csv) == 0)
+      fprintf(Csv, "case,neurons,populations,connectivity,synapses,delays,life_ms,"
+                   "init_s,loop_s,peak_rss_mb,spikes_per_s,ns_per_synapse,synapses_delivered,rate_hz\n");
+
+   NumCases = NumFailed = 0;
+   while (fgets(Line, BUFFER_DIM, Matrix) != NULL) {
+      Line[strcspn(Line, "#")] = '\0';
+      if (sscanf(Line, "%255s %255s %255s %255s %255s %255s %255s",
+                 Name, NStr, PStr, Conn, Syn, DStr, LifeStr) != 7)
+         continue;
+      NumCases++;
+      snprintf(Dir, BUFFER_DIM, "%s/%s", WorkDir, Name);
+      snprintf(Output, BUFFER_DIM, "%s/perseo.out", Dir);
+      snprintf(Log, BUFFER_DIM, "%s/perseo.log", Dir);
+      if (stat(Dir, &st) != 0 && mkdir(Dir, 0755) != 0) {
+         fprintf(stderr, "ERROR (benchrun): unable to create '%s'.\n", Dir);
+         NumFailed++;
+         continue;
+      }
+      remove(Log);
+
+      Args[0] = BenchGenPath; Args[1] = Dir; Args[2] = NStr; Args[3] = PStr;
+      Args[4] = Conn; Args[5] = Syn; Args[6] = DStr; Args[7] = LifeStr; Args[8] = NULL;
+      if (execute(Args, NULL, NULL, NULL) != 0) {
+         fprintf(stderr, "ERROR (benchrun): case '%s' not generated.\n", Name);
+         NumFailed++;
+         continue;
+      }
+
+      printf("%s: running...", Name);
+      fflush(stdout);
+      Args[0] = PerseoPath;
+      Args[1] = NULL;
+      Start = wallClock();
+      if (execute(Args, Dir, "perseo.out", &MaxRSS) != 0 || readProfile(Log, &p)) {
+         printf(" failed (see '%s').\n", Output);
+         NumFailed++;
+         continue;
+      }
+      Wall = wallClock() - Start;
+
+      N = atol(NStr);
+      fprintf(Csv, "%s,%ld,%s,%s,%s,%s,%s,%.3f,%.3f,%.1f,%.6g,%.4g,%.0f,%.4g\n",
+              Name, N, PStr, Conn, Syn, DStr, LifeStr,
+              Wall - p.WallTime, p.WallTime, MaxRSS / 1024.0,
+              p.SpikesPerSecond, p.NsPerSynapse, p.SynapsesDelivered,
+              p.EmittedSpikes * 1000.0 / (N * atof(LifeStr)));
+      fflush(Csv);
+      printf(" %.1f s (init %.1f s), %.1f Mbytes, %.4g ns/synapse\n",
+             Wall, Wall - p.WallTime, MaxRSS / 1024.0, p.NsPerSynapse);
+   }
+
+   fclose(Matrix);
+   fclose(Csv);
+   printf("%d cases, %d failed: results in '%s'.\n", NumCases, NumFailed, CsvName);
+
+   return NumFailed > 0 ? EXIT_FAILURE : 0;
+}
+
+
+
+#undef BUFFER_DIM
@@ -0,0 +1,618 @@
+/*
+ *
+ *   microbench.c
+ *
+ *   Microbenchmarks of the building blocks of the simulation
+ *   loop, measured in isolation with the access patterns of a
+ *   run:
+ *
+ *      queue   the FIFO of a delay layer (queue.c), with a
+ *              backlog of spikes and bursts of emissions of
+ *              heavy-tailed size, pushed and then popped;
+ *      events  the sorted queue of the events (sortedqueue.c)
+ *              in a hold model: the first event is got and a
+ *              new one is put, with many ties and a few far
+ *              times;
+ *      rng     blocks of draws from the generators (randdev.c);
+ *      axon    the decode of the axons (DPost and Exception,
+ *              see connectivity.h) delivering a spike to the
+ *              post-synaptic neurons, at varied connectivity;
+ *      replay  the replayed spikes (replay.c): the records of a
+ *              mapped file decoded and fanned out to the target
+ *              neurons of their source (compressed rows), with
+ *              1, 10 and 100 targets per source.
+ *
+ *      microbench [-n <operations>] [queue] [events] [rng] [axon] [replay]
+ *
+ *   Each case is repeated for <operations> times (100000 by
+ *   default) and a row reports the items (spikes, events,
+ *   draws, synapses or replayed spikes) managed per second and the percentiles
+ *   of the latency of an operation in ns, net of the cost of
+ *   reading the clock. All the benchmarks run without
+ *   arguments.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "perseo.h"
+#include "queue.h"
+#include "sortedqueue.h"
+#include "randdev.h"
+#include "modules.h"
+#include "connectivity.h"
+#include "replay.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define SEED          878918202 /* Seed of all the draws. */
+#define MAX_DISTANCE        255 /* Max distance between two post-synaptic neurons (see connectivity.c). */
+#define RNG_BLOCK          1024 /* Draws per operation of the generators. */
+#define AXON_NEURONS     100000 /* Post-synaptic neurons of the axons. */
+#define AXON_NUMBER        1024 /* Axons decoded in turn. */
+#define SPIKE_BACKLOG     16384 /* Spikes waiting in the queue of a layer. */
+#define REPLAY_RECORDS  1048576 /* Records of the replay file. */
+#define REPLAY_SOURCES     4096 /* Source neurons of the replay file. */
+#define REPLAY_BLOCK       1024 /* Replayed spikes delivered per operation. */
+#define NUM_CLOCK_LAPS    10000 /* Laps to measure the cost of reading the clock. */
+
+/**
+ *  An event of the hold model, keyed by its time as the
+ *  ones of events.c.
+ */
+
+typedef struct {
+   double Time; /* Time of the event in ms. */
+   int      Id; /* Number of the event. */
+} bench_event;
+
+/**
+ *  An axon segment encoded as in the synaptic matrix and
+ *  decoded by nextPostSynaptic() as the simulation loop does.
+ */
+
+typedef struct {
+   byte        *DPost; /* Distances between successive post-synaptic neurons. */
+   indexn  *Exception; /* Post-synaptic neurons farther than MAX_DISTANCE. */
+   float    *Synapses; /* Efficacies. */
+   indexn NumSynapses; /* Length of DPost. */
+} bench_axon;
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static double ClockCost = 0.0;  /* Cost of reading the clock in ns. */
+static long NumOperations = 100000; /* Operations per case. */
+static double *Latencies = NULL; /* Latency of each operation in ns. */
+static rand_stream Stream;      /* Draws of the access patterns. */
+static volatile double Sink;    /* Keeps the results from being optimized out. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*---------*
+ *  nanos  *
+ *---------*/
+
+/**
+ *  Returns a monotonic time in ns.
+ */
+
+static double nanos()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/*------------*
+ *  allocate  *
+ *------------*/
+
+/**
+ *  Allocates <Size> bytes, exiting if out of memory.
+ */
+
+static void *allocate(size_t Size)
+{
+   void *p;
+
+   if ((p = malloc(Size)) == NULL) {
+      fprintf(stderr, "ERROR (microbench): out of memory.\n");
+      exit(EXIT_FAILURE);
+   }
+   return p;
+}
+
+
+/*-------------*
+ *  cmpDouble  *
+ *-------------*/
+
+/**
+ *  Orders the latencies for qsort.
+ */
+
+static int cmpDouble(const void *a, const void *b)
+{
+   return *(double *)a < *(double *)b ? -1 : *(double *)a > *(double *)b;
+}
+
+
+/*-------------*
+ *  cmpEvents  *
+ *-------------*/
+
+/**
+ *  Orders the events by time, as cmpEvents in events.c.
+ */
+
+static int cmpEvents(void *Left, void *Right)
+{
+   if (((bench_event *)Left)->Time < ((bench_event *)Right)->Time)
+      return -1;
+   else if (((bench_event *)Left)->Time > ((bench_event *)Right)->Time)
+      return 1;
+   return 0;
+}
+
+
+/*-------------*
+ *  calibrate  *
+ *-------------*/
+
+/**
+ *  Measures the median cost of reading the clock twice.
+ */
+
+static void calibrate()
+{
+   double *Laps, t;
+   int k;
+
+   Laps = allocate(sizeof(double) * NUM_CLOCK_LAPS);
+   for (k=0; k<NUM_CLOCK_LAPS; k++) {
+      t = nanos();
+      Laps[k] = nanos() - t;
+   }
+   qsort(Laps, NUM_CLOCK_LAPS, sizeof(double), cmpDouble);
+   ClockCost = Laps[NUM_CLOCK_LAPS / 2];
+   free(Laps);
+}
+
+
+/*----------*
+ *  report  *
+ *----------*/
+
+/**
+ *  Prints the row of the case <Name>, with <Items> managed
+ *  in the <NumOperations> operations whose latencies are in
+ *  Latencies.
+ */
+
+static void report(char *Name,
+                   double Items)
+{
+   double Total;
+   long k;
+
+   for (Total = 0.0, k=0; k<NumOperations; k++) {
+      Latencies[k] = Latencies[k] > ClockCost ? Latencies[k] - ClockCost : 0.0;
+      Total += Latencies[k];
+   }
+   qsort(Latencies, NumOperations, sizeof(double), cmpDouble);
+
+#define percentile(p) Latencies[(long)((p) * (NumOperations - 1))]
+   printf("%-28s %12.4g %10.0f %10.0f %10.0f %10.0f %10.0f\n", Name,
+          Total > 0.0 ? Items / Total * 1e9 : 0.0,
+          percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999),
+          Latencies[NumOperations - 1]);
+#undef percentile
+   fflush(stdout);
+}
+
+
+/*-------------*
+ *  burstSize  *
+ *-------------*/
+
+/**
+ *  Returns the size of a burst of emissions: exponential with
+ *  mean <Mean>, and one in a hundred a synchronous burst of
+ *  <Mean> * 64 spikes.
+ */
+
+static int burstSize(int Mean)
+{
+   if (StreamRandom(&Stream) < 0.01)
+      return Mean * 64;
+   return 1 + (int)(StreamExpDev(&Stream) * (Mean - 1));
+}
+
+
+/*--------------*
+ *  benchQueue  *
+ *--------------*/
+
+/**
+ *  Pushes and pops bursts of spikes in the queue of a delay
+ *  layer, with SPIKE_BACKLOG spikes waiting.
+ */
+
+static void benchQueue()
+{
+   int Means[] = {4, 64, 1024};
+   int *Bursts, m, b;
+   double Items, t;
+   char Name[64];
+   spike s;
+   queue q;
+   long k;
+
+   Bursts = allocate(sizeof(int) * NumOperations);
+   for (m=0; m<3; m++) {
+      initQueue(&q, sizeof(spike));
+      memset(&s, 0, sizeof(spike));
+      for (k=0; k<SPIKE_BACKLOG; k++) {
+         s.Neuron = (indexn)k;
+         putQueueElement(&q, &s);
+      }
+      for (Items = 0.0, k=0; k<NumOperations; k++)
+         Items += Bursts[k] = burstSize(Means[m]);
+
+      for (k=0; k<NumOperations; k++) {
+         t = nanos();
+         for (b=0; b<Bursts[k]; b++) {
+            s.Neuron = (indexn)b;
+            putQueueElement(&q, &s);
+         }
+         for (b=0; b<Bursts[k]; b++)
+            getQueueElement(&q, &s);
+         Latencies[k] = nanos() - t;
+      }
+      Sink = s.Neuron;
+      sprintf(Name, "queue burst %d", Means[m]);
+      report(Name, Items);
+      free(q.Queue);
+   }
+   free(Bursts);
+}
+
+
+/*---------------*
+ *  benchEvents  *
+ *---------------*/
+
+/**
+ *  Holds the sorted queue of the events at a fixed size: the
+ *  first event is got and a new one is put at a later time,
+ *  equal to it in a case out of five, exponentially close in
+ *  most of the others, and with a heavy tail (Pareto) in one
+ *  case out of ten.
+ */
+
+static void benchEvents()
+{
+   int Sizes[] = {16, 1024, 65536};
+   bench_event *Pool, *e;
+   double *Steps, u, t;
+   sorted_queue SQ;
+   char Name[64];
+   int m;
+   long k;
+
+   Steps = allocate(sizeof(double) * NumOperations);
+   for (k=0; k<NumOperations; k++) {
+      u = StreamRandom(&Stream);
+      Steps[k] = u < 0.2 ? 0.0 : u < 0.9 ? StreamExpDev(&Stream) : 100.0 * pow(1.0 - StreamRandom(&Stream), -1.0 / 1.5);
+   }
+
+   for (m=0; m<3; m++) {
+      Pool = allocate(sizeof(bench_event) * Sizes[m]);
+      initSortedQueue(&SQ, cmpEvents);
+      for (k=0; k<Sizes[m]; k++) {
+         Pool[k].Time = 10.0 * StreamRandom(&Stream);
+         Pool[k].Id = (int)k;
+         putSortedQueueItem(&SQ, &Pool[k]);
+      }
+
+      for (k=0; k<NumOperations; k++) {
+         t = nanos();
+         e = getSortedQueueItem(&SQ);
+         e->Time += Steps[k];
+         putSortedQueueItem(&SQ, e);
+         Latencies[k] = nanos() - t;
+      }
+      sprintf(Name, "events hold %d", Sizes[m]);
+      report(Name, (double)NumOperations);
+
+      while (!isSortedQueueEmpty(&SQ))
+         getSortedQueueItem(&SQ);
+      free(Pool);
+   }
+   free(Steps);
+}
+
+
+/*------------*
+ *  benchRng  *
+ *------------*/
+
+/**
+ *  Draws blocks of RNG_BLOCK numbers from the generators.
+ */
+
+static void benchRng()
+{
+   char *Names[] = {"rng Random", "rng ExpDev", "rng StreamRandom", "rng StreamExpDev",
+                    "rng randomFill", "rng expFill", "rng normFill",
+                    "rng Random index", "rng wordFill index"};
+   double x[RNG_BLOCK], Sum, t;
+   uint32_t w[RNG_BLOCK];
+   rand_stream s;
+   int g, n;
+   long k;
+
+   SetRandomSeed(SEED);
+   InitRandomStream(&s, SEED, 0, 1);
+   for (g=0; g<9; g++) {
+      Sum = 0.0;
+      for (k=0; k<NumOperations; k++) {
+         t = nanos();
+         switch (g) {
+            case 0: for (n=0; n<RNG_BLOCK; n++) Sum += Random(); break;
+            case 1: for (n=0; n<RNG_BLOCK; n++) Sum += ExpDev(); break;
+            case 2: for (n=0; n<RNG_BLOCK; n++) Sum += StreamRandom(&s); break;
+            case 3: for (n=0; n<RNG_BLOCK; n++) Sum += StreamExpDev(&s); break;
+            case 4: randomFill(&s, x, RNG_BLOCK); Sum += x[RNG_BLOCK - 1]; break;
+            case 5: expFill(&s, x, RNG_BLOCK); Sum += x[RNG_BLOCK - 1]; break;
+            case 6: normFill(&s, x, RNG_BLOCK); Sum += x[RNG_BLOCK - 1]; break;
+            case 7: for (n=0; n<RNG_BLOCK; n++) Sum += (int)(Random() * ANALOG_DEPTH); break;
+            case 8: wordFill(&s, w, RNG_BLOCK);
+                    for (n=0; n<RNG_BLOCK; n++) Sum += (int)wordIndex(w[n], ANALOG_DEPTH);
+                    break;
+         }
+         Latencies[k] = nanos() - t;
+      }
+      Sink = Sum;
+      report(Names[g], (double)NumOperations * RNG_BLOCK);
+   }
+}
+
+
+/*--------------*
+ *  encodeAxon  *
+ *--------------*/
+
+/**
+ *  Encodes in <a> the axon of a neuron connected with
+ *  probability <CProb> to each of the AXON_NEURONS, as
+ *  createSynapticMatrix does.
+ */
+
+static void encodeAxon(bench_axon *a,
+                       double   CProb)
+{
+   long Post, Last, n, NumExceptions;
+
+   a->DPost = allocate(AXON_NEURONS);
+   a->Exception = allocate(sizeof(indexn) * AXON_NEURONS);
+   a->NumSynapses = 0;
+   NumExceptions = 0;
+   Last = -1;
+   for (Post=0; Post<AXON_NEURONS; Post++)
+      if (StreamRandom(&Stream) < CProb) {
+         n = Post - Last;
+         if (n > MAX_DISTANCE) {
+            n = EXCEPTION;
+            a->Exception[NumExceptions++] = (indexn)Post;
+         }
+         a->DPost[a->NumSynapses++] = (byte)n;
+         Last = Post;
+      }
+   a->Synapses = allocate(sizeof(float) * (a->NumSynapses + 1));
+   for (n=0; n<a->NumSynapses; n++)
+      a->Synapses[n] = (float)(0.01 * StreamRandom(&Stream));
+}
+
+
+/*-------------*
+ *  benchAxon  *
+ *-------------*/
+
+/**
+ *  Decodes AXON_NUMBER axons in a random order, adding the
+ *  efficacies to the potential of the post-synaptic neurons
+ *  as the loop of the simulation does.
+ */
+
+static void benchAxon()
+{
+   double CProbs[] = {0.001, 0.005, 0.02, 0.1, 0.5};
+   bench_axon *Axons, *Pre;
+   double *V, Items, t;
+   int *Order, m, j;
+   indexn i, nExcep, Post;
+   long k;
+   char Name[64];
+
+   Axons = allocate(sizeof(bench_axon) * AXON_NUMBER);
+   Order = allocate(sizeof(int) * NumOperations);
+   V = calloc(AXON_NEURONS, sizeof(double));
+   for (k=0; k<NumOperations; k++)
+      Order[k] = (int)(StreamRandom(&Stream) * AXON_NUMBER);
+
+   for (m=0; m<5; m++) {
+      for (j=0; j<AXON_NUMBER; j++)
+         encodeAxon(&Axons[j], CProbs[m]);
+
+      for (Items = 0.0, k=0; k<NumOperations; k++) {
+         Pre = &Axons[Order[k]];
+         t = nanos();
+         Post = -1;
+         nExcep = 0;
+         for (i=0; i<Pre->NumSynapses; i++) {
+            Post = nextPostSynaptic(Pre->DPost, Pre->Exception, i, Post, &nExcep);
+            V[Post] += Pre->Synapses[i];
+         }
+         Latencies[k] = nanos() - t;
+         Items += Pre->NumSynapses;
+      }
+      Sink = V[0];
+      sprintf(Name, "axon CProb %g", CProbs[m]);
+      report(Name, Items);
+
+      for (j=0; j<AXON_NUMBER; j++) {
+         free(Axons[j].DPost);
+         free(Axons[j].Exception);
+         free(Axons[j].Synapses);
+      }
+   }
+   free(V);
+   free(Order);
+   free(Axons);
+}
+
+
+/*---------------*
+ *  benchReplay  *
+ *---------------*/
+
+/**
+ *  Delivers blocks of REPLAY_BLOCK replayed spikes from a
+ *  file of REPLAY_RECORDS records of REPLAY_SOURCES sources,
+ *  each one mapped onto <FanOut> targets among AXON_NEURONS.
+ *  The file is opened again, out of the timing, when ended.
+ */
+
+static void benchReplay()
+{
+   int FanOuts[] = {1, 10, 100};
+   char FileName[] = "/tmp/microbenchXXXXXX";
+   char MapName[] = "/tmp/microbenchXXXXXX";
+   replay_record Rec;
+   double Items, Sum, t;
+   char Name[64];
+   FILE *File;
+   int m, b, f;
+   long k;
+
+   /*** The replay file and the map files are written once. ***/
+   close(mkstemp(FileName));
+   close(mkstemp(MapName));
+   if ((File = fopen(FileName, "wb")) == NULL) {
+      fprintf(stderr, "ERROR (microbench): unable to write '%s'.\n", FileName);
+      exit(EXIT_FAILURE);
+   }
+   memset(&Rec, 0, sizeof(replay_record));
+   for (k=0; k<REPLAY_RECORDS; k++) {
+      Rec.Time = 0.01 * k;
+      Rec.Neuron = (unsigned int)(StreamRandom(&Stream) * REPLAY_SOURCES);
+      fwrite(&Rec, sizeof(replay_record), 1, File);
+   }
+   fclose(File);
+   NumNeurons = AXON_NEURONS;
+
+   for (m=0; m<3; m++) {
+      if (FanOuts[m] > 1) {
+         File = fopen(MapName, "wt");
+         for (k=0; k<REPLAY_SOURCES; k++)
+            for (f=0; f<FanOuts[m]; f++)
+               fprintf(File, "%ld %d\n", k, (int)(StreamRandom(&Stream) * AXON_NEURONS));
+         fclose(File);
+      }
+
+      for (Items = Sum = 0.0, k=0; k<NumOperations; k++) {
+         if (ReplayEmpty && openReplay(FileName, 0.0, 0, FanOuts[m] > 1 ? MapName : NULL)) {
+            fprintf(stderr, "ERROR (microbench): unable to replay '%s'.\n", FileName);
+            exit(EXIT_FAILURE);
+         }
+         t = nanos();
+         for (b=0; b<REPLAY_BLOCK && !ReplayEmpty; b++) {
+            Sum += ReplaySpike.Neuron;
+            nextReplaySpike();
+         }
+         Latencies[k] = nanos() - t;
+         Items += b;
+      }
+      Sink = Sum;
+      sprintf(Name, "replay fan-out %d", FanOuts[m]);
+      report(Name, Items);
+   }
+
+   remove(FileName);
+   remove(MapName);
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   char *Names[] = {"queue", "events", "rng", "axon", "replay"};
+   void (*Benchmarks[])() = {benchQueue, benchEvents, benchRng, benchAxon, benchReplay};
+   int Selected[5] = {0, 0, 0, 0, 0};
+   int k, b, First, Any;
+
+   First = 1;
+   if (ArgC > 2 && strcmp(ArgV[1], "-n") == 0) {
+      NumOperations = atol(ArgV[2]);
+      First = 3;
+   }
+   for (Any = 0, k=First; k<ArgC; k++) {
+      for (b=0; b<5 && strcmp(ArgV[k], Names[b]) != 0; b++);
+      if (b == 5 || NumOperations < 1) {
+         fprintf(stderr, "Usage: %s [-n <operations>] [queue] [events] [rng] [axon] [replay]\n", ArgV[0]);
+         return EXIT_FAILURE;
+      }
+      Selected[b] = Any = 1;
+   }
+
+   Latencies = allocate(sizeof(double) * NumOperations);
+   InitRandomStream(&Stream, SEED, 0, 0);
+   calibrate();
+
+   printf("# %ld operations per case, clock read in %.0f ns (subtracted).\n", NumOperations, ClockCost);
+   printf("%-28s %12s %10s %10s %10s %10s %10s\n", "case", "items/s", "p50(ns)", "p90(ns)", "p99(ns)", "p99.9(ns)", "max(ns)");
+   for (b=0; b<5; b++)
+      if (Selected[b] || !Any)
+         (*Benchmarks[b])();
+
+   free(Latencies);
+   return 0;
+}
+
+
+
+#undef SEED
+#undef MAX_DISTANCE
+#undef RNG_BLOCK
+#undef AXON_NEURONS
+#undef AXON_NUMBER
+#undef SPIKE_BACKLOG
+#undef REPLAY_RECORDS
+#undef REPLAY_SOURCES
+#undef REPLAY_BLOCK
+#undef NUM_CLOCK_LAPS
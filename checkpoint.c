@@ -0,0 +1,723 @@
+/*
+ *
+ *   checkpoint.c
+ *
+ *   Library of functions to save the whole state of the
+ *   simulation in a checkpoint file, and to restart from it
+ *   a simulation continuing bit by bit as the saved one.
+ *   Each module writes and reads its own section, while the
+ *   file and the log files are managed here.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#include "types.h"
+#include "invar.h"
+
+#include "perseo.h"
+#include "results.h"
+#include "events.h"
+#include "commands.h"
+#include "modules.h"
+#include "neurons.h"
+#include "connectivity.h"
+#include "delays.h"
+#include "traces.h"
+#include "replay.h"
+#include "writer.h"
+#include "checkpoint.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM                  256 /* Maximum static string size in the module. */
+#define CHECKPOINT_BUFFER_SIZE  4194304 /* Size in bytes of the buffer of the checkpoint file. */
+#define MAX_CHAIN_LENGTH           1024 /* Maximum number of files in a chain of incremental checkpoints. */
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL char *CheckpointFileName = "checkpoint.dat"; /* Name of the checkpoint file. */
+PERSEO_LOCAL real    CheckpointPeriod = 0.0;              /* Period in ms of the checkpoints (0 for none). */
+PERSEO_LOCAL int CheckpointIncrements = 0;                /* Incremental checkpoints following a full one. */
+PERSEO_LOCAL char    *RestartFileName = EMPTY_STRING;     /* Checkpoint file to restart from. */
+
+PERSEO_LOCAL boolean CheckpointRequested = false; /* Set to write a checkpoint as soon as possible. */
+PERSEO_LOCAL double   NextCheckpointTime;          /* Time of the next periodic checkpoint. */
+
+volatile sig_atomic_t CheckpointSignals = 0; /* Checkpoint signals received by the process, polled *
+                                              * by every simulation thread.                       */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL boolean          Restarting = false; /* It is true if the simulation restarts from a checkpoint. */
+static PERSEO_LOCAL FILE           *RestartFile = NULL;  /* The checkpoint to restart from, under reading. */
+static PERSEO_LOCAL checkpoint_header    Header;         /* Header of the restart file. */
+static PERSEO_LOCAL int                 NumLogs = 0;     /* Number of log files in the restart file. */
+static PERSEO_LOCAL char             **LogNames = NULL;  /* Names of the log files. */
+static PERSEO_LOCAL long            *LogLengths = NULL;  /* Lengths of the log files at the checkpoint. */
+static PERSEO_LOCAL char     *RequestedFileName = NULL;  /* File of the checkpoint requested by a command, if any. */
+static PERSEO_LOCAL char ParentName[BUFFER_DIM] = "";    /* The last checkpoint written or restarted from, if any. */
+static PERSEO_LOCAL double           ParentTime;         /* Time of the ParentName checkpoint. */
+static PERSEO_LOCAL int             ChainLength = 0;     /* ChainLength of the ParentName checkpoint. */
+static PERSEO_LOCAL sig_atomic_t SeenCheckpointSignals = 0; /* CheckpointSignals already handled by the thread. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-----------------------*
+ *  interruptCheckpoint  *
+ *-----------------------*/
+
+/**
+ *  Management of the signal asking for a checkpoint, which
+ *  is written at the end of the current simulation step of
+ *  every simulation thread (see pollCheckpointSignal).
+ */
+
+static void interruptCheckpoint (int Signal)
+{
+   CheckpointSignals++;
+   signal(Signal, interruptCheckpoint);
+}
+
+
+/*----------------------*
+ *  nextCheckpointTime  *
+ *----------------------*/
+
+/**
+ *  Returns the time of the first periodic checkpoint
+ *  following <Time>.
+ */
+
+static double nextCheckpointTime (double Time)
+{
+   if (CheckpointPeriod <= 0.0)
+      return HUGE_VAL;
+
+   return (floor(Time / CheckpointPeriod) + 1.0) * CheckpointPeriod;
+}
+
+
+/*------------------*
+ *  restorePayload  *
+ *------------------*/
+
+/**
+ *  Reads the state of the synapses from the "SYNP" or "SYND"
+ *  section starting in <File>. For an incremental section the
+ *  synapses are first read from the chain of its parents.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int restorePayload (FILE *File, /* Checkpoint positioned at the section. */
+                           int  Depth) /* Number of files read in the chain. */
+{
+   checkpoint_header h;
+   char  Buffer[BUFFER_DIM];
+   char   Tag[4];
+   char  *Name;
+   double Time;
+   FILE *Parent;
+   int   Error;
+
+   if (readCheckpointData(File, Tag, 4))
+      return 1;
+   if (strncmp(Tag, "SYNP", 4) == 0)
+      return restoreSynapses(File);
+   if (strncmp(Tag, "SYND", 4) != 0 || Depth >= MAX_CHAIN_LENGTH ||
+       (Name = readCheckpointString(File)) == NULL)
+      return 1;
+
+   /*** The parent has to be the checkpoint from which the changes are saved. ***/
+   Error = readCheckpointData(File, &Time, sizeof(Time));
+   if (!Error) {
+      if ((Parent = fopen(Name, "rb")) == NULL)
+         Error = 1;
+      else {
+         setvbuf(Parent, NULL, _IOFBF, CHECKPOINT_BUFFER_SIZE);
+         Error = readCheckpointData(Parent, &h, sizeof(h)) ||
+                 strncmp(h.Magic, CHECKPOINT_MAGIC, 4) != 0 || h.Version != CHECKPOINT_VERSION ||
+                 h.Time != Time || h.NumNeurons != NumNeurons || h.DelayNumber != DelayNumber ||
+                 fseek(Parent, h.PayloadOffset, SEEK_SET) != 0 ||
+                 restorePayload(Parent, Depth + 1);
+         fclose(Parent);
+      }
+      if (Error) {
+         snprintf(Buffer, sizeof(Buffer), "the parent checkpoint '%s' at time %.7g ms is missing or changed.\n", Name, Time);
+         printError("restorePayload", Buffer);
+      }
+   }
+   releaseMemory(strlen(Name) + 1, MEMORY_OTHER);
+   free(Name);
+
+   return Error || restoreDirtySynapses(File);
+}
+
+
+/*---------------*
+ *  releaseLogs  *
+ *---------------*/
+
+/**
+ *  Frees the names and the lengths of the log files read
+ *  from the restart file.
+ */
+
+static void releaseLogs ()
+{
+   int k;
+
+   if (LogNames == NULL)
+      return;
+
+   for (k=0; k<NumLogs; k++) {
+      releaseMemory(strlen(LogNames[k]) + 1, MEMORY_OTHER);
+      free(LogNames[k]);
+   }
+   free(LogNames);
+   free(LogLengths);
+   releaseMemory(sizeof(char *) * (NumLogs + 1), MEMORY_OTHER);
+   releaseMemory(sizeof(long) * (NumLogs + 1), MEMORY_OTHER);
+   LogNames = NULL;
+   LogLengths = NULL;
+   NumLogs = 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*--------------------------*
+ *  Section read and write  *
+ *--------------------------*/
+
+/**
+ *  Functions used by the modules to save and load their
+ *  sections. Returns 1 on error, 0 otherwise.
+ */
+
+int writeCheckpointData(FILE *File, void *Data, size_t Size)
+{
+   return fwrite(Data, 1, Size, File) != Size;
+}
+
+int readCheckpointData(FILE *File, void *Data, size_t Size)
+{
+   return fread(Data, 1, Size, File) != Size;
+}
+
+int writeCheckpointString(FILE *File, char *String)
+{
+   int Length = strlen(String) + 1;
+
+   return writeCheckpointData(File, &Length, sizeof(Length)) ||
+          writeCheckpointData(File, String, Length);
+}
+
+int writeCheckpointSection(FILE *File, char *Tag)
+{
+   return writeCheckpointData(File, Tag, 4);
+}
+
+int readCheckpointSection(FILE *File, char *Tag)
+{
+   char Read[4];
+
+   return readCheckpointData(File, Read, 4) || strncmp(Read, Tag, 4) != 0;
+}
+
+
+/*------------------------*
+ *  readCheckpointString  *
+ *------------------------*/
+
+/**
+ *  Reads a string written by writeCheckpointString, allocated
+ *  with getMemory. Returns NULL on error.
+ */
+
+char *readCheckpointString(FILE *File)
+{
+   char *String;
+   int   Length;
+
+   if (readCheckpointData(File, &Length, sizeof(Length)) || Length <= 0 || Length > BUFFER_DIM)
+      return NULL;
+   String = getMemory(Length, "ERROR (readCheckpointString): Out of memory.");
+   if (readCheckpointData(File, String, Length) || String[Length-1] != '\0') {
+      free(String);
+      releaseMemory(Length, MEMORY_OTHER);
+      return NULL;
+   }
+
+   return String;
+}
+
+
+/*----------------*
+ *  isRestarting  *
+ *----------------*/
+
+/**
+ *  Returns true if the simulation restarts from a checkpoint.
+ */
+
+boolean isRestarting ()
+{
+   return Restarting;
+}
+
+
+/*---------------*
+ *  openRestart  *
+ *---------------*/
+
+/**
+ *  Opens the checkpoint RestartFileName, if defined, reading
+ *  its header and the lengths of the log files. The seeds
+ *  are set to the saved ones, so that the same network is
+ *  built. It has to be called before the log files are opened.
+ */
+
+void openRestart ()
+{
+   char Buffer[BUFFER_DIM];
+   int k;
+
+   if (!isDefined("RESTARTFILE"))
+      return;
+
+   /*** Reads the header. ***/
+   if ((RestartFile = fopen(RestartFileName, "rb")) == NULL) {
+      snprintf(Buffer, sizeof(Buffer), "unable to open '%s'.\n", RestartFileName);
+      printFatalError("openRestart", Buffer);
+   }
+   setvbuf(RestartFile, NULL, _IOFBF, CHECKPOINT_BUFFER_SIZE);
+   if (readCheckpointData(RestartFile, &Header, sizeof(Header)) ||
+       strncmp(Header.Magic, CHECKPOINT_MAGIC, 4) != 0 || Header.Version != CHECKPOINT_VERSION) {
+      snprintf(Buffer, sizeof(Buffer), "'%s' is not a checkpoint file.\n", RestartFileName);
+      printFatalError("openRestart", Buffer);
+   }
+
+   /*** The binary outputs cannot be resumed. ***/
+   if (ContainerResults || (SpikesResults && strcmp(SpikesFormat, "TEXT") != 0))
+      printFatalError("openRestart", "the results container and the binary spike rasters cannot be resumed.\n");
+
+   /*** The same network is built again. ***/
+   NeuronsSeed = Header.NeuronsSeed;
+   SynapsesSeed = Header.SynapsesSeed;
+
+   /*** Lengths of the log files. ***/
+   if (readCheckpointSection(RestartFile, "LOGS") ||
+       readCheckpointData(RestartFile, &NumLogs, sizeof(NumLogs)) || NumLogs < 0) {
+      snprintf(Buffer, sizeof(Buffer), "'%s' is corrupted.\n", RestartFileName);
+      printFatalError("openRestart", Buffer);
+   }
+   LogNames = getMemory(sizeof(char *) * (NumLogs + 1), "ERROR (openRestart): Out of memory.");
+   LogLengths = getMemory(sizeof(long) * (NumLogs + 1), "ERROR (openRestart): Out of memory.");
+   for (k=0; k<NumLogs; k++)
+      if ((LogNames[k] = readCheckpointString(RestartFile)) == NULL ||
+          readCheckpointData(RestartFile, &(LogLengths[k]), sizeof(long))) {
+         snprintf(Buffer, sizeof(Buffer), "'%s' is corrupted.\n", RestartFileName);
+         printFatalError("openRestart", Buffer);
+      }
+
+   Restarting = true;
+}
+
+
+/*-----------------*
+ *  resumeLogFile  *
+ *-----------------*/
+
+/**
+ *  Reopens for appending the log file <FileName> truncated to
+ *  the length it had when the restart checkpoint was written.
+ *  Returns NULL if the file cannot be opened.
+ */
+
+FILE *resumeLogFile(char *FileName)
+{
+   char Buffer[BUFFER_DIM];
+   FILE *File;
+   int k;
+
+   for (k=0; k<NumLogs; k++)
+      if (strcmp(LogNames[k], FileName) == 0)
+         break;
+   if (k == NumLogs) {
+      snprintf(Buffer, sizeof(Buffer), "log file '%s' not saved in the checkpoint.\n", FileName);
+      printFatalError("resumeLogFile", Buffer);
+   }
+
+   /*** Is the file shorter than at the checkpoint? ***/
+   if ((File = fopen(FileName, "rb")) == NULL)
+      return NULL;
+   fseek(File, 0, SEEK_END);
+   if (ftell(File) < LogLengths[k]) {
+      fclose(File);
+      return NULL;
+   }
+   fclose(File);
+
+   /*** Drops the records following the checkpoint. ***/
+#ifndef _WIN32
+   if (truncate(FileName, (off_t)LogLengths[k]) != 0)
+      return NULL;
+#else
+   if ((File = fopen(FileName, "r+b")) == NULL)
+      return NULL;
+   _chsize(_fileno(File), LogLengths[k]);
+   fclose(File);
+#endif
+
+   return fopen(FileName, "at");
+}
+
+
+/*---------------------*
+ *  restoreCheckpoint  *
+ *---------------------*/
+
+/**
+ *  Loads the state of the simulation from the restart file,
+ *  returning the simulation time in <*Time> and the next
+ *  external spike in <*ExtSpike>. It has to be called once
+ *  the network is built and the observers attached.
+ */
+
+void restoreCheckpoint(double   *Time, /* Simulation time. */
+                       spike *ExtSpike) /* Next external spike. */
+{
+   char Buffer[BUFFER_DIM];
+
+#ifdef PRINT_STATUS
+   fprintf(stderr, "\nRestarting from '%s'... ", RestartFileName);
+#endif
+
+   if (Header.NumNeurons != NumNeurons || Header.NumPopulations != NumPopulations ||
+       Header.DelayNumber != DelayNumber || Header.NumNeuronVariables != NumNeuronVariables) {
+      snprintf(Buffer, sizeof(Buffer), "the network of '%s' differs from the simulated one.\n", RestartFileName);
+      printFatalError("restoreCheckpoint", Buffer);
+   }
+
+   /*** Loads the sections. ***/
+   if (readCheckpointSection(RestartFile, "POPS") || restorePopulations(RestartFile) ||
+       readCheckpointSection(RestartFile, "SYNS") || restoreSynapticMatrix(RestartFile) ||
+       restorePayload(RestartFile, 0) ||
+       readCheckpointSection(RestartFile, "TRCS") || restoreTraces(RestartFile) ||
+       readCheckpointSection(RestartFile, "RPLS") || restoreReplays(RestartFile) ||
+       readCheckpointSection(RestartFile, "CMDS") || restoreCommands(RestartFile) ||
+       readCheckpointSection(RestartFile, "OBSS") || restoreResults(RestartFile) ||
+       readCheckpointSection(RestartFile, "END ")) {
+      snprintf(Buffer, sizeof(Buffer), "'%s' is corrupted or does not match the simulation.\n", RestartFileName);
+      printFatalError("restoreCheckpoint", Buffer);
+   }
+   fclose(RestartFile);
+   RestartFile = NULL;
+   releaseLogs();
+
+   *Time = Header.Time;
+   *ExtSpike = Header.ExtSpike;
+
+   /*** The next incremental checkpoint saves the changes from the restart. ***/
+   strcpy(ParentName, RestartFileName);
+   ParentTime = Header.Time;
+   ChainLength = Header.ChainLength;
+
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Restart from '%s' at time %.7g ms.\n\n", RestartFileName, *Time);
+   fflush(DocFile);
+
+#ifdef PRINT_STATUS
+   fprintf(stderr, "time %.7g ms (Memory: %g Mbytes)\r", *Time, (real)MemoryAmount/1024.0/1024.0);
+#endif
+}
+
+
+/*-------------------*
+ *  initCheckpoints  *
+ *-------------------*/
+
+/**
+ *  Sets the time of the first periodic checkpoint following
+ *  <Time>, and installs the signal asking for a checkpoint
+ *  (SIGUSR1), where available.
+ */
+
+void initCheckpoints(double Time)
+{
+   NextCheckpointTime = nextCheckpointTime(Time);
+
+#ifdef SIGUSR1
+   signal(SIGUSR1, interruptCheckpoint);
+#endif
+}
+
+
+/*------------------------*
+ *  pollCheckpointSignal  *
+ *------------------------*/
+
+/**
+ *  Sets CheckpointRequested if a checkpoint signal came since
+ *  the last one handled by the thread, and returns it.
+ */
+
+boolean pollCheckpointSignal (void)
+{
+   if (CheckpointSignals != SeenCheckpointSignals) {
+      SeenCheckpointSignals = CheckpointSignals;
+      CheckpointRequested = 1;
+   }
+
+   return CheckpointRequested;
+}
+
+
+/*-------------------*
+ *  forkCheckpoints  *
+ *-------------------*/
+
+/**
+ *  In a process forked by the simulation, puts <Prefix> in
+ *  front of the name of the next checkpoints. The chain of
+ *  the parent process is left, since its files are replaced
+ *  by it.
+ */
+
+void forkCheckpoints(char *Prefix)
+{
+   char *Name;
+
+   Name = getMemory(strlen(Prefix) + strlen(CheckpointFileName) + 1, "ERROR (forkCheckpoints): Out of memory.");
+   sprintf(Name, "%s%s", Prefix, CheckpointFileName);
+   CheckpointFileName = Name;
+   ParentName[0] = '\0';
+}
+
+
+/*-------------------*
+ *  writeCheckpoint  *
+ *-------------------*/
+
+/**
+ *  Writes a checkpoint of the simulation at <Time>, with the
+ *  next external spike <*ExtSpike>. The file is streamed
+ *  section by section without copies of the state, and is
+ *  renamed only once completed. A full checkpoint written
+ *  in CheckpointFileName removes the increments of the
+ *  previous chain, which refer to the replaced file and
+ *  could no longer be restored. A checkpoint requested in
+ *  another file is a full one left out of the chain: the
+ *  parent and the changes tracked since it are kept. On
+ *  error the simulation goes on.
+ */
+
+void writeCheckpoint(double   Time, /* Simulation time. */
+                     spike *ExtSpike) /* Next external spike. */
+{
+   checkpoint_header h;
+   char    Buffer[BUFFER_DIM];
+   char  FileName[BUFFER_DIM];
+   char   TmpName[BUFFER_DIM + 4];
+   char *FileBuffer;
+   FILE       *File;
+   boolean Incremental, /* The checkpoint saves only the changed synapses. */
+              Detached; /* The checkpoint is requested in a file out of the chain. */
+   int     Error, k;
+
+   CheckpointRequested = 0;
+   NextCheckpointTime = nextCheckpointTime(Time);
+
+   /*** An incremental checkpoint follows a saved one in the chain. ***/
+   Detached = RequestedFileName != NULL && strcmp(RequestedFileName, CheckpointFileName) != 0;
+   Incremental = RequestedFileName == NULL && ParentName[0] != '\0' && ChainLength < CheckpointIncrements;
+   if (RequestedFileName != NULL)
+      sprintf(FileName, "%.*s", BUFFER_DIM - 1, RequestedFileName);
+   else if (Incremental)
+      sprintf(FileName, "%.*s.%d", BUFFER_DIM - 13, CheckpointFileName, ChainLength + 1);
+   else
+      sprintf(FileName, "%.*s", BUFFER_DIM - 1, CheckpointFileName);
+   if (strcmp(FileName, ParentName) == 0) // The parent cannot be replaced by its child.
+      Incremental = false;
+   sprintf(TmpName, "%s.tmp", FileName);
+
+   /*** The header, zeroed to have no random padding bytes. ***/
+   memset(&h, 0, sizeof(h));
+   memcpy(h.Magic, CHECKPOINT_MAGIC, 4);
+   h.Version = CHECKPOINT_VERSION;
+   h.NeuronsSeed = NeuronsSeed;
+   h.SynapsesSeed = SynapsesSeed;
+   h.NumNeurons = NumNeurons;
+   h.NumPopulations = NumPopulations;
+   h.DelayNumber = DelayNumber;
+   h.NumNeuronVariables = NumNeuronVariables;
+   h.Time = Time;
+   h.ExtSpike = *ExtSpike;
+   h.ChainLength = Incremental ? ChainLength + 1 : 0;
+
+   /*** Streams the sections on the temporary file. ***/
+   if ((File = fopen(TmpName, "wb")) == NULL)
+      Error = 1;
+   else {
+      FileBuffer = getAreaMemory(CHECKPOINT_BUFFER_SIZE, MEMORY_OUTPUT, "ERROR (writeCheckpoint): Out of memory.");
+      setvbuf(File, FileBuffer, _IOFBF, CHECKPOINT_BUFFER_SIZE);
+      Error = writeCheckpointData(File, &h, sizeof(h)) ||
+              writeCheckpointSection(File, "LOGS") || checkpointOutStreams(File) ||
+              writeCheckpointSection(File, "POPS") || checkpointPopulations(File) ||
+              writeCheckpointSection(File, "SYNS") || checkpointSynapticMatrix(File) ||
+              (h.PayloadOffset = ftell(File)) < 0;
+      if (!Error) {
+         if (Incremental)
+            Error = writeCheckpointSection(File, "SYND") || writeCheckpointString(File, ParentName) ||
+                    writeCheckpointData(File, &ParentTime, sizeof(ParentTime)) || checkpointDirtySynapses(File);
+         else
+            Error = writeCheckpointSection(File, "SYNP") || checkpointSynapses(File);
+      }
+      Error = Error ||
+              writeCheckpointSection(File, "TRCS") || checkpointTraces(File) ||
+              writeCheckpointSection(File, "RPLS") || checkpointReplays(File) ||
+              writeCheckpointSection(File, "CMDS") || checkpointCommands(File) ||
+              writeCheckpointSection(File, "OBSS") || checkpointResults(File) ||
+              writeCheckpointSection(File, "END ") ||
+              fseek(File, 0, SEEK_SET) != 0 || writeCheckpointData(File, &h, sizeof(h));
+      if (fclose(File) != 0)
+         Error = 1;
+      free(FileBuffer);
+      releaseMemory(CHECKPOINT_BUFFER_SIZE, MEMORY_OUTPUT);
+   }
+
+   /*** The previous checkpoint is replaced only by a complete one. ***/
+   if (!Error) {
+#ifdef _WIN32
+      remove(FileName);
+#endif
+      Error = rename(TmpName, FileName) != 0;
+   }
+   if (Error) {
+      remove(TmpName);
+      snprintf(Buffer, sizeof(Buffer), "unable to write the checkpoint '%.*s'.\n", BUFFER_DIM - 40, FileName);
+      printError("writeCheckpoint", Buffer);
+   } else {
+
+      /*** A new base makes stale the increments of the old one. ***/
+      if (!Incremental && !Detached)
+         for (k=1; ; k++) {
+            sprintf(TmpName, "%.*s.%d", BUFFER_DIM - 13, CheckpointFileName, k);
+            if (remove(TmpName) != 0 && k >= CheckpointIncrements)
+               break;
+         }
+
+      /*** The changes are tracked from the new checkpoint of the chain. ***/
+      if (!Detached) {
+         strcpy(ParentName, FileName);
+         ParentTime = Time;
+         ChainLength = h.ChainLength;
+         clearDirtyAxons();
+      }
+#ifdef PRINT_STATUS
+      fprintf(stderr, "\n%s checkpoint at time %.7g ms written in '%s'.\n",
+              Incremental ? "Incremental" : "Full", Time, FileName);
+#endif
+   }
+
+   if (RequestedFileName != NULL) {
+      releaseMemory(strlen(RequestedFileName) + 1, MEMORY_OTHER);
+      free(RequestedFileName);
+      RequestedFileName = NULL;
+   }
+}
+
+
+/*---------------------*
+ *  requestCheckpoint  *
+ *---------------------*/
+
+/**
+ *  Hook function of the event asking for a checkpoint, in the
+ *  file named Event->ParamStr if not NULL.
+ */
+
+int requestCheckpoint(event *Event)
+{
+   if (Event->ParamStr != NULL) {
+      if (RequestedFileName != NULL) {
+         releaseMemory(strlen(RequestedFileName) + 1, MEMORY_OTHER);
+         free(RequestedFileName);
+      }
+      RequestedFileName = getMemory(strlen(Event->ParamStr) + 1, "ERROR (requestCheckpoint): Out of memory.");
+      strcpy(RequestedFileName, Event->ParamStr);
+   }
+   CheckpointRequested = 1;
+
+   return 1;
+}
+
+
+/*----------------------*
+ *  releaseCheckpoints  *
+ *----------------------*/
+
+/**
+ *  Closes the restart file, if not read, and forgets the
+ *  checkpoints written, so that a new simulation starts
+ *  its own chain of checkpoints.
+ */
+
+void releaseCheckpoints ()
+{
+   if (RestartFile != NULL)
+      fclose(RestartFile);
+   RestartFile = NULL;
+   releaseLogs();
+   if (RequestedFileName != NULL) {
+      releaseMemory(strlen(RequestedFileName) + 1, MEMORY_OTHER);
+      free(RequestedFileName);
+   }
+   RequestedFileName = NULL;
+   Restarting = false;
+   CheckpointRequested = 0;
+   SeenCheckpointSignals = CheckpointSignals;
+   ParentName[0] = '\0';
+   ChainLength = 0;
+}
+
+
+
+#undef MAX_CHAIN_LENGTH
+#undef CHECKPOINT_BUFFER_SIZE
+#undef BUFFER_DIM
@@ -0,0 +1,225 @@
+/*
+ *
+ *   checkpoint.h
+ *
+ *   Library of functions to save the whole state of the
+ *   simulation in a checkpoint file, and to restart from it
+ *   a simulation continuing bit by bit as the saved one.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+
+
+#include <stdio.h>
+#include <signal.h>
+
+#include "types.h"
+#include "invar.h"
+#include "events.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Layout of a checkpoint file (native binary format, to be
+ *  read by the same build of Perseo which wrote it):
+ *
+ *    checkpoint_header
+ *    sections, each one starting with a 4-character tag:
+ *      "LOGS" lengths of the log files (see writer.h)
+ *      "POPS" populations, external streams and neurons (see modules.h)
+ *      "SYNS" delay queues (see connectivity.h)
+ *      "SYNP" state of all the synapses, or
+ *      "SYND" name of the parent checkpoint (string), its time
+ *             (double) and the axon segments changed since it
+ *             (see connectivity.h)
+ *      "TRCS" streamed traces (see traces.h)
+ *      "RPLS" replayed spike trains (see replay.h)
+ *      "CMDS" command file and pending events (see commands.h)
+ *      "OBSS" state of the observers (see results.h)
+ *      "END "
+ *
+ *  The network structure is not saved: it is built again
+ *  from the saved seeds, and only its state is loaded.
+ *  An incremental checkpoint ("SYND") saves only the plastic
+ *  synapses whose stable state changed since its parent, so
+ *  that the synapses are loaded from a chain of files ending
+ *  with a full one. The efficacies are restored exactly, while
+ *  the hidden variable VJ of the synapses not saved is the one
+ *  of the older file.
+ *  PayloadOffset in the header locates the "SYNP" or "SYND"
+ *  section, to read the chain without parsing the rest.
+ */
+
+#define CHECKPOINT_MAGIC  "PCKP" /* First 4 bytes of the file. */
+#ifdef LARGE_NETWORK
+#define CHECKPOINT_VERSION   107 /* Version of the layout, with 64 bit indices. */
+#else
+#define CHECKPOINT_VERSION     7 /* Version of the layout. */
+#endif
+
+typedef struct {
+   char            Magic[4]; /* CHECKPOINT_MAGIC. */
+   int              Version; /* CHECKPOINT_VERSION. */
+   int          NeuronsSeed; /* Seed of the neuron states. */
+   int         SynapsesSeed; /* Seed of the synaptic matrix. */
+   indexn        NumNeurons; /* Number of neurons. */
+   int       NumPopulations; /* Number of populations. */
+   int          DelayNumber; /* Number of delay layers. */
+   int   NumNeuronVariables; /* State variables per neuron. */
+   double              Time; /* Simulation time of the checkpoint. */
+   spike           ExtSpike; /* Next external spike to deliver. */
+   long       PayloadOffset; /* Position of the "SYNP" or "SYND" section. */
+   int          ChainLength; /* Incremental checkpoints up to the full one (0 if full). */
+} checkpoint_header;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL char *CheckpointFileName; /* Name of the checkpoint file. */
+extern PERSEO_LOCAL real    CheckpointPeriod; /* Period in ms of the checkpoints (0 for none). */
+extern PERSEO_LOCAL int CheckpointIncrements; /* Incremental checkpoints following a full one. */
+extern PERSEO_LOCAL char    *RestartFileName; /* Checkpoint file to restart from. */
+
+extern PERSEO_LOCAL boolean CheckpointRequested; /* Set to write a checkpoint as soon as possible. */
+extern PERSEO_LOCAL double   NextCheckpointTime; /* Time of the next periodic checkpoint. */
+
+extern volatile sig_atomic_t CheckpointSignals; /* Checkpoint signals received by the process, polled *
+                                                 * by every simulation thread.                       */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Functions used by the modules to save and load their
+ *  sections. Returns 1 on error, 0 otherwise.
+ */
+
+int writeCheckpointData(FILE *File, void *Data, size_t Size);
+int readCheckpointData(FILE *File, void *Data, size_t Size);
+int writeCheckpointString(FILE *File, char *String);
+int writeCheckpointSection(FILE *File, char *Tag);
+int readCheckpointSection(FILE *File, char *Tag);
+
+
+/**
+ *  Reads a string written by writeCheckpointString, allocated
+ *  with getMemory. Returns NULL on error.
+ */
+
+char *readCheckpointString(FILE *File);
+
+
+/**
+ *  Returns true if the simulation restarts from a checkpoint.
+ */
+
+boolean isRestarting ();
+
+
+/**
+ *  Opens the checkpoint RestartFileName, if defined, reading
+ *  its header and the lengths of the log files. The seeds
+ *  are set to the saved ones, so that the same network is
+ *  built. It has to be called before the log files are opened.
+ */
+
+void openRestart ();
+
+
+/**
+ *  Reopens for appending the log file <FileName> truncated to
+ *  the length it had when the restart checkpoint was written.
+ *  Returns NULL if the file cannot be opened.
+ */
+
+FILE *resumeLogFile(char *FileName);
+
+
+/**
+ *  Loads the state of the simulation from the restart file,
+ *  returning the simulation time in <*Time> and the next
+ *  external spike in <*ExtSpike>. It has to be called once
+ *  the network is built and the observers attached.
+ */
+
+void restoreCheckpoint(double   *Time, /* Simulation time. */
+                       spike *ExtSpike); /* Next external spike. */
+
+
+/**
+ *  Sets the time of the first periodic checkpoint following
+ *  <Time>, and installs the signal asking for a checkpoint
+ *  (SIGUSR1), where available.
+ */
+
+void initCheckpoints(double Time);
+
+
+/**
+ *  Sets CheckpointRequested if a checkpoint signal came since
+ *  the last one handled by the thread, and returns it.
+ */
+
+boolean pollCheckpointSignal (void);
+
+
+/**
+ *  In a process forked by the simulation, puts <Prefix> in
+ *  front of the name of the next checkpoints, the first of
+ *  them being a full one.
+ */
+
+void forkCheckpoints(char *Prefix);
+
+
+/**
+ *  Writes a checkpoint of the simulation at <Time>, with the
+ *  next external spike <*ExtSpike>. The file is streamed
+ *  section by section without copies of the state, and is
+ *  renamed only once completed. On error the simulation
+ *  goes on. After a full checkpoint, the following
+ *  CheckpointIncrements ones are incremental, named as
+ *  CheckpointFileName followed by '.1', '.2', ...
+ */
+
+void writeCheckpoint(double   Time, /* Simulation time. */
+                     spike *ExtSpike); /* Next external spike. */
+
+
+/**
+ *  Hook function of the event asking for a checkpoint, in the
+ *  file named Event->ParamStr if not NULL.
+ */
+
+int requestCheckpoint(event *Event);
+
+
+/**
+ *  Closes the restart file, if not read, and forgets the
+ *  checkpoints written, so that a new simulation starts
+ *  its own chain of checkpoints.
+ */
+
+void releaseCheckpoints ();
+
+
+
+#endif /* __CHECKPOINT_H__ */
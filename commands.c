@@ -1,768 +1,1353 @@
-/*
- *
- *   commands.c
- *
- *     Library of commands recognised by the simulation,
- *   submitted as events to manage at a given time. Functions
- *   implements the commands and thei parsing from an input 
- *   file.
- *
- *   Project: Perseo 2.1.x
- *
- */
-
-
-
-#include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <math.h>
-
-#include "types.h"
-#include "events.h"
-#include "stimuli.h"
-#include "perseo.h"
-#include "results.h"
-#include "modules.h"
-#include "connectivity.h"
-
-
-
-/*----------------------*
- *  GLOBAL DEFINITIONS  *
- *----------------------*/
-
-char   *CommandsFileName = EMPTY_STRING; /* File name containing the commands to submit to the simulation ("protocol.ini"). */
-
-
-
-/*---------------------*
- *  LOCAL DEFINITIONS  *
- *---------------------*/
-
-#define PROCESSED_COMMAND     1
-#define PARSING_ERROR         0
-#define UNPROCESSED_COMMAND  -1
-
-#define BUFFER_DIM          256
-
-#define SAMPLING_PERIOD       1.0  /* Period between two consecutive command reading in ms. */
-
-
-
-/*-------------------*
- *  LOCAL FUNCTIONS  *
- *-------------------*/
-
-//
-// TO CUSTOMIZE (1)...
-//
-
-/*------------------*
- *  RANDOM_STIMULI  *
- *------------------*/
-
-/**
- *  Random stimuli generation:
- *
- *    RANDOM_STIMULI <iN> <fCL>
- *
- *  where iN is the number of random stimuli to build,
- *  and fCL is the coding level (the probability to have
- *  a neuron stimulate by the single stimulus).
- *
- *  WARNING: NOT IMPLEMENTED...
- */
-
-int processRandomStimuliCommand(char *InputLine, 
-                                double *pTime)
-{
-   float      f[3];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]));
-
-   if (strcmp(strupr(Command), "RANDOM_STIMULI") == 0)
-      if (ParamNum == 3)
-         createRandomStimuli((int)f[0], f[1]);
-      else {
-         printError("processRandomStimuliCommand", "parameters of 'RANDOM_STIMULI' differ from 2.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-
-/*----------------------*
- *  CORRUPTED_STIMULUS  *
- *----------------------*/
-
-/**
- *  Corrupted stimuli generation:
- *
- *     CORRUPTED_STIMULUS <iN> <fCL>
- *
- *  where iN is number of stimulus to corrupt,
- *  fCL is the corruption level of the stimulus,
- *  and range from 0 to 1: if it is 0 the stimulus
- *  is unchanged, while if it is 1 a random stimulus 
- *  is done.
- *
- *  WARNING: NOT IMPLEMENTED...
- */
-
-int processCorruptedStimulusCommand(char *InputLine, double *pTime)
-{
-   float      f[3];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]));
-
-   if (strcmp(strupr(Command), "CORRUPTED_STIMULUS") == 0)
-      if (ParamNum == 3)
-         createCorruptedStimulus((int)f[0], f[1]);
-      else {
-         printError("processCorruptedStimulusCommand", "parameters of 'CORRUPTED_STIMULUS' differ from 2.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*-----------------------------*
- *  PRINT_DENDRITIC_STRUCTURE  *
- *-----------------------------*/
-
-/**
- *  Print the a summary of the dendritic structure per population:
- *
- *     PRINT_DENDRITIC_STRUCTURE <dT>
- *
- *  <dT> time after which print the summary.
- */
-
-int processPrintDendriticStructureCommand(char *InputLine, double *pTime)
-{
-   float      f[2];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
-
-   if (strcmp(strupr(Command), "PRINT_DENDRITIC_STRUCTURE") == 0)
-      if (ParamNum == 2) {
-         *pTime += f[0];
-         newEvent(*pTime, &outDenStruct, NULL, 0);
-      } else {
-         printError("processPrintDendriticStructureCommand", "parameters of 'PRINT_DENDRITIC_STRUCTURE' differ from 1.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*----------------------------*
- *  PRINT_SYNAPTIC_STRUCTURE  *
- *----------------------------*/
-
-/**
- *  Print the a summary of the synaptic structure per population:
- *
- *     PRINT_SYNAPTIC_STRUCTURE <dT>
- *
- *  <dT> time after which print the summary.
- */
-
-int processPrintSynapticStructureCommand(char *InputLine, double *pTime)
-{
-   float      f[2];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
-
-   if (strcmp(strupr(Command), "PRINT_SYNAPTIC_STRUCTURE") == 0)
-      if (ParamNum == 2) {
-         *pTime += f[0];
-         if (SynStructResults)
-            newEvent(*pTime, &outSynStruct, NULL, 0);
-         else
-            printError("processPrintSynapticStructureCommand", "'PRINT_SYNAPTIC_STRUCTURE' is neglected because 'OUTSYNSTRUCT' is 'NO'.\n");
-      } else {
-         printError("processPrintSynapticStructureCommand", "parameters of 'PRINT_SYNAPTIC_STRUCTURE' differ from 1.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*-------------------------*
- *  START_SPIKE_RECORDING  *
- *-------------------------*/
-
-/**
- *  Starts to print the spikes if OUT_SPIKES is YES
- *
- *     START_SPIKE_RECORDING <dT>
- *
- *  The neurons monitored are the ones specified in 
- *  the definition file. The dump start after a 
- *  relative time <dT>.
- */
-
-int processStartSpikeRecordingCommand(char *InputLine, double *pTime)
-{
-   float      f[2];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
-
-   if (strcmp(strupr(Command), "START_SPIKE_RECORDING") == 0)
-      if (ParamNum == 2) {
-         *pTime += f[0];
-         newEvent(*pTime, &startSpikeRecording, NULL, 0);
-      } else {
-         printError("processStartSpikeRecordingCommand", "parameters of 'START_SPIKE_RECORDING' differ from 1.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*------------------------*
- *  STOP_SPIKE_RECORDING  *
- *------------------------*/
-
-/**
- *  Stops to print the spikes if OUT_SPIKES is YES
- *
- *     STOP_SPIKE_RECORDING <dT>
- *
- *  The neurons monitored are the ones specified in 
- *  the definition file. The stop is at a relative 
- *  time <dT>.
- */
-
-int processStopSpikeRecordingCommand(char *InputLine, double *pTime)
-{
-   float      f[2];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
-
-   if (strcmp(strupr(Command), "STOP_SPIKE_RECORDING") == 0)
-      if (ParamNum == 2) {
-         *pTime += f[0];
-         newEvent(*pTime, &startSpikeRecording, NULL, 0);
-      } else {
-         printError("processStopSpikeRecordingCommand", "parameters of 'STOP_SPIKE_RECORDING' differ from 1.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*---------------------*
- *  START_STIMULATION  *
- *---------------------*/
-
-/**
- *  Starts the update of afferent spike frequency from the outside
- *  to the neuron in the population to stimulate.
- *
- *    START_STIMULATION <dT> <iN> <fC>
- *
- *  Stimulation starts after a relative time <dT>. The stimulus to 
- *  consider between the one defined is the <iN>-th. <fC> is the 
- *  "contrast" of the stimulation: the percentage of variation in
- *  the afferent spike frequency from outside (\nu_ext \to 
- *  \nu_ext*(1 + fC).
- *
- *  WARNING: NOT IMPLEMENTED...
- */
-
-int processStartStimulationCommand(char *InputLine, double *pTime)
-{
-   float      f[4];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]));
-
-   if (strcmp(strupr(Command), "START_STIMULATION") == 0)
-      if (ParamNum == 4) {
-         *pTime += f[0];
-         newEvent(*pTime, &startStimulation, NULL, 2, f[1], f[2]);
-      } else {
-         printError("processStartStimulationCommand", "parameters of 'START_STIMULATION' differ from 3.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*--------------------*
- *  STOP_STIMULATION  *
- *--------------------*/
-
-/**
- *  Stops the last activated stimulation
- *
- *    STOP_STIMULATION <dT>
- *
- *  <dT> relative time after which interrupt the stimulation.
- *
- *  WARNING: NOT IMPLEMENTED...
- */
-
-int processStopStimulationCommand(char *InputLine, double *pTime)
-{
-   float      f[2];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
-
-   if (strcmp(strupr(Command), "STOP_STIMULATION") == 0)
-      if (ParamNum == 2) {
-         *pTime += f[0];
-         newEvent(*pTime, &stopStimulation, NULL, 0);
-      } else {
-         printError("processStopStimulationCommand", "parameters of 'STOP_STIMULATION' differ from 1.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*-------------*
- *  SET_PARAM  *
- *-------------*/
-
-/**
- *  Hook function called to manage the command which allow to 
- *  modify a population parameter like the external spike
- *  frequency.
- *
- *  WARNING: Only parameter n. 4 is managed (NuExt).
- */
-
-int setPopulationParamFromEvent(event *Event)
-{
-   setPopulationParam((int)(Event->Param[0]), (int)(Event->Param[1]), Event->Param[2], Event->Time);
-   return 1;
-}
-
-
-/**
- *  Hook function called to manage the command which allow to 
- *  modify a synaptic population parameter like the JumpUp or 
- *  JumpDown of the hidden synaptic variable.
- *
- *  WARNING: Only parameter n. 13 and 14 are managed (JumpUp and JumpDown).
- */
-
-int setConnectivityParamFromEvent(event *Event)
-{
-   setConnectivityParam((int)(Event->Param[0]), (int)(Event->Param[1]), (int)(Event->Param[2]), Event->Param[3], Event->Time);
-   return 1;
-}
-
-
-/**
- *  Sets a neural or synaptic population parameter to a new value.
- *
- *    SET_PARAM <time> <population> <param_num> <value>
- *
- *  <param_num> number of parameter to update (see modules.ini) of the.
- *  <population> after a period <time>, from the last event or the 
- *  simulation beginning, with the new value <value>.
- *  The parameter 4 is NuExt.
- *
- *  Other usage:
- *
- *    SET_PARAM <time> <post-pop.> <pre-pop.> <param_num> <value>
- *
- *  <param_num> number of parameter to update (see connectivity.ini) of the
- *  synaptic population having <post-pop.> and <pre-pop.> respectively as
- *  post and pre-synaptic population. The update is after <time> ms from the 
- *  last event or the simulation beginning. <value> is the new value of the 
- *  parameter.
- *  The parameters 13 and 14 are respectively <JumpUp> and <JumpDown>.
- */
-
-int processSetParamCommand(char *InputLine, double *pTime)
-{
-   float      f[5];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]), &(f[4]));
-
-   if (strcmp(strupr(Command), "SET_PARAM") == 0)
-      if (ParamNum == 5) {
-         *pTime += f[0];
-         newEvent(*pTime, &setPopulationParamFromEvent, NULL, 3, f[1], f[2], f[3]);
-      } else 
-         if (ParamNum == 6) {
-            *pTime += f[0];
-            newEvent(*pTime, &setConnectivityParamFromEvent, NULL, 4, f[1], f[2], f[3], f[4]);
-         } else {
-            printError("processSetParamCommand", "parameters of 'SET_PARAM' differ from 4.\n");
-            return PARSING_ERROR;
-         }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*------------------*
- *  SET_PARAM_FROM  *
- *------------------*/
-
-/**
- *  Sets a population parameter to a set of new values read from a file.
- *
- *    SET_PARAM_FROM <in_file_name> <population> <param_num>
- *
- *  Updates the parameter <param_num> (see modules.ini) of the 
- *  population <population> reading from the file <in_file_name> as
- *  many times as the number of rows in the file: each row has to
- *  provide two values, the first is the time after which to update
- *  the parameters with the value specified in the second column.
- */
-
-int processSetParamFromCommand(char *InputLine, double *pTime)
-{
-   float         f[5];
-   char    Command[BUFFER_DIM];
-   char   FileName[BUFFER_DIM];
-   char     sError[BUFFER_DIM];
-   FILE *ParamFile;
-   int    ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %s %f %f %f", Command, FileName, &(f[0]), &(f[1]), &(f[2]));
-
-   if (strcmp(strupr(Command), "SET_PARAM_FROM") == 0)
-      if (ParamNum == 4) {
-         if ((ParamFile = fopen(FileName, "rt")) == NULL) {
-            sprintf(sError, "unable to open parameter file '%s'.", FileName);
-            printError("processSetParamFromCommand", sError);
-            return PARSING_ERROR;
-         }
-         while (fscanf(ParamFile, "%f %f", &(f[3]), &(f[4])) == 2) {
-            *pTime += f[3];
-            newEvent(*pTime, &setPopulationParamFromEvent, NULL, 3, f[0], f[1], f[4]);
-         }
-         fclose(ParamFile);
-      } else {
-         printError("processSetParamFromCommand", "parameters of 'SET_PARAM_FROM' differ from 3.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*--------------------------*
- *  SINUSOIDAL_STIMULATION  *
- *--------------------------*/
-
-/**
- *  The hook function called to manage an event associated to
- *  the sinusoidal stimulation. The event to manage is the one
- *  passed as parameters.
- *  The return value is 1 if the event has to be disposed from
- *  the heap, 0 if it has to be reused.
- */
-
-int manageSinusoidalStimulation(event *Event)
-{
-   typedef struct {
-              double Pop;
-              double Num;
-              double T0;
-              double Dt;
-              double T;
-              double Phi;
-              double A;
-              double tmp;
-           } SinStimParam; 
-   static SinStimParam *p;
-
-   p = (SinStimParam *)(Event->Param);
-
-   if (Event->Time <= p->T0)
-      p->tmp = getPopulationParam((int)p->Pop, (int)p->Num);
-
-   setPopulationParam((int)p->Pop, (int)p->Num,
-                      p->tmp * (1.0 + (p->A * sin(6.283185307179586477 * (Event->Time - p->T0) / p->T) + p->Phi)), 
-                      Event->Time);
-   Event->Time += p->Dt;
-   putEvent(Event);
-
-   return 0;
-}
-
-
-/**
- *  Sinusoidal modulation of a population parameter.
- *
- *     SINUSOIDAL_STIMULATION <iP> <iN> <fT0> <fDt> <fT> <fPhi> <fA>
- *
- *  The parameter Param(iP, iN) at time <t> becomes:
- *     Param(iP, iN) (1 + fA sin(2 \pi (t-fT0)/fT + fPhi))
- *  where:
- *     <iP> population to which deliver the modulation;
- *     <iN> parameter number to modulate (4 for \nu_ext);
- *     <fT0> relative time when the modulation starts;
- *     <fDt> the sampling period of the modulation;
- *     <fT> period of the sinusoid;
- *     <fPhi> phase shift of the sinusoid.
- *     <fA> amplitude of the sinusoid.
- */
-
-int processSinusoidalStimulationCommand(char *InputLine, double *pTime)
-{
-   float      f[8];
-   char Command[BUFFER_DIM];
-   int ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %f %f %f %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]), &(f[4]), &(f[5]), &(f[6]), &(f[7]));
-
-   if (strcmp(strupr(Command), "SINUSOIDAL_STIMULATION") == 0)
-      if (ParamNum == 8) {
-         *pTime += f[2];
-         newEvent(*pTime, &manageSinusoidalStimulation, NULL, 8, f[0], f[1], *pTime, f[3], f[4], f[5], f[6], 0.0);
-      } else {
-         printError("processSinusoidalStimulationCommand", "parameters of 'SINUSOIDAL_STIMULATION' differ from 7.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*--------------------*
- *  EXTERNAL_COMMAND  *
- *--------------------*/
-
-/**
- *  The hook function called to manage an event associated to
- *  the launch of an external command. The event to manage is the one
- *  passed as parameters.
- *  The return value is 1 if the event has to be disposed from
- *  the heap, 0 if it has to be reused.
- */
-
-int manageExternalCommand(event *Event)
-{
-   flushOutputFiles();
-   system(Event->ParamStr);
-   return 1;
-}
-
-
-/**
- *  External command launch.
- *
- *     EXTERNAL_COMMAND <fT> <sCommand>
- *
- *  <fT> relative time when the external command <sCommand> will be 
- *  launched.
- */
-
-int processExternalCommand(char *InputLine, double *pTime)
-{
-   float         f;
-   char    Command[BUFFER_DIM];
-   char ExtCommand[BUFFER_DIM];
-   int    ParamNum;
-
-   ParamNum = sscanf(InputLine, "%s %f %s", Command, &f, ExtCommand);
-
-   if (strcmp(strupr(Command), "EXTERNAL_COMMAND") == 0)
-      if (ParamNum == 3) {
-         *pTime += f;
-         newEvent(*pTime, &manageExternalCommand, strstr(InputLine, ExtCommand), 0);
-      } else {
-         printError("processExternalCommand", "parameters of 'EXTERNAL_COMMAND' differ from 2.\n");
-         return PARSING_ERROR;
-      }
-   else
-      return UNPROCESSED_COMMAND;
-
-   return PROCESSED_COMMAND;
-}
-
-
-/*-------------------------*
- *  parseAndSubmitCommand  *
- *-------------------------*/
-
-/**
- *  Given an input string, parses it and recognises a
- *  possible command to submit to the simulation creating
- *  an associated event.
- *  The time at which the event will be processed is
- *  a relative time to add to the time pointed by <pTime>
- *  which is provided from outside and will be updated by
- *  this function.
- *  Return 1 if a command is recognized and stored, 0 
- *  otherwise.
- */
-
-int parseAndSubmitCommand(char *InputLine, /* The string to process. */
-                          double *pTime)   /* A pointer to the actual time. */
-{
-   char sBuffer[BUFFER_DIM];
-   char *pDest;
-   int    rval;
-
-   /* Remove comments if any. */
-   pDest = strstr(InputLine, "#");
-   if (pDest != NULL) pDest[0] = '\0';
-
-   /* Parses and submit the command. */
-   if (sscanf(InputLine, "%s", sBuffer) == EOF) // Is it an empty line?
-      return 1;
-
-//
-// TO CUSTOMIZE (2)...
-//
-  if ((rval = processRandomStimuliCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-     if ((rval = processCorruptedStimulusCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-        if ((rval = processPrintDendriticStructureCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-           if ((rval = processStartSpikeRecordingCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-              if ((rval = processStopSpikeRecordingCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                 if ((rval = processStartStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                    if ((rval = processStopStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                       if ((rval = processSinusoidalStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                          if ((rval = processSetParamFromCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                             if ((rval = processSetParamCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                                if ((rval = processExternalCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                                   if ((rval = processPrintSynapticStructureCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
-                                      rval = 0;
-
-   return rval;
-}
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/*----------------*
- *  readCommands  *
- *----------------*/
- 
-/**
- *  Reads and parses a command from lines, if available,
- *  in the command file, making correspondingly new events
- *  which will be processed at a given time of the simulation.
- *  If no command file is specified the stdin is assumed.
- *  If the pointer to the simulation time passed as parameter
- *  is NULL the static variables are initialized.
- *  The initialization have to occurre before any other call
- *  of the function.
- *  Note that the command file is not close once opened, in order
- *  to allow further command to be specified during the simulation.
- *  After the first initialization reading, the following readings
- *  occur each SAMPLING_PERIOD ms.
- */
-
-void readCommands (double *SimuTime) /* A ptr to the actual simulation time. */
-{
-   static FILE *CommandFile = NULL;      /* The command file. */
-   static int       LineNum = 0;         /* The number of scanning line. */
-   static double   LastTime;             /* Time of the last command reading. */
-   char                Line[BUFFER_DIM]; /* The string cointening the line under parsing. */
-   double              Time;             /* Local time to compute absolute time when the events will be managed. */
-
-   /*** Notify the first read of the command file. ***/
-#ifdef PRINT_STATUS
-   if (SimuTime == NULL)
-      fprintf(stderr, "\nReading commands... (Memory: %g Mbytes)\r", (real)MemoryAmount/1024.0/1024.0);
-#endif
- 
-   /*** File opening. ***/
-   if (SimuTime == NULL) {
-      if (strlen(CommandsFileName)>0) {
-         if ((CommandFile = fopen(CommandsFileName, "rt")) == NULL) {
-            sprintf(Line, "Unable to open command file '%s'.", CommandsFileName);
-            printError("readCommands", Line);
-//            CommandFile = stdin;
-         }
-      } else {
-//         CommandFile = stdin;
-      }
-      Time = START_TIME_OFFSET;
-      LastTime = Time;
-      initEventManager();
-   } else
-      /*** Is a new read required? ***/
-      if (LastTime + SAMPLING_PERIOD > *SimuTime)
-         return;
-      else
-         LastTime = Time = *SimuTime;
-
-   if (CommandFile == NULL) return;
-
-   /*** Parsing of the commands: one per line. ***/
-   while (fgets(Line, BUFFER_DIM, CommandFile) != NULL) {
-      parseAndSubmitCommand(Line, &Time);
-      LineNum++;      
-   }
-
-   /*** Notify the first read of the command file. ***/
-#ifdef PRINT_STATUS
-   if (SimuTime == NULL)
-      fprintf(stderr, "Reading commands... (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
-
-#endif
-}
-
-
-
-#undef SAMPLING_PERIOD
-#undef BUFFER_DIM
-#undef UNPROCESSED_COMMAND
-#undef PARSING_ERROR
-#undef PROCESSED_COMMAND
+/*
+ *
+ *   commands.c
+ *
+ *     Library of commands recognised by the simulation,
+ *   submitted as events to manage at a given time. Functions
+ *   implements the commands and thei parsing from an input 
+ *   file.
+ *
+ *   Project: Perseo 2.1.x
+ *
+ */
+
+
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "types.h"
+#include "events.h"
+#include "stimuli.h"
+#include "perseo.h"
+#include "results.h"
+#include "modules.h"
+#include "connectivity.h"
+#include "traces.h"
+#include "replay.h"
+#include "checkpoint.h"
+#include "ensemble.h"
+#include "control.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+PERSEO_LOCAL char   *CommandsFileName = EMPTY_STRING; /* File name containing the commands to submit to the simulation ("protocol.ini"). */
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define PROCESSED_COMMAND     1
+#define PARSING_ERROR         0
+#define UNPROCESSED_COMMAND  -1
+
+#define BUFFER_DIM          256
+
+#define SAMPLING_PERIOD       1.0  /* Period between two consecutive command reading in ms. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL FILE *CommandFile = NULL; /* The command file. */
+static PERSEO_LOCAL int       LineNum = 0;    /* The number of scanning line. */
+static PERSEO_LOCAL double   LastTime;        /* Time of the last command reading. */
+static PERSEO_LOCAL int     Suspended = 0;    /* It is 1 if the reading waits for a BRANCH command. */
+#ifndef _WIN32
+static PERSEO_LOCAL pthread_t *CommandThreads = NULL; /* Threads running the external commands. */
+static PERSEO_LOCAL int     NumCommandThreads = 0;    /* Number of elements in CommandThreads. */
+#endif
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+//
+// TO CUSTOMIZE (1)...
+//
+
+/*------------------*
+ *  RANDOM_STIMULI  *
+ *------------------*/
+
+/**
+ *  Random stimuli generation:
+ *
+ *    RANDOM_STIMULI <iN> <fCL>
+ *
+ *  where iN is the number of random stimuli to build,
+ *  and fCL is the coding level (the probability to have
+ *  a neuron stimulate by the single stimulus).
+ *
+ *  WARNING: NOT IMPLEMENTED...
+ */
+
+int processRandomStimuliCommand(char *InputLine, 
+                                double *pTime)
+{
+   float      f[3];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]));
+
+   if (strcmp(strupr(Command), "RANDOM_STIMULI") == 0)
+      if (ParamNum == 3)
+         createRandomStimuli((int)f[0], f[1]);
+      else {
+         printError("processRandomStimuliCommand", "parameters of 'RANDOM_STIMULI' differ from 2.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+
+/*----------------------*
+ *  CORRUPTED_STIMULUS  *
+ *----------------------*/
+
+/**
+ *  Corrupted stimuli generation:
+ *
+ *     CORRUPTED_STIMULUS <iN> <fCL>
+ *
+ *  where iN is number of stimulus to corrupt,
+ *  fCL is the corruption level of the stimulus,
+ *  and range from 0 to 1: if it is 0 the stimulus
+ *  is unchanged, while if it is 1 a random stimulus 
+ *  is done.
+ *
+ *  WARNING: NOT IMPLEMENTED...
+ */
+
+int processCorruptedStimulusCommand(char *InputLine, double *pTime)
+{
+   float      f[3];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]));
+
+   if (strcmp(strupr(Command), "CORRUPTED_STIMULUS") == 0)
+      if (ParamNum == 3)
+         createCorruptedStimulus((int)f[0], f[1]);
+      else {
+         printError("processCorruptedStimulusCommand", "parameters of 'CORRUPTED_STIMULUS' differ from 2.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-----------------------------*
+ *  PRINT_DENDRITIC_STRUCTURE  *
+ *-----------------------------*/
+
+/**
+ *  Print the a summary of the dendritic structure per population:
+ *
+ *     PRINT_DENDRITIC_STRUCTURE <dT>
+ *
+ *  <dT> time after which print the summary.
+ */
+
+int processPrintDendriticStructureCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
+
+   if (strcmp(strupr(Command), "PRINT_DENDRITIC_STRUCTURE") == 0)
+      if (ParamNum == 2) {
+         *pTime += f[0];
+         newEvent(*pTime, &outDenStruct, NULL, 0);
+      } else {
+         printError("processPrintDendriticStructureCommand", "parameters of 'PRINT_DENDRITIC_STRUCTURE' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*----------------------------*
+ *  PRINT_SYNAPTIC_STRUCTURE  *
+ *----------------------------*/
+
+/**
+ *  Print the a summary of the synaptic structure per population:
+ *
+ *     PRINT_SYNAPTIC_STRUCTURE <dT>
+ *
+ *  <dT> time after which print the summary.
+ */
+
+int processPrintSynapticStructureCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
+
+   if (strcmp(strupr(Command), "PRINT_SYNAPTIC_STRUCTURE") == 0)
+      if (ParamNum == 2) {
+         *pTime += f[0];
+         if (SynStructResults)
+            newEvent(*pTime, &outSynStruct, NULL, 0);
+         else
+            printError("processPrintSynapticStructureCommand", "'PRINT_SYNAPTIC_STRUCTURE' is neglected because 'OUTSYNSTRUCT' is 'NO'.\n");
+      } else {
+         printError("processPrintSynapticStructureCommand", "parameters of 'PRINT_SYNAPTIC_STRUCTURE' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-------------------------*
+ *  START_SPIKE_RECORDING  *
+ *-------------------------*/
+
+/**
+ *  Starts to print the spikes if OUT_SPIKES is YES
+ *
+ *     START_SPIKE_RECORDING <dT>
+ *
+ *  The neurons monitored are the ones specified in 
+ *  the definition file. The dump start after a 
+ *  relative time <dT>.
+ */
+
+int processStartSpikeRecordingCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
+
+   if (strcmp(strupr(Command), "START_SPIKE_RECORDING") == 0)
+      if (ParamNum == 2) {
+         *pTime += f[0];
+         newEvent(*pTime, &startSpikeRecording, NULL, 0);
+      } else {
+         printError("processStartSpikeRecordingCommand", "parameters of 'START_SPIKE_RECORDING' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*------------------------*
+ *  STOP_SPIKE_RECORDING  *
+ *------------------------*/
+
+/**
+ *  Stops to print the spikes if OUT_SPIKES is YES
+ *
+ *     STOP_SPIKE_RECORDING <dT>
+ *
+ *  The neurons monitored are the ones specified in 
+ *  the definition file. The stop is at a relative 
+ *  time <dT>.
+ */
+
+int processStopSpikeRecordingCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
+
+   if (strcmp(strupr(Command), "STOP_SPIKE_RECORDING") == 0)
+      if (ParamNum == 2) {
+         *pTime += f[0];
+         newEvent(*pTime, &stopSpikeRecording, NULL, 0);
+      } else {
+         printError("processStopSpikeRecordingCommand", "parameters of 'STOP_SPIKE_RECORDING' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*---------------------*
+ *  START_STIMULATION  *
+ *---------------------*/
+
+/**
+ *  Starts the update of afferent spike frequency from the outside
+ *  to the neuron in the population to stimulate.
+ *
+ *    START_STIMULATION <dT> <iN> <fC>
+ *
+ *  Stimulation starts after a relative time <dT>. The stimulus to 
+ *  consider between the one defined is the <iN>-th. <fC> is the 
+ *  "contrast" of the stimulation: the percentage of variation in
+ *  the afferent spike frequency from outside (\nu_ext \to 
+ *  \nu_ext*(1 + fC).
+ *
+ *  WARNING: NOT IMPLEMENTED...
+ */
+
+int processStartStimulationCommand(char *InputLine, double *pTime)
+{
+   float      f[4];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]));
+
+   if (strcmp(strupr(Command), "START_STIMULATION") == 0)
+      if (ParamNum == 4) {
+         *pTime += f[0];
+         newEvent(*pTime, &startStimulation, NULL, 2, f[1], f[2]);
+      } else {
+         printError("processStartStimulationCommand", "parameters of 'START_STIMULATION' differ from 3.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*--------------------*
+ *  STOP_STIMULATION  *
+ *--------------------*/
+
+/**
+ *  Stops the last activated stimulation
+ *
+ *    STOP_STIMULATION <dT>
+ *
+ *  <dT> relative time after which interrupt the stimulation.
+ *
+ *  WARNING: NOT IMPLEMENTED...
+ */
+
+int processStopStimulationCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f", Command, &(f[0]), &(f[1]));
+
+   if (strcmp(strupr(Command), "STOP_STIMULATION") == 0)
+      if (ParamNum == 2) {
+         *pTime += f[0];
+         newEvent(*pTime, &stopStimulation, NULL, 0);
+      } else {
+         printError("processStopStimulationCommand", "parameters of 'STOP_STIMULATION' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-------------*
+ *  SET_PARAM  *
+ *-------------*/
+
+/**
+ *  Hook function called to manage the command which allow to 
+ *  modify a population parameter like the external spike
+ *  frequency.
+ *
+ *  WARNING: Only parameter n. 4 is managed (NuExt).
+ */
+
+int setPopulationParamFromEvent(event *Event)
+{
+   setPopulationParam((int)(Event->Param[0]), (int)(Event->Param[1]), Event->Param[2], Event->Time);
+   return 1;
+}
+
+
+/**
+ *  Hook function called to manage the command which allow to 
+ *  modify a synaptic population parameter like the JumpUp or 
+ *  JumpDown of the hidden synaptic variable.
+ *
+ *  WARNING: Only parameter n. 13 and 14 are managed (JumpUp and JumpDown).
+ */
+
+int setConnectivityParamFromEvent(event *Event)
+{
+   setConnectivityParam((int)(Event->Param[0]), (int)(Event->Param[1]), (int)(Event->Param[2]), Event->Param[3], Event->Time);
+   return 1;
+}
+
+
+/**
+ *  Sets a neural or synaptic population parameter to a new value.
+ *
+ *    SET_PARAM <time> <population> <param_num> <value>
+ *
+ *  <param_num> number of parameter to update (see modules.ini) of the.
+ *  <population> after a period <time>, from the last event or the 
+ *  simulation beginning, with the new value <value>.
+ *  The parameter 4 is NuExt.
+ *
+ *  Other usage:
+ *
+ *    SET_PARAM <time> <post-pop.> <pre-pop.> <param_num> <value>
+ *
+ *  <param_num> number of parameter to update (see connectivity.ini) of the
+ *  synaptic population having <post-pop.> and <pre-pop.> respectively as
+ *  post and pre-synaptic population. The update is after <time> ms from the 
+ *  last event or the simulation beginning. <value> is the new value of the 
+ *  parameter.
+ *  The parameters 13 and 14 are respectively <JumpUp> and <JumpDown>.
+ */
+
+int processSetParamCommand(char *InputLine, double *pTime)
+{
+   float      f[5];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]), &(f[4]));
+
+   if (strcmp(strupr(Command), "SET_PARAM") == 0)
+      if (ParamNum == 5) {
+         *pTime += f[0];
+         newEvent(*pTime, &setPopulationParamFromEvent, NULL, 3, f[1], f[2], f[3]);
+      } else 
+         if (ParamNum == 6) {
+            *pTime += f[0];
+            newEvent(*pTime, &setConnectivityParamFromEvent, NULL, 4, f[1], f[2], f[3], f[4]);
+         } else {
+            printError("processSetParamCommand", "parameters of 'SET_PARAM' differ from 4.\n");
+            return PARSING_ERROR;
+         }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*------------------*
+ *  SET_PARAM_FROM  *
+ *------------------*/
+
+/**
+ *  Sets a population parameter to a set of new values read from a file.
+ *
+ *    SET_PARAM_FROM <in_file_name> <population> <param_num>
+ *
+ *  Updates the parameter <param_num> (see modules.ini) of the 
+ *  population <population> reading from the file <in_file_name> as
+ *  many times as the number of rows in the file: each row has to
+ *  provide two values, the first is the time after which to update
+ *  the parameters with the value specified in the second column.
+ *  NOTE: the whole file is loaded as events in the heap, long
+ *        traces have to be streamed with SET_PARAM_STREAM.
+ */
+
+int processSetParamFromCommand(char *InputLine, double *pTime)
+{
+   float         f[5];
+   char    Command[BUFFER_DIM];
+   char   FileName[BUFFER_DIM];
+   char     sError[BUFFER_DIM];
+   FILE *ParamFile;
+   int    ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %s %f %f %f", Command, FileName, &(f[0]), &(f[1]), &(f[2]));
+
+   if (strcmp(strupr(Command), "SET_PARAM_FROM") == 0)
+      if (ParamNum == 4) {
+         if ((ParamFile = fopen(FileName, "rt")) == NULL) {
+            sprintf(sError, "unable to open parameter file '%.*s'.", BUFFER_DIM - 40, FileName);
+            printError("processSetParamFromCommand", sError);
+            return PARSING_ERROR;
+         }
+         while (fscanf(ParamFile, "%f %f", &(f[3]), &(f[4])) == 2) {
+            *pTime += f[3];
+            newEvent(*pTime, &setPopulationParamFromEvent, NULL, 3, f[0], f[1], f[4]);
+         }
+         fclose(ParamFile);
+      } else {
+         printError("processSetParamFromCommand", "parameters of 'SET_PARAM_FROM' differ from 3.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*--------------------*
+ *  SET_PARAM_STREAM  *
+ *--------------------*/
+
+/**
+ *  The hook function called to manage an event associated to
+ *  a population parameter streamed from a trace file. The 
+ *  parameter is updated with the current sample and the event 
+ *  is rescheduled at the time of the next different sample, 
+ *  so that a single event is in the queue whatever is the 
+ *  length of the trace.
+ *  The return value is 1 if the event has to be disposed from
+ *  the heap, 0 if it has to be reused.
+ */
+
+int manageParamStream(event *Event)
+{
+   trace *t;
+   int    k;
+
+   k = (int)(Event->Param[0]);
+   t = getTrace(k);
+
+   setPopulationParam((int)(Event->Param[1]), (int)(Event->Param[2]), t->Values[t->Cursor], Event->Time);
+
+   /*** Is the trace ended? ***/
+   if (advanceTrace(k)) {
+      closeTrace(k);
+      return 1;
+   }
+
+   Event->Time = t->T0 + t->Dt * t->Cursor;
+   putEvent(Event);
+
+   return 0;
+}
+
+
+/**
+ *  Sets a population parameter to the values streamed from a 
+ *  binary trace file.
+ *
+ *    SET_PARAM_STREAM <time> <in_file_name> <population> <param_num> <dt>
+ *
+ *  After a relative period <time> the parameter <param_num> (see 
+ *  modules.ini) of the population <population> is updated every 
+ *  <dt> ms with the values read in sequence from <in_file_name>.
+ *  The file has no header and contains the values as native
+ *  double precision numbers (8 bytes). It is mapped in memory
+ *  and never loaded, so that the memory used does not depend on
+ *  its length. The last value is kept at the end of the trace.
+ */
+
+int processSetParamStreamCommand(char *InputLine, double *pTime)
+{
+   float         f[5];
+   char    Command[BUFFER_DIM];
+   char   FileName[BUFFER_DIM];
+   char     sError[BUFFER_DIM];
+   int    ParamNum;
+   int           k;
+
+   ParamNum = sscanf(InputLine, "%255s %f %255s %f %f %f %f", Command, &(f[0]), FileName, &(f[1]), &(f[2]), &(f[3]), &(f[4]));
+
+   if (strcmp(strupr(Command), "SET_PARAM_STREAM") == 0)
+      if (ParamNum == 6 && f[3] > 0.0) {
+         *pTime += f[0];
+         if ((k = openTrace(FileName, *pTime, f[3])) < 0) {
+            snprintf(sError, sizeof(sError), "unable to map trace file '%.*s'.\n", BUFFER_DIM - 32, FileName);
+            printError("processSetParamStreamCommand", sError);
+            return PARSING_ERROR;
+         }
+         newEvent(*pTime, &manageParamStream, NULL, 3, (double)k, f[1], f[2]);
+      } else {
+         printError("processSetParamStreamCommand", "parameters of 'SET_PARAM_STREAM' differ from 5.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-----------------*
+ *  REPLAY_SPIKES  *
+ *-----------------*/
+
+/**
+ *  Replays a recorded spike train delivering it to the neurons
+ *  of the network as spikes coming from outside.
+ *
+ *    REPLAY_SPIKES <time> <in_file_name> <first_target> [<map_file_name>]
+ *
+ *  After a relative period <time> the spikes in the binary file
+ *  <in_file_name> are delivered, merged with the external and 
+ *  recurrent ones. The file has no header and is a sequence of
+ *  16-byte records sorted in time: the emission time in ms from
+ *  the start of the replay (a native double) and the source neuron
+ *  (a 32-bit unsigned integer) followed by 4 zero bytes. It is
+ *  mapped in memory and streamed.
+ *  The source neuron s is delivered to the neuron <first_target> + s,
+ *  or if <map_file_name> is given to the neurons <first_target> + t
+ *  for each row "s t" of this text file.
+ */
+
+int processReplaySpikesCommand(char *InputLine, double *pTime)
+{
+   float         f[3];
+   char    Command[BUFFER_DIM];
+   char   FileName[BUFFER_DIM];
+   char    MapName[BUFFER_DIM];
+   char     sError[BUFFER_DIM];
+   int    ParamNum;
+
+   ParamNum = sscanf(InputLine, "%255s %f %255s %f %255s", Command, &(f[0]), FileName, &(f[1]), MapName);
+
+   if (strcmp(strupr(Command), "REPLAY_SPIKES") == 0)
+      if ((ParamNum == 4 || ParamNum == 5) && f[1] >= 0.0) {
+         *pTime += f[0];
+         if (openReplay(FileName, *pTime, (indexn)f[1], ParamNum == 5 ? MapName : NULL)) {
+            snprintf(sError, sizeof(sError), "unable to load replay file '%.*s'.\n", BUFFER_DIM - 32, FileName);
+            printError("processReplaySpikesCommand", sError);
+            return PARSING_ERROR;
+         }
+      } else {
+         printError("processReplaySpikesCommand", "parameters of 'REPLAY_SPIKES' differ from 3 or 4.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*--------------------------*
+ *  SINUSOIDAL_STIMULATION  *
+ *--------------------------*/
+
+/**
+ *  The hook function called to manage an event associated to
+ *  the sinusoidal stimulation. The event to manage is the one
+ *  passed as parameters.
+ *  The return value is 1 if the event has to be disposed from
+ *  the heap, 0 if it has to be reused.
+ */
+
+int manageSinusoidalStimulation(event *Event)
+{
+   typedef struct {
+              double Pop;
+              double Num;
+              double T0;
+              double Dt;
+              double T;
+              double Phi;
+              double A;
+              double tmp;
+           } SinStimParam; 
+   SinStimParam *p;
+
+   p = (SinStimParam *)(Event->Param);
+
+   if (Event->Time <= p->T0)
+      p->tmp = getPopulationParam((int)p->Pop, (int)p->Num);
+
+   setPopulationParam((int)p->Pop, (int)p->Num,
+                      p->tmp * (1.0 + (p->A * sin(6.283185307179586477 * (Event->Time - p->T0) / p->T) + p->Phi)), 
+                      Event->Time);
+   Event->Time += p->Dt;
+   putEvent(Event);
+
+   return 0;
+}
+
+
+/**
+ *  Sinusoidal modulation of a population parameter.
+ *
+ *     SINUSOIDAL_STIMULATION <iP> <iN> <fT0> <fDt> <fT> <fPhi> <fA>
+ *
+ *  The parameter Param(iP, iN) at time <t> becomes:
+ *     Param(iP, iN) (1 + fA sin(2 \pi (t-fT0)/fT + fPhi))
+ *  where:
+ *     <iP> population to which deliver the modulation;
+ *     <iN> parameter number to modulate (4 for \nu_ext);
+ *     <fT0> relative time when the modulation starts;
+ *     <fDt> the sampling period of the modulation;
+ *     <fT> period of the sinusoid;
+ *     <fPhi> phase shift of the sinusoid.
+ *     <fA> amplitude of the sinusoid.
+ */
+
+int processSinusoidalStimulationCommand(char *InputLine, double *pTime)
+{
+   float      f[8];
+   char Command[BUFFER_DIM];
+   int ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %f %f %f %f %f %f %f", Command, &(f[0]), &(f[1]), &(f[2]), &(f[3]), &(f[4]), &(f[5]), &(f[6]), &(f[7]));
+
+   if (strcmp(strupr(Command), "SINUSOIDAL_STIMULATION") == 0)
+      if (ParamNum == 8) {
+         *pTime += f[2];
+         newEvent(*pTime, &manageSinusoidalStimulation, NULL, 8, f[0], f[1], *pTime, f[3], f[4], f[5], f[6], 0.0);
+      } else {
+         printError("processSinusoidalStimulationCommand", "parameters of 'SINUSOIDAL_STIMULATION' differ from 7.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-------------------*
+ *  RATE_MODULATION  *
+ *-------------------*/
+
+/**
+ *  Hook function called to manage the command which sets the
+ *  time-varying modulation of the external spike frequency 
+ *  of a population.
+ */
+
+int setRateModulationFromEvent(event *Event)
+{
+   if (setRateModulation((int)(Event->Param[0]), Event->ParamStr, Event->Time))
+      printError("setRateModulationFromEvent", "bad definition of 'RATE_MODULATION'.\n");
+   return 1;
+}
+
+
+/**
+ *  Time-varying modulation of the external spike frequency of a 
+ *  population, without any further event to manage:
+ *
+ *     RATE_MODULATION <fT> <iP> SINUSOID <fPeriod> <fPhi> <fA>
+ *     RATE_MODULATION <fT> <iP> LINEAR <ft1> <fg1> <ft2> <fg2> ...
+ *     RATE_MODULATION <fT> <iP> TABLE <sFile> <fDt>
+ *     RATE_MODULATION <fT> <iP> NONE
+ *
+ *  After a relative time <fT> the frequency of the external spikes
+ *  delivered to the population <iP> becomes NuExt Gain(t), where
+ *  NuExt is the parameter 4 of the population and t is the time
+ *  elapsed from the start of the modulation:
+ *     SINUSOID: Gain(t) = 1 + fA sin(2 \pi t/fPeriod + fPhi);
+ *     LINEAR: Gain(t) is piecewise-linear through the nodes (ftk, fgk),
+ *             constant before the first and after the last one;
+ *     TABLE: Gain(t) is read from the file <sFile>, a value every 
+ *            <fDt> ms, and the last value is kept at the end of it;
+ *     NONE: removes the modulation.
+ *  External spikes are drawn by thinning, so that the statistics
+ *  are exact at any modulation frequency.
+ */
+
+int processRateModulationCommand(char *InputLine, double *pTime)
+{
+   float      f[2];
+   char Command[BUFFER_DIM];
+   char    Type[BUFFER_DIM];
+   int ParamNum;
+   int   Start;
+
+   Start = 0;
+   ParamNum = sscanf(InputLine, "%s %f %f %n%s", Command, &(f[0]), &(f[1]), &Start, Type);
+
+   if (strcmp(strupr(Command), "RATE_MODULATION") == 0)
+      if (ParamNum == 4 && 
+          (strcmp(strupr(Type), RMT_SINUSOID) == 0 || strcmp(Type, RMT_LINEAR) == 0 ||
+           strcmp(Type, RMT_TABLE) == 0 || strcmp(Type, RMT_NONE) == 0)) {
+         *pTime += f[0];
+         newEvent(*pTime, &setRateModulationFromEvent, &(InputLine[Start]), 1, f[1]);
+      } else {
+         printError("processRateModulationCommand", "bad parameters of 'RATE_MODULATION'.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*--------------------*
+ *  EXTERNAL_COMMAND  *
+ *--------------------*/
+
+#ifndef _WIN32
+/**
+ *  Body of the thread running the external command <Arg>,
+ *  which is freed at the end.
+ */
+
+static void *runExternalCommand(void *Arg)
+{
+   system((char *)Arg);
+   free(Arg);
+   return NULL;
+}
+#endif
+
+
+/**
+ *  The hook function called to manage an event associated to
+ *  the launch of an external command, which runs in its own
+ *  thread so that the simulation does not wait for it (the
+ *  log files are flushed before). The thread is joined by
+ *  waitExternalCommands. The event to manage is the one
+ *  passed as parameters.
+ *  The return value is 1 if the event has to be disposed from
+ *  the heap, 0 if it has to be reused.
+ */
+
+int manageExternalCommand(event *Event)
+{
+#ifndef _WIN32
+   pthread_t    Thread;
+   sigset_t    All, Old;
+   char     *ExtCommand;
+   int           Error;
+#endif
+
+   flushOutputFiles();
+
+#ifndef _WIN32
+   /*** The copy is freed by the thread, out of MemoryAmount. ***/
+   if ((ExtCommand = strdup(Event->ParamStr)) != NULL) {
+      sigfillset(&All);
+      pthread_sigmask(SIG_SETMASK, &All, &Old);
+      Error = pthread_create(&Thread, NULL, runExternalCommand, ExtCommand);
+      pthread_sigmask(SIG_SETMASK, &Old, NULL);
+      if (Error == 0) {
+         CommandThreads = (pthread_t *)resizeMemory(CommandThreads, sizeof(pthread_t) * NumCommandThreads,
+                                                    sizeof(pthread_t) * (NumCommandThreads + 1), MEMORY_OTHER,
+                                                    "ERROR (manageExternalCommand): Out of memory.");
+         CommandThreads[NumCommandThreads++] = Thread;
+         return 1;
+      }
+      free(ExtCommand);
+   }
+#endif
+   system(Event->ParamStr);
+   return 1;
+}
+
+
+/*------------------------*
+ *  waitExternalCommands  *
+ *------------------------*/
+
+/**
+ *  Waits for the end of the external commands launched by
+ *  manageExternalCommand.
+ */
+
+void waitExternalCommands ()
+{
+#ifndef _WIN32
+   int k;
+
+   for (k=0; k<NumCommandThreads; k++)
+      pthread_join(CommandThreads[k], NULL);
+   if (CommandThreads != NULL) {
+      free(CommandThreads);
+      releaseMemory(sizeof(pthread_t) * NumCommandThreads, MEMORY_OTHER);
+   }
+   CommandThreads = NULL;
+   NumCommandThreads = 0;
+#endif
+}
+
+
+/**
+ *  External command launch.
+ *
+ *     EXTERNAL_COMMAND <fT> <sCommand>
+ *
+ *  <fT> relative time when the external command <sCommand> will be 
+ *  launched. The simulation goes on while the command runs.
+ */
+
+int processExternalCommand(char *InputLine, double *pTime)
+{
+   float         f;
+   char    Command[BUFFER_DIM];
+   char ExtCommand[BUFFER_DIM];
+   int    ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %s", Command, &f, ExtCommand);
+
+   if (strcmp(strupr(Command), "EXTERNAL_COMMAND") == 0)
+      if (ParamNum == 3) {
+         *pTime += f;
+         newEvent(*pTime, &manageExternalCommand, strstr(InputLine, ExtCommand), 0);
+      } else {
+         printError("processExternalCommand", "parameters of 'EXTERNAL_COMMAND' differ from 2.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*--------------*
+ *  CHECKPOINT  *
+ *--------------*/
+
+/**
+ *  Checkpoint of the whole state of the simulation.
+ *
+ *     CHECKPOINT <fT> [<sFile>]
+ *
+ *  After a relative time <fT> the state of the simulation is
+ *  saved in the file <sFile>, or in CheckpointFile if it is
+ *  not given. A simulation started with RestartFile set to
+ *  this file continues as the saved one from that time.
+ */
+
+int processCheckpointCommand(char *InputLine, double *pTime)
+{
+   float        f;
+   char   Command[BUFFER_DIM];
+   char  FileName[BUFFER_DIM];
+   int   ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f %s", Command, &f, FileName);
+
+   if (strcmp(strupr(Command), "CHECKPOINT") == 0)
+      if (ParamNum == 2 || ParamNum == 3) {
+         *pTime += f;
+         newEvent(*pTime, &requestCheckpoint, ParamNum == 3 ? FileName : NULL, 0);
+      } else {
+         printError("processCheckpointCommand", "parameters of 'CHECKPOINT' differ from 1 or 2.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*----------*
+ *  BRANCH  *
+ *----------*/
+
+/**
+ *  Branching of the simulation in protocol variants.
+ *
+ *     BRANCH <fT> <sPrefix> <sFile> [<sPrefix> <sFile> ...]
+ *
+ *  After a relative time <fT> the simulation forks a process
+ *  for each pair <sPrefix> <sFile>, continuing from the same
+ *  state with the commands in <sFile> and writing its log
+ *  files with <sPrefix> in front of their names. The lines
+ *  following the command are read only after the branch.
+ */
+
+int processBranchCommand(char *InputLine, double *pTime)
+{
+   float        f;
+   char   Command[BUFFER_DIM];
+   char     Param[BUFFER_DIM];
+   int   ParamNum, Start, Pos, Len, n;
+
+   Start = 0;
+   ParamNum = sscanf(InputLine, "%s %f %n%s", Command, &f, &Start, Param);
+
+   if (strcmp(strupr(Command), "BRANCH") == 0) {
+      for (n=0, Pos=Start; ParamNum == 3 && sscanf(InputLine + Pos, "%s%n", Param, &Len) == 1; Pos += Len)
+         n++;
+      if (n > 0 && n % 2 == 0) {
+         *pTime += f;
+         newEvent(*pTime, &forkBranches, InputLine + Start, 0);
+         Suspended = 1;
+      } else {
+         printError("processBranchCommand", "parameters of 'BRANCH' differ from a time and pairs of prefix and command file.\n");
+         return PARSING_ERROR;
+      }
+   } else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*----------------*
+ *  PRINT_MEMORY  *
+ *----------------*/
+
+/**
+ *  The hook function writing in LogFile the memory usage of
+ *  each area (see memusage.h) at the time of the event.
+ *  The return value is 1 as the event has to be disposed
+ *  from the heap.
+ */
+
+static int outMemoryUsage(event *Event)
+{
+   char When[BUFFER_DIM];
+
+   sprintf(When, "t=%.7g", Event->Time);
+   printMemoryUsage(DocFile, When);
+
+   return 1;
+}
+
+
+/**
+ *  Report of the memory usage:
+ *
+ *     PRINT_MEMORY <fT>
+ *
+ *  After a relative time <fT> the bytes, peak bytes,
+ *  allocations and frees of each area of memory are written
+ *  in LogFile.
+ */
+
+int processPrintMemoryCommand(char *InputLine, double *pTime)
+{
+   float        f;
+   char   Command[BUFFER_DIM];
+   int   ParamNum;
+
+   ParamNum = sscanf(InputLine, "%s %f", Command, &f);
+
+   if (strcmp(strupr(Command), "PRINT_MEMORY") == 0)
+      if (ParamNum == 2) {
+         *pTime += f;
+         newEvent(*pTime, &outMemoryUsage, NULL, 0);
+      } else {
+         printError("processPrintMemoryCommand", "parameters of 'PRINT_MEMORY' differ from 1.\n");
+         return PARSING_ERROR;
+      }
+   else
+      return UNPROCESSED_COMMAND;
+
+   return PROCESSED_COMMAND;
+}
+
+
+/*-------------------------*
+ *  parseAndSubmitCommand  *
+ *-------------------------*/
+
+/**
+ *  Given an input string, parses it and recognises a
+ *  possible command to submit to the simulation creating
+ *  an associated event.
+ *  The time at which the event will be processed is
+ *  a relative time to add to the time pointed by <pTime>
+ *  which is provided from outside and will be updated by
+ *  this function.
+ *  Return 1 if a command is recognized and stored, 0 
+ *  otherwise.
+ */
+
+int parseAndSubmitCommand(char *InputLine, /* The string to process. */
+                          double *pTime)   /* A pointer to the actual time. */
+{
+   char sBuffer[BUFFER_DIM];
+   char *pDest;
+   int    rval;
+
+   /* Remove comments if any. */
+   pDest = strstr(InputLine, "#");
+   if (pDest != NULL) pDest[0] = '\0';
+
+   /* Parses and submit the command. */
+   if (sscanf(InputLine, "%s", sBuffer) == EOF) // Is it an empty line?
+      return 1;
+
+//
+// TO CUSTOMIZE (2)...
+//
+  if ((rval = processRandomStimuliCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+     if ((rval = processCorruptedStimulusCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+        if ((rval = processPrintDendriticStructureCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+           if ((rval = processStartSpikeRecordingCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+              if ((rval = processStopSpikeRecordingCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                 if ((rval = processStartStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                    if ((rval = processStopStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                       if ((rval = processSinusoidalStimulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                          if ((rval = processSetParamFromCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                             if ((rval = processSetParamCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                if ((rval = processExternalCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                   if ((rval = processPrintSynapticStructureCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                      if ((rval = processRateModulationCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                         if ((rval = processSetParamStreamCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                            if ((rval = processReplaySpikesCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                               if ((rval = processCheckpointCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                                  if ((rval = processBranchCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                                     if ((rval = processPrintMemoryCommand(InputLine, pTime)) == UNPROCESSED_COMMAND)
+                                                        rval = 0;
+
+   return rval;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*----------------*
+ *  readCommands  *
+ *----------------*/
+ 
+/**
+ *  Reads and parses a command from lines, if available,
+ *  in the command file, making correspondingly new events
+ *  which will be processed at a given time of the simulation.
+ *  If no command file is specified the stdin is assumed.
+ *  If the pointer to the simulation time passed as parameter
+ *  is NULL the static variables are initialized.
+ *  The initialization have to occurre before any other call
+ *  of the function.
+ *  Note that the command file is not close once opened, in order
+ *  to allow further command to be specified during the simulation.
+ *  After the first initialization reading, the following readings
+ *  occur each SAMPLING_PERIOD ms.
+ */
+
+void readCommands (double *SimuTime) /* A ptr to the actual simulation time. */
+{
+   char   Line[BUFFER_DIM]; /* The string cointening the line under parsing. */
+   double Time;             /* Local time to compute absolute time when the events will be managed. */
+
+   /*** Notify the first read of the command file. ***/
+#ifdef PRINT_STATUS
+   if (SimuTime == NULL)
+      fprintf(stderr, "\nReading commands... (Memory: %g Mbytes)\r", (real)MemoryAmount/1024.0/1024.0);
+#endif
+ 
+   /*** File opening. ***/
+   if (SimuTime == NULL) {
+      if (strlen(CommandsFileName)>0) {
+         if ((CommandFile = fopen(CommandsFileName, "rt")) == NULL) {
+            sprintf(Line, "Unable to open command file '%s'.", CommandsFileName);
+            printError("readCommands", Line);
+//            CommandFile = stdin;
+         }
+      } else {
+//         CommandFile = stdin;
+      }
+      Time = START_TIME_OFFSET;
+      LastTime = Time;
+      initEventManager();
+
+      /*** On restart the commands are read from the saved position. ***/
+      if (isRestarting())
+         return;
+   } else
+      /*** Is a new read required? ***/
+      if (LastTime + SAMPLING_PERIOD > *SimuTime)
+         return;
+      else {
+         LastTime = Time = *SimuTime;
+
+         /*** Serves the control socket, if any, at the same pace. ***/
+         serveControl(Time);
+      }
+
+   if (CommandFile == NULL) return;
+
+   /*** Parsing of the commands: one per line, up to a BRANCH. ***/
+   while (!Suspended && fgets(Line, BUFFER_DIM, CommandFile) != NULL) {
+      parseAndSubmitCommand(Line, &Time);
+      LineNum++;      
+   }
+
+   /*** Notify the first read of the command file. ***/
+#ifdef PRINT_STATUS
+   if (SimuTime == NULL)
+      fprintf(stderr, "Reading commands... (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
+
+#endif
+}
+
+
+/*------------------*
+ *  resumeCommands  *
+ *------------------*/
+
+/**
+ *  Resumes the reading of the commands stopped by a BRANCH
+ *  command, whose times are relative to the branching time
+ *  <Time>. The commands are read from <FileName> if it is
+ *  not NULL, otherwise from the lines of the command file
+ *  following the BRANCH command.
+ */
+
+void resumeCommands (char *FileName, /* New command file, or NULL. */
+                     double    Time) /* Time of the branch. */
+{
+   char Line[BUFFER_DIM];
+
+#ifndef _WIN32
+   /*** The external commands of the parent process are not waited. ***/
+   if (CommandThreads != NULL) {
+      free(CommandThreads);
+      releaseMemory(sizeof(pthread_t) * NumCommandThreads, MEMORY_OTHER);
+   }
+   CommandThreads = NULL;
+   NumCommandThreads = 0;
+#endif
+
+   /*** The old file is left open, since its offset is shared with the parent process. ***/
+   if (FileName != NULL) {
+      if ((CommandFile = fopen(FileName, "rt")) == NULL) {
+         sprintf(Line, "Unable to open command file '%.*s'.", BUFFER_DIM - 32, FileName);
+         printError("resumeCommands", Line);
+      }
+      CommandsFileName = getMemory(strlen(FileName) + 1, "ERROR (resumeCommands): Out of memory.");
+      strcpy(CommandsFileName, FileName);
+      LineNum = 0;
+   }
+   Suspended = 0;
+   LastTime = Time;
+
+   if (CommandFile == NULL) return;
+
+   while (!Suspended && fgets(Line, BUFFER_DIM, CommandFile) != NULL) {
+      parseAndSubmitCommand(Line, &Time);
+      LineNum++;
+   }
+}
+
+
+/*-----------------*
+ *  closeCommands  *
+ *-----------------*/
+
+/**
+ *  Closes the command file, so that a new simulation can
+ *  read its own commands from the start, once the external
+ *  commands launched are ended.
+ */
+
+void closeCommands ()
+{
+   waitExternalCommands();
+   if (CommandFile != NULL)
+      fclose(CommandFile);
+   CommandFile = NULL;
+   LineNum = 0;
+   Suspended = 0;
+}
+
+
+/*----------------------*
+ *  checkpointCommands  *
+ *----------------------*/
+
+/**
+ *  Hook functions of the events, in the order used to save
+ *  them in a checkpoint.
+ */
+
+static event_func EventHandlers[] = {
+   outDenStruct, outSynStruct, startSpikeRecording, stopSpikeRecording,
+   startStimulation, stopStimulation, setPopulationParamFromEvent,
+   setConnectivityParamFromEvent, manageParamStream, manageSinusoidalStimulation,
+   setRateModulationFromEvent, manageExternalCommand, sampleRates,
+   sampleSynTrans, sampleCurrent, requestCheckpoint, forkBranches, outMemoryUsage
+};
+
+#define NUM_EVENT_HANDLERS (int)(sizeof(EventHandlers) / sizeof(event_func))
+
+
+/**
+ *  Writes on <File> the position reached in the command file,
+ *  whether it waits for a branch, and the pending events.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointCommands(FILE *File)
+{
+   long Position = CommandFile != NULL ? ftell(CommandFile) : -1;
+
+   return writeCheckpointData(File, &Position, sizeof(Position)) ||
+          writeCheckpointData(File, &LineNum, sizeof(LineNum)) ||
+          writeCheckpointData(File, &LastTime, sizeof(LastTime)) ||
+          writeCheckpointData(File, &Suspended, sizeof(Suspended)) ||
+          checkpointEvents(File, EventHandlers, NUM_EVENT_HANDLERS);
+}
+
+
+/*-------------------*
+ *  restoreCommands  *
+ *-------------------*/
+
+/**
+ *  Reads from <File> the position in the command file and
+ *  the pending events written by checkpointCommands.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int restoreCommands(FILE *File)
+{
+   long Position;
+
+   if (readCheckpointData(File, &Position, sizeof(Position)) ||
+       readCheckpointData(File, &LineNum, sizeof(LineNum)) ||
+       readCheckpointData(File, &LastTime, sizeof(LastTime)) ||
+       readCheckpointData(File, &Suspended, sizeof(Suspended)))
+      return 1;
+   if (Position >= 0 && (CommandFile == NULL || fseek(CommandFile, Position, SEEK_SET) != 0))
+      return 1;
+
+   return restoreEvents(File, EventHandlers, NUM_EVENT_HANDLERS);
+}
+
+
+
+#undef NUM_EVENT_HANDLERS
+#undef SAMPLING_PERIOD
+#undef BUFFER_DIM
+#undef UNPROCESSED_COMMAND
+#undef PARSING_ERROR
+#undef PROCESSED_COMMAND
@@ -1,50 +1,106 @@
-/*
- *
- *   commands.h
- *
- *     Library of commands recognised by the simulation,
- *   submitted as events to manage at a given time. Functions
- *   implements the commands and thei parsing from an input 
- *   file.
- *
- *   Project: Perseo 2.1.x
- *
- */
-
-
-
-#ifndef __COMMANDS_H__
-#define __COMMANDS_H__
-
-
-
-/*----------------------*
- *  GLOBAL DEFINITIONS  *
- *----------------------*/
-
-extern char *CommandsFileName; /* File name containing the commands to submit to the simulation ("protocol.ini"). */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/**
- *  Reads and parses a command from lines, if available,
- *  in the command file, making correspondingly new events
- *  which will be processed at a given time of the simulation.
- *  If no command file is specified the stdin is assumed.
- *  If the pointer to the simulation time passed as parameter
- *  is NULL the static variables are initialized.
- *  The initialization have to occurre before any other call
- *  of the function.
- *  Note that the command file is not close once opened, in order
- *  to allow further command to be specified during the simulation.
- */
-
-void readCommands (double *SimuTime); /* A ptr to the actual simulation time. */
-
-
-
-#endif /* __COMMANDS_H__ */
+/*
+ *
+ *   commands.h
+ *
+ *     Library of commands recognised by the simulation,
+ *   submitted as events to manage at a given time. Functions
+ *   implements the commands and thei parsing from an input 
+ *   file.
+ *
+ *   Project: Perseo 2.1.x
+ *
+ */
+
+
+
+#ifndef __COMMANDS_H__
+#define __COMMANDS_H__
+
+
+
+#include <stdio.h>
+
+#include "types.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+extern PERSEO_LOCAL char *CommandsFileName; /* File name containing the commands to submit to the simulation ("protocol.ini"). */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Reads and parses a command from lines, if available,
+ *  in the command file, making correspondingly new events
+ *  which will be processed at a given time of the simulation.
+ *  If no command file is specified the stdin is assumed.
+ *  If the pointer to the simulation time passed as parameter
+ *  is NULL the static variables are initialized.
+ *  The initialization have to occurre before any other call
+ *  of the function.
+ *  Note that the command file is not close once opened, in order
+ *  to allow further command to be specified during the simulation.
+ */
+
+void readCommands (double *SimuTime); /* A ptr to the actual simulation time. */
+
+
+/**
+ *  Parses the command in <InputLine> and submits the events
+ *  implementing it, at times relative to the one pointed by
+ *  <pTime>, which is updated. Returns 1 if the command is
+ *  recognized and stored, 0 otherwise.
+ */
+
+int parseAndSubmitCommand(char *InputLine, /* The string to process. */
+                          double *pTime);  /* A pointer to the actual time. */
+
+
+/**
+ *  Resumes the reading of the commands stopped by a BRANCH
+ *  command, whose times are relative to the branching time
+ *  <Time>. The commands are read from <FileName> if it is
+ *  not NULL (in a forked branch), otherwise from the lines
+ *  of the command file following the BRANCH command.
+ */
+
+void resumeCommands (char *FileName, /* New command file, or NULL. */
+                     double    Time); /* Time of the branch. */
+
+
+/**
+ *  Closes the command file, so that a new simulation can
+ *  read its own commands from the start, once the external
+ *  commands launched are ended.
+ */
+
+void closeCommands ();
+
+
+/**
+ *  Waits for the end of the external commands launched by
+ *  the EXTERNAL_COMMAND events, each one in its own thread.
+ */
+
+void waitExternalCommands ();
+
+
+/**
+ *  Writes on <File> the position reached in the command file
+ *  and the pending events, and reads them back.
+ *  Returns 1 on error, 0 otherwise (see checkpoint.h).
+ */
+
+int checkpointCommands(FILE *File);
+int restoreCommands(FILE *File);
+
+
+
+#endif /* __COMMANDS_H__ */
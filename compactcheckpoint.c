@@ -0,0 +1,223 @@
+/*
+ *
+ *   compactcheckpoint.c
+ *
+ *   Compacts a chain of incremental checkpoints written by
+ *   Perseo (see checkpoint.h) in a single full checkpoint,
+ *   from which a simulation can restart without the other
+ *   files of the chain.
+ *
+ *      compactcheckpoint <in_file_name> <out_file_name>
+ *
+ *   <in_file_name> is the last checkpoint of the chain, whose
+ *   parents are opened with the names saved in it. The
+ *   synapses are merged block by block, reading each file of
+ *   the chain only once.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "checkpoint.h"
+
+
+
+#define BUFFER_DIM              256 /* Maximum length of a file name. */
+#define MAX_CHAIN_LENGTH       1024 /* Maximum number of files in a chain. */
+#define COPY_BUFFER_SIZE      65536 /* Size of the buffer copying the sections. */
+
+
+/**
+ *  A checkpoint of the chain, positioned at the next changed
+ *  block of its incremental section.
+ */
+
+typedef struct {
+   FILE      *File; /* The checkpoint file. */
+   long  NumBlocks; /* Changed blocks still to read. */
+   long       Next; /* Index of the next changed block, -1 if none. */
+} chain_link;
+
+
+/**
+ *  Reads the index of the next changed block of <l>.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int nextBlock (chain_link *l)
+{
+   if (l->NumBlocks == 0) {
+      l->Next = -1;
+      return 0;
+   }
+   l->NumBlocks--;
+
+   return fread(&(l->Next), sizeof(long), 1, l->File) != 1 || l->Next < 0;
+}
+
+
+/**
+ *  Reads from <File> a block of synapses, preceded by its
+ *  size, in <*Buffer> grown up to <*BufferSize> bytes.
+ *  Returns the size of the block, or -1 on error.
+ */
+
+static long readBlock (FILE *File, char **Buffer, size_t *BufferSize)
+{
+   size_t Size;
+
+   if (fread(&Size, sizeof(Size), 1, File) != 1)
+      return -1;
+   if (Size > *BufferSize) {
+      if ((*Buffer = realloc(*Buffer, Size)) == NULL)
+         return -1;
+      *BufferSize = Size;
+   }
+   if (Size > 0 && fread(*Buffer, 1, Size, File) != Size)
+      return -1;
+
+   return (long)Size;
+}
+
+
+/**
+ *  Reads the header of the checkpoint <File>, positioning it
+ *  at the beginning of the synapses. Returns 1 on error, 0
+ *  otherwise.
+ */
+
+static int readHeader (FILE *File, checkpoint_header *h)
+{
+   return fread(h, sizeof(*h), 1, File) != 1 ||
+          strncmp(h->Magic, CHECKPOINT_MAGIC, 4) != 0 || h->Version != CHECKPOINT_VERSION ||
+          fseek(File, h->PayloadOffset, SEEK_SET) != 0;
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   static chain_link Chain[MAX_CHAIN_LENGTH];
+   checkpoint_header h, Top;
+   FILE   *Base, *In, *Out;
+   char   Name[BUFFER_DIM];
+   char   Tag[4];
+   char  *Buffer = NULL;
+   size_t BufferSize = 0;
+   double ParentTime;
+   long   b, NumBlocks, Size;
+   int    k, n, Length;
+
+   if (ArgC != 3) {
+      fprintf(stderr, "Usage: %s <in_file_name> <out_file_name>\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+   if (strcmp(ArgV[1], ArgV[2]) == 0) {
+      fprintf(stderr, "ERROR (compactcheckpoint): the output file has to differ from the input one.\n");
+      return EXIT_FAILURE;
+   }
+
+   /*** Opens the chain up to the full checkpoint. ***/
+   if ((In = fopen(ArgV[1], "rb")) == NULL || readHeader(In, &Top)) {
+      fprintf(stderr, "ERROR (compactcheckpoint): '%s' is not a checkpoint.\n", ArgV[1]);
+      return EXIT_FAILURE;
+   }
+   strcpy(Name, "");
+   for (Base=In, n=0; ; n++) {
+      if (fread(Tag, 4, 1, Base) != 1)
+         break;
+      if (strncmp(Tag, "SYNP", 4) == 0)
+         break;
+      Chain[n].File = Base;
+      if (strncmp(Tag, "SYND", 4) != 0 || n == MAX_CHAIN_LENGTH ||
+          fread(&Length, sizeof(Length), 1, Base) != 1 || Length <= 0 || Length > BUFFER_DIM ||
+          fread(Name, 1, Length, Base) != (size_t)Length || Name[Length-1] != '\0' ||
+          fread(&ParentTime, sizeof(ParentTime), 1, Base) != 1 ||
+          fread(&(Chain[n].NumBlocks), sizeof(long), 1, Base) != 1 || nextBlock(&Chain[n])) {
+         fprintf(stderr, "ERROR (compactcheckpoint): '%s' is corrupted.\n", n == 0 ? ArgV[1] : Name);
+         return EXIT_FAILURE;
+      }
+      if ((Base = fopen(Name, "rb")) == NULL || readHeader(Base, &h) || h.Time != ParentTime ||
+          h.NumNeurons != Top.NumNeurons || h.DelayNumber != Top.DelayNumber) {
+         fprintf(stderr, "ERROR (compactcheckpoint): the parent checkpoint '%s' is missing or changed.\n", Name);
+         return EXIT_FAILURE;
+      }
+   }
+   if (strncmp(Tag, "SYNP", 4) != 0) {
+      fprintf(stderr, "ERROR (compactcheckpoint): '%s' is corrupted.\n", n == 0 ? ArgV[1] : Name);
+      return EXIT_FAILURE;
+   }
+
+   /*** The sections preceding the synapses, with a full header. ***/
+   if ((Out = fopen(ArgV[2], "wb")) == NULL) {
+      fprintf(stderr, "ERROR (compactcheckpoint): unable to open '%s'.\n", ArgV[2]);
+      return EXIT_FAILURE;
+   }
+   h = Top;
+   h.ChainLength = 0;
+   Buffer = malloc(COPY_BUFFER_SIZE);
+   BufferSize = COPY_BUFFER_SIZE;
+   In = fopen(ArgV[1], "rb");
+   fwrite(&h, sizeof(h), 1, Out);
+   fseek(In, sizeof(h), SEEK_SET);
+   for (Size = Top.PayloadOffset - sizeof(h); Size > 0; Size -= COPY_BUFFER_SIZE) {
+      Length = Size < COPY_BUFFER_SIZE ? (int)Size : COPY_BUFFER_SIZE;
+      if (fread(Buffer, 1, Length, In) != (size_t)Length)
+         break;
+      fwrite(Buffer, 1, Length, Out);
+   }
+   fclose(In);
+
+   /*** The synapses, from the newest file changing each block. ***/
+   fwrite("SYNP", 4, 1, Out);
+   NumBlocks = (long)Top.DelayNumber * Top.NumNeurons;
+   for (b=0; b<NumBlocks; b++) {
+      Size = readBlock(Base, &Buffer, &BufferSize);
+      for (k=n-1; k>=0 && Size >= 0; k--)
+         if (Chain[k].Next == b)
+            if ((Size = readBlock(Chain[k].File, &Buffer, &BufferSize)) >= 0 && nextBlock(&Chain[k]))
+               Size = -1;
+      if (Size < 0)
+         break;
+      fwrite(&Size, sizeof(size_t), 1, Out);
+      fwrite(Buffer, 1, Size, Out);
+   }
+   for (k=0; k<n; k++)
+      if (Chain[k].Next >= 0)
+         b = -1;
+   if (b != NumBlocks) {
+      fprintf(stderr, "ERROR (compactcheckpoint): the synapses of the chain are corrupted.\n");
+      remove(ArgV[2]);
+      return EXIT_FAILURE;
+   }
+
+   /*** The sections following the synapses. ***/
+   In = n > 0 ? Chain[0].File : Base;
+   while ((Size = (long)fread(Buffer, 1, BufferSize, In)) > 0)
+      fwrite(Buffer, 1, Size, Out);
+
+   if (fclose(Out) != 0) {
+      fprintf(stderr, "ERROR (compactcheckpoint): unable to write '%s'.\n", ArgV[2]);
+      remove(ArgV[2]);
+      return EXIT_FAILURE;
+   }
+   for (k=0; k<n; k++)
+      fclose(Chain[k].File);
+   fclose(Base);
+   free(Buffer);
+   fprintf(stderr, "%d files compacted in '%s' at time %.7g ms.\n", n + 1, ArgV[2], Top.Time);
+
+   return 0;
+}
+
+
+
+#undef COPY_BUFFER_SIZE
+#undef MAX_CHAIN_LENGTH
+#undef BUFFER_DIM
@@ -1,741 +1,1142 @@
-/*
- *
- *   connectivity.c
- *
- *   Library of structures and functions to manage 
- *   the connectivity of the network: the populations
- *   of synapses at mean-field level.
- *
- *   Project    PERSEO 2.0
- *
- */
-
-
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <memory.h>
-#include <limits.h>
-#include <math.h>
-#include <string.h>
-
-#include "invar.h"
-#include "nalib.h"
-#include "randdev.h"
-
-#include "types.h"
-#include "perseo.h"
-#include "modules.h"
-#include "connectivity.h"
-#include "delays.h"
-#include "synapses.h"
-
-
-
-/*---------------------*
- *  LOCAL DEFINITIONS  *
- *---------------------*/
-
-#define STRING_SIZE         256 /* Max length of local strings. */
-#define BASIC_REAL_PARAMETERS 5 /* Number of real parameters fixed per population definition. */
-/* #define BUFFER_SIZE          16 /* Size of the buffer for variable arrays. */ 
-#define BUFFER_SIZE       32768 /* 2^15 Size of the buffer for variable arrays. */ 
-#define MAX_DISTANCE        255 /* Max distance between two consecutive post-synaptic neurons *
-                                 * for compression purpose.                                   */
-
-
-/*----------------------*
- *   GLOBAL VARIABLES   *
- *----------------------*/
-
-synaptic_layer  *SynapticMatrix = NULL; /* Synaptic matrix decomposed in layers. */
-
-connectivity    ***Connectivity = NULL; /* Matrix of the synaptic populations defining the network architecture 
-                                           (matrix of pointers to connectivity structure). */
-connectivity *ConnectivityArray = NULL; /* Each non NULL entry is the structure of an existing synaptic populations. */
-int        NumConnectivityArray = 0;    /* Number of connectivity structures loaded in ConnectivityArray. */
-real        *ConnectivityParams = NULL; /* A whole array of the variable parameters for the Connectivity. */
-int       NumConnectivityParams = 0;    /* Number of reals loaded in ConnectivityParams. */
-
-char      *ConnectivityFileName = EMPTY_STRING; /* File name containing the definition of the connectivity ("connectivity.ini"). */
-char    *SynapticExtractionType = EMPTY_STRING; /* Type of synaptic random extraction 'RANDOM', 'FIXEDNUM', ... */
-
-
-
-/*-----------------------*
- *  FUNCTION DEFINITION  *
- *-----------------------*/
-
-
-/** 
- *  Returns the number of absent synapses between to consecutive
- *  synapses on the axon. 
- */
-
-indexn (*getEmptySynapses)(int postPop, int prePop);
-
-
-
-/*------------------------------*
- *  loadConnectivityDefinition  *
- *------------------------------*/
-
-/**
- *  Adds an element to the <Connectivity> matrix, and fills the fields of
- *  the structure <connectivity>.
- */
-
-int loadConnectivityDefinition(int NumRealParams, IVreal *RealParams, 
-                               int NumStringParams, char **StringParams)
-{
-   static int ConnectivityParamsSize = 0;
-   static int  ConnectivityArraySize = 0;
-   real         *newCP;
-   connectivity *newCA;
-   int     SynapseType = -1;
-
-   int i, pre, post;
-
-   if (Connectivity == NULL) {
-
-      /*** Allocate memory for the connectivity matrix. ***/
-      Connectivity = (connectivity ***)getMemory(sizeof(connectivity**) * NumPopulations, 
-                               "ERROR (loadConnectivityDefinition): Out of memory.");
-      for (post=0; post<NumPopulations; post++)
-         Connectivity[post] = (connectivity **)getMemory(sizeof(connectivity*) * NumPopulations, 
-                                        "ERROR (loadConnectivityDefinition): Out of memory.");
-
-      /*** Initialize the connectivity matrix. ***/
-      for (post=0; post<NumPopulations; post++)
-         for (pre=0; pre<NumPopulations; pre++) 
-            Connectivity[post][pre] = NULL;
-   }
-
-   /*** Synapse parameters parsing. ***/
-   if (NumStringParams >= 1) {
-      SynapseType = getSynapseType(StringParams[0]);
-      if (SynapseType >= 0)
-      {
-         if (parseSynapseParams(SynapseType, NumRealParams - BASIC_REAL_PARAMETERS, &RealParams[BASIC_REAL_PARAMETERS])) {
-            printError("loadConnectivityDefinition", "Uncorrect synapse parameters.\n");
-            return 1;
-         }
-      } else {
-         printError("loadConnectivityDefinition", "Unknown synapse type.\n");
-         return 1;
-      }
-   } else {
-      printError("loadConnectivityDefinition", "Synapse type unspecified.\n");
-      return 1;
-   }
-
-   /*** Allocate memory for synapse parameters. ***/
-   NumConnectivityParams += NumRealParams - BASIC_REAL_PARAMETERS;
-   if (NumConnectivityParams > ConnectivityParamsSize) { // More memory is needed?
-      ConnectivityParamsSize += BUFFER_SIZE;
-      if (ConnectivityParamsSize == BUFFER_SIZE)
-          ConnectivityParams = (real *)getMemory(sizeof(real) * ConnectivityParamsSize, "ERROR (loadConnectivityDefinition): Out of memory.");
-      else {
-         newCP = (real *)realloc(ConnectivityParams, sizeof(real) * ConnectivityParamsSize);
-         for (i=0; i<NumConnectivityArray; i++)
-            ConnectivityArray[i].Parameters = (ConnectivityArray[i].Parameters - ConnectivityParams) + newCP;
-         ConnectivityParams = newCP;
-         MemoryAmount += sizeof(real) * BUFFER_SIZE;
-         if (ConnectivityParams == NULL)
-            printFatalError("loadConnectivityDefinition", "Out of memory.");
-      }
-   }
-
-   /*** Allocate memory for the connectivity structure. ***/
-   NumConnectivityArray++; 
-   if (NumConnectivityArray > ConnectivityArraySize) { // More memory is needed?
-      ConnectivityArraySize += BUFFER_SIZE;
-      if (ConnectivityParamsSize == BUFFER_SIZE)
-         ConnectivityArray = (connectivity *)getMemory(sizeof(connectivity) * ConnectivityArraySize, "ERROR (loadConnectivityDefinition): Out of memory.");
-      else {
-         newCA = (connectivity *)realloc(ConnectivityArray, sizeof(connectivity) * ConnectivityArraySize);
-         for (post=0; post<NumPopulations; post++)
-            for (pre=0; pre<NumPopulations; pre++) 
-               if (Connectivity[post][pre] != NULL)
-                  Connectivity[post][pre] = (Connectivity[post][pre] - ConnectivityArray) + newCA;
-         ConnectivityArray = newCA;
-         MemoryAmount += sizeof(connectivity) * BUFFER_SIZE;
-         if (ConnectivityArray == NULL)
-            printFatalError("loadConnectivityDefinition", "Out of memory.");
-      }
-   }
-
-   /*** Defines the connectivity element. ***/
-   post = (int) (RealParams[0]);
-   pre = (int) (RealParams[1]);
-   if (post < 0 || post >= NumPopulations ||
-      pre < 0 || pre >= NumPopulations) {
-      printError("loadConnectivityDefinition", "Element of the connectivity matrix out of range.\n");
-      return 1;
-   }
-   Connectivity[post][pre] = &(ConnectivityArray[NumConnectivityArray-1]);
-   Connectivity[post][pre]->CProb = (real)RealParams[2];
-   Connectivity[post][pre]->DMin = (real)RealParams[3];
-   Connectivity[post][pre]->DMax = (real)RealParams[4];
-   Connectivity[post][pre]->SynapseType = SynapseType;
-   Connectivity[post][pre]->Parameters = &(ConnectivityParams[NumConnectivityParams - NumRealParams + BASIC_REAL_PARAMETERS]);
-   Connectivity[post][pre]->ID = NumConnectivityArray - 1;
-   for (i=0; i < NumRealParams - BASIC_REAL_PARAMETERS; i++)
-      Connectivity[post][pre]->Parameters[i] = (real) RealParams[BASIC_REAL_PARAMETERS + i];
-   Connectivity[post][pre]->NumParameters = NumRealParams - BASIC_REAL_PARAMETERS;
-
-   /*** Sets synapses fields like pointer to functions and the size of the synapse. ***/
-   setConnectivitySynapseFields(Connectivity[post][pre]);
-
-   /*** Look up tables for synaptic efficacies. ***/
-   Connectivity[post][pre]->JTab = NULL;
-   if (setSynapticEffaciesLUT(Connectivity[post][pre]))
-      printFatalError("loadConnectivityDefinition", "Out of memory.");
-   
-   return 0;
-}
-
-
-/*------------------------*
- *  getEmptySynapses_RAN  *
- *------------------------*/
-
-/**
- *  Return the number plus one of non-existent (empty) synapses
- *  between two consecutive post-synaptic neurons, following 
- *  a Bernoulli distribution with probability p.
- */
-
-indexn getEmptySynapses_RAN  (int postPop, int prePop)
-{
-   static indexn n;
-   static real  r, P, C;
-
-   /*** Frees the memory allocated for local structures, it's a needed fake block of code. ***/
-   if (postPop < 0 && prePop < 0 )
-      return 0;
-
-   if (Connectivity[postPop][prePop]->CProb <= 0.0)
-       n = INT_MAX;
-   else {
-      r = Random();
-      P = Connectivity[postPop][prePop]->CProb;
-      C = P;
-      n = 1;
-      while (C < r) {
-         n++;
-         P *= 1 - Connectivity[postPop][prePop]->CProb;
-         C += P;
-      }
-      if (n<=0) {
-         n = INT_MAX;
-      }
-   }
-
-   return n;
-}
-
-
-/*------------------------*
- *  getEmptySynapses_FIX  *
- *------------------------*/
-
-/**
- *  Return the number plus one of non-existent (empty) synapses
- *  between two consecutive post-synaptic neurons, in order to
- *  provide a fixed number of synapses given by the product of
- *  the connectivity and the number of neurons in the pre-
- *  synaptic population.
- *  NOTE: if the parameters are both negatives, the local
- *  memory structure are freed.
- */
-
-indexn getEmptySynapses_FIX (int postPop, int prePop)
-{
-   static indexn n, m, s, k, SynNum;
-   static int lastPost, lastPre, npre;
-   static indexn MaxDendSize = 0;
-   static int p, q;                  /* Cursor to scan populations. */
-   static double r, dx, offset;
-   static int prePopMask = -1;
-   static int postPopMask = -1;
-   static indexn **SynMatMask = NULL; /* A mask of pre-synaptic addresses. Zero element have to 
-                                       * be negelcted. Note that for computational convenience
-                                       * the rows refer to presynaptic elements and the 
-                                       * columns the postsynaptic neurons. */
-   static double *SynExtraction = NULL; /* Support array in which are collected the poissonian
-                                         * extractions which set the post-synaptic neurons with
-                                         * a synaptic contact. */
-   static indexn *PopOffset = NULL; /* The index of the first neuron in a module. */
-   static indexn *PreSynCursor = NULL; /* The index of the last element visited in a given column
-                                        * of the SynMatMask. */
-   static unsigned int SupportMemoryAmount = 0; /* The amount of memory used in local  
-                                                 * structures located in the heap. */
-
-   /***                                                               ***/
-   /*** Frees the memory allocated for local structures, is required. ***/
-   /***                                                               ***/
-   if (postPop < 0 && prePop < 0 )
-   {
-      if (SynMatMask != NULL)
-      {
-         free(PopOffset);
-         free(SynExtraction);
-         free(PreSynCursor);
-         for (n=0; n<MaxDendSize; n++)
-            free(SynMatMask[n]);
-         free(SynMatMask);
-
-         /*** Prints the status of the SynapticMatrix creation. ***/
-         MemoryAmount -= SupportMemoryAmount;
-#ifdef PRINT_STATUS
-         fprintf(stderr, "Initializing Synaptic Matrix... 100.0%% (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
-#endif
-      }
-
-      return 0;
-   }
-
-
-   /***                                ***/
-   /*** Has the mask to be recomputed? ***/
-   /***                                ***/
-   if (prePop != prePopMask)
-   {
-      prePopMask = prePop;
-
-      /*** Makes room, if needed for the synaptic matrix mask. ***/
-      if (SynMatMask == NULL)
-      {
-         SupportMemoryAmount = MemoryAmount;
-
-         /*** Allocates and set the offset neurons of the populations. ***/
-#ifdef PRINT_DEBUG
-         fprintf(stderr, "\na. Allocates memory for offset neurons of the population...");
-#endif
-         PopOffset = (indexn *)getMemory(sizeof(indexn) * NumPopulations, 
-                               "ERROR (getEmptySynapses_FIX): Out of memory (5).\n");
-
-         /*** Finds the size of the largest dendritic tree branch connecting ***
-          *** one population to a post-synaptic neuron.                      ***/
-         for (p=0; p<NumPopulations; p++)
-         {
-            PopOffset[p] = p == 0 ? 0 : PopOffset[p-1] + Populations[p-1].N;
-            for (q=0; q<NumPopulations; q++)
-               if (Connectivity[p][q] != NULL)
-               {
-                  SynNum = roundr2i(Populations[q].N * Connectivity[p][q]->CProb);
-                  if (MaxDendSize < SynNum)
-                     MaxDendSize = SynNum;
-               }
-         }
-
-         /*** Allocates memory for the synaptic matrix mask. ***/
-#ifdef PRINT_DEBUG
-         fprintf(stderr, "\nb. Allocates memory for the synaptic matrix mask...");
-#endif
-
-         SynMatMask = (indexn **)getMemory(sizeof(indexn *) * MaxDendSize, 
-                                "ERROR (getEmptySynapses_FIX): Out of memory (1).\n");
-         for (n=0; n<MaxDendSize; n++)
-            SynMatMask[n] = (indexn *)getMemory(sizeof(indexn) * NumNeurons, 
-                                      "ERROR (getEmptySynapses_FIX): Out of memory (2).\n");
-
-         /*** Allocates memory for the synaptic extraction support array. ***/
-         SynExtraction = (double *)getMemory(sizeof(double) * (MaxDendSize + 1), 
-                                "ERROR (getEmptySynapses_FIX): Out of memory (3).\n");
-
-         /*** Allocates and cursor for pre-synaptic neurons. ***/
-         PreSynCursor = (indexn *)getMemory(sizeof(indexn) * NumNeurons, 
-                               "ERROR (getEmptySynapses_FIX): Out of memory (4).\n");
-
-         SupportMemoryAmount = MemoryAmount - SupportMemoryAmount;
-
-#ifdef PRINT_STATUS
-         fprintf(stderr, "\nSupporting memory for fixed connectivity... %g Mbytes\n", (real)SupportMemoryAmount/1024.0/1024.0);
-#endif
-      }
-
-      /***                                                                     ***/
-      /*** Initializes with all zeros the synaptic matrix mask and the cursor. ***/
-      /***                                                                     ***/
-      for (n=0; n<MaxDendSize; n++)
-         memset(SynMatMask[n], 0xFF, sizeof(indexn) * NumNeurons);
-      memset(PreSynCursor, 0, sizeof(indexn) * NumNeurons);
-
-      /***                                     ***/
-      /*** Populates the synaptic matrix mask. ***/
-      /***                                     ***/
-#ifdef PRINT_DEBUG
-         fprintf(stderr, "\nc. Populates the synaptic matrix mask...");
-#endif
-      for (n=0, p=0; p<NumPopulations; p++)
-         if (Connectivity[p][prePop] == NULL)
-            n += Populations[p].N;
-         else
-         {
-            SynNum = roundr2i(Populations[prePop].N * Connectivity[p][prePop]->CProb);
-
-            /*** Is the subnetwork fully connected? ***/
-            if (SynNum == Populations[prePop].N)
-            {
-               for (m=0; m<Populations[p].N; m++, n++)
-               {
-                  for (s=0; s<SynNum; s++)
-                     SynMatMask[s][n] = s;
-               }
-
-            /*** ... sparse connectivity. ***/
-            } else if (SynNum > 0) {            // It can be 0 even if Connectivity is not NULL
-               for (m=0; m<Populations[p].N; m++, n++)
-               {
-                  for (s=0, r=0.0; s<SynNum; s++)
-                  {
-                     r += ExpDev();
-                     SynExtraction[s] = r;
-                  }
-                  dx = SynExtraction[SynNum-1] / (Populations[prePop].N - SynNum);
-                  offset = -Random() * (SynExtraction[SynNum-1] + SynNum*dx);
-                  for (s=0, k=0; s<SynNum; s++)
-                  {
-                     npre = (int)floor(s+(offset+SynExtraction[s])/dx);
-                     if (npre >= 0)
-                        SynMatMask[k++][n] = npre;
-                  }
-                  for (s=0; k<SynNum; k++, s++)
-                  {
-                     npre = Populations[prePop].N + (int)floor(s+(offset+SynExtraction[s])/dx);
-                     SynMatMask[k][n] = npre;
-                  }
-               }
-            }
-         }
-
-      lastPre = 0;
-   } else
-      if (lastPost == NumNeurons || postPop < postPopMask)
-      {
-         lastPre++;
-         lastPost = -1;
-      }
-
-   /*** Has the post-synaptic population changed? ***/
-   if (postPop != postPopMask)
-   {
-      postPopMask = postPop;
-      lastPost = PopOffset[postPop] - 1;
-   }
-
-   /*** Return the empty synapses plus one read from the synaptic matrix mask. ***/
-   p = lastPost;
-   for (lastPost++; (indexn)lastPost<PopOffset[postPop]+Populations[postPop].N; lastPost++)
-      if (PreSynCursor[lastPost]<MaxDendSize)
-         if (SynMatMask[PreSynCursor[lastPost]][lastPost] == lastPre) 
-         {
-            PreSynCursor[lastPost] = PreSynCursor[lastPost] + 1;
-            break;
-         }
-
-   return (indexn)(lastPost - p);
-}
-
-
-/*------------------------*
- *  createSynapticMatrix  *
- *------------------------*/
-
-/**
- *  Functions called after the connectivity definition. 
- *  It allocates the layered structure of the synaptic matrix.
- */
-
-void createSynapticMatrix ()
-{
-   int           l;       /* Index for the layer array. */
-   indexn        i, j, D; 
-   int   prePop, postPop;
-   int              Post; /* A cursor to identify the existent synapses. */
-   connectivity       *c; /* A cursor for the connectivity matrix. */
-   axon_segment *Support; /* Support structure hosting a maximally populated *
-                           * axon.                                           */
-   indexn *NumExceptions; /* An array of number of exceptions per layer. */
-   indexn      *LastPost; /* Index array of the last post-synaptic neuron *
-                           * extracted per layer.                         */
-   int      *SynapseSize; /* Array of the size in byte of the memory segments   *
-                           * that will host the synapses of the SynapticMatrix. */
-   unsigned int SupportMemoryAmount; /* Local variable to compute the memory allocated. */
-
-#ifdef PRINT_STATUS
-   real    Status = 0.0; /* Processing status cursor. */
-   real IncStatus = 0.1; /* Visible increment of the cursor. */
-#endif
-
-   /*** Allocates memory for the layers. ***/
-#ifdef PRINT_DEBUG
-   fprintf(stderr, "\na. Allocates memory for delay layers...");
-#endif
-   SynapticMatrix = (synaptic_layer *)getMemory(sizeof(synaptic_layer)*DelayNumber, "ERROR (createSynapticMatrix): Out of memory (1).");
-
-   /*** Initializes the layers and allocates memory for ***
-    *** pre-synaptic neuron axon segment.               ***/
-#ifdef PRINT_DEBUG
-   fprintf(stderr, "\nb. Allocates memory for pre-synaptic axon segments...");
-#endif
-   for (l=0; l<DelayNumber; l++) {
-      initQueue(&(SynapticMatrix[l].Queue), sizeof(spike));
-      SynapticMatrix[l].Empty = true;
-      SynapticMatrix[l].Delay = DelayMin + DelayStep * l;
-      SynapticMatrix[l].Pre = (axon_segment *)getMemory(sizeof(axon_segment)*NumNeurons, "ERROR (createSynapticMatrix): Out of memory (2).");
-      for (j=0; j<NumNeurons; j++) {
-         SynapticMatrix[l].Pre[j].DPost = NULL;
-         SynapticMatrix[l].Pre[j].Exception = NULL;
-         SynapticMatrix[l].Pre[j].Synapses = NULL;
-         SynapticMatrix[l].Pre[j].NumSynapses = 0;
-      }
-   }
-
-   /*** Allocates memory for the support structures. ***/
-#ifdef PRINT_DEBUG
-   fprintf(stderr, "\nc. Allocates memory for support structures...");
-#endif
-   SupportMemoryAmount = MemoryAmount;
-   Support = (axon_segment *)getMemory(sizeof(axon_segment)*DelayNumber, "ERROR (createSynapticMatrix): Out of memory (3).\n");
-   NumExceptions = (indexn *)getMemory(sizeof(indexn)*DelayNumber, "ERROR (createSynapticMatrix): Out of memory (3).\n");
-   LastPost = (indexn *)getMemory(sizeof(indexn)*DelayNumber, "ERROR (createSynapticMatrix): Out of memory (3).\n");
-   SynapseSize = (int *)getMemory(sizeof(int)*DelayNumber, "ERROR (createSynapticMatrix): Out of memory (3).\n");
-   for (l=0; l<DelayNumber; l++) {
-       Support[l].DPost = (byte *)getMemory(sizeof(byte)*NumNeurons, "ERROR (createSynapticMatrix): Out of memory (4).");
-       Support[l].Exception = (indexn *)getMemory(sizeof(indexn)*NumNeurons, "ERROR (createSynapticMatrix): Out of memory (4).");
-   }
-   SupportMemoryAmount = MemoryAmount  - SupportMemoryAmount;
-#ifdef PRINT_STATUS
-   fprintf(stderr, "\nSupporting memory... %g Mbytes", (real)SupportMemoryAmount/1024.0/1024.0);
-#endif
-
-
-   /*** Loop on the presynapic neurons. ***/
-#ifdef PRINT_STATUS
-   fprintf(stderr, "\nInitializing Synaptic Matrix... \r");
-//   fflush(stderr);
-#endif
-
-   for (j=0; j<NumNeurons; j++) {
-      prePop = Neurons[j].Pop->ID;
-
-      /*** Initializes the support structure. ***/
-      for (l=0; l<DelayNumber; l++) {
-         Support[l].NumSynapses = 0;
-         NumExceptions[l] = 0;
-         LastPost[l] = -1;
-         SynapseSize[l] = 0;
-      }
-
-      /*** Loop on the existing connectivity elements population by population. ***/
-      for (i=postPop=0; postPop<NumPopulations; i+=Populations[postPop].N, postPop++) {
-
-         if (Connectivity[postPop][prePop] != NULL) {
-
-            c = Connectivity[postPop][prePop];
-            Post = i - 1;
-
-            /*** Loop on the post-synaptic neurons connected to the pre-synaptic j. ***/
-            while ((Post += (*getEmptySynapses)(postPop, prePop)) < (int)(i + Populations[postPop].N))
-            {
-               /*** May happens when empty synapses is too large, related to low connectivity... ***/
-               if (Post < 0)
-                  break;
-
-               /*** No self-coupling is allowed. ***/
-//              if (Post != j) {
-                  l = (*getRandomDelay)(c);
-                  D = Post - LastPost[l];
-                  if (D > MAX_DISTANCE) {
-                     D = EXCEPTION;
-                     Support[l].Exception[NumExceptions[l]++] = Post;
-                  }
-                  Support[l].DPost[Support[l].NumSynapses++] = D;
-                  SynapseSize[l] += c->SynapseSize;
-                  LastPost[l] = Post;
-//               }
-            }
-         }
-      }
-
-      /*** Copies the support structure to the SynapticMatrix. ***/
-      for (l=0; l<DelayNumber; l++) {
-
-         /*** Allocates memory for the j-th axon. ***/
-         SynapticMatrix[l].Pre[j].DPost = (byte *)getMemory(sizeof(byte)*Support[l].NumSynapses, "ERROR (createSynapticMatrix): Out of memory (5).");
-         SynapticMatrix[l].Pre[j].Exception = (indexn *)getMemory(sizeof(indexn)*NumExceptions[l], "ERROR (createSynapticMatrix): Out of memory (5).");
-         SynapticMatrix[l].Pre[j].Synapses = getMemory(SynapseSize[l], "ERROR (createSynapticMatrix): Out of memory (5).");
-
-         /*** Initializes fields and copies the contents. ***/
-         SynapticMatrix[l].Pre[j].NumSynapses = Support[l].NumSynapses;
-         memcpy(SynapticMatrix[l].Pre[j].DPost, Support[l].DPost, sizeof(byte)*Support[l].NumSynapses);
-         memcpy(SynapticMatrix[l].Pre[j].Exception, Support[l].Exception, sizeof(indexn)*NumExceptions[l]);
-      }
-
-      /*** Prints the status of the SynapticMatrix creation. ***/
-#ifdef PRINT_STATUS
-     if ((100.0*j)/NumNeurons > Status + IncStatus) {
-        Status = (int)((100.0*j)/NumNeurons / IncStatus) * IncStatus;
-        fprintf(stderr, "Initializing Synaptic Matrix... %5.1f%% (Memory: %g Mbytes)    \r", Status, (real)MemoryAmount/1024.0/1024.0);
-     }
-#endif
-
-      /*** Did an interrupt signal occur? ***/
-      if (QuitSimulation) break;
-   }
-
-   /*** Frees the memory occupied by the support structures. ***/
-   (*getEmptySynapses)(-1, -1);
-   for (l=0; l<DelayNumber; l++) {
-      free(Support[l].DPost);
-      free(Support[l].Exception);
-   }
-   free(Support);
-   free(NumExceptions);
-   free(LastPost);
-   free(SynapseSize);
-   MemoryAmount -= SupportMemoryAmount;
-
-   /*** Prints the status of the SynapticMatrix creation. ***/
-#ifdef PRINT_STATUS
-        fprintf(stderr, "Initializing Synaptic Matrix... 100.0%% (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
-#endif
-}
-
-
-/*----------------------*
- *  scanSynapticMatrix  *
- *----------------------*/
-
-/**
- *  Visits a portion of the synaptic matrix defined by an 
- *  interval of post-synaptic neurons [PostStart,PostEnd] 
- *  and an interval of pre-synaptic neurons [PreStart,PreEnd].
- *  For each synapse met a user-defined hook function 
- *  (InspectFunc) is called. The synapse are visited in 
- *  ascending order of pre-synaptic neuron, transmission 
- *  delay and post-synaptic neuron.
- */
-
-void scanSynapticMatrix (indexn           PostStart, 
-                         indexn             PostEnd, 
-                         indexn            PreStart, 
-                         indexn              PreEnd,
-                         InspectFuncPtr InspectFunc)
-{
-   int        l, n;
-   indexn  i, j, k;
-   byte         *s;
-   connectivity *c;
-
-   /*** Scans the presynaptic neurons. ***/
-   for (j=PreStart; j<=PreEnd; j++)
-
-      /*** Scans the layer of transmission delay. ***/
-      for (l=0; l<DelayNumber; l++) {
-         i = -1; 
-         s = (byte *)(SynapticMatrix[l].Pre[j].Synapses);
-         n = 0;
-
-         /*** Scans the axon segment. ***/
-         for (k=0; k<SynapticMatrix[l].Pre[j].NumSynapses; k++) {
-            if (SynapticMatrix[l].Pre[j].DPost[k] != EXCEPTION)
-               i += SynapticMatrix[l].Pre[j].DPost[k];
-            else
-               i = SynapticMatrix[l].Pre[j].Exception[n++];
-
-            c = Connectivity[Neurons[i].Pop->ID][Neurons[j].Pop->ID];
-
-            if (i >= PostStart)
-               if (i <= PostEnd)
-                  (*InspectFunc)(i, j, (void *)s, c, l);
-               else
-                  break;
-
-            s += c->SynapseSize;
-         }
-      }
-}
-
-
-
-/*------------------------*
- *  setConnectivityParam  *
- *------------------------*/
-
-/**
- *  Updates online the global parameter of a synaptic population,
- *  like the JumpUp or JumpDown of the hidden synaptic variable.
- *
- *  WARNING: Only parameters n. 13 and 14 are managed (JumpUp and 
- *  JumpDown) or the ones from 5 to 8 (the synaptic efficacies and
- *  their relative standard deviations).
- */
-
-void setConnectivityParam(int          Post, /* Post-synaptic population. */
-                          int           Pre, /* Post-synaptic population. */
-                          int      ParamNum, /* Number of parameter to change. */
-                          double ParamValue, /* New value to assign to the parameter. */
-                          double       Time) /* Time when the update occur. */
-{
-   static connectivity *c;
-
-   if (Post >= 0 && Post < NumPopulations &&
-       Pre >= 0 && Pre < NumPopulations)
-
- /* TEMP: Such a solution is not the final one. In general the synaptic module will be *
-  *       the one capable to update the synaptic parameter whose meaning depends on    *
-  *       the synapse type.                                                            */
-      if ((c = Connectivity[Post][Pre]) != NULL)
-         if (c->NumParameters > ParamNum-BASIC_REAL_PARAMETERS)
-            if (ParamNum == 13 || ParamNum == 14) // JumpUp or JumpDown
-            { 
-               c->Parameters[ParamNum-BASIC_REAL_PARAMETERS] = ParamValue;
-            } else {
-                if (ParamNum >= 5 && ParamNum <= 8) // J* or DJ*
-                {
-                    c->Parameters[ParamNum-BASIC_REAL_PARAMETERS] = ParamValue;
-                    setSynapticEffaciesLUT(c);
-                }
-            }
-}
-
-
-/*-----------------------------*
- *  setSynapticExtractionType  *
- *-----------------------------*/
-
-/**
- *  Sets the function pointers dependent on the
- *  type of synaptic extraction choosen.
- */
-
-int setSynapticExtractionType()
-{
-   if (strcmp(strupr(SynapticExtractionType), SET_RAN) == 0)
-   {
-      getEmptySynapses = &getEmptySynapses_RAN;
-      return 0;
-   }
-   if (strcmp(strupr(SynapticExtractionType), SET_FIX) == 0)
-   {
-      getEmptySynapses = &getEmptySynapses_FIX;
-      return 0;
-   }
-   if (strcmp(strupr(SynapticExtractionType), EMPTY_STRING) == 0)
-   {
-      getEmptySynapses = &getEmptySynapses_RAN;
-      return 0;
-   }
-   
-   return 1;
-}
-
-
-#undef MAX_DISTANCE
-#undef BUFFER_SIZE
-#undef BASIC_REAL_PARAMETERS
-#undef STRING_SIZE
+/*
+ *
+ *   connectivity.c
+ *
+ *   Library of structures and functions to manage 
+ *   the connectivity of the network: the populations
+ *   of synapses at mean-field level.
+ *
+ *   Project    PERSEO 2.0
+ *
+ */
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include "invar.h"
+#include "nalib.h"
+#include "randdev.h"
+
+#include "types.h"
+#include "perseo.h"
+#include "modules.h"
+#include "connectivity.h"
+#include "delays.h"
+#include "synapses.h"
+#include "checkpoint.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define STRING_SIZE         256 /* Max length of local strings. */
+#define BASIC_REAL_PARAMETERS 5 /* Number of real parameters fixed per population definition. */
+/* #define BUFFER_SIZE          16 /* Size of the buffer for variable arrays. */ 
+#define BUFFER_SIZE       32768 /* 2^15 Size of the buffer for variable arrays. */ 
+#define isDirtyAxon(j) (DirtyAxons[(j) >> 3] & (1 << ((j) & 7))) /* See markDirtyAxon. */
+
+
+/*----------------------*
+ *   GLOBAL VARIABLES   *
+ *----------------------*/
+
+PERSEO_LOCAL synaptic_layer  *SynapticMatrix = NULL; /* Synaptic matrix decomposed in layers. */
+PERSEO_LOCAL byte                *DirtyAxons = NULL; /* Bitmap of the pre-synaptic neurons whose synapses changed since the last checkpoint. */
+
+PERSEO_LOCAL connectivity    ***Connectivity = NULL; /* Matrix of the synaptic populations defining the network architecture 
+                                                        (matrix of pointers to connectivity structure). */
+PERSEO_LOCAL connectivity *ConnectivityArray = NULL; /* Each non NULL entry is the structure of an existing synaptic populations. */
+PERSEO_LOCAL int        NumConnectivityArray = 0;    /* Number of connectivity structures loaded in ConnectivityArray. */
+PERSEO_LOCAL real        *ConnectivityParams = NULL; /* A whole array of the variable parameters for the Connectivity. */
+PERSEO_LOCAL int       NumConnectivityParams = 0;    /* Number of reals loaded in ConnectivityParams. */
+
+PERSEO_LOCAL char      *ConnectivityFileName = EMPTY_STRING; /* File name containing the definition of the connectivity ("connectivity.ini"). */
+PERSEO_LOCAL char    *SynapticExtractionType = EMPTY_STRING; /* Type of synaptic random extraction 'RANDOM', 'FIXEDNUM', ... */
+PERSEO_LOCAL rand_stream  ConnectivityStream;        /* Random stream of the synaptic contacts of the current neuron. */
+
+
+
+/*---------------------*
+ *   LOCAL VARIABLES   *
+ *---------------------*/
+
+static PERSEO_LOCAL int ConnectivityParamsSize = 0; /* Number of reals allocated in ConnectivityParams. */
+static PERSEO_LOCAL int  ConnectivityArraySize = 0; /* Number of structures allocated in ConnectivityArray. */
+
+
+
+/*-----------------------*
+ *  FUNCTION DEFINITION  *
+ *-----------------------*/
+
+
+/** 
+ *  Returns the number of absent synapses between to consecutive
+ *  synapses on the axon. 
+ */
+
+PERSEO_LOCAL indexn (*getEmptySynapses)(int postPop, int prePop);
+
+
+
+/*------------------------------*
+ *  loadConnectivityDefinition  *
+ *------------------------------*/
+
+/**
+ *  Adds an element to the <Connectivity> matrix, and fills the fields of
+ *  the structure <connectivity>.
+ */
+
+int loadConnectivityDefinition(int NumRealParams, IVreal *RealParams, 
+                               int NumStringParams, char **StringParams)
+{
+   real         *newCP;
+   connectivity *newCA;
+   int     SynapseType = -1;
+
+   int i, pre, post;
+
+   if (Connectivity == NULL) {
+
+      /*** Allocate memory for the connectivity matrix. ***/
+      Connectivity = (connectivity ***)getAreaMemory(sizeof(connectivity**) * NumPopulations, MEMORY_POPULATIONS,
+                               "ERROR (loadConnectivityDefinition): Out of memory.");
+      for (post=0; post<NumPopulations; post++)
+         Connectivity[post] = (connectivity **)getAreaMemory(sizeof(connectivity*) * NumPopulations, MEMORY_POPULATIONS,
+                                        "ERROR (loadConnectivityDefinition): Out of memory.");
+
+      /*** Initialize the connectivity matrix. ***/
+      for (post=0; post<NumPopulations; post++)
+         for (pre=0; pre<NumPopulations; pre++) 
+            Connectivity[post][pre] = NULL;
+   }
+
+   /*** Synapse parameters parsing. ***/
+   if (NumStringParams >= 1) {
+      SynapseType = getSynapseType(StringParams[0]);
+      if (SynapseType >= 0)
+      {
+         if (parseSynapseParams(SynapseType, NumRealParams - BASIC_REAL_PARAMETERS, &RealParams[BASIC_REAL_PARAMETERS])) {
+            printError("loadConnectivityDefinition", "Uncorrect synapse parameters.\n");
+            return 1;
+         }
+      } else {
+         printError("loadConnectivityDefinition", "Unknown synapse type.\n");
+         return 1;
+      }
+   } else {
+      printError("loadConnectivityDefinition", "Synapse type unspecified.\n");
+      return 1;
+   }
+
+   /*** Allocate memory for synapse parameters. ***/
+   NumConnectivityParams += NumRealParams - BASIC_REAL_PARAMETERS;
+   if (NumConnectivityParams > ConnectivityParamsSize) { // More memory is needed?
+      ConnectivityParamsSize += BUFFER_SIZE;
+      if (ConnectivityParamsSize == BUFFER_SIZE)
+          ConnectivityParams = (real *)getAreaMemory(sizeof(real) * ConnectivityParamsSize, MEMORY_POPULATIONS,
+                                                     "ERROR (loadConnectivityDefinition): Out of memory.");
+      else {
+         newCP = (real *)resizeMemory(ConnectivityParams, sizeof(real) * (ConnectivityParamsSize - BUFFER_SIZE),
+                                      sizeof(real) * ConnectivityParamsSize, MEMORY_POPULATIONS,
+                                      "ERROR (loadConnectivityDefinition): Out of memory.");
+         for (i=0; i<NumConnectivityArray; i++)
+            ConnectivityArray[i].Parameters = (ConnectivityArray[i].Parameters - ConnectivityParams) + newCP;
+         ConnectivityParams = newCP;
+      }
+   }
+
+   /*** Allocate memory for the connectivity structure. ***/
+   NumConnectivityArray++; 
+   if (NumConnectivityArray > ConnectivityArraySize) { // More memory is needed?
+      ConnectivityArraySize += BUFFER_SIZE;
+      if (ConnectivityArraySize == BUFFER_SIZE)
+         ConnectivityArray = (connectivity *)getAreaMemory(sizeof(connectivity) * ConnectivityArraySize, MEMORY_POPULATIONS,
+                                                           "ERROR (loadConnectivityDefinition): Out of memory.");
+      else {
+         newCA = (connectivity *)resizeMemory(ConnectivityArray, sizeof(connectivity) * (ConnectivityArraySize - BUFFER_SIZE),
+                                              sizeof(connectivity) * ConnectivityArraySize, MEMORY_POPULATIONS,
+                                              "ERROR (loadConnectivityDefinition): Out of memory.");
+         for (post=0; post<NumPopulations; post++)
+            for (pre=0; pre<NumPopulations; pre++) 
+               if (Connectivity[post][pre] != NULL)
+                  Connectivity[post][pre] = (Connectivity[post][pre] - ConnectivityArray) + newCA;
+         ConnectivityArray = newCA;
+      }
+   }
+
+   /*** Defines the connectivity element. ***/
+   post = (int) (RealParams[0]);
+   pre = (int) (RealParams[1]);
+   if (post < 0 || post >= NumPopulations ||
+      pre < 0 || pre >= NumPopulations) {
+      printError("loadConnectivityDefinition", "Element of the connectivity matrix out of range.\n");
+      return 1;
+   }
+   Connectivity[post][pre] = &(ConnectivityArray[NumConnectivityArray-1]);
+   Connectivity[post][pre]->CProb = (real)RealParams[2];
+   Connectivity[post][pre]->DMin = (real)RealParams[3];
+   Connectivity[post][pre]->DMax = (real)RealParams[4];
+   Connectivity[post][pre]->SynapseType = SynapseType;
+   Connectivity[post][pre]->Parameters = &(ConnectivityParams[NumConnectivityParams - NumRealParams + BASIC_REAL_PARAMETERS]);
+   Connectivity[post][pre]->ID = NumConnectivityArray - 1;
+   for (i=0; i < NumRealParams - BASIC_REAL_PARAMETERS; i++)
+      Connectivity[post][pre]->Parameters[i] = (real) RealParams[BASIC_REAL_PARAMETERS + i];
+   Connectivity[post][pre]->NumParameters = NumRealParams - BASIC_REAL_PARAMETERS;
+
+   /*** Sets synapses fields like pointer to functions and the size of the synapse. ***/
+   setConnectivitySynapseFields(Connectivity[post][pre]);
+
+   /*** Look up tables for synaptic efficacies. ***/
+   Connectivity[post][pre]->JTab = NULL;
+   if (setSynapticEffaciesLUT(Connectivity[post][pre]))
+      printFatalError("loadConnectivityDefinition", "Out of memory.");
+   
+   return 0;
+}
+
+
+/*------------------------*
+ *  getEmptySynapses_RAN  *
+ *------------------------*/
+
+/**
+ *  Return the number plus one of non-existent (empty) synapses
+ *  between two consecutive post-synaptic neurons, following 
+ *  a Bernoulli distribution with probability p. INDEXN_MAX,
+ *  beyond any population, is returned when no synapse follows.
+ */
+
+indexn getEmptySynapses_RAN  (int postPop, int prePop)
+{
+   indexn n;
+   real  r, P, C;
+
+   /*** Frees the memory allocated for local structures, it's a needed fake block of code. ***/
+   if (postPop < 0 && prePop < 0 )
+      return 0;
+
+   if (Connectivity[postPop][prePop]->CProb <= 0.0)
+       n = INDEXN_MAX;
+   else {
+      r = StreamRandom(&ConnectivityStream);
+      P = Connectivity[postPop][prePop]->CProb;
+      C = P;
+      n = 1;
+      while (C < r) {
+         n++;
+         P *= 1 - Connectivity[postPop][prePop]->CProb;
+         C += P;
+      }
+      if (n<=0) {
+         n = INDEXN_MAX;
+      }
+   }
+
+   return n;
+}
+
+
+/*------------------------*
+ *  getEmptySynapses_FIX  *
+ *------------------------*/
+
+/**
+ *  Return the number plus one of non-existent (empty) synapses
+ *  between two consecutive post-synaptic neurons, in order to
+ *  provide a fixed number of synapses given by the product of
+ *  the connectivity and the number of neurons in the pre-
+ *  synaptic population.
+ *  NOTE: if the parameters are both negatives, the local
+ *  memory structure are freed.
+ */
+
+indexn getEmptySynapses_FIX (int postPop, int prePop)
+{
+   static PERSEO_LOCAL indexn n, m, s, k, SynNum;
+   static PERSEO_LOCAL indexn lastPost, lastPre, firstPost;
+   static PERSEO_LOCAL int64_t npre;
+   static PERSEO_LOCAL indexn MaxDendSize = 0;
+   static PERSEO_LOCAL int p, q;                  /* Cursor to scan populations. */
+   static PERSEO_LOCAL double r, dx, offset;
+   static PERSEO_LOCAL int prePopMask = -1;
+   static PERSEO_LOCAL int postPopMask = -1;
+   static PERSEO_LOCAL indexn **SynMatMask = NULL; /* A mask of pre-synaptic addresses. Zero element have to 
+                                                    * be negelcted. Note that for computational convenience
+                                                    * the rows refer to presynaptic elements and the 
+                                                    * columns the postsynaptic neurons. */
+   static PERSEO_LOCAL double *SynExtraction = NULL; /* Support array in which are collected the poissonian
+                                                      * extractions which set the post-synaptic neurons with
+                                                      * a synaptic contact. */
+   static PERSEO_LOCAL indexn *PopOffset = NULL; /* The index of the first neuron in a module. */
+   static PERSEO_LOCAL indexn *PreSynCursor = NULL; /* The index of the last element visited in a given column
+                                                     * of the SynMatMask. */
+   static PERSEO_LOCAL uint64_t SupportMemoryAmount = 0; /* The amount of memory used in local  
+                                                          * structures located in the heap. */
+
+   /***                                                               ***/
+   /*** Frees the memory allocated for local structures, is required. ***/
+   /***                                                               ***/
+   if (postPop < 0 && prePop < 0 )
+   {
+      if (SynMatMask != NULL)
+      {
+         free(PopOffset);
+         releaseMemory(sizeof(indexn) * NumPopulations, MEMORY_BUILD);
+         free(SynExtraction);
+         releaseMemory(sizeof(double) * (MaxDendSize + 1), MEMORY_BUILD);
+         free(PreSynCursor);
+         releaseMemory(sizeof(indexn) * NumNeurons, MEMORY_BUILD);
+         for (n=0; n<MaxDendSize; n++) {
+            free(SynMatMask[n]);
+            releaseMemory(sizeof(indexn) * NumNeurons, MEMORY_BUILD);
+         }
+         free(SynMatMask);
+         releaseMemory(sizeof(indexn *) * MaxDendSize, MEMORY_BUILD);
+
+         /*** The mask is built again by the next matrix. ***/
+         SynMatMask = NULL;
+         MaxDendSize = 0;
+         prePopMask = postPopMask = -1;
+
+         /*** Prints the status of the SynapticMatrix creation. ***/
+#ifdef PRINT_STATUS
+         fprintf(stderr, "Initializing Synaptic Matrix... 100.0%% (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
+#endif
+      }
+
+      return 0;
+   }
+
+
+   /***                                ***/
+   /*** Has the mask to be recomputed? ***/
+   /***                                ***/
+   if (prePop != prePopMask)
+   {
+      prePopMask = prePop;
+
+      /*** Makes room, if needed for the synaptic matrix mask. ***/
+      if (SynMatMask == NULL)
+      {
+         SupportMemoryAmount = MemoryAmount;
+
+         /*** Allocates and set the offset neurons of the populations. ***/
+#ifdef PRINT_DEBUG
+         fprintf(stderr, "\na. Allocates memory for offset neurons of the population...");
+#endif
+         PopOffset = (indexn *)getAreaMemory(sizeof(indexn) * NumPopulations, MEMORY_BUILD,
+                               "ERROR (getEmptySynapses_FIX): Out of memory (5).\n");
+
+         /*** Finds the size of the largest dendritic tree branch connecting ***
+          *** one population to a post-synaptic neuron.                      ***/
+         for (p=0; p<NumPopulations; p++)
+         {
+            PopOffset[p] = p == 0 ? 0 : PopOffset[p-1] + Populations[p-1].N;
+            for (q=0; q<NumPopulations; q++)
+               if (Connectivity[p][q] != NULL)
+               {
+                  SynNum = roundr2i(Populations[q].N * Connectivity[p][q]->CProb);
+                  if (MaxDendSize < SynNum)
+                     MaxDendSize = SynNum;
+               }
+         }
+
+         /*** Allocates memory for the synaptic matrix mask. ***/
+#ifdef PRINT_DEBUG
+         fprintf(stderr, "\nb. Allocates memory for the synaptic matrix mask...");
+#endif
+
+         SynMatMask = (indexn **)getAreaMemory(sizeof(indexn *) * MaxDendSize, MEMORY_BUILD,
+                                "ERROR (getEmptySynapses_FIX): Out of memory (1).\n");
+         for (n=0; n<MaxDendSize; n++)
+            SynMatMask[n] = (indexn *)getAreaMemory(sizeof(indexn) * NumNeurons, MEMORY_BUILD,
+                                      "ERROR (getEmptySynapses_FIX): Out of memory (2).\n");
+
+         /*** Allocates memory for the synaptic extraction support array. ***/
+         SynExtraction = (double *)getAreaMemory(sizeof(double) * (MaxDendSize + 1), MEMORY_BUILD,
+                                "ERROR (getEmptySynapses_FIX): Out of memory (3).\n");
+
+         /*** Allocates and cursor for pre-synaptic neurons. ***/
+         PreSynCursor = (indexn *)getAreaMemory(sizeof(indexn) * NumNeurons, MEMORY_BUILD,
+                               "ERROR (getEmptySynapses_FIX): Out of memory (4).\n");
+
+         SupportMemoryAmount = MemoryAmount - SupportMemoryAmount;
+
+#ifdef PRINT_STATUS
+         fprintf(stderr, "\nSupporting memory for fixed connectivity... %g Mbytes\n", (real)SupportMemoryAmount/1024.0/1024.0);
+#endif
+      }
+
+      /***                                                                     ***/
+      /*** Initializes with all zeros the synaptic matrix mask and the cursor. ***/
+      /***                                                                     ***/
+      for (n=0; n<MaxDendSize; n++)
+         memset(SynMatMask[n], 0xFF, sizeof(indexn) * NumNeurons);
+      memset(PreSynCursor, 0, sizeof(indexn) * NumNeurons);
+
+      /***                                     ***/
+      /*** Populates the synaptic matrix mask. ***/
+      /***                                     ***/
+#ifdef PRINT_DEBUG
+         fprintf(stderr, "\nc. Populates the synaptic matrix mask...");
+#endif
+      for (n=0, p=0; p<NumPopulations; p++)
+         if (Connectivity[p][prePop] == NULL)
+            n += Populations[p].N;
+         else
+         {
+            SynNum = roundr2i(Populations[prePop].N * Connectivity[p][prePop]->CProb);
+
+            /*** Is the subnetwork fully connected? ***/
+            if (SynNum == Populations[prePop].N)
+            {
+               for (m=0; m<Populations[p].N; m++, n++)
+               {
+                  for (s=0; s<SynNum; s++)
+                     SynMatMask[s][n] = s;
+               }
+
+            /*** ... sparse connectivity. ***/
+            } else if (SynNum > 0) {            // It can be 0 even if Connectivity is not NULL
+               for (m=0; m<Populations[p].N; m++, n++)
+               {
+                  InitRandomStream(&ConnectivityStream, SynapsesSeed, RS_CONNECTIVITY, (uint64_t)prePop * NumNeurons + n);
+                  for (s=0, r=0.0; s<SynNum; s++)
+                  {
+                     r += StreamExpDev(&ConnectivityStream);
+                     SynExtraction[s] = r;
+                  }
+                  dx = SynExtraction[SynNum-1] / (Populations[prePop].N - SynNum);
+                  offset = -StreamRandom(&ConnectivityStream) * (SynExtraction[SynNum-1] + SynNum*dx);
+                  for (s=0, k=0; s<SynNum; s++)
+                  {
+                     npre = (int64_t)floor(s+(offset+SynExtraction[s])/dx);
+                     if (npre >= 0)
+                        SynMatMask[k++][n] = npre;
+                  }
+                  for (s=0; k<SynNum; k++, s++)
+                  {
+                     npre = (int64_t)Populations[prePop].N + (int64_t)floor(s+(offset+SynExtraction[s])/dx);
+                     SynMatMask[k][n] = npre;
+                  }
+               }
+            }
+         }
+
+      lastPre = 0;
+   } else
+      if (lastPost == NumNeurons || postPop < postPopMask)
+      {
+         lastPre++;
+         lastPost = -1;
+      }
+
+   /*** Has the post-synaptic population changed? ***/
+   if (postPop != postPopMask)
+   {
+      postPopMask = postPop;
+      lastPost = PopOffset[postPop] - 1;
+   }
+
+   /*** Return the empty synapses plus one read from the synaptic matrix mask. ***/
+   firstPost = lastPost;
+   for (lastPost++; lastPost<PopOffset[postPop]+Populations[postPop].N; lastPost++)
+      if (PreSynCursor[lastPost]<MaxDendSize)
+         if (SynMatMask[PreSynCursor[lastPost]][lastPost] == lastPre) 
+         {
+            PreSynCursor[lastPost] = PreSynCursor[lastPost] + 1;
+            break;
+         }
+
+   return lastPost - firstPost;
+}
+
+
+/*------------------------*
+ *  createSynapticMatrix  *
+ *------------------------*/
+
+/**
+ *  Functions called after the connectivity definition. 
+ *  It allocates the layered structure of the synaptic matrix.
+ */
+
+void createSynapticMatrix ()
+{
+   int           l;       /* Index for the layer array. */
+   indexn        i, j, D; 
+   int   prePop, postPop;
+   indexn           Post; /* A cursor to identify the existent synapses. */
+   indexn          Empty; /* Empty synapses plus one before the next one. */
+   connectivity       *c; /* A cursor for the connectivity matrix. */
+   axon_segment *Support; /* Support structure hosting a maximally populated *
+                           * axon.                                           */
+   indexn *NumExceptions; /* An array of number of exceptions per layer. */
+   indexn      *LastPost; /* Index array of the last post-synaptic neuron *
+                           * extracted per layer.                         */
+   int      *SynapseSize; /* Array of the size in byte of the memory segments   *
+                           * that will host the synapses of the SynapticMatrix. */
+   uint64_t SupportMemoryAmount; /* Local variable to compute the memory allocated. */
+
+#ifdef PRINT_STATUS
+   real    Status = 0.0; /* Processing status cursor. */
+   real IncStatus = 0.1; /* Visible increment of the cursor. */
+#endif
+
+   /*** Allocates memory for the layers. ***/
+#ifdef PRINT_DEBUG
+   fprintf(stderr, "\na. Allocates memory for delay layers...");
+#endif
+   SynapticMatrix = (synaptic_layer *)getAreaMemory(sizeof(synaptic_layer)*DelayNumber, MEMORY_INDICES, "ERROR (createSynapticMatrix): Out of memory (1).");
+
+   /*** Initializes the layers and allocates memory for ***
+    *** pre-synaptic neuron axon segment.               ***/
+#ifdef PRINT_DEBUG
+   fprintf(stderr, "\nb. Allocates memory for pre-synaptic axon segments...");
+#endif
+   for (l=0; l<DelayNumber; l++) {
+      initQueue(&(SynapticMatrix[l].Queue), sizeof(spike));
+      SynapticMatrix[l].Empty = true;
+      SynapticMatrix[l].Delay = DelayMin + DelayStep * l;
+      SynapticMatrix[l].Pre = (axon_segment *)getAreaMemory(sizeof(axon_segment)*NumNeurons, MEMORY_INDICES, "ERROR (createSynapticMatrix): Out of memory (2).");
+      for (j=0; j<NumNeurons; j++) {
+         SynapticMatrix[l].Pre[j].DPost = NULL;
+         SynapticMatrix[l].Pre[j].Exception = NULL;
+         SynapticMatrix[l].Pre[j].Synapses = NULL;
+         SynapticMatrix[l].Pre[j].NumSynapses = 0;
+      }
+   }
+   DirtyAxons = (byte *)getAreaMemory(sizeof(byte)*(NumNeurons/8 + 1), MEMORY_INDICES, "ERROR (createSynapticMatrix): Out of memory (1).");
+   clearDirtyAxons();
+
+   /*** Allocates memory for the support structures. ***/
+#ifdef PRINT_DEBUG
+   fprintf(stderr, "\nc. Allocates memory for support structures...");
+#endif
+   SupportMemoryAmount = MemoryAmount;
+   Support = (axon_segment *)getAreaMemory(sizeof(axon_segment)*DelayNumber, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (3).\n");
+   NumExceptions = (indexn *)getAreaMemory(sizeof(indexn)*DelayNumber, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (3).\n");
+   LastPost = (indexn *)getAreaMemory(sizeof(indexn)*DelayNumber, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (3).\n");
+   SynapseSize = (int *)getAreaMemory(sizeof(int)*DelayNumber, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (3).\n");
+   for (l=0; l<DelayNumber; l++) {
+       Support[l].DPost = (byte *)getAreaMemory(sizeof(byte)*NumNeurons, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (4).");
+       Support[l].Exception = (indexn *)getAreaMemory(sizeof(indexn)*NumNeurons, MEMORY_BUILD, "ERROR (createSynapticMatrix): Out of memory (4).");
+   }
+   SupportMemoryAmount = MemoryAmount  - SupportMemoryAmount;
+#ifdef PRINT_STATUS
+   fprintf(stderr, "\nSupporting memory... %g Mbytes", (real)SupportMemoryAmount/1024.0/1024.0);
+#endif
+
+
+   /*** Loop on the presynapic neurons. ***/
+#ifdef PRINT_STATUS
+   fprintf(stderr, "\nInitializing Synaptic Matrix... \r");
+//   fflush(stderr);
+#endif
+
+   for (j=0; j<NumNeurons; j++) {
+      prePop = Neurons[j].Pop->ID;
+
+      /*** Streams of the synaptic contacts and of the delays of the axon of j. ***/
+      InitRandomStream(&ConnectivityStream, SynapsesSeed, RS_CONNECTIVITY, (uint64_t)j);
+      InitRandomStream(&DelayStream, SynapsesSeed, RS_DELAYS, (uint64_t)j);
+
+      /*** Initializes the support structure. ***/
+      for (l=0; l<DelayNumber; l++) {
+         Support[l].NumSynapses = 0;
+         NumExceptions[l] = 0;
+         LastPost[l] = -1;
+         SynapseSize[l] = 0;
+      }
+
+      /*** Loop on the existing connectivity elements population by population. ***/
+      for (i=postPop=0; postPop<NumPopulations; i+=Populations[postPop].N, postPop++) {
+
+         if (Connectivity[postPop][prePop] != NULL) {
+
+            c = Connectivity[postPop][prePop];
+            Post = i - 1;
+
+            /*** Loop on the post-synaptic neurons connected to the pre-synaptic j: ***
+             *** the empty synapses are compared with the neurons left, so that   ***
+             *** a large jump (low connectivity) cannot wrap the cursor around.   ***/
+            while ((Empty = (*getEmptySynapses)(postPop, prePop)) < i + Populations[postPop].N - Post)
+            {
+               Post += Empty;
+
+               /*** No self-coupling is allowed. ***/
+//              if (Post != j) {
+                  l = (*getRandomDelay)(c);
+                  D = Post - LastPost[l];
+                  if (D > MAX_DISTANCE) {
+                     D = EXCEPTION;
+                     Support[l].Exception[NumExceptions[l]++] = Post;
+                  }
+                  Support[l].DPost[Support[l].NumSynapses++] = D;
+                  SynapseSize[l] += c->SynapseSize;
+                  LastPost[l] = Post;
+//               }
+            }
+         }
+      }
+
+      /*** Copies the support structure to the SynapticMatrix. ***/
+      for (l=0; l<DelayNumber; l++) {
+
+         /*** Allocates memory for the j-th axon. ***/
+         SynapticMatrix[l].Pre[j].DPost = (byte *)getAreaMemory(sizeof(byte)*Support[l].NumSynapses, MEMORY_INDICES, "ERROR (createSynapticMatrix): Out of memory (5).");
+         SynapticMatrix[l].Pre[j].Exception = (indexn *)getAreaMemory(sizeof(indexn)*NumExceptions[l], MEMORY_INDICES, "ERROR (createSynapticMatrix): Out of memory (5).");
+         SynapticMatrix[l].Pre[j].Synapses = getAreaMemory(SynapseSize[l], MEMORY_SYNAPSES, "ERROR (createSynapticMatrix): Out of memory (5).");
+
+         /*** Initializes fields and copies the contents: the synapses ***
+          *** are cleared, as checkpointSynapses needs their padding.   ***/
+         memset(SynapticMatrix[l].Pre[j].Synapses, 0, SynapseSize[l]);
+         SynapticMatrix[l].Pre[j].NumSynapses = Support[l].NumSynapses;
+         memcpy(SynapticMatrix[l].Pre[j].DPost, Support[l].DPost, sizeof(byte)*Support[l].NumSynapses);
+         memcpy(SynapticMatrix[l].Pre[j].Exception, Support[l].Exception, sizeof(indexn)*NumExceptions[l]);
+      }
+
+      /*** Prints the status of the SynapticMatrix creation. ***/
+#ifdef PRINT_STATUS
+     if ((100.0*j)/NumNeurons > Status + IncStatus) {
+        Status = (int)((100.0*j)/NumNeurons / IncStatus) * IncStatus;
+        fprintf(stderr, "Initializing Synaptic Matrix... %5.1f%% (Memory: %g Mbytes)    \r", Status, (real)MemoryAmount/1024.0/1024.0);
+     }
+#endif
+
+      /*** Did an interrupt signal occur? ***/
+      if (pollInterrupt()) break;
+   }
+
+   /*** Frees the memory occupied by the support structures. ***/
+   (*getEmptySynapses)(-1, -1);
+   for (l=0; l<DelayNumber; l++) {
+      free(Support[l].DPost);
+      releaseMemory(sizeof(byte)*NumNeurons, MEMORY_BUILD);
+      free(Support[l].Exception);
+      releaseMemory(sizeof(indexn)*NumNeurons, MEMORY_BUILD);
+   }
+   free(Support);
+   releaseMemory(sizeof(axon_segment)*DelayNumber, MEMORY_BUILD);
+   free(NumExceptions);
+   releaseMemory(sizeof(indexn)*DelayNumber, MEMORY_BUILD);
+   free(LastPost);
+   releaseMemory(sizeof(indexn)*DelayNumber, MEMORY_BUILD);
+   free(SynapseSize);
+   releaseMemory(sizeof(int)*DelayNumber, MEMORY_BUILD);
+
+   /*** Prints the status of the SynapticMatrix creation. ***/
+#ifdef PRINT_STATUS
+        fprintf(stderr, "Initializing Synaptic Matrix... 100.0%% (Memory: %g Mbytes)    \r", (real)MemoryAmount/1024.0/1024.0);
+#endif
+}
+
+
+/*----------------------*
+ *  scanSynapticMatrix  *
+ *----------------------*/
+
+/**
+ *  Visits a portion of the synaptic matrix defined by an 
+ *  interval of post-synaptic neurons [PostStart,PostEnd] 
+ *  and an interval of pre-synaptic neurons [PreStart,PreEnd].
+ *  For each synapse met a user-defined hook function 
+ *  (InspectFunc) is called. The synapse are visited in 
+ *  ascending order of pre-synaptic neuron, transmission 
+ *  delay and post-synaptic neuron.
+ */
+
+void scanSynapticMatrix (indexn           PostStart, 
+                         indexn             PostEnd, 
+                         indexn            PreStart, 
+                         indexn              PreEnd,
+                         InspectFuncPtr InspectFunc)
+{
+   int           l;
+   indexn  i, j, k, n;
+   byte         *s;
+   connectivity *c;
+
+   /*** Scans the presynaptic neurons. ***/
+   for (j=PreStart; j<=PreEnd; j++)
+
+      /*** Scans the layer of transmission delay. ***/
+      for (l=0; l<DelayNumber; l++) {
+         i = -1; 
+         s = (byte *)(SynapticMatrix[l].Pre[j].Synapses);
+         n = 0;
+
+         /*** Scans the axon segment. ***/
+         for (k=0; k<SynapticMatrix[l].Pre[j].NumSynapses; k++) {
+            i = nextPostSynaptic(SynapticMatrix[l].Pre[j].DPost, SynapticMatrix[l].Pre[j].Exception, k, i, &n);
+
+            c = Connectivity[Neurons[i].Pop->ID][Neurons[j].Pop->ID];
+
+            if (i >= PostStart)
+               if (i <= PostEnd)
+                  (*InspectFunc)(i, j, (void *)s, c, l);
+               else
+                  break;
+
+            s += c->SynapseSize;
+         }
+      }
+}
+
+
+
+/*------------------------*
+ *  setConnectivityParam  *
+ *------------------------*/
+
+/**
+ *  Updates online the global parameter of a synaptic population,
+ *  like the JumpUp or JumpDown of the hidden synaptic variable.
+ *
+ *  WARNING: Only parameters n. 13 and 14 are managed (JumpUp and 
+ *  JumpDown) or the ones from 5 to 8 (the synaptic efficacies and
+ *  their relative standard deviations).
+ */
+
+void setConnectivityParam(int          Post, /* Post-synaptic population. */
+                          int           Pre, /* Post-synaptic population. */
+                          int      ParamNum, /* Number of parameter to change. */
+                          double ParamValue, /* New value to assign to the parameter. */
+                          double       Time) /* Time when the update occur. */
+{
+   connectivity *c;
+
+   if (Post >= 0 && Post < NumPopulations &&
+       Pre >= 0 && Pre < NumPopulations)
+
+ /* TEMP: Such a solution is not the final one. In general the synaptic module will be *
+  *       the one capable to update the synaptic parameter whose meaning depends on    *
+  *       the synapse type.                                                            */
+      if ((c = Connectivity[Post][Pre]) != NULL)
+         if (c->NumParameters > ParamNum-BASIC_REAL_PARAMETERS)
+            if (ParamNum == 13 || ParamNum == 14) // JumpUp or JumpDown
+            { 
+               c->Parameters[ParamNum-BASIC_REAL_PARAMETERS] = ParamValue;
+            } else {
+                if (ParamNum >= 5 && ParamNum <= 8) // J* or DJ*
+                {
+                    c->Parameters[ParamNum-BASIC_REAL_PARAMETERS] = ParamValue;
+                    setSynapticEffaciesLUT(c);
+                }
+            }
+}
+
+
+/*-----------------------------*
+ *  setSynapticExtractionType  *
+ *-----------------------------*/
+
+/**
+ *  Sets the function pointers dependent on the
+ *  type of synaptic extraction choosen.
+ */
+
+int setSynapticExtractionType()
+{
+   if (strcmp(strupr(SynapticExtractionType), SET_RAN) == 0)
+   {
+      getEmptySynapses = &getEmptySynapses_RAN;
+      return 0;
+   }
+   if (strcmp(strupr(SynapticExtractionType), SET_FIX) == 0)
+   {
+      getEmptySynapses = &getEmptySynapses_FIX;
+      return 0;
+   }
+   if (strcmp(strupr(SynapticExtractionType), EMPTY_STRING) == 0)
+   {
+      getEmptySynapses = &getEmptySynapses_RAN;
+      return 0;
+   }
+   
+   return 1;
+}
+
+
+/*---------------*
+ *  segmentSize  *
+ *---------------*/
+
+/**
+ *  Returns the size in bytes of the synapses on the axon
+ *  segment <Pre> of the neuron <j>, which may have 
+ *  different sizes depending on the post-synaptic
+ *  population.
+ */
+
+static size_t segmentSize(axon_segment *Pre, /* Axon segment. */
+                          indexn          j) /* Pre-synaptic neuron. */
+{
+   size_t Size = 0;
+   indexn i, nExcep = 0;
+   indexn Post = -1;
+
+   for (i=0; i<Pre->NumSynapses; i++) {
+      Post = nextPostSynaptic(Pre->DPost, Pre->Exception, i, Post, &nExcep);
+      Size += Connectivity[Neurons[Post].Pop->ID][Neurons[j].Pop->ID]->SynapseSize;
+   }
+
+   return Size;
+}
+
+
+/*------------------------*
+ *  writeCheckpointSpike  *
+ *------------------------*/
+
+/**
+ *  Writes on <File> the spike <s> through a zeroed copy,
+ *  so that the padding of its timex carries no stack 
+ *  garbage and two checkpoints of the same run are equal.
+ */
+
+static int writeCheckpointSpike(FILE *File, spike *s)
+{
+   spike c;
+
+   memset(&c, 0, sizeof(c));
+   c.Emission.Seconds = s->Emission.Seconds;
+   c.Emission.Millis = s->Emission.Millis;
+   c.Neuron = s->Neuron;
+   c.ISI = s->ISI;
+
+   return writeCheckpointData(File, &c, sizeof(c));
+}
+
+
+/*----------------------------*
+ *  checkpointSynapticMatrix  *
+ *----------------------------*/
+
+/**
+ *  Writes on <File> the parameters of the synaptic
+ *  populations and the spikes waiting in the delay layers.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointSynapticMatrix(FILE *File)
+{
+   synaptic_layer *Layer;
+   size_t Pos;
+   indexn n;
+   int    k;
+
+   for (k=0; k<NumConnectivityArray; k++)
+      if (writeCheckpointData(File, ConnectivityArray[k].Parameters, sizeof(real) * ConnectivityArray[k].NumParameters))
+         return 1;
+
+   for (k=0; k<DelayNumber; k++) {
+      Layer = &SynapticMatrix[k];
+
+      /*** The spikes in the layer, from the oldest one. ***/
+      n = elementNumber(Layer->Queue);
+      if (writeCheckpointSpike(File, &(Layer->Spike)) ||
+          writeCheckpointData(File, &(Layer->Empty), sizeof(boolean)) ||
+          writeCheckpointData(File, &n, sizeof(n)))
+         return 1;
+      for (Pos=Layer->Queue.First; n>0; n--) {
+         if (writeCheckpointSpike(File, (spike *)(Layer->Queue.Queue + Pos)))
+            return 1;
+         Pos += Layer->Queue.ElementSize;
+         if (Pos >= Layer->Queue.ElementNum * Layer->Queue.ElementSize)
+            Pos = 0;
+      }
+   }
+
+   return 0;
+}
+
+
+/*-------------------------*
+ *  restoreSynapticMatrix  *
+ *-------------------------*/
+
+/**
+ *  Reads from <File> the parameters and the delay layers
+ *  written by checkpointSynapticMatrix, on a matrix built
+ *  with the same seed. Returns 1 on error, 0 otherwise.
+ */
+
+int restoreSynapticMatrix(FILE *File)
+{
+   real Params[STRING_SIZE];
+   synaptic_layer *Layer;
+   connectivity       *c;
+   spike      Spike;
+   indexn n;
+   int    k;
+
+   /*** The efficacy tables are updated if the parameters changed. ***/
+   for (k=0; k<NumConnectivityArray; k++) {
+      c = &ConnectivityArray[k];
+      if (c->NumParameters > STRING_SIZE ||
+          readCheckpointData(File, Params, sizeof(real) * c->NumParameters))
+         return 1;
+      if (memcmp(Params, c->Parameters, sizeof(real) * c->NumParameters) != 0) {
+         memcpy(c->Parameters, Params, sizeof(real) * c->NumParameters);
+         if (setSynapticEffaciesLUT(c))
+            printFatalError("restoreSynapticMatrix", "Out of memory.");
+      }
+   }
+
+   for (k=0; k<DelayNumber; k++) {
+      Layer = &SynapticMatrix[k];
+
+      /*** The spikes in the layer, from the oldest one. ***/
+      while (!isQueueEmpty(Layer->Queue))
+         getQueueElement(&(Layer->Queue), &Spike);
+      if (readCheckpointData(File, &(Layer->Spike), sizeof(spike)) ||
+          readCheckpointData(File, &(Layer->Empty), sizeof(boolean)) ||
+          readCheckpointData(File, &n, sizeof(n)))
+         return 1;
+      for (; n>0; n--) {
+         if (readCheckpointData(File, &Spike, sizeof(spike)))
+            return 1;
+         putQueueElement(&(Layer->Queue), &Spike);
+      }
+   }
+
+   return 0;
+}
+
+
+/*----------------------*
+ *  checkpointSynapses  *
+ *----------------------*/
+
+/**
+ *  Writes on <File> the state of all the synapses, streamed
+ *  axon segment by axon segment. The segments are written as
+ *  raw bytes, padding between the fields of a synapse included:
+ *  it is cleared by createSynapticMatrix and never written by
+ *  the synapse functions, which set the fields one by one, so
+ *  that identical runs give identical checkpoints.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointSynapses(FILE *File)
+{
+   axon_segment *Pre;
+   size_t Size;
+   indexn    j;
+   int       l;
+
+   for (l=0; l<DelayNumber; l++)
+      for (j=0; j<NumNeurons; j++) {
+         Pre = &(SynapticMatrix[l].Pre[j]);
+         Size = segmentSize(Pre, j);
+         if (writeCheckpointData(File, &Size, sizeof(Size)) ||
+             writeCheckpointData(File, Pre->Synapses, Size))
+            return 1;
+      }
+
+   return 0;
+}
+
+
+/*---------------------------*
+ *  checkpointDirtySynapses  *
+ *---------------------------*/
+
+/**
+ *  Writes on <File> the number of changed axon segments and
+ *  their state, for the pre-synaptic neurons marked by
+ *  markDirtyAxon, as raw bytes like checkpointSynapses.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointDirtySynapses(FILE *File)
+{
+   axon_segment *Pre;
+   size_t Size;
+   long  Block, n;
+   indexn     j;
+   int        l;
+
+   for (n=0, j=0; j<NumNeurons; j++)
+      if (isDirtyAxon(j))
+         n += DelayNumber;
+   if (writeCheckpointData(File, &n, sizeof(n)))
+      return 1;
+
+   for (l=0; l<DelayNumber; l++)
+      for (j=0; j<NumNeurons; j++)
+         if (isDirtyAxon(j)) {
+            Pre = &(SynapticMatrix[l].Pre[j]);
+            Block = (long)l * NumNeurons + j;
+            Size = segmentSize(Pre, j);
+            if (writeCheckpointData(File, &Block, sizeof(Block)) ||
+                writeCheckpointData(File, &Size, sizeof(Size)) ||
+                writeCheckpointData(File, Pre->Synapses, Size))
+               return 1;
+         }
+
+   return 0;
+}
+
+
+/*-------------------*
+ *  restoreSynapses  *
+ *-------------------*/
+
+/**
+ *  Reads from <File> the state of all the synapses written
+ *  by checkpointSynapses. Returns 1 on error, 0 otherwise.
+ */
+
+int restoreSynapses(FILE *File)
+{
+   axon_segment *Pre;
+   size_t Size;
+   indexn    j;
+   int       l;
+
+   for (l=0; l<DelayNumber; l++)
+      for (j=0; j<NumNeurons; j++) {
+         Pre = &(SynapticMatrix[l].Pre[j]);
+         if (readCheckpointData(File, &Size, sizeof(Size)) ||
+             Size != segmentSize(Pre, j) ||
+             readCheckpointData(File, Pre->Synapses, Size))
+            return 1;
+      }
+
+   return 0;
+}
+
+
+/*------------------------*
+ *  restoreDirtySynapses  *
+ *------------------------*/
+
+/**
+ *  Reads from <File> the changed axon segments written by
+ *  checkpointDirtySynapses, overwriting the current ones.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int restoreDirtySynapses(FILE *File)
+{
+   axon_segment *Pre;
+   size_t Size;
+   long  Block, n;
+
+   if (readCheckpointData(File, &n, sizeof(n)) || n < 0)
+      return 1;
+
+   for (; n>0; n--) {
+      if (readCheckpointData(File, &Block, sizeof(Block)) ||
+          Block < 0 || Block >= (long)DelayNumber * NumNeurons)
+         return 1;
+      Pre = &(SynapticMatrix[Block / NumNeurons].Pre[Block % NumNeurons]);
+      if (readCheckpointData(File, &Size, sizeof(Size)) ||
+          Size != segmentSize(Pre, (indexn)(Block % NumNeurons)) ||
+          readCheckpointData(File, Pre->Synapses, Size))
+         return 1;
+   }
+
+   return 0;
+}
+
+
+/*-------------------*
+ *  clearDirtyAxons  *
+ *-------------------*/
+
+/**
+ *  Clears the marks of markDirtyAxon, once the synapses are
+ *  saved.
+ */
+
+void clearDirtyAxons ()
+{
+   memset(DirtyAxons, 0, sizeof(byte)*(NumNeurons/8 + 1));
+}
+
+
+/*-------------------------*
+ *  releaseSynapticMatrix  *
+ *-------------------------*/
+
+/**
+ *  Frees the synaptic matrix, with its queues of spikes, and
+ *  the definition of the connectivity, so that a new network
+ *  can be loaded. The populations have to be still defined.
+ */
+
+void releaseSynapticMatrix ()
+{
+   axon_segment *Pre;
+   indexn     i, j, nExcep;
+   int        l, post;
+
+   if (SynapticMatrix != NULL) {
+      for (l=0; l<DelayNumber; l++) {
+         freeQueue(&(SynapticMatrix[l].Queue));
+         for (j=0; j<NumNeurons; j++) {
+            Pre = &SynapticMatrix[l].Pre[j];
+            if (Pre->DPost == NULL)
+               continue;
+            for (i=nExcep=0; i<Pre->NumSynapses; i++)
+               if (Pre->DPost[i] == EXCEPTION)
+                  nExcep++;
+            releaseMemory(segmentSize(Pre, j), MEMORY_SYNAPSES);
+            releaseMemory(sizeof(byte)*Pre->NumSynapses, MEMORY_INDICES);
+            releaseMemory(sizeof(indexn)*nExcep, MEMORY_INDICES);
+            free(Pre->Synapses);
+            free(Pre->DPost);
+            free(Pre->Exception);
+         }
+         free(SynapticMatrix[l].Pre);
+         releaseMemory(sizeof(axon_segment)*NumNeurons, MEMORY_INDICES);
+      }
+      free(SynapticMatrix);
+      releaseMemory(sizeof(synaptic_layer)*DelayNumber, MEMORY_INDICES);
+      free(DirtyAxons);
+      releaseMemory(sizeof(byte)*(NumNeurons/8 + 1), MEMORY_INDICES);
+      SynapticMatrix = NULL;
+      DirtyAxons = NULL;
+   }
+
+   if (Connectivity != NULL) {
+      for (post=0; post<NumPopulations; post++) {
+         free(Connectivity[post]);
+         releaseMemory(sizeof(connectivity*) * NumPopulations, MEMORY_POPULATIONS);
+      }
+      free(Connectivity);
+      releaseMemory(sizeof(connectivity**) * NumPopulations, MEMORY_POPULATIONS);
+      Connectivity = NULL;
+   }
+   if (ConnectivityArraySize > 0) {
+      free(ConnectivityArray);
+      releaseMemory(sizeof(connectivity) * ConnectivityArraySize, MEMORY_POPULATIONS);
+   }
+   if (ConnectivityParamsSize > 0) {
+      free(ConnectivityParams);
+      releaseMemory(sizeof(real) * ConnectivityParamsSize, MEMORY_POPULATIONS);
+   }
+   ConnectivityArray = NULL;
+   ConnectivityParams = NULL;
+   NumConnectivityArray = ConnectivityArraySize = 0;
+   NumConnectivityParams = ConnectivityParamsSize = 0;
+}
+
+
+#undef isDirtyAxon
+#undef BUFFER_SIZE
+#undef BASIC_REAL_PARAMETERS
+#undef STRING_SIZE
@@ -0,0 +1,498 @@
+/*
+ *
+ *   container.c
+ *
+ *   Library of functions to write and read the results
+ *   container, a single binary file collecting the sampled
+ *   streams in typed columnar chunks, with a time index in
+ *   the footer to reach any time range without scanning the
+ *   file.
+ *   The library is shared by Perseo and the reader tools, so
+ *   that it does not depend on the simulator modules but the
+ *   memory accounting (memusage.c), which charges the buffers
+ *   of the writer to MEMORY_OUTPUT.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "memusage.h"
+#include "container.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_SIZE  256 /* Size of the buffer for the chunk index. */
+
+#define align8(n) (((n) + 7) & ~(uint64_t)7)
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*--------------*
+ *  writeBytes  *
+ *--------------*/
+
+/**
+ *  Writes <Size> bytes from <Data> on the container <c>,
+ *  followed by zeros up to a multiple of 8 bytes.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int writeBytes(container *c, void *Data, size_t Size)
+{
+   static const char Zeros[8] = {0};
+   size_t Pad = (size_t)(align8(Size) - Size);
+
+   if (fwrite(Data, 1, Size, c->File) != Size ||
+       fwrite(Zeros, 1, Pad, c->File) != Pad)
+      return 1;
+   c->Offset += Size + Pad;
+
+   return 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*-----------------*
+ *  openContainer  *
+ *-----------------*/
+
+/**
+ *  Starts the writing of a container on the binary file
+ *  <File>. Returns 1 on error, 0 otherwise.
+ */
+
+int openContainer(container *c, /* Container to initialize. */
+                  FILE   *File) /* File opened for binary writing. */
+{
+   container_header h;
+
+   memset(c, 0, sizeof(container));
+   c->File = File;
+
+   memcpy(h.Magic, CONTAINER_MAGIC, 4);
+   h.Version = CONTAINER_VERSION;
+   h.Zero = 0;
+
+   return writeBytes(c, &h, sizeof(h));
+}
+
+
+/*----------------------*
+ *  addContainerStream  *
+ *----------------------*/
+
+/**
+ *  Adds a stream to the container <c>, with the name and
+ *  column names in <Description> (separated by tabs) and
+ *  <IndexColumns> integer columns.
+ *  Returns the index of the stream.
+ */
+
+int addContainerStream(container        *c, /* Container under writing. */
+                       char   *Description, /* Name and column names. */
+                       int    IndexColumns) /* Number of index columns. */
+{
+   container_stream *s;
+
+   c->Streams = (container_stream *)resizeMemory(c->Streams, sizeof(container_stream) * c->NumStreams,
+                                                 sizeof(container_stream) * (c->NumStreams + 1),
+                                                 MEMORY_OUTPUT, "ERROR (addContainerStream): Out of memory.");
+   s = &c->Streams[c->NumStreams];
+   memset(s, 0, sizeof(container_stream));
+
+   s->Description = (char *)getAreaMemory(strlen(Description) + 1, MEMORY_OUTPUT, "ERROR (addContainerStream): Out of memory.");
+   s->Times = (double *)getAreaMemory(sizeof(double) * CONTAINER_ROWS, MEMORY_OUTPUT, "ERROR (addContainerStream): Out of memory.");
+   s->Index1 = (uint64_t *)getAreaMemory(sizeof(uint64_t) * CONTAINER_ROWS, MEMORY_OUTPUT, "ERROR (addContainerStream): Out of memory.");
+   s->Index2 = (uint64_t *)getAreaMemory(sizeof(uint64_t) * CONTAINER_ROWS, MEMORY_OUTPUT, "ERROR (addContainerStream): Out of memory.");
+   strcpy(s->Description, Description);
+   s->IndexColumns = IndexColumns;
+
+   return c->NumStreams++;
+}
+
+
+/*----------------------*
+ *  addContainerRecord  *
+ *----------------------*/
+
+/**
+ *  Adds to the stream <Stream> of <c> the record at <Time>,
+ *  with indexes <i> and <j> and <NumValues> <Values>.
+ *  Completed chunks are written on file.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int addContainerRecord(container    *c, /* Container under writing. */
+                       int      Stream, /* Index of the stream. */
+                       double     Time, /* Time of the record. */
+                       uint64_t      i, /* First index. */
+                       uint64_t      j, /* Second index. */
+                       int   NumValues, /* Number of values. */
+                       double *Values) /* Values of the record. */
+{
+   container_stream *s = &c->Streams[Stream];
+   int k;
+
+   /*** A chunk holds records with the same number of values. ***/
+   if (s->NumRows > 0 && (uint32_t)NumValues != s->NumValues)
+      if (flushContainerStream(c, Stream))
+         return 1;
+   if ((uint32_t)NumValues > s->MaxValues) {
+      s->Values = (double *)resizeMemory(s->Values, sizeof(double) * CONTAINER_ROWS * s->MaxValues,
+                                         sizeof(double) * CONTAINER_ROWS * NumValues,
+                                         MEMORY_OUTPUT, "ERROR (addContainerRecord): Out of memory.");
+      s->MaxValues = NumValues;
+   }
+   s->NumValues = NumValues;
+
+   s->Times[s->NumRows] = Time;
+   s->Index1[s->NumRows] = i;
+   s->Index2[s->NumRows] = j;
+   for (k=0; k<NumValues; k++)
+      s->Values[k * CONTAINER_ROWS + s->NumRows] = Values[k];
+
+   if (++s->NumRows == CONTAINER_ROWS)
+      return flushContainerStream(c, Stream);
+
+   return 0;
+}
+
+
+/*------------------------*
+ *  flushContainerStream  *
+ *------------------------*/
+
+/**
+ *  Writes the chunk under construction of the stream <Stream>.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int flushContainerStream(container *c, /* Container under writing. */
+                         int   Stream) /* Index of the stream. */
+{
+   container_stream *s = &c->Streams[Stream];
+   container_chunk  *Chunk;
+   uint32_t k, n = s->NumRows;
+
+   if (n == 0)
+      return 0;
+
+   /*** Index entry. ***/
+   if (c->NumChunks == c->MaxChunks) { // More memory is needed?
+      c->Chunks = (container_chunk *)resizeMemory(c->Chunks, sizeof(container_chunk) * c->MaxChunks,
+                                                  sizeof(container_chunk) * (c->MaxChunks + BUFFER_SIZE),
+                                                  MEMORY_OUTPUT, "ERROR (flushContainerStream): Out of memory.");
+      c->MaxChunks += BUFFER_SIZE;
+   }
+   Chunk = &c->Chunks[c->NumChunks++];
+   Chunk->Stream = Stream;
+   Chunk->NumRows = n;
+   Chunk->NumValues = s->NumValues;
+   Chunk->Zero = 0;
+   Chunk->Offset = c->Offset;
+   Chunk->TimeFirst = Chunk->TimeLast = s->Times[0];
+   for (k=1; k<n; k++)
+      if (s->Times[k] < Chunk->TimeFirst)
+         Chunk->TimeFirst = s->Times[k];
+      else if (s->Times[k] > Chunk->TimeLast)
+         Chunk->TimeLast = s->Times[k];
+
+   /*** Columns. ***/
+   if (fwrite(s->Times, sizeof(double), n, c->File) != n)
+      return 1;
+   c->Offset += sizeof(double) * n;
+   if (s->IndexColumns == 1 && writeBytes(c, s->Index1, sizeof(uint64_t) * n))
+      return 1;
+   if (s->IndexColumns == 2) {
+      if (fwrite(s->Index1, sizeof(uint64_t), n, c->File) != n)
+         return 1;
+      c->Offset += sizeof(uint64_t) * n;
+      if (writeBytes(c, s->Index2, sizeof(uint64_t) * n))
+         return 1;
+   }
+   for (k=0; k<s->NumValues; k++) {
+      if (fwrite(&s->Values[k * CONTAINER_ROWS], sizeof(double), n, c->File) != n)
+         return 1;
+      c->Offset += sizeof(double) * n;
+   }
+
+   s->NumRows = 0;
+
+   return 0;
+}
+
+
+/*------------------*
+ *  closeContainer  *
+ *------------------*/
+
+/**
+ *  Writes the pending chunks, the stream descriptors and the
+ *  time index, closes the file and frees the memory.
+ *  Returns 1 on error, also if the Error field was set, 0
+ *  otherwise.
+ */
+
+int closeContainer(container *c)
+{
+   container_trailer t;
+   uint32_t Head[2];
+   int Error = c->Error;
+   int k;
+
+   for (k=0; k<c->NumStreams; k++)
+      Error |= flushContainerStream(c, k);
+
+   /*** Stream descriptors. ***/
+   t.FooterOffset = c->Offset;
+   for (k=0; k<c->NumStreams; k++) {
+      Head[0] = c->Streams[k].IndexColumns;
+      Head[1] = (uint32_t)strlen(c->Streams[k].Description) + 1;
+      Error |= writeBytes(c, Head, sizeof(Head));
+      Error |= writeBytes(c, c->Streams[k].Description, Head[1]);
+   }
+
+   /*** Time index and trailer. ***/
+   if (c->NumChunks > 0)
+      Error |= writeBytes(c, c->Chunks, sizeof(container_chunk) * c->NumChunks);
+   t.NumStreams = c->NumStreams;
+   t.NumChunks = c->NumChunks;
+   memcpy(t.Magic, CONTAINER_MAGIC, 4);
+   t.Version = CONTAINER_VERSION;
+   Error |= writeBytes(c, &t, sizeof(t));
+   Error |= fclose(c->File) != 0;
+
+   /*** Memory release. ***/
+   for (k=0; k<c->NumStreams; k++) {
+      releaseMemory(strlen(c->Streams[k].Description) + 1, MEMORY_OUTPUT);
+      releaseMemory(sizeof(double) * CONTAINER_ROWS, MEMORY_OUTPUT);
+      releaseMemory(sizeof(uint64_t) * CONTAINER_ROWS, MEMORY_OUTPUT);
+      releaseMemory(sizeof(uint64_t) * CONTAINER_ROWS, MEMORY_OUTPUT);
+      if (c->Streams[k].Values != NULL)
+         releaseMemory(sizeof(double) * CONTAINER_ROWS * c->Streams[k].MaxValues, MEMORY_OUTPUT);
+      free(c->Streams[k].Description);
+      free(c->Streams[k].Times);
+      free(c->Streams[k].Index1);
+      free(c->Streams[k].Index2);
+      free(c->Streams[k].Values);
+   }
+   if (c->Streams != NULL)
+      releaseMemory(sizeof(container_stream) * c->NumStreams, MEMORY_OUTPUT);
+   if (c->Chunks != NULL)
+      releaseMemory(sizeof(container_chunk) * c->MaxChunks, MEMORY_OUTPUT);
+   free(c->Streams);
+   free(c->Chunks);
+   c->Streams = NULL;
+   c->Chunks = NULL;
+   c->File = NULL;
+
+   return Error;
+}
+
+
+/*----------------*
+ *  mapContainer  *
+ *----------------*/
+
+/**
+ *  Maps in memory the container <FileName> for reading.
+ *  Returns 1 if the file is not a container, 0 otherwise.
+ */
+
+int mapContainer(container  *c, /* Container to initialize. */
+                 char *FileName) /* Name of the container file. */
+{
+   container_trailer *t;
+   uint32_t *Head;
+   uint64_t  Pos;
+   double    Max;
+   uint32_t  k, s;
+#ifndef _WIN32
+   int         fd;
+   struct stat st;
+#else
+   FILE   *InFile;
+#endif
+
+   memset(c, 0, sizeof(container));
+
+   /*** Maps the file in memory. ***/
+#ifndef _WIN32
+   if ((fd = open(FileName, O_RDONLY)) < 0)
+      return 1;
+   if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(container_header) + sizeof(container_trailer)) {
+      close(fd);
+      return 1;
+   }
+   c->Size = (size_t)st.st_size;
+   c->Data = (char *)mmap(NULL, c->Size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (c->Data == (char *)MAP_FAILED) {
+      c->Data = NULL;
+      return 1;
+   }
+#else
+   if ((InFile = fopen(FileName, "rb")) == NULL)
+      return 1;
+   fseek(InFile, 0, SEEK_END);
+   c->Size = (size_t)ftell(InFile);
+   fseek(InFile, 0, SEEK_SET);
+   if (c->Size < sizeof(container_header) + sizeof(container_trailer) ||
+       (c->Data = (char *)malloc(c->Size)) == NULL ||
+       fread(c->Data, 1, c->Size, InFile) != c->Size) {
+      fclose(InFile);
+      return 1;
+   }
+   fclose(InFile);
+#endif
+
+   /*** Trailer and footer. ***/
+   t = (container_trailer *)(c->Data + c->Size - sizeof(container_trailer));
+   if (memcmp(c->Data, CONTAINER_MAGIC, 4) != 0 || memcmp(t->Magic, CONTAINER_MAGIC, 4) != 0 ||
+       t->Version != CONTAINER_VERSION || t->FooterOffset > c->Size) {
+      unmapContainer(c);
+      return 1;
+   }
+   c->NumStreams = t->NumStreams;
+   c->NumChunks = t->NumChunks;
+   c->Streams = (container_stream *)calloc(c->NumStreams + 1, sizeof(container_stream));
+   c->StreamChunks = (uint32_t **)calloc(c->NumStreams + 1, sizeof(uint32_t *));
+   c->NumStreamChunks = (uint32_t *)calloc(c->NumStreams + 1, sizeof(uint32_t));
+   c->StreamTime = (double **)calloc(c->NumStreams + 1, sizeof(double *));
+   if (c->Streams == NULL || c->StreamChunks == NULL || c->NumStreamChunks == NULL || c->StreamTime == NULL) {
+      unmapContainer(c);
+      return 1;
+   }
+   for (Pos = t->FooterOffset, s=0; s<(uint32_t)c->NumStreams; s++) {
+      if (Pos + 2 * sizeof(uint32_t) > c->Size) {
+         unmapContainer(c);
+         return 1;
+      }
+      Head = (uint32_t *)(c->Data + Pos);
+      c->Streams[s].IndexColumns = Head[0];
+      c->Streams[s].Description = c->Data + Pos + 2 * sizeof(uint32_t);
+      Pos += align8(2 * sizeof(uint32_t)) + align8(Head[1]);
+   }
+   c->Chunks = (container_chunk *)(c->Data + Pos);
+   if (Pos + sizeof(container_chunk) * c->NumChunks + sizeof(container_trailer) != c->Size) {
+      unmapContainer(c);
+      return 1;
+   }
+
+   /*** Chunks of each stream, with the running maximum of the times. ***/
+   for (k=0; k<c->NumChunks; k++)
+      if (c->Chunks[k].Stream < (uint32_t)c->NumStreams)
+         c->NumStreamChunks[c->Chunks[k].Stream]++;
+   for (s=0; s<(uint32_t)c->NumStreams; s++) {
+      c->StreamChunks[s] = (uint32_t *)malloc(sizeof(uint32_t) * (c->NumStreamChunks[s] + 1));
+      c->StreamTime[s] = (double *)malloc(sizeof(double) * (c->NumStreamChunks[s] + 1));
+      if (c->StreamChunks[s] == NULL || c->StreamTime[s] == NULL) {
+         unmapContainer(c);
+         return 1;
+      }
+      c->NumStreamChunks[s] = 0;
+   }
+   for (k=0; k<c->NumChunks; k++)
+      if ((s = c->Chunks[k].Stream) < (uint32_t)c->NumStreams) {
+         Max = c->Chunks[k].TimeLast;
+         if (c->NumStreamChunks[s] > 0 && c->StreamTime[s][c->NumStreamChunks[s] - 1] > Max)
+            Max = c->StreamTime[s][c->NumStreamChunks[s] - 1];
+         c->StreamTime[s][c->NumStreamChunks[s]] = Max;
+         c->StreamChunks[s][c->NumStreamChunks[s]++] = k;
+      }
+
+   return 0;
+}
+
+
+/*----------------------*
+ *  findContainerChunk  *
+ *----------------------*/
+
+/**
+ *  Returns the position k in c->StreamChunks[<Stream>] of
+ *  the first chunk with records not preceding <Time>, found
+ *  by binary search, so that the chunks from k on hold all
+ *  the records from <Time> on. If there are none returns
+ *  c->NumStreamChunks[<Stream>].
+ */
+
+uint32_t findContainerChunk(container  *c, /* Mapped container. */
+                            int    Stream, /* Index of the stream. */
+                            double   Time) /* Time of interest. */
+{
+   uint32_t Low = 0;
+   uint32_t High = c->NumStreamChunks[Stream];
+   uint32_t Mid;
+
+   while (Low < High) {
+      Mid = Low + (High - Low) / 2;
+      if (c->StreamTime[Stream][Mid] < Time)
+         Low = Mid + 1;
+      else
+         High = Mid;
+   }
+
+   return Low;
+}
+
+
+/*------------------*
+ *  unmapContainer  *
+ *------------------*/
+
+/**
+ *  Unmaps the container <c>.
+ */
+
+void unmapContainer(container *c)
+{
+   int s;
+
+   if (c->StreamChunks != NULL && c->StreamTime != NULL)
+      for (s=0; s<c->NumStreams; s++) {
+         free(c->StreamChunks[s]);
+         free(c->StreamTime[s]);
+      }
+   free(c->StreamChunks);
+   free(c->StreamTime);
+   free(c->NumStreamChunks);
+   free(c->Streams);
+#ifndef _WIN32
+   if (c->Data != NULL)
+      munmap(c->Data, c->Size);
+#else
+   free(c->Data);
+#endif
+   memset(c, 0, sizeof(container));
+}
+
+
+
+#undef align8
+#undef BUFFER_SIZE
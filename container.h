@@ -0,0 +1,222 @@
+/*
+ *
+ *   container.h
+ *
+ *   Library of functions to write and read the results
+ *   container, a single binary file collecting the sampled
+ *   streams in typed columnar chunks, with a time index in
+ *   the footer to reach any time range without scanning the
+ *   file.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __CONTAINER_H__
+#define __CONTAINER_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Layout of a container file (native byte order, all the
+ *  sections aligned to 8 bytes):
+ *
+ *    container_header   (16 bytes)
+ *    chunk              (repeated)
+ *    stream descriptors (NumStreams, see below)
+ *    container_chunk    (NumChunks, the time index)
+ *    container_trailer  (24 bytes, at the end of the file)
+ *
+ *  A chunk holds NumRows consecutive records of a stream with
+ *  the same number of values, stored by columns:
+ *
+ *    double   Time[NumRows]                 Record times in ms.
+ *    uint64_t i[NumRows]                    If IndexColumns >= 1.
+ *    uint64_t j[NumRows]                    If IndexColumns == 2.
+ *    (padding to 8 bytes)
+ *    double   Value[NumValues][NumRows]     A column per value.
+ *
+ *  A stream descriptor is a uint32_t IndexColumns, a uint32_t
+ *  Length and a string of Length bytes (padded with '\0' to
+ *  8 bytes), with the stream name and the column names
+ *  separated by tabs: Time, the index columns and the value
+ *  columns. Values beyond the named ones are unnamed.
+ *  The index lists the chunks in the order they are written,
+ *  so that the chunks of a stream are sorted in time.
+ *  The index columns are 64 bits wide since version 2, so
+ *  that the neurons of a LARGE_NETWORK build fit (see types.h).
+ */
+
+#define CONTAINER_MAGIC  "PRCN" /* First and last 4 bytes of the file. */
+#define CONTAINER_VERSION     2 /* Version of the layout. */
+#define CONTAINER_ROWS     4096 /* Maximum number of rows in a chunk. */
+
+typedef struct {
+   char          Magic[4]; /* CONTAINER_MAGIC. */
+   uint32_t       Version; /* CONTAINER_VERSION. */
+   uint64_t          Zero; /* Reserved, it has to be 0. */
+} container_header;
+
+typedef struct {
+   uint32_t        Stream; /* Index of the stream. */
+   uint32_t       NumRows; /* Number of records. */
+   uint32_t     NumValues; /* Number of values per record. */
+   uint32_t          Zero; /* Padding, it has to be 0. */
+   uint64_t        Offset; /* Position of the chunk in the file. */
+   double       TimeFirst; /* Minimum time of the records. */
+   double        TimeLast; /* Maximum time of the records. */
+} container_chunk;
+
+typedef struct {
+   uint64_t  FooterOffset; /* Position of the stream descriptors. */
+   uint32_t    NumStreams; /* Number of streams. */
+   uint32_t     NumChunks; /* Number of chunks in the index. */
+   char          Magic[4]; /* CONTAINER_MAGIC. */
+   uint32_t       Version; /* CONTAINER_VERSION. */
+} container_trailer;
+
+
+/**
+ *  A stream of the container: its description and, while
+ *  writing, the chunk under construction.
+ */
+
+typedef struct {
+   char       *Description; /* Name and column names separated by tabs. */
+   int        IndexColumns; /* Number of integer index columns (0, 1 or 2). */
+   uint32_t      NumValues; /* Values per record of the chunk. */
+   uint32_t        NumRows; /* Records in the chunk. */
+   uint32_t      MaxValues; /* Values per record with allocated memory. */
+   double           *Times; /* Time column of the chunk. */
+   uint64_t        *Index1; /* First index column. */
+   uint64_t        *Index2; /* Second index column. */
+   double          *Values; /* Value columns, CONTAINER_ROWS values each. */
+} container_stream;
+
+
+/**
+ *  A container opened for writing, or mapped in memory for
+ *  reading.
+ */
+
+typedef struct {
+   FILE                *File; /* File under writing. */
+   uint64_t           Offset; /* Bytes written. */
+   container_stream *Streams; /* The streams. */
+   int            NumStreams; /* Number of streams. */
+   container_chunk  *Chunks;  /* The time index. */
+   uint32_t       NumChunks;  /* Number of chunks. */
+   uint32_t       MaxChunks;  /* Size of the Chunks array while writing. */
+   char               *Data;  /* The file mapped in memory while reading. */
+   size_t              Size;  /* Size of the mapped file. */
+   uint32_t **StreamChunks;   /* Chunks of each stream, in time order, while reading. */
+   uint32_t *NumStreamChunks; /* Number of chunks of each stream. */
+   double      **StreamTime;  /* Maximum time of the records up to each chunk of a stream. */
+   int                Error;  /* Set by the writer once a record could not be added. */
+} container;
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Starts the writing of a container on the binary file
+ *  <File>. Returns 1 on error, 0 otherwise.
+ */
+
+int openContainer(container *c, /* Container to initialize. */
+                  FILE   *File); /* File opened for binary writing. */
+
+
+/**
+ *  Adds a stream to the container <c>, with the name and
+ *  column names in <Description> (separated by tabs) and
+ *  <IndexColumns> integer columns.
+ *  Returns the index of the stream.
+ */
+
+int addContainerStream(container        *c, /* Container under writing. */
+                       char   *Description, /* Name and column names. */
+                       int    IndexColumns); /* Number of index columns. */
+
+
+/**
+ *  Adds to the stream <Stream> of <c> the record at <Time>,
+ *  with indexes <i> and <j> and <NumValues> <Values>.
+ *  Completed chunks are written on file.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int addContainerRecord(container    *c, /* Container under writing. */
+                       int      Stream, /* Index of the stream. */
+                       double     Time, /* Time of the record. */
+                       uint64_t      i, /* First index. */
+                       uint64_t      j, /* Second index. */
+                       int   NumValues, /* Number of values. */
+                       double *Values); /* Values of the record. */
+
+
+/**
+ *  Writes the chunk under construction of the stream <Stream>.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int flushContainerStream(container *c, /* Container under writing. */
+                         int   Stream); /* Index of the stream. */
+
+
+/**
+ *  Writes the pending chunks, the stream descriptors and the
+ *  time index, closes the file and frees the memory.
+ *  Returns 1 on error, also if the Error field was set, 0
+ *  otherwise.
+ */
+
+int closeContainer(container *c);
+
+
+/**
+ *  Maps in memory the container <FileName> for reading.
+ *  Returns 1 if the file is not a container, 0 otherwise.
+ */
+
+int mapContainer(container  *c, /* Container to initialize. */
+                 char *FileName); /* Name of the container file. */
+
+
+/**
+ *  Returns the position k in c->StreamChunks[<Stream>] of
+ *  the first chunk with records not preceding <Time>, found 
+ *  by binary search, so that the chunks from k on hold all
+ *  the records from <Time> on. If there are none returns
+ *  c->NumStreamChunks[<Stream>].
+ */
+
+uint32_t findContainerChunk(container  *c, /* Mapped container. */
+                            int    Stream, /* Index of the stream. */
+                            double   Time); /* Time of interest. */
+
+
+/**
+ *  Unmaps the container <c>.
+ */
+
+void unmapContainer(container *c);
+
+
+
+#endif /* __CONTAINER_H__ */
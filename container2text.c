@@ -0,0 +1,118 @@
+/*
+ *
+ *   container2text.c
+ *
+ *   Extracts from a results container logged by Perseo (see
+ *   container.h) the records of a stream in a time range,
+ *   printed as text rows on the standard output: the time,
+ *   the index columns and the values.
+ *
+ *      container2text <in_file_name> [<stream> [<t_from> [<t_to>]]]
+ *
+ *   Without <stream> the streams of the container are listed
+ *   with their columns. Only the records with time in
+ *   [<t_from>, <t_to>) are printed, reading only the chunks
+ *   found through the time index.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "container.h"
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   container    c;
+   container_chunk *Chunk;
+   double  *Times, *Values;
+   uint64_t *Index1, *Index2;
+   double  tFrom, tTo;
+   char   *Name, *Columns;
+   size_t  Len;
+   uint32_t k, r, v;
+   int      s;
+   long     NumRecords;
+
+   if (ArgC < 2 || ArgC > 5) {
+      fprintf(stderr, "Usage: %s <in_file_name> [<stream> [<t_from> [<t_to>]]]\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+   tFrom = ArgC >= 4 ? atof(ArgV[3]) : -1e300;
+   tTo = ArgC == 5 ? atof(ArgV[4]) : 1e300;
+
+   if (mapContainer(&c, ArgV[1])) {
+      fprintf(stderr, "ERROR (container2text): '%s' is not a results container.\n", ArgV[1]);
+      return EXIT_FAILURE;
+   }
+
+   /*** Lists the streams and their columns. ***/
+   if (ArgC == 2) {
+      for (s=0; s<c.NumStreams; s++) {
+         Name = c.Streams[s].Description;
+         Len = strcspn(Name, "\t");
+         printf("%.*s: %u chunks", (int)Len, Name, c.NumStreamChunks[s]);
+         if (c.NumStreamChunks[s] > 0)
+            printf(", time up to %.7g ms", c.StreamTime[s][c.NumStreamChunks[s] - 1]);
+         printf("\n");
+         for (Columns = Name + Len, k=1; *Columns != '\0'; k++) {
+            Columns++;
+            Len = strcspn(Columns, "\t");
+            printf("   %u. %.*s\n", k, (int)Len, Columns);
+            Columns += Len;
+         }
+      }
+      unmapContainer(&c);
+      return 0;
+   }
+
+   /*** Looks for the stream. ***/
+   for (s=0; s<c.NumStreams; s++) {
+      Len = strcspn(c.Streams[s].Description, "\t");
+      if (Len == strlen(ArgV[2]) && strncmp(c.Streams[s].Description, ArgV[2], Len) == 0)
+         break;
+   }
+   if (s == c.NumStreams) {
+      fprintf(stderr, "ERROR (container2text): stream '%s' not found.\n", ArgV[2]);
+      unmapContainer(&c);
+      return EXIT_FAILURE;
+   }
+
+   /*** Prints the records from the first chunk of interest. ***/
+   NumRecords = 0;
+   for (k=findContainerChunk(&c, s, tFrom); k<c.NumStreamChunks[s]; k++) {
+      Chunk = &c.Chunks[c.StreamChunks[s][k]];
+      if (Chunk->TimeFirst >= tTo)
+         continue;
+      Times = (double *)(c.Data + Chunk->Offset);
+      Index1 = (uint64_t *)(Times + Chunk->NumRows);
+      Index2 = Index1 + Chunk->NumRows;
+      Values = (double *)((char *)Index1 + ((sizeof(uint64_t) * Chunk->NumRows * c.Streams[s].IndexColumns + 7) & ~(size_t)7));
+      for (r=0; r<Chunk->NumRows; r++) {
+         if (Times[r] < tFrom || Times[r] >= tTo)
+            continue;
+         printf("%.7g", Times[r]);
+         if (c.Streams[s].IndexColumns >= 1)
+            printf(" %" PRIu64, Index1[r]);
+         if (c.Streams[s].IndexColumns == 2)
+            printf(" %" PRIu64, Index2[r]);
+         for (v=0; v<Chunk->NumValues; v++)
+            printf(" %.7g", Values[v * Chunk->NumRows + r]);
+         printf("\n");
+         NumRecords++;
+      }
+   }
+
+   unmapContainer(&c);
+   fprintf(stderr, "%ld records extracted.\n", NumRecords);
+
+   return 0;
+}
@@ -0,0 +1,550 @@
+/*
+ *
+ *   control.c
+ *
+ *   Library of the control socket, steering a running
+ *   simulation through a thread which hands the requests to
+ *   it with no locks (see control.h).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "types.h"
+#include "invar.h"
+
+#include "perseo.h"
+#include "events.h"
+#include "modules.h"
+#include "results.h"
+#include "commands.h"
+#include "control.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM        256 /* Maximum static string size in the module (and length of a request). */
+#define REPLY_DIM       65536 /* Maximum length of a reply. */
+#define CONTROL_POLL      200 /* Milliseconds waited by the thread for a connection or a line. */
+#define CONTROL_SLEEP 1000000 /* Nanoseconds slept waiting for the other side of the mailbox. */
+
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0 /* A closed connection raises SIGPIPE, blocked in the thread. */
+#endif
+
+/*** State of the mailbox. ***/
+#define REQUEST_EMPTY  0 /* No request. */
+#define REQUEST_POSTED 1 /* A request waits for the simulation. */
+#define REQUEST_DONE   2 /* The reply waits for the thread. */
+
+/*** Atomic access to the mailbox (GCC builtins). ***/
+#if defined(__GNUC__) && !defined(_WIN32)
+#define loadAcquire(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define storeRelease(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else
+#define loadAcquire(p)     (*(p))
+#define storeRelease(p, v) (*(p) = (v))
+#endif
+
+/**
+ *  The mailbox shared by the simulation and the thread
+ *  serving the socket, which cannot reach the variables of
+ *  the simulation (local to the simulation thread, see
+ *  PERSEO_LOCAL). Request is written by the thread and Reply
+ *  by the simulation, each one before passing the mailbox
+ *  to the other side through State.
+ */
+
+typedef struct {
+   int               State; /* REQUEST_EMPTY, REQUEST_POSTED or REQUEST_DONE. */
+   int                Stop; /* Set to 1 to ask the thread to end. */
+   int              Socket; /* Listening socket. */
+   int          Connection; /* Connection being served, -1 if none. */
+   char Path[BUFFER_DIM];   /* Path of the socket. */
+   char Request[BUFFER_DIM]; /* The line received. */
+   char Reply[REPLY_DIM];   /* The line to send back. */
+} control_args;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL char *ControlSocketName = ""; /* Path of the control socket (empty for none). */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL control_args     *Args = NULL;  /* The mailbox of the running thread. */
+static PERSEO_LOCAL boolean         Paused = false; /* It is true while the evolution is paused. */
+static PERSEO_LOCAL double   LastRatesTime = 0.0;   /* Network time of the last RATES. */
+static PERSEO_LOCAL long  *LastSpikeTotal = NULL;   /* Spikes emitted by each population at the last RATES. */
+#ifndef _WIN32
+static PERSEO_LOCAL pthread_t  Controller;          /* The thread serving the socket. */
+#endif
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+#ifndef _WIN32
+
+/*---------------*
+ *  waitControl  *
+ *---------------*/
+
+/**
+ *  Sleeps for CONTROL_SLEEP ns.
+ */
+
+static void waitControl()
+{
+   struct timespec ts = {0, CONTROL_SLEEP};
+
+   nanosleep(&ts, NULL);
+}
+
+
+/*-------------*
+ *  sendReply  *
+ *-------------*/
+
+/**
+ *  Sends the line <Line> on the connection <Fd>.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int sendReply(int    Fd,
+                     char *Line)
+{
+   size_t Len = strlen(Line);
+   ssize_t n;
+
+   while (Len > 0) {
+      if ((n = send(Fd, Line, Len, MSG_NOSIGNAL)) < 0) {
+         if (errno == EINTR) continue;
+         return 1;
+      }
+      Line += n;
+      Len -= n;
+   }
+   return send(Fd, "\n", 1, MSG_NOSIGNAL) != 1;
+}
+
+
+/*-------------------*
+ *  serveConnection  *
+ *-------------------*/
+
+/**
+ *  Hands to the simulation each line received on the
+ *  connection <c->Connection>, sending back its reply, up
+ *  to the closing of the connection or to the end of the
+ *  thread. A line not fitting in BUFFER_DIM - 1 characters
+ *  is not handed, and gets an error as reply.
+ */
+
+static void serveConnection(control_args *c)
+{
+   char Line[BUFFER_DIM];
+   struct pollfd pfd;
+   boolean Skip; /* The rest of a too long line is discarded. */
+   size_t Len;
+   ssize_t n;
+   char *End;
+
+   Len = 0;
+   Skip = false;
+   pfd.fd = c->Connection;
+   pfd.events = POLLIN;
+   while (!loadAcquire(&c->Stop)) {
+      if (poll(&pfd, 1, CONTROL_POLL) <= 0)
+         continue;
+      if ((n = recv(c->Connection, Line + Len, BUFFER_DIM - 1 - Len, 0)) <= 0)
+         return;
+      Len += n;
+      Line[Len] = '\0';
+
+      /*** Each complete line is a request. ***/
+      while ((End = strchr(Line, '\n')) != NULL) {
+         *End = '\0';
+         if (End > Line && End[-1] == '\r')
+            End[-1] = '\0';
+         if (!Skip)
+            strcpy(c->Request, Line);
+         Len -= End + 1 - Line;
+         memmove(Line, End + 1, Len + 1);
+
+         if (Skip) {
+            strcpy(c->Reply, "ERROR line too long");
+            Skip = false;
+         } else {
+            storeRelease(&c->State, REQUEST_POSTED);
+            while (loadAcquire(&c->State) != REQUEST_DONE && !loadAcquire(&c->Stop))
+               waitControl();
+            if (loadAcquire(&c->State) != REQUEST_DONE)
+               strcpy(c->Reply, "ERROR the simulation ended");
+            storeRelease(&c->State, REQUEST_EMPTY);
+         }
+         if (sendReply(c->Connection, c->Reply))
+            return;
+      }
+
+      /*** A line filling the buffer is too long: it is discarded up to its end. ***/
+      if (Len == BUFFER_DIM - 1) {
+         Skip = true;
+         Len = 0;
+         Line[0] = '\0';
+      }
+   }
+}
+
+
+/*---------------*
+ *  controlLoop  *
+ *---------------*/
+
+/**
+ *  Body of the thread serving the socket: the connections
+ *  are served one at a time.
+ */
+
+static void *controlLoop(void *Arg)
+{
+   control_args *c = (control_args *)Arg;
+   struct pollfd pfd;
+   int Fd;
+
+   pfd.fd = c->Socket;
+   pfd.events = POLLIN;
+   while (!loadAcquire(&c->Stop)) {
+      if (poll(&pfd, 1, CONTROL_POLL) <= 0)
+         continue;
+      if ((Fd = accept(c->Socket, NULL, NULL)) < 0)
+         continue;
+      c->Connection = Fd;
+      serveConnection(c);
+      c->Connection = -1;
+      close(Fd);
+   }
+
+   return NULL;
+}
+
+
+/*---------------*
+ *  openControl  *
+ *---------------*/
+
+/**
+ *  Opens the control socket <Path> and starts the thread
+ *  serving it. The signals are blocked in the thread, so
+ *  that they reach the simulation. Returns 1 on error,
+ *  reporting the reason in <Error>, 0 otherwise.
+ */
+
+static int openControl(char  *Path,
+                       char *Error)
+{
+   struct sockaddr_un Addr;
+   sigset_t All, Old;
+
+   if (strlen(Path) >= sizeof(Addr.sun_path) || strlen(Path) >= BUFFER_DIM) {
+      sprintf(Error, "path too long");
+      return 1;
+   }
+   memset(&Addr, 0, sizeof(Addr));
+   Addr.sun_family = AF_UNIX;
+   strcpy(Addr.sun_path, Path);
+
+   Args->State = REQUEST_EMPTY;
+   Args->Stop = 0;
+   Args->Connection = -1;
+   strcpy(Args->Path, Path);
+   if ((Args->Socket = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+      sprintf(Error, "%s", strerror(errno));
+      return 1;
+   }
+   unlink(Path);
+   if (bind(Args->Socket, (struct sockaddr *)&Addr, sizeof(Addr)) != 0 || listen(Args->Socket, 4) != 0) {
+      sprintf(Error, "%s", strerror(errno));
+      close(Args->Socket);
+      return 1;
+   }
+
+   sigfillset(&All);
+   pthread_sigmask(SIG_SETMASK, &All, &Old);
+   if (pthread_create(&Controller, NULL, controlLoop, Args) != 0) {
+      pthread_sigmask(SIG_SETMASK, &Old, NULL);
+      sprintf(Error, "unable to start the thread");
+      close(Args->Socket);
+      unlink(Path);
+      return 1;
+   }
+   pthread_sigmask(SIG_SETMASK, &Old, NULL);
+
+   return 0;
+}
+
+#endif
+
+
+/*-----------------*
+ *  answerRequest  *
+ *-----------------*/
+
+/**
+ *  Answers the request in the mailbox at the network time
+ *  <Time>, writing the reply in the mailbox.
+ */
+
+static void answerRequest(double Time)
+{
+   char Verb[BUFFER_DIM];
+   char Line[BUFFER_DIM];
+   char File[BUFFER_DIM];
+   char *Reply = Args->Reply;
+   double t, dt;
+   float f;
+   size_t Len;
+   int n, k;
+
+   if ((n = sscanf(Args->Request, "%s %s", Verb, File)) < 1) {
+      strcpy(Reply, "ERROR empty request");
+      return;
+   }
+   strupr(Verb);
+
+   if (strcmp(Verb, "TIME") == 0)
+      sprintf(Reply, "OK %.7g %.7g", Time, Life);
+
+   else if (strcmp(Verb, "RATES") == 0) {
+      dt = Time - LastRatesTime;
+      Len = sprintf(Reply, "OK %.7g", dt);
+      for (k=0; k<NumPopulations && Len < REPLY_DIM - 32; k++) {
+         Len += sprintf(Reply + Len, " %.5g", dt > 0.0 ? (Populations[k].SpikeTotal - LastSpikeTotal[k]) * 1000.0 /
+                                                         (Populations[k].N * dt) : 0.0);
+         LastSpikeTotal[k] = Populations[k].SpikeTotal;
+      }
+      LastRatesTime = Time;
+
+   } else if (strcmp(Verb, "MEMORY") == 0) {
+      Len = sprintf(Reply, "OK %.0f %.0f", (double)MemoryAmount, (double)MemoryPeak);
+      for (k=0; k<MEMORY_AREAS; k++)
+         Len += sprintf(Reply + Len, " %s=%.0f", MemoryAreaNames[k], (double)MemoryUsage[k].Bytes);
+
+   } else if (strcmp(Verb, "STATUS") == 0)
+      sprintf(Reply, "OK %s %.7g %d", Paused ? "paused" : "running", Time, pendingEvents());
+
+   else if (strcmp(Verb, "PAUSE") == 0) {
+      Paused = true;
+      sprintf(Reply, "OK paused at %.7g", Time);
+
+   } else if (strcmp(Verb, "RESUME") == 0) {
+      Paused = false;
+      sprintf(Reply, "OK resumed at %.7g", Time);
+
+   } else if (strcmp(Verb, "FLUSH") == 0) {
+      flushOutputFiles();
+      strcpy(Reply, "OK");
+
+   } else if (strcmp(Verb, "QUIT") == 0) {
+      QuitSimulation = true;
+      Paused = false;
+      sprintf(Reply, "OK quitting at %.7g", Time);
+
+   } else {
+
+      /*** A command of the protocol, CHECKPOINT with no time being at once. ***/
+      if (strcmp(Verb, "CHECKPOINT") == 0 && (n == 1 || sscanf(File, "%f", &f) != 1))
+         sprintf(Line, "CHECKPOINT 0 %.*s", BUFFER_DIM - 16, n == 1 ? "" : File);
+      else
+         strcpy(Line, Args->Request);
+      t = Time;
+      if (parseAndSubmitCommand(Line, &t) == 1)
+         strcpy(Reply, "OK");
+      else
+         strcpy(Reply, "ERROR unknown command or bad parameters");
+   }
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*----------------*
+ *  startControl  *
+ *----------------*/
+
+/**
+ *  Opens the control socket and starts the thread serving
+ *  it, if ControlSocketName is not empty.
+ */
+
+void startControl ()
+{
+   char Error[BUFFER_DIM];
+   int k;
+
+   if (strlen(ControlSocketName) == 0)
+      return;
+
+#ifndef _WIN32
+   Args = getMemory(sizeof(control_args), "ERROR (startControl): Out of memory.");
+   if (openControl(ControlSocketName, Error)) {
+      free(Args);
+      releaseMemory(sizeof(control_args), MEMORY_OTHER);
+      Args = NULL;
+   }
+#else
+   sprintf(Error, "sockets not available on this system");
+#endif
+   if (Args == NULL) {
+      fprintf(DocFile, "#----------\n");
+      fprintf(DocFile, "# Control socket not available (%s): the run goes on without it.\n\n", Error);
+      return;
+   }
+
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Control socket: '%s'\n\n", ControlSocketName);
+
+   Paused = false;
+   LastRatesTime = START_TIME_OFFSET;
+   LastSpikeTotal = getMemory(sizeof(long) * NumPopulations, "ERROR (startControl): Out of memory.");
+   for (k=0; k<NumPopulations; k++)
+      LastSpikeTotal[k] = Populations[k].SpikeTotal;
+}
+
+
+/*----------------*
+ *  serveControl  *
+ *----------------*/
+
+/**
+ *  Serves the request in the mailbox, if any, at the
+ *  network time <Time>. While the simulation is paused,
+ *  it waits serving the following requests, up to RESUME,
+ *  QUIT or a signal.
+ */
+
+void serveControl (double Time)
+{
+   if (Args == NULL)
+      return;
+
+   do {
+      if (loadAcquire(&Args->State) == REQUEST_POSTED) {
+         answerRequest(Time);
+         storeRelease(&Args->State, REQUEST_DONE);
+      }
+#ifndef _WIN32
+      if (Paused && !pollInterrupt())
+         waitControl();
+#endif
+   } while (Paused && !pollInterrupt());
+}
+
+
+/*---------------*
+ *  forkControl  *
+ *---------------*/
+
+/**
+ *  In a process forked by the simulation, where the thread
+ *  is not inherited, closes the socket of the parent and
+ *  opens a new one with <Prefix> in front of its name.
+ */
+
+void forkControl (char *Prefix)
+{
+#ifndef _WIN32
+   char Error[BUFFER_DIM];
+   char  Path[BUFFER_DIM];
+
+   if (Args == NULL)
+      return;
+
+   close(Args->Socket);
+   if (Args->Connection >= 0)
+      close(Args->Connection);
+   sprintf(Path, "%.*s%s", BUFFER_DIM / 2, Prefix, ControlSocketName);
+   if (openControl(Path, Error)) {
+      free(Args);
+      releaseMemory(sizeof(control_args), MEMORY_OTHER);
+      Args = NULL;
+      fprintf(DocFile, "# Control socket not available (%s): the branch goes on without it.\n\n", Error);
+   }
+#endif
+}
+
+
+/*--------------*
+ *  endControl  *
+ *--------------*/
+
+/**
+ *  Stops the thread serving the control socket and removes
+ *  the socket.
+ */
+
+void endControl ()
+{
+   if (Args != NULL) {
+#ifndef _WIN32
+      storeRelease(&Args->Stop, 1);
+      pthread_join(Controller, NULL);
+      close(Args->Socket);
+      unlink(Args->Path);
+#endif
+      free(Args);
+      releaseMemory(sizeof(control_args), MEMORY_OTHER);
+      Args = NULL;
+   }
+
+   if (LastSpikeTotal != NULL) {
+      free(LastSpikeTotal);
+      releaseMemory(sizeof(long) * NumPopulations, MEMORY_OTHER);
+      LastSpikeTotal = NULL;
+   }
+}
+
+
+
+#undef storeRelease
+#undef loadAcquire
+#undef REQUEST_DONE
+#undef REQUEST_POSTED
+#undef REQUEST_EMPTY
+#undef CONTROL_SLEEP
+#undef CONTROL_POLL
+#undef REPLY_DIM
+#undef BUFFER_DIM
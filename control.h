@@ -0,0 +1,94 @@
+/*
+ *
+ *   control.h
+ *
+ *   Library of the control socket, steering a running
+ *   simulation. A thread listens on the Unix-domain socket
+ *   ControlSocket and hands each line received to the
+ *   simulation through a single-slot mailbox, with no locks:
+ *   the simulation serves it when it reads the commands (see
+ *   readCommands) and the thread sends back the one-line reply.
+ *   A line is either a command of the protocol, whose time is
+ *   relative to the present one, or one of:
+ *
+ *      TIME                  network time and life time in ms;
+ *      RATES                 rates of the populations in Hz
+ *                            since the previous RATES;
+ *      MEMORY                memory allocated in bytes, its peak
+ *                            and <area>=<bytes> of each area;
+ *      STATUS                time, pending events and pause;
+ *      PAUSE / RESUME        stops and restarts the evolution;
+ *      FLUSH                 flushes the log files;
+ *      CHECKPOINT [<file>]   saves the state at once;
+ *      QUIT                  ends the simulation.
+ *
+ *   The replies start with "OK" or "ERROR". The socket is
+ *   removed at the end of the run.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __CONTROL_H__
+#define __CONTROL_H__
+
+
+
+#include "types.h"
+#include "perseo.h"
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL char *ControlSocketName; /* Path of the control socket (empty for none). */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Opens the control socket and starts the thread serving
+ *  it, if ControlSocketName is not empty. If the socket
+ *  cannot be opened, the run goes on without it and the
+ *  reason is reported in LogFile.
+ */
+
+void startControl ();
+
+
+/**
+ *  Serves the request received on the control socket, if
+ *  any, at the network time <Time>. While the simulation is
+ *  paused, it waits here serving the following requests.
+ */
+
+void serveControl (double Time);
+
+
+/**
+ *  In a process forked by the simulation, closes the socket
+ *  of the parent and opens a new one, with <Prefix> in front
+ *  of its name.
+ */
+
+void forkControl (char *Prefix);
+
+
+/**
+ *  Stops the thread serving the control socket and removes
+ *  the socket.
+ */
+
+void endControl ();
+
+
+
+#endif /* __CONTROL_H__ */
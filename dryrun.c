@@ -0,0 +1,210 @@
+/*
+ *
+ *   dryrun.c
+ *
+ *   Pre-flight estimate of a simulation (perseo --dry-run):
+ *   from the definitions of the populations and of the
+ *   connectivity only, without building the network, it
+ *   reports the expected synapses per connectivity block
+ *   and per delay layer, the memory that the synaptic
+ *   matrix, its construction, the spike queues and the
+ *   output buffers will take, and the events per second
+ *   of network time. A scheduler can read it
+ *   to size or reject a run in a few milliseconds.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "nalib.h"
+#include "sortedqueue.h"
+
+#include "types.h"
+#include "perseo.h"
+#include "modules.h"
+#include "neurons.h"
+#include "connectivity.h"
+#include "delays.h"
+#include "events.h"
+#include "results.h"
+#include "dryrun.h"
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+PERSEO_LOCAL boolean DryRun = false; /* If true only the estimate is done (--dry-run). */
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL real DryRunRate = 10.0; /* Emission rate of the neurons in Hz assumed when their population gives none. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------------*
+ *  populationRate  *
+ *------------------*/
+
+/**
+ *  Emission rate in Hz assumed for the neurons of the
+ *  population <a>: the rate NuExt of its external neurons,
+ *  which the neurons of a balanced network reproduce, or
+ *  DryRunRate if the definition gives no rate.
+ */
+
+static double populationRate(int a)
+{
+   return Populations[a].NuExt > 0.0 ? Populations[a].NuExt : DryRunRate;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*----------*
+ *  dryRun  *
+ *----------*/
+
+/**
+ *  Writes on <File> the estimate of the network defined by
+ *  the parameters, the populations and the connectivity
+ *  already read. Returns 1 if the estimated peak of memory
+ *  exceeds the physical memory of the host, 0 otherwise.
+ */
+
+int dryRun(FILE *File)
+{
+   connectivity *c;
+   double *LayerSynapses; /* Expected synapses per delay layer. */
+   double S, q, d, BlockExceptions;
+   double Synapses = 0.0, Exceptions = 0.0, Payload = 0.0, External = 0.0;
+   double Emitted = 0.0, Delivered = 0.0; /* Spikes per second emitted by the neurons and delivered by the synapses. */
+   double Neu, Indices, Support, Mask = 0.0, Queues = 0.0, Events, Output, Peak, Physical = 0.0;
+   indexn SynNum, MaxDendSize = 0;
+   int a, b, l, FixedNum;
+
+   /*** The layers are those of initSynapticMatrix. ***/
+   setDelayBounds();
+   LayerSynapses = (double *)getMemory(sizeof(double) * DelayNumber, "ERROR (dryRun): Out of memory.");
+   for (l=0; l<DelayNumber; l++)
+      LayerSynapses[l] = 0.0;
+   FixedNum = strcmp(SynapticExtractionType, SET_FIX) == 0;
+
+   fprintf(File, "# DRYRUN Neurons %" PRIindexn "\n", NumNeurons);
+   fprintf(File, "# DRYRUN Populations %d\n", NumPopulations);
+   fprintf(File, "# DRYRUN Blocks %d\n", NumConnectivityArray);
+   fprintf(File, "# DRYRUN Layers %d\n", DelayNumber);
+
+   /*** Expected synapses of each block and their share in each layer: ***
+    *** a synapse is an exception if the MAX_DISTANCE neurons preceding ***
+    *** it on the layer have no synapse from the same neuron.           ***/
+   for (a=0; a<NumPopulations; a++) {
+      External += (double)Populations[a].N * Populations[a].CExt * Populations[a].NuExt;
+      Emitted += (double)Populations[a].N * populationRate(a);
+      for (b=0; b<NumPopulations; b++) {
+         if ((c = Connectivity[a][b]) == NULL)
+            continue;
+         if (FixedNum) {
+            SynNum = c->CProb > 0.0 ? roundr2i(Populations[b].N * c->CProb) : 0;
+            if (MaxDendSize < SynNum)
+               MaxDendSize = SynNum;
+            S = (double)Populations[a].N * SynNum;
+         } else
+            S = c->CProb > 0.0 ? (double)Populations[a].N * Populations[b].N * (c->CProb < 1.0 ? c->CProb : 1.0) : 0.0;
+         d = S / ((double)Populations[a].N * Populations[b].N);
+
+         BlockExceptions = 0.0;
+         for (l=0; l<DelayNumber; l++)
+            if ((q = (*getDelayProbability)(c, l)) > 0.0) {
+               LayerSynapses[l] += S * q;
+               BlockExceptions += S * q * pow(1.0 - d * q, MAX_DISTANCE);
+            }
+         fprintf(File, "# DRYRUN Block %d %d %.0f %d %.0f\n", a, b, S, c->SynapseSize, BlockExceptions);
+
+         Synapses += S;
+         Delivered += S * populationRate(b);
+         Exceptions += BlockExceptions;
+         Payload += S * c->SynapseSize;
+      }
+   }
+   for (l=0; l<DelayNumber; l++)
+      fprintf(File, "# DRYRUN Layer %d %g %.0f %.4f\n", l, DelayMin + DelayStep * l, LayerSynapses[l],
+              Synapses > 0.0 ? LayerSynapses[l] / Synapses : 0.0);
+   fprintf(File, "# DRYRUN Synapses %.0f\n", Synapses);
+   fprintf(File, "# DRYRUN SynapsesPerNeuron %.1f\n", NumNeurons > 0 ? Synapses / NumNeurons : 0.0);
+   fprintf(File, "# DRYRUN Exceptions %.0f\n", Exceptions);
+
+   /*** Memory of the network, as allocated by createPopulations ***
+    *** and createSynapticMatrix, on top of the one already taken ***
+    *** by the definitions (populations and tables).              ***/
+   Neu = (double)NumNeurons * (sizeof(neuron) + sizeof(real) * NumNeuronVariables);
+   Indices = (double)DelayNumber * (sizeof(synaptic_layer) + (double)NumNeurons * sizeof(axon_segment))
+           + (NumNeurons / 8 + 1) + Synapses * sizeof(byte) + Exceptions * sizeof(indexn);
+   Support = (double)DelayNumber * (sizeof(axon_segment) + 2 * sizeof(indexn) + sizeof(int)
+           + (double)NumNeurons * (sizeof(byte) + sizeof(indexn)));
+   if (FixedNum)
+      Mask = (double)MaxDendSize * (sizeof(indexn *) + (double)NumNeurons * sizeof(indexn))
+           + (MaxDendSize + 1.0) * sizeof(double) + (double)NumNeurons * sizeof(indexn)
+           + (double)NumPopulations * sizeof(indexn);
+
+   /*** The queue of a layer holds the spikes emitted in its delay, ***
+    *** each population at its own rate, the pending events are    ***
+    *** the samplings of the rates (those of the protocol are read ***
+    *** as their time comes) and the output streams take their     ***
+    *** rings and their file buffers.                              ***/
+   for (l=0; l<DelayNumber; l++)
+      Queues += sizeof(spike) * (Emitted * (DelayMin + DelayStep * l) / 1000.0 + 1.0);
+   Events = RatesResults ? sizeof(event) + sizeof(double) + sizeof(avl_tree) : 0.0;
+   Output = outputFilesMemory();
+   Peak = MemoryAmount + Neu + Indices + Payload + Support + Mask + Queues + Events + Output;
+
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_NEURONS], Neu);
+   fprintf(File, "# DRYRUN Memory %s %" PRIu64 "\n", MemoryAreaNames[MEMORY_POPULATIONS], MemoryUsage[MEMORY_POPULATIONS].Bytes);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_INDICES], Indices);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_SYNAPSES], Payload);
+   fprintf(File, "# DRYRUN Memory %s %" PRIu64 "\n", MemoryAreaNames[MEMORY_TABLES], MemoryUsage[MEMORY_TABLES].Bytes);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_QUEUES], Queues);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_EVENTS], Events);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_OUTPUT], Output);
+   fprintf(File, "# DRYRUN Memory %s %.0f\n", MemoryAreaNames[MEMORY_BUILD], Support + Mask);
+   fprintf(File, "# DRYRUN MemoryBuildMask %.0f\n", Mask);
+   fprintf(File, "# DRYRUN MemoryPeak %.0f\n", Peak);
+#ifndef _WIN32
+   Physical = (double)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+   fprintf(File, "# DRYRUN PhysicalMemory %.0f\n", Physical);
+#endif
+
+   /*** Events per second of network time. ***/
+   for (a=0; a<NumPopulations; a++)
+      fprintf(File, "# DRYRUN PopulationRate %d %g Hz\n", a, populationRate(a));
+   fprintf(File, "# DRYRUN EmissionRate %g Hz\n", NumNeurons > 0 ? Emitted / NumNeurons : 0.0);
+   fprintf(File, "# DRYRUN ExternalSpikesPerSecond %.6g\n", External);
+   fprintf(File, "# DRYRUN EmittedSpikesPerSecond %.6g\n", Emitted);
+   fprintf(File, "# DRYRUN QueuedSpikesPerSecond %.6g\n", Emitted * DelayNumber);
+   fprintf(File, "# DRYRUN SynapsesDeliveredPerSecond %.6g\n", Delivered);
+   fflush(File);
+
+   free(LayerSynapses);
+   releaseMemory(sizeof(double) * DelayNumber, MEMORY_OTHER);
+
+   return Physical > 0.0 && Peak > Physical;
+}
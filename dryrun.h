@@ -0,0 +1,85 @@
+/*
+ *
+ *   dryrun.h
+ *
+ *   Pre-flight estimate of a simulation (perseo --dry-run):
+ *   from the definitions of the populations and of the
+ *   connectivity only, without building the network, it
+ *   reports the expected synapses per connectivity block
+ *   and per delay layer, the memory that the synaptic
+ *   matrix, its construction, the spike queues and the
+ *   output buffers will take, and the events per second
+ *   of network time. A scheduler can read it
+ *   to size or reject a run in a few milliseconds.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __DRYRUN_H__
+#define __DRYRUN_H__
+
+
+
+#include <stdio.h>
+
+#include "types.h"
+#include "invar.h"
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+extern PERSEO_LOCAL boolean DryRun; /* If true only the estimate is done (--dry-run). */
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL real DryRunRate; /* Emission rate of the neurons in Hz assumed when their population gives none. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Writes on <File> the estimate of the network defined by
+ *  the parameters, the populations and the connectivity
+ *  already read (see initParameters), on lines
+ *  "# DRYRUN <Name> <Values...>" to be easily parsed:
+ *
+ *   - Block <post> <pre> <synapses> <bytes per synapse> <exceptions>
+ *     for each connectivity block;
+ *   - Layer <l> <delay> <synapses> <fraction> for each delay layer;
+ *   - Memory <Area> <bytes> for the areas of memusage.h that
+ *     the network takes, MemoryBuild the peak scratch of the
+ *     construction of the synaptic matrix and MemoryPeak the
+ *     peak of the whole allocation;
+ *   - PopulationRate <a> <rate> the emission rate assumed for
+ *     each population, EmissionRate their mean over the neurons,
+ *     and the external, emitted, queued and delivered spikes
+ *     per second.
+ *
+ *  The synapses are the expected ones (N_pre N_post c with
+ *  RANDOM extraction) and the exceptions of the addressing
+ *  are estimated as the synapses farther than MAX_DISTANCE
+ *  from the preceding one on a layer. The neurons of each
+ *  population emit at its external rate NuExt, or at
+ *  DryRunRate if the population gives none. The queue of a
+ *  layer holds the spikes emitted in its delay, the
+ *  output streams enabled by the parameters take their rings
+ *  (with AsyncOutput) and their file buffers, and the events
+ *  are the pending samplings of the rates. The events of the
+ *  protocol and the buffer of the checkpoints are left out.
+ *  Returns 1 if MemoryPeak exceeds the physical memory of
+ *  the host, 0 otherwise.
+ */
+
+int dryRun(FILE *File);
+
+
+
+#endif /* __DRYRUN_H__ */
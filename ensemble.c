@@ -0,0 +1,375 @@
+/*
+ *
+ *   ensemble.c
+ *
+ *   Library of functions to run an ensemble of simulations
+ *   sharing the same network, built only once. Each member
+ *   is a forked process with its own neuronal seed, command
+ *   file and output directory, while the synapses it never
+ *   changes (the fixed ones) stay shared copy-on-write.
+ *   A running simulation can also branch in forked processes
+ *   going on with different commands (BRANCH command).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#endif
+
+#include "types.h"
+#include "invar.h"
+
+#include "perseo.h"
+#include "init.h"
+#include "results.h"
+#include "commands.h"
+#include "checkpoint.h"
+#include "events.h"
+#include "ensemble.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "control.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM          256 /* Maximum static string size in the module. */
+#define MAX_BRANCHES        256 /* Maximum number of branches forked by a process. */
+#define CONSOLE_FILE "console.txt" /* File receiving the stderr of a member or a branch. */
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL int          EnsembleSize = 0;            /* Number of members of the ensemble (0 for a single simulation). */
+PERSEO_LOCAL int          EnsembleJobs = 0;            /* Maximum number of members running at once (0 for the number of cores). */
+PERSEO_LOCAL char   *EnsembleDirectory = "member%d";   /* Output directory of a member, formatted with its index. */
+PERSEO_LOCAL char *EnsembleCommandFile = EMPTY_STRING; /* Command file of a member, formatted with its index. */
+
+
+
+#ifndef _WIN32
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL pid_t *Members = NULL; /* Process of each launched member. */
+static PERSEO_LOCAL int    Running = 0;    /* Number of members running. */
+static PERSEO_LOCAL int     Failed = 0;    /* Number of members ended with an error. */
+
+static PERSEO_LOCAL pid_t Branches[MAX_BRANCHES]; /* Process of each forked branch. */
+static PERSEO_LOCAL int      NumBranches = 0;     /* Number of forked branches. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-------------*
+ *  runMember  *
+ *-------------*/
+
+/**
+ *  Runs the simulation of the member <k> in the forked
+ *  process, ending it.
+ */
+
+static void runMember (int k)
+{
+   static PERSEO_LOCAL char CommandFile[BUFFER_DIM];
+   char Buffer[BUFFER_DIM];
+
+   /*** The commands are read from the directory of the parent. ***/
+   if (isDefined("ENSEMBLECOMMANDFILE")) {
+      sprintf(CommandFile, EnsembleCommandFile, k);
+      CommandsFileName = CommandFile;
+   }
+   readCommands(NULL);
+
+   /*** The log files are written in the directory of the member. ***/
+   sprintf(Buffer, EnsembleDirectory, k);
+   mkdir(Buffer, 0777);
+   if (chdir(Buffer) != 0) {
+      sprintf(Buffer, "unable to enter the directory of the member %d.", k);
+      printFatalError("runMember", Buffer);
+   }
+   if (freopen(CONSOLE_FILE, "wt", stderr) == NULL)
+      exit(EXIT_FAILURE);
+   fclose(DocFile);
+   openOutputFiles();
+   fprintf(DocFile, "# Ensemble member %d of %d.\n", k, EnsembleSize);
+   fprintf(DocFile, "# Synaptic Seed: %i\n", SynapsesSeed);
+   resetNeurons(NeuronsSeed + k);
+
+   attachObservers();
+   simulation();
+   closeOutputFiles();
+   waitBranches();
+   waitExternalCommands();
+
+   exit(QuitSimulation ? EXIT_FAILURE : 0);
+}
+
+
+/*--------------*
+ *  waitMember  *
+ *--------------*/
+
+/**
+ *  Waits for the end of a running member, and reports its
+ *  outcome in DocFile.
+ */
+
+static void waitMember (int NumMembers) /* Number of launched members. */
+{
+   pid_t Pid;
+   int Status, k;
+
+   if ((Pid = wait(&Status)) < 0) {
+      if (errno != EINTR)
+         Running = 0; // No more children to wait.
+      return;
+   }
+   Running--;
+
+   for (k=0; k<NumMembers; k++)
+      if (Members[k] == Pid)
+         break;
+   if (k == NumMembers)
+      return;
+
+   if (WIFEXITED(Status) && WEXITSTATUS(Status) == 0)
+      fprintf(DocFile, "# Member %d (Neuronal Seed: %i) completed.\n", k, NeuronsSeed + k);
+   else {
+      fprintf(DocFile, "# Member %d (Neuronal Seed: %i) failed.\n", k, NeuronsSeed + k);
+      Failed++;
+   }
+   fflush(DocFile);
+
+#ifdef PRINT_STATUS
+   fprintf(stderr, "Ensemble member %d ended (%d running).\n", k, Running);
+#endif
+}
+
+
+/*-------------*
+ *  runBranch  *
+ *-------------*/
+
+/**
+ *  Prepares the forked process of the branch at <Time> to go
+ *  on with the commands in <FileName> and the log files named
+ *  with <Prefix> in front.
+ */
+
+static void runBranch (double     Time, /* Time of the branch. */
+                       char    *Prefix, /* Prefix of the log files. */
+                       char  *FileName) /* Command file. */
+{
+   char Buffer[BUFFER_DIM];
+   char *Slash;
+
+   NumBranches = 0; // The branches of the parent are not waited.
+
+   /*** The directory in the prefix, if any, is created. ***/
+   if ((Slash = strrchr(Prefix, '/')) != NULL) {
+      sprintf(Buffer, "%.*s", (int)(Slash - Prefix), Prefix);
+      mkdir(Buffer, 0777);
+   }
+   sprintf(Buffer, "%.*s%s", BUFFER_DIM - 12, Prefix, CONSOLE_FILE);
+   if (freopen(Buffer, "wt", stderr) == NULL)
+      exit(EXIT_FAILURE);
+
+   forkOutputFiles(Prefix);
+   forkCheckpoints(Prefix);
+   forkProfile(Prefix);
+   forkTelemetry(Prefix);
+   forkControl(Prefix);
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Branch '%s' at time %.7g ms, with the commands in '%s'.\n\n", Prefix, Time, FileName);
+   fflush(DocFile);
+
+   resumeCommands(FileName, Time);
+}
+
+#endif /* _WIN32 */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*---------------*
+ *  runEnsemble  *
+ *---------------*/
+
+/**
+ *  Builds the network and runs on it EnsembleSize simulations,
+ *  at most EnsembleJobs at once, each one in a forked process.
+ */
+
+void runEnsemble ()
+{
+#ifndef _WIN32
+   char Buffer[BUFFER_DIM];
+   pid_t Pid;
+   int k;
+
+   if (isRestarting())
+      printFatalError("runEnsemble", "a restart cannot be run as an ensemble.\n");
+   if (EnsembleJobs <= 0)
+      EnsembleJobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   if (EnsembleJobs <= 0)
+      EnsembleJobs = 1;
+
+   /*** The network shared by the members. ***/
+   openDocFile();
+   initNeuralNetwork();
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Ensemble of %d members, at most %d at once, in the directories '%s'.\n",
+           EnsembleSize, EnsembleJobs, EnsembleDirectory);
+   Members = getMemory(sizeof(pid_t) * EnsembleSize, "ERROR (runEnsemble): Out of memory.");
+
+   /*** Launches a member as soon as a slot is free. ***/
+   for (k=0; k<EnsembleSize && !pollInterrupt(); k++) {
+      while (Running >= EnsembleJobs)
+         waitMember(k);
+      fflush(DocFile);
+      fflush(stdout);
+      fflush(stderr);
+      if ((Pid = fork()) == 0)
+         runMember(k);
+      Members[k] = Pid;
+      if (Pid < 0) {
+         sprintf(Buffer, "unable to launch the member %d.", k);
+         printError("runEnsemble", Buffer);
+         Failed++;
+      } else
+         Running++;
+#ifdef PRINT_STATUS
+      if (Pid > 0)
+         fprintf(stderr, "\nEnsemble member %d launched (%d running).\n", k, Running);
+#endif
+   }
+   while (Running > 0)
+      waitMember(k);
+
+   fprintf(DocFile, "# %d members completed, %d failed.\n", k - Failed, Failed);
+   fclose(DocFile);
+   free(Members);
+   releaseMemory(sizeof(pid_t) * EnsembleSize, MEMORY_OTHER);
+#else
+   printFatalError("runEnsemble", "the ensembles need fork(), not available on this system.\n");
+#endif
+}
+
+
+
+/*----------------*
+ *  forkBranches  *
+ *----------------*/
+
+/**
+ *  Hook function of the BRANCH event: for each pair of prefix
+ *  and command file in Event->ParamStr forks a process going
+ *  on from the present state with those commands and log
+ *  files. The forking process goes on reading its command
+ *  file from the line following the BRANCH command.
+ */
+
+int forkBranches(event *Event)
+{
+   char   Prefix[BUFFER_DIM];
+   char FileName[BUFFER_DIM];
+   char  *Params;
+#ifndef _WIN32
+   char Buffer[BUFFER_DIM];
+   pid_t Pid;
+#endif
+   int Len;
+
+   flushOutputFiles();
+   fflush(stdout);
+   fflush(stderr);
+
+   for (Params = Event->ParamStr; sscanf(Params, "%s %s%n", Prefix, FileName, &Len) == 2; Params += Len) {
+#ifndef _WIN32
+      if (NumBranches == MAX_BRANCHES) {
+         printError("forkBranches", "too many branches.\n");
+         break;
+      }
+      if ((Pid = fork()) == 0) {
+         runBranch(Event->Time, Prefix, FileName);
+         return 1;
+      }
+      if (Pid < 0) {
+         sprintf(Buffer, "unable to fork the branch '%.*s'.\n", BUFFER_DIM - 40, Prefix);
+         printError("forkBranches", Buffer);
+         break;
+      }
+      Branches[NumBranches++] = Pid;
+      fprintf(DocFile, "# Branch '%s' forked at time %.7g ms, with the commands in '%s'.\n",
+              Prefix, Event->Time, FileName);
+      fflush(DocFile);
+#else
+      printError("forkBranches", "the branches need fork(), not available on this system.\n");
+      break;
+#endif
+   }
+
+   resumeCommands(NULL, Event->Time);
+
+   return 1;
+}
+
+
+/*----------------*
+ *  waitBranches  *
+ *----------------*/
+
+/**
+ *  Waits for the end of the branches forked by the process.
+ */
+
+void waitBranches ()
+{
+#ifndef _WIN32
+   int Status, k;
+
+   for (k=0; k<NumBranches; k++) {
+      Status = -1;
+      while (waitpid(Branches[k], &Status, 0) < 0 && errno == EINTR);
+#ifdef PRINT_STATUS
+      fprintf(stderr, "Branch %d %s.\n", k, WIFEXITED(Status) && WEXITSTATUS(Status) == 0 ? "completed" : "failed");
+#endif
+   }
+   NumBranches = 0;
+#endif
+}
+
+
+
+#undef CONSOLE_FILE
+#undef MAX_BRANCHES
+#undef BUFFER_DIM
@@ -0,0 +1,77 @@
+/*
+ *
+ *   ensemble.h
+ *
+ *   Library of functions to run an ensemble of simulations
+ *   sharing the same network, built only once. Each member
+ *   is a forked process with its own neuronal seed, command
+ *   file and output directory, while the synapses it never
+ *   changes (the fixed ones) stay shared copy-on-write.
+ *   A running simulation can also branch in forked processes
+ *   going on with different commands (BRANCH command).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __ENSEMBLE_H__
+#define __ENSEMBLE_H__
+
+
+
+#include "events.h"
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL int           EnsembleSize; /* Number of members of the ensemble (0 for a single simulation). */
+extern PERSEO_LOCAL int           EnsembleJobs; /* Maximum number of members running at once (0 for the number of cores). */
+extern PERSEO_LOCAL char    *EnsembleDirectory; /* Output directory of a member, formatted with its index. */
+extern PERSEO_LOCAL char  *EnsembleCommandFile; /* Command file of a member, formatted with its index. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Builds the network and runs on it EnsembleSize simulations,
+ *  at most EnsembleJobs at once. The member k uses the neuronal
+ *  seed NeuronsSeed + k, the command file EnsembleCommandFile
+ *  formatted with k (if set, otherwise CommandFile) and writes
+ *  its log files in the directory EnsembleDirectory formatted
+ *  with k. The outcome of each member is reported in LogFile.
+ *  It replaces the whole single simulation in main().
+ */
+
+void runEnsemble ();
+
+
+/**
+ *  Hook function of the BRANCH event: for each pair of prefix
+ *  and command file in Event->ParamStr forks a process going
+ *  on from the present state with the commands of the file
+ *  (see resumeCommands) and the log files named with the
+ *  prefix in front (see forkOutputFiles). The forking process
+ *  goes on reading its command file.
+ */
+
+int forkBranches(event *Event);
+
+
+/**
+ *  Waits for the end of the branches forked by the process.
+ */
+
+void waitBranches ();
+
+
+
+#endif /* __ENSEMBLE_H__ */
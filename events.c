@@ -1,191 +1,323 @@
-/*
- *
- *   events.c
- *
- *     Manages events arising during the life of the simulation
- *   like dumping of some information, start and stop composite 
- *   stimulation or updating parameters of the populations.
- *     The events are created by newEvent(). 
- *     During the simulation the function manageEvent() have to
- *   be called in order to verify if it is the time for an event.
- *
- *   Project: Perseo 2.1.x
- *
- */
-
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdarg.h>
-#include <string.h>
-
-#include "sortedqueue.h"
-#include "events.h"
-#include "perseo.h"
-
-
-
-/*-------------------*
- *  LOCAL VARIABLES  *
- *-------------------*/
-
-sorted_queue Events; /* The sorted queue containing the external commands sorted in time. */
-
-
-
-/*-------------------*
- *  LOCAL FUNCTIONS  *
- *-------------------*/
-
-
-/**
- *  Compare to events returning 1, 0 or -1 depending
- *  on if the time to manage Left event is greater, 
- *  equal or lower than the Right one.
- *  This function is used to define the metrics of
- *  the elements in the sorted queue storing the 
- *  events.
- */
-int cmpEvents(event *Left, event *Right)
-{
-   if ((*Left).Time < (*Right).Time)
-      return -1;
-   else
-      if ((*Left).Time > (*Right).Time)
-         return 1;
-   return 0;
-}
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/*--------------------*
- *  initEventManager  *
- *--------------------*/
-
-/**
- *  Initializes variables and structures needed to
- *  manage the events. It has to be launched before
- *  to use the other functions of this library.
- */
-
-void initEventManager()
-{
-   initSortedQueue(&Events, &cmpEvents);
-}
-
-
-/*------------*
- *  newEvent  *
- *------------*/
-
-/**
- *  Insert a new command in the event queue, which has to be
- *  managed at time <Time> using function <cmdFunc> with
- *  parameters variable in number.
- *  Returns the created event.
- */ 
-
-event *newEvent(double    Time, /* Time when the event will be managed. */
-                int (*cmdFunc)(event *),  /* Hook function managing the event. */
-                char *ParamStr, /* Optional string parameters. It may be NULL. */
-                int   ParamNum, /* Number of double parameters. */
-                ... )           /* double parameters, variable in number. */
-{
-   static event   *Event;
-   static va_list marker;
-   static int          k;
-
-   /*** Allocates memory. ***/
-   Event = getMemory(sizeof(event), "ERROR (newEvent): Out of memory (A).");
-   if (ParamNum > 0)
-      Event->Param = getMemory(sizeof(double) * ParamNum, "ERROR (newEvent): Out of memory (B).");
-   else
-      Event->Param = NULL;
-   if (ParamStr != NULL) {
-      Event->CharNum = strlen(ParamStr) + 1;
-      Event->ParamStr = getMemory(sizeof(char) * Event->CharNum, "ERROR (newEvent): Out of memory (C).");
-   } else {
-      Event->CharNum = 0;
-      Event->ParamStr = NULL;
-   }
-
-   /*** Sets the parameters of the event. ***/
-   Event->Time = Time;
-   Event->cmdFunc = cmdFunc;
-   Event->ParamNum = ParamNum;
-   va_start(marker, ParamNum);
-   for (k=0; k<ParamNum; k++)
-       Event->Param[k] = va_arg( marker, double);
-   va_end(marker);
-   if (ParamStr != NULL)
-      strcpy(Event->ParamStr, ParamStr);
-
-   /*** Appends the event to the queue. ***/
-   putSortedQueueItem(&Events, Event);
-
-   return Event;
-}
-
-
-/*------------*
- *  putEvent  *
- *------------*/
-
-/**
- *  Puts an existing and possibly updated event into the 
- *  event queue in order to allow the simulation to manage
- *  it at the time stored in the event structure.
- */ 
-
-void putEvent(event *Event)
-{
-   /*** Appends the event to the queue. ***/
-   putSortedQueueItem(&Events, Event);
-}
-
-
-/*---------------*
- *  deleteEvent  *
- *---------------*/
-
-/**
- *  Free the memory allocated for the event passed as parameter.
- */ 
-
-void deleteEvent(event *Event)
-{
-   free(Event->Param);
-   MemoryAmount -= sizeof(double) * Event->ParamNum;
-   if (Event->ParamStr != NULL) {
-      free(Event->ParamStr);
-      MemoryAmount -= Event->CharNum;
-   }
-   free(Event);
-   MemoryAmount -= sizeof(event);
-}
-
-
-/*---------------*
- *  manageEvent  *
- *---------------*/
-
-/**
- *  Manages all the events with time smaller than <Time>.
- */
-
-void manageEvent (double Time) /* Next actual time of the simulation. */
-{
-   static event *Event;
-   if (!isSortedQueueEmpty(&Events))
-      while (Time > ((event *)frontSortedQueueItem(&Events))->Time) {
-         Event = (event *)getSortedQueueItem(&Events);
-         if ((*(Event->cmdFunc))(Event))
-            deleteEvent(Event);
-         if (isSortedQueueEmpty(&Events)) break;
-      }
-}
\ No newline at end of file
+/*
+ *
+ *   events.c
+ *
+ *     Manages events arising during the life of the simulation
+ *   like dumping of some information, start and stop composite 
+ *   stimulation or updating parameters of the populations.
+ *     The events are created by newEvent(). 
+ *     During the simulation the function manageEvent() have to
+ *   be called in order to verify if it is the time for an event.
+ *
+ *   Project: Perseo 2.1.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "sortedqueue.h"
+#include "events.h"
+#include "perseo.h"
+#include "checkpoint.h"
+#include "profile.h"
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+PERSEO_LOCAL sorted_queue Events; /* The sorted queue containing the external commands sorted in time. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+
+/**
+ *  Compare to events returning 1, 0 or -1 depending
+ *  on if the time to manage Left event is greater, 
+ *  equal or lower than the Right one.
+ *  This function is used to define the metrics of
+ *  the elements in the sorted queue storing the 
+ *  events.
+ */
+int cmpEvents(event *Left, event *Right)
+{
+   if ((*Left).Time < (*Right).Time)
+      return -1;
+   else
+      if ((*Left).Time > (*Right).Time)
+         return 1;
+   return 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*--------------------*
+ *  initEventManager  *
+ *--------------------*/
+
+/**
+ *  Initializes variables and structures needed to
+ *  manage the events. It has to be launched before
+ *  to use the other functions of this library.
+ */
+
+void initEventManager()
+{
+   initSortedQueue(&Events, &cmpEvents);
+}
+
+
+/*------------*
+ *  newEvent  *
+ *------------*/
+
+/**
+ *  Insert a new command in the event queue, which has to be
+ *  managed at time <Time> using function <cmdFunc> with
+ *  parameters variable in number.
+ *  Returns the created event.
+ */ 
+
+event *newEvent(double    Time, /* Time when the event will be managed. */
+                int (*cmdFunc)(event *),  /* Hook function managing the event. */
+                char *ParamStr, /* Optional string parameters. It may be NULL. */
+                int   ParamNum, /* Number of double parameters. */
+                ... )           /* double parameters, variable in number. */
+{
+   event   *Event;
+   va_list marker;
+   int          k;
+
+   /*** Allocates memory. ***/
+   Event = getAreaMemory(sizeof(event), MEMORY_EVENTS, "ERROR (newEvent): Out of memory (A).");
+   if (ParamNum > 0)
+      Event->Param = getAreaMemory(sizeof(double) * ParamNum, MEMORY_EVENTS, "ERROR (newEvent): Out of memory (B).");
+   else
+      Event->Param = NULL;
+   if (ParamStr != NULL) {
+      Event->CharNum = strlen(ParamStr) + 1;
+      Event->ParamStr = getAreaMemory(sizeof(char) * Event->CharNum, MEMORY_EVENTS, "ERROR (newEvent): Out of memory (C).");
+   } else {
+      Event->CharNum = 0;
+      Event->ParamStr = NULL;
+   }
+
+   /*** Sets the parameters of the event. ***/
+   Event->Time = Time;
+   Event->cmdFunc = cmdFunc;
+   Event->ParamNum = ParamNum;
+   va_start(marker, ParamNum);
+   for (k=0; k<ParamNum; k++)
+       Event->Param[k] = va_arg( marker, double);
+   va_end(marker);
+   if (ParamStr != NULL)
+      strcpy(Event->ParamStr, ParamStr);
+
+   /*** Appends the event to the queue. ***/
+   putSortedQueueItem(&Events, Event);
+
+   return Event;
+}
+
+
+/*------------*
+ *  putEvent  *
+ *------------*/
+
+/**
+ *  Puts an existing and possibly updated event into the 
+ *  event queue in order to allow the simulation to manage
+ *  it at the time stored in the event structure.
+ */ 
+
+void putEvent(event *Event)
+{
+   /*** Appends the event to the queue. ***/
+   putSortedQueueItem(&Events, Event);
+}
+
+
+/*---------------*
+ *  deleteEvent  *
+ *---------------*/
+
+/**
+ *  Free the memory allocated for the event passed as parameter.
+ */ 
+
+void deleteEvent(event *Event)
+{
+   free(Event->Param);
+   releaseMemory(sizeof(double) * Event->ParamNum, MEMORY_EVENTS);
+   if (Event->ParamStr != NULL) {
+      free(Event->ParamStr);
+      releaseMemory(Event->CharNum, MEMORY_EVENTS);
+   }
+   free(Event);
+   releaseMemory(sizeof(event), MEMORY_EVENTS);
+}
+
+
+/*---------------*
+ *  manageEvent  *
+ *---------------*/
+
+/**
+ *  Manages all the events with time smaller than <Time>.
+ */
+
+void manageEvent (double Time) /* Next actual time of the simulation. */
+{
+   event *Event;
+   if (!isSortedQueueEmpty(&Events))
+      while (Time > ((event *)frontSortedQueueItem(&Events))->Time) {
+         Event = (event *)getSortedQueueItem(&Events);
+         profileCount(ManagedEvents, 1);
+         if ((*(Event->cmdFunc))(Event))
+            deleteEvent(Event);
+         if (isSortedQueueEmpty(&Events)) break;
+      }
+}
+
+
+/*-----------------*
+ *  pendingEvents  *
+ *-----------------*/
+
+/**
+ *  Returns the number of events in the queue.
+ */
+
+int pendingEvents ()
+{
+   return sortedQueueSize(&Events);
+}
+
+
+/*-----------------*
+ *  releaseEvents  *
+ *-----------------*/
+
+/**
+ *  Deletes the events waiting in the queue, leaving it empty.
+ */
+
+void releaseEvents ()
+{
+   while (!isSortedQueueEmpty(&Events))
+      deleteEvent((event *)getSortedQueueItem(&Events));
+}
+
+
+/*--------------------*
+ *  checkpointEvents  *
+ *--------------------*/
+
+/**
+ *  Writes on <File> the events in the queue, in the order
+ *  they will be managed. The queue is emptied and filled
+ *  again in the same order, which is kept also for events
+ *  with the same time, being put after the ones already
+ *  in the queue. Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointEvents(FILE            *File, /* Checkpoint file. */
+                     event_func *Handlers, /* Known hook functions. */
+                     int      NumHandlers) /* Length of Handlers. */
+{
+   event **List;
+   event     *e;
+   int  Error = 0;
+   int k, h, n;
+
+   n = sortedQueueSize(&Events);
+   List = getAreaMemory(sizeof(event *) * (n + 1), MEMORY_EVENTS, "ERROR (checkpointEvents): Out of memory.");
+   for (k=0; k<n; k++)
+      List[k] = (event *)getSortedQueueItem(&Events);
+
+   Error = writeCheckpointData(File, &n, sizeof(n));
+   for (k=0; k<n && !Error; k++) {
+      e = List[k];
+      for (h=0; h<NumHandlers; h++)
+         if (Handlers[h] == e->cmdFunc)
+            break;
+      Error = h == NumHandlers ||
+              writeCheckpointData(File, &h, sizeof(h)) ||
+              writeCheckpointData(File, &(e->Time), sizeof(e->Time)) ||
+              writeCheckpointData(File, &(e->ParamNum), sizeof(e->ParamNum)) ||
+              writeCheckpointData(File, e->Param, sizeof(double) * e->ParamNum) ||
+              writeCheckpointData(File, &(e->CharNum), sizeof(e->CharNum)) ||
+              writeCheckpointData(File, e->ParamStr, e->CharNum);
+   }
+
+   for (k=0; k<n; k++)
+      putSortedQueueItem(&Events, List[k]);
+   free(List);
+   releaseMemory(sizeof(event *) * (n + 1), MEMORY_EVENTS);
+
+   return Error;
+}
+
+
+/*-----------------*
+ *  restoreEvents  *
+ *-----------------*/
+
+/**
+ *  Replaces the events in the queue with the ones written
+ *  on <File> by checkpointEvents.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int restoreEvents(FILE            *File, /* Checkpoint file. */
+                  event_func *Handlers, /* Known hook functions. */
+                  int      NumHandlers) /* Length of Handlers. */
+{
+   event *e;
+   int k, h, n;
+
+   while (!isSortedQueueEmpty(&Events))
+      deleteEvent((event *)getSortedQueueItem(&Events));
+
+   if (readCheckpointData(File, &n, sizeof(n)))
+      return 1;
+   for (k=0; k<n; k++) {
+      e = getAreaMemory(sizeof(event), MEMORY_EVENTS, "ERROR (restoreEvents): Out of memory (A).");
+      e->Param = NULL;
+      e->ParamStr = NULL;
+      if (readCheckpointData(File, &h, sizeof(h)) || h < 0 || h >= NumHandlers ||
+          readCheckpointData(File, &(e->Time), sizeof(e->Time)) ||
+          readCheckpointData(File, &(e->ParamNum), sizeof(e->ParamNum)) || e->ParamNum < 0)
+         return 1;
+      e->cmdFunc = Handlers[h];
+      if (e->ParamNum > 0) {
+         e->Param = getAreaMemory(sizeof(double) * e->ParamNum, MEMORY_EVENTS, "ERROR (restoreEvents): Out of memory (B).");
+         if (readCheckpointData(File, e->Param, sizeof(double) * e->ParamNum))
+            return 1;
+      }
+      if (readCheckpointData(File, &(e->CharNum), sizeof(e->CharNum)) || e->CharNum < 0)
+         return 1;
+      if (e->CharNum > 0) {
+         e->ParamStr = getAreaMemory(sizeof(char) * e->CharNum, MEMORY_EVENTS, "ERROR (restoreEvents): Out of memory (C).");
+         if (readCheckpointData(File, e->ParamStr, e->CharNum))
+            return 1;
+      }
+      putEvent(e);
+   }
+
+   return 0;
+}
@@ -1,410 +1,649 @@
-/*
- *
- *   init.h
- *
- *   Library of functions to read definition files to 
- *   initialize the data structures needed to the simulation
- *
- *   Project: PERSEO 2.x
- *
- */
-
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <signal.h>
-#include <math.h>
-
-#include "invar.h"
-#include "randdev.h"
-
-#include "types.h"
-#include "perseo.h"
-#include "results.h"
-#include "stimuli.h"
-#include "init.h"
-#include "events.h"
-#include "modules.h"
-#include "neurons.h"
-#include "connectivity.h"
-#include "synapses.h"
-#include "delays.h"
-#include "commands.h"
-
-
-
-/*---------------------*
- *  LOCAL DEFINITIONS  *
- *---------------------*/
-
-#define BUFFER_DIM 256 /* Maximum static string size in the module. */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/*---------------*
- *  initNeurons  *
- *---------------*/
-
-/**
- *   Initialize the array of all neurons in the 
- *   network. It is defined in <modules.c>.
- */
-
-void initNeurons (void)
-{
-   indexn i;
-
-#ifdef PRINT_STATUS
-   fprintf(stderr, "\nInitializing Neurons... ");
-#endif
-
-   /*** Initialize the seed of pseudorandom number generator. ***/
-   if (isDefined("NEURONSSEED"))
-      SetRandomSeed(NeuronsSeed);
-   else
-      Randomize();
-   NeuronsSeed = GetRandomSeed();
-   fprintf(DocFile, "# Neuronal Seed: %i\n", NeuronsSeed);
-   fflush(DocFile);
-
-   /*** Initialize the state variables of the neurons. ***/
-   if ((*initNeuronVariables)())
-      printFatalError("initNeurons", "Initialization type for neuron state variables unknown.");
-
-   /*** Initializations of the other fixed neuron fields (Tr, Te, LastUpdate). ***/
-   for (i=0; i<NumNeurons; i++) {
-      doubleToTimex(START_TIME_OFFSET, Neurons[i].Tr);
-	   doubleToTimex(START_TIME_OFFSET-Life, Neurons[i].Te);
-	   doubleToTimex(START_TIME_OFFSET, Neurons[i].LastUpdate);
-   }
-
-#ifdef PRINT_STATUS
-    fprintf(stderr, "100.0%% (Memory: %g Mbytes)\r", (real)MemoryAmount/1024.0/1024.0);
-#endif
-}
-
-
-/*----------------------*
- *  initSynapticMatrix  *
- *----------------------*/
-
-/**
- *  Allocates memory for the synaptic matrix creating
- *  random connectivity and initializing the state of 
- *  the synapses.
- */
-
-void initSynapticMatrix (void)
-
-{
-   /*** Initialize the seed of pseudorandom number generator. ***/
-   if (isDefined("SYNAPSESSEED"))
-      SetRandomSeed(SynapsesSeed);
-   else
-      Randomize();
-   SynapsesSeed = GetRandomSeed();
-   fprintf(DocFile, "# Synaptic Seed: %i\n", SynapsesSeed);
-   fflush(DocFile);
-
-   /*** Sets the bounds of the delay distribution. ***/
-   setDelayBounds();
-
-   /*** Creates and fills the synaptic matrix. ***/
-   createSynapticMatrix();
-
-   /*** Initialized the state variables of the synapses. ***/
-   scanSynapticMatrix (0, NumNeurons-1, 0, NumNeurons-1, &initSynapseState);
-}
-
-
-/*---------------------*
- *  initNeuralNetwork  *
- *---------------------*/
-
-/**
- *  Allocates memory for and initializes the structures hosting 
- *  data necessary to the simulation (populations, connectivity,
- *  neurons and synapses).
- */
-
-void initNeuralNetwork (void)
-
-{
-   /*** Interrupt management... ***/
-   signal(SIGINT, interruptSimulation);
-   signal(SIGTERM, interruptSimulation);
-
-   /*** Populations initialization... ***/
-   createPopulations();
-
-   /*** Neurons initialization... ***/
-   initNeurons();
-
-   /*** Synapses initialization... ***/
-   initSynapticMatrix();
-}
-
-
-/*------------------*
- *  initParameters  *
- *------------------*/
-
-/**
- *   Declaration and definition of the simulation parameters.
- */
-
-void initParameters (int ArgC, char * ArgV[])
-
-{
-   IVinteger i[100];
-   IVinteger b[100];
-   IVreal    r[100];
-   char sError[BUFFER_DIM];
-
-   /*** List of declarations. ***/
-   addStringVariable  ("NEURONTYPE", &NeuronType, false);
-
-   addStringVariable  ("MODULEFILE", &ModulesFileName, false);
-
-   addStringVariable  ("DELAYDISTRIBTYPE", &DelayDistribType, false);
-   addIntegerVariable ("DELAYNUMBER", &i[1], 1, INT_MAX, false);
-
-   addStringVariable  ("SYNAPTICEXTRACTIONTYPE", &SynapticExtractionType, true);
-   
-   addStringVariable  ("CONNECTIVITYFILE", &ConnectivityFileName, false);
-
-   addStringVariable  ("LOGFILE", &DocFileName, true);
-
-   addRealVariable    ("LIFE", &r[0], 0, (IVreal)1e37, false);
-
-   addIntegerVariable ("NEURONSSEED", &i[2], -INT_MAX, INT_MAX, true);
-   addIntegerVariable ("SYNAPSESSEED", &i[3], -INT_MAX, INT_MAX, true);
-
-   addStringVariable  ("COMMANDFILE", &CommandsFileName, true);
-
-   addBooleanVariable ("OUTRATES", &b[0], true);
-   addStringVariable  ("RATESFILE", &RatesFileName, true);
-   addRealVariable    ("RATESSAMPLING", &r[23], (IVreal)1e-37, (IVreal)1e37, true);
-   addRealVariable    ("STARTTIME", &r[24], (IVreal)-1e37, (IVreal)1e37, true);
-
-   addBooleanVariable ("OUTSYNAPSES", &b[1], true);
-   addStringVariable  ("SYNAPSESFILE", &SynapsesFileName, true);
-   addIntegerVariable ("PRESTART", &i[5], 0, INT_MAX, true);
-   addIntegerVariable ("PREEND", &i[6], 0, INT_MAX, true);
-   addIntegerVariable ("POSTSTART", &i[7], 0, INT_MAX, true);
-   addIntegerVariable ("POSTEND", &i[8], 0, INT_MAX, true);
-
-   addBooleanVariable ("OUTSPIKES", &b[2], true);
-   addStringVariable  ("SPIKESFILE", &SpikesFileName, true);
-   addIntegerVariable ("NEURONSTART", &i[9], 0, INT_MAX, true);
-   addIntegerVariable ("NEURONEND", &i[10], 0, INT_MAX, true);
-
-   addBooleanVariable ("OUTSYNSTATE", &b[3], true);
-   addStringVariable  ("SYNSTATEFILE", &SynStateFileName, true);
-   addIntegerVariable ("SSPRESTART", &i[11], 0, INT_MAX, true);
-   addIntegerVariable ("SSPREEND", &i[12], 0, INT_MAX, true);
-   addIntegerVariable ("SSPOSTSTART", &i[13], 0, INT_MAX, true);
-   addIntegerVariable ("SSPOSTEND", &i[14], 0, INT_MAX, true);
-
-   addBooleanVariable ("OUTNEUSTATE", &b[4], true);
-   addStringVariable  ("NEUSTATEFILE", &NeuStateFileName, true);
-   addIntegerVariable ("NSSTART", &i[15], 0, INT_MAX, true);
-   addIntegerVariable ("NSEND", &i[16], 0, INT_MAX, true);
-
-   addBooleanVariable ("OUTSYNTRANS", &b[5], true);
-   addStringVariable  ("SYNTRANSFILE", &SynTransFileName, true);
-   addRealVariable    ("SYNTRANSSAMPLING", &r[45], (IVreal)1e-37, (IVreal)1e37, true);
-
-   addBooleanVariable ("OUTSYNSTRUCT", &b[6], true);
-   addStringVariable  ("SYNSTRUCTFILE", &SynStructFileName, true);
-
-   addBooleanVariable ("OUTSYNDETTRANS", &b[7], true);
-   addStringVariable  ("SYNDETTRANSFILE", &detailSynTransFileName, true);
-
-   addBooleanVariable ("OUTAFFCURR", &b[8], true);
-   addStringVariable  ("AFFCURRFILE", &CurrentFileName, true);
-   addRealVariable    ("AFFCURRSAMPLING", &r[46], (IVreal)1e-37, (IVreal)1e37, true);
-   addIntegerVariable ("ACNEURON", &i[17], 0, INT_MAX, true);
-
-   /*** Declaration of parameters and error parsing. ***/
-   if (readDefinitionFile(INIT_FILE)) exit(1);
-   if (readCommandLineDefinition(ArgC, ArgV)) exit(1);
-   if (isDefinitionCompleted()) exit(1);
-
-   /*** Parameters setting. ***/
-   addIntegerVariable ("NEURONSSEED", &i[2], -INT_MAX, INT_MAX, true);
-   addIntegerVariable ("SYNAPSESSEED", &i[3], -INT_MAX, INT_MAX, true);
-
-   DelayNumber = i[1];
-
-   Life = r[0];
-
-   /*** Seeds ***/
-   if (isDefined("NEURONSSEED")) NeuronsSeed = i[2];
-   if (isDefined("SYNAPSESSEED")) SynapsesSeed = i[3];
-
-   /*** Command file not specified: the standard input will be ***
-    *** assumed as input file.                                 ***/
-   if (!isDefined("COMMANDFILE")) {
-      CommandsFileName = getMemory(1,"(initParameters): Not enough memory\n");
-      CommandsFileName[0] = '\0';
-   }
-
-   /*** Command file not specified: the standard input will be ***
-    *** assumed as input file.                                 ***/
-   if (!isDefined("LOGFILE")) {
-      DocFileName = DEFAULT_LOG_FILENAME;
-   }
-
-   /***                                                       ***
-    *** Sets constants and function pointers dependent on the ***
-    *** type of choosen neuron.                               ***
-    ***                                                       ***/
-   if (setNeuronType()) {
-      sprintf(sError, "Neuron type '%s' unknown .\n", NeuronType);
-      printFatalError("initParameters", sError);
-   }
-
-
-   /***                                                  ***
-    *** Sets the function pointers dependent on the      ***
-    *** type of choosen transmission delay distribution. ***
-    ***                                                  ***/
-   if (setDelayDistributionType()) {
-      sprintf(sError, "Delay distribution type '%s' unknown .\n", DelayDistribType);
-      printFatalError("initParameters", sError);
-   }
-
-
-   /***                                                  ***
-    *** Sets the function pointers dependent on the      ***
-    *** type of synaptic extraction choosen.             ***
-    ***                                                  ***/
-   if (setSynapticExtractionType()) {
-      sprintf(sError, "Synaptic extraction type '%s' unknown .\n", SynapticExtractionType);
-      printFatalError("initParameters", sError);
-   }
-
-
-   /***                                                  ***/
-   /*** loading populations and connectivity definition. ***/
-   /***                                                  ***/
-   if (readArrayDefinition (ModulesFileName, loadPopulationsDefinition))
-      printFatalError("initParameters", "Bad population definition.\n");
-   
-   if (readArrayDefinition (ConnectivityFileName, loadConnectivityDefinition))
-      printFatalError("initParameters", "Bad connectivity definition.\n");
-
-
-   /***                                                   ***/
-   /*** Reading parameters for monitoring the simulation. ***/
-   /***                                                   ***/
-
-   /*** Rates Output. ***/
-   if (isDefined("OUTRATES")) {
-      RatesResults = b[0];
-      if (isDefined("RATESSAMPLING")) RatesSampling = r[23];
-      if (isDefined("STARTTIME"))     RatesStartTime = r[24];
-   } else
-      RatesResults = false;
-
-   /*** Synapses Output. ***/
-   if (isDefined("OUTSYNAPSES")) {
-      if (SynapsesResults = b[1]) {
-         if (isDefined("PRESTART"))  SynapsePreStart = i[5];
-         if (isDefined("PREEND"))    SynapsePreEnd = i[6];
-         if (SynapsePreStart > SynapsePreEnd ||
-             SynapsePreEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in synapses (A).\n");
-         if (isDefined("POSTSTART")) SynapsePostStart = i[7];
-         if (isDefined("POSTEND"))   SynapsePostEnd = i[8];
-         if (SynapsePostStart > SynapsePostEnd ||
-             SynapsePostEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in synapses (B).\n");
-      }
-   } else
-      SynapsesResults = false;
-
-   /*** Spikes Output. ***/
-   if (isDefined("OUTSPIKES")) {
-      if (SpikesResults = b[2]) {
-         if (isDefined("NEURONSTART"))  SpikeStart = i[9];
-         if (isDefined("NEURONEND"))    SpikeEnd = i[10];
-         if (SpikeStart > SpikeEnd ||
-             SpikeEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in spikes.\n");
-      }
-   } else
-      SpikesResults = false;
-
-
-   /*** Asynchronous SYNAPTIC STATE logging. ***/
-   if (isDefined("OUTSYNSTATE")) {
-      if (SynStateResults = b[3]) {
-         if (isDefined("SSPRESTART"))  SynStatePreStart = i[11];
-         if (isDefined("SSPREEND"))    SynStatePreEnd = i[12];
-         if (SynStatePreStart > SynStatePreEnd ||
-             SynStatePreEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in synapses (D).\n");
-         if (isDefined("SSPOSTSTART")) SynStatePostStart = i[13];
-         if (isDefined("SSPOSTEND"))   SynStatePostEnd = i[14];
-         if (SynStatePostStart > SynStatePostEnd ||
-             SynStatePostEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in synapses (E).\n");
-      }
-   } else
-      SynStateResults = false;
-
-   /*** Asynchronous NEURONAL STATE logging. ***/
-   if (isDefined("OUTNEUSTATE")) {
-      if (NeuStateResults = b[4]) {
-         if (isDefined("NSSTART"))  NeuStateStart = i[15];
-         if (isDefined("NSEND"))    NeuStateEnd = i[16];
-         if (NeuStateStart > NeuStateEnd ||
-             NeuStateEnd >= NumNeurons)
-            printFatalError("initParameters", "Bad neurons range in synapses (F).\n");
-      }
-   } else
-      NeuStateResults = false;
-
-   /*** Synaptic transition number logging. ***/
-   if (isDefined("OUTSYNTRANS")) {
-      if (SynTransResults = b[5])
-         if (isDefined("SYNTRANSSAMPLING"))  SynTransSampling = r[45];
-   } else
-      SynTransResults = false;
-
-   /*** Synaptic matrix prints at population level. ***/
-   if (isDefined("OUTSYNSTRUCT")) {
-      SynStructResults = b[6];
-   } else
-      SynStructResults = false;
-
-   /*** Detailed synaptic transition logging. ***/
-   if (isDefined("OUTSYNDETTRANS")) {
-      detailSynTransResults = b[7];
-   } else
-      detailSynTransResults = false;
-
-   /*** Afferent current logging. ***/
-   if (isDefined("OUTAFFCURR")) {
-      if (CurrentResults = b[8]) {
-         if (isDefined("AFFCURRSAMPLING")) CurrentSampling = r[46];
-         if (isDefined("ACNEURON")) CurrentNeuron = i[17];
-         if (CurrentNeuron >= NumNeurons)            
-            printFatalError("initParameters", "Incorrect neuron number (ACNEURON).\n");
-      }
-   } else
-      CurrentResults = false;
-}
-
-
-
-#undef BUFFER_DIM
-
+/*
+ *
+ *   init.h
+ *
+ *   Library of functions to read definition files to 
+ *   initialize the data structures needed to the simulation
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <math.h>
+
+#include "invar.h"
+#include "randdev.h"
+
+#include "types.h"
+#include "perseo.h"
+#include "results.h"
+#include "stimuli.h"
+#include "init.h"
+#include "events.h"
+#include "modules.h"
+#include "neurons.h"
+#include "connectivity.h"
+#include "synapses.h"
+#include "delays.h"
+#include "commands.h"
+#include "replay.h"
+#include "traces.h"
+#include "writer.h"
+#include "checkpoint.h"
+#include "ensemble.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "control.h"
+#include "dryrun.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM 256 /* Maximum static string size in the module. */
+#define DEFAULTS_SIZE 1024 /* Size in bytes of the copy of the default parameters. */
+
+#define PARAMETER(v) {&(v), sizeof(v)} /* Reference to a parameter (see copyParameters). */
+
+
+/**
+ *  A parameter set in INIT_FILE: its global variable and size.
+ */
+
+typedef struct {
+   void *Address; /* The global variable. */
+   size_t   Size; /* Its size in bytes. */
+} parameter_ref;
+
+
+
+/*---------------------*
+ *   LOCAL VARIABLES   *
+ *---------------------*/
+
+static PERSEO_LOCAL char    Defaults[DEFAULTS_SIZE]; /* Default values of the parameters of the thread. */
+static PERSEO_LOCAL boolean DefaultsSaved = false;   /* It is true once the defaults are copied. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------------*
+ *  copyParameters  *
+ *------------------*/
+
+/**
+ *  Saves (<Save> true) the default values of the parameters
+ *  which initParameters sets only if defined, or restores
+ *  them, so that a new simulation of the thread does not
+ *  inherit the values of the previous one.
+ */
+
+static void copyParameters (boolean Save)
+{
+   parameter_ref Parameters[] = {
+      PARAMETER(NeuronType), PARAMETER(ModulesFileName), PARAMETER(DelayDistribType),
+      PARAMETER(SynapticExtractionType), PARAMETER(ConnectivityFileName), PARAMETER(DocFileName),
+      PARAMETER(CommandsFileName), PARAMETER(NeuronsSeed), PARAMETER(SynapsesSeed),
+      PARAMETER(RatesFileName), PARAMETER(RatesSampling), PARAMETER(RatesStartTime),
+      PARAMETER(SynapsesFileName), PARAMETER(SynapsePreStart), PARAMETER(SynapsePreEnd),
+      PARAMETER(SynapsePostStart), PARAMETER(SynapsePostEnd),
+      PARAMETER(SpikesFileName), PARAMETER(SpikeStart), PARAMETER(SpikeEnd),
+      PARAMETER(SpikesFormat), PARAMETER(SpikesTick),
+      PARAMETER(SynStateFileName), PARAMETER(SynStatePreStart), PARAMETER(SynStatePreEnd),
+      PARAMETER(SynStatePostStart), PARAMETER(SynStatePostEnd),
+      PARAMETER(NeuStateFileName), PARAMETER(NeuStateStart), PARAMETER(NeuStateEnd),
+      PARAMETER(SynTransFileName), PARAMETER(SynTransSampling), PARAMETER(SynStructFileName),
+      PARAMETER(detailSynTransFileName), PARAMETER(CurrentFileName), PARAMETER(CurrentSampling),
+      PARAMETER(CurrentNeuron), PARAMETER(ContainerFileName),
+      PARAMETER(AsyncOutput), PARAMETER(OutBufferSize), PARAMETER(OutBackPressure),
+      PARAMETER(CheckpointFileName), PARAMETER(CheckpointPeriod), PARAMETER(CheckpointIncrements),
+      PARAMETER(RestartFileName), PARAMETER(EnsembleSize), PARAMETER(EnsembleJobs),
+      PARAMETER(EnsembleDirectory), PARAMETER(EnsembleCommandFile),
+      PARAMETER(HWCounters), PARAMETER(HWCountersFileName), PARAMETER(HWCountersSampling),
+      PARAMETER(Telemetry), PARAMETER(TelemetrySampling), PARAMETER(ControlSocketName),
+      PARAMETER(DryRunRate)
+   };
+   size_t Offset = 0;
+   int k;
+
+   for (k=0; k<(int)(sizeof(Parameters) / sizeof(parameter_ref)); k++) {
+      if (Offset + Parameters[k].Size > DEFAULTS_SIZE)
+         printFatalError("copyParameters", "Too many parameters (DEFAULTS_SIZE).\n");
+      if (Save)
+         memcpy(Defaults + Offset, Parameters[k].Address, Parameters[k].Size);
+      else
+         memcpy(Parameters[k].Address, Defaults + Offset, Parameters[k].Size);
+      Offset += Parameters[k].Size;
+   }
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*---------------*
+ *  initNeurons  *
+ *---------------*/
+
+/**
+ *   Initialize the array of all neurons in the 
+ *   network. It is defined in <modules.c>.
+ */
+
+void initNeurons (void)
+{
+#ifdef PRINT_STATUS
+   fprintf(stderr, "\nInitializing Neurons... ");
+#endif
+
+   /*** Initialize the seed of pseudorandom number generator. ***/
+   if (isDefined("NEURONSSEED") || isRestarting())
+      SetRandomSeed(NeuronsSeed);
+   else
+      Randomize();
+   resetNeurons(GetRandomSeed());
+
+#ifdef PRINT_STATUS
+    fprintf(stderr, "100.0%% (Memory: %g Mbytes)\r", (real)MemoryAmount/1024.0/1024.0);
+#endif
+}
+
+
+/*----------------*
+ *  resetNeurons  *
+ *----------------*/
+
+/**
+ *   Sets the state of the neurons and the random streams
+ *   of the external spikes drawn from the seed <Seed>,
+ *   which becomes NeuronsSeed.
+ */
+
+void resetNeurons (int Seed)
+{
+   indexn i;
+
+   SetRandomSeed(Seed);
+   NeuronsSeed = Seed;
+   fprintf(DocFile, "# Neuronal Seed: %i\n", NeuronsSeed);
+   fflush(DocFile);
+
+   /*** Initialize the random streams of the external spikes. ***/
+   initExternalStreams(NeuronsSeed);
+
+   /*** Initialize the state variables of the neurons. ***/
+   if ((*initNeuronVariables)())
+      printFatalError("initNeurons", "Initialization type for neuron state variables unknown.");
+
+   /*** Initializations of the other fixed neuron fields (Tr, Te, LastUpdate). ***/
+   for (i=0; i<NumNeurons; i++) {
+      doubleToTimex(START_TIME_OFFSET, Neurons[i].Tr);
+	   doubleToTimex(START_TIME_OFFSET-Life, Neurons[i].Te);
+	   doubleToTimex(START_TIME_OFFSET, Neurons[i].LastUpdate);
+   }
+}
+
+
+/*----------------------*
+ *  initSynapticMatrix  *
+ *----------------------*/
+
+/**
+ *  Allocates memory for the synaptic matrix creating
+ *  random connectivity and initializing the state of 
+ *  the synapses.
+ */
+
+void initSynapticMatrix (void)
+
+{
+   indexn j;
+
+   /*** Initialize the seed of pseudorandom number generator. ***/
+   if (isDefined("SYNAPSESSEED") || isRestarting())
+      SetRandomSeed(SynapsesSeed);
+   else
+      Randomize();
+   SynapsesSeed = GetRandomSeed();
+   fprintf(DocFile, "# Synaptic Seed: %i\n", SynapsesSeed);
+   fflush(DocFile);
+
+   /*** Sets the bounds of the delay distribution. ***/
+   setDelayBounds();
+
+   /*** Creates and fills the synaptic matrix. ***/
+   createSynapticMatrix();
+
+   /*** Initialized the state variables of the synapses, axon by axon ***
+    *** with a random stream per pre-synaptic neuron.                 ***/
+   for (j=0; j<NumNeurons; j++) {
+      InitRandomStream(&SynapseStream, SynapsesSeed, RS_SYNAPSES, (uint64_t)j);
+      scanSynapticMatrix (0, NumNeurons-1, j, j, &initSynapseState);
+   }
+}
+
+
+/*---------------------*
+ *  initNeuralNetwork  *
+ *---------------------*/
+
+/**
+ *  Allocates memory for and initializes the structures hosting 
+ *  data necessary to the simulation (populations, connectivity,
+ *  neurons and synapses).
+ */
+
+void initNeuralNetwork (void)
+
+{
+   /*** Interrupt management... ***/
+   signal(SIGINT, interruptSimulation);
+   signal(SIGTERM, interruptSimulation);
+
+   /*** Populations initialization... ***/
+   createPopulations();
+
+   /*** Neurons initialization... ***/
+   initNeurons();
+
+   /*** Synapses initialization... ***/
+   initSynapticMatrix();
+}
+
+
+/*------------------------*
+ *  releaseNeuralNetwork  *
+ *------------------------*/
+
+/**
+ *  Frees the network and every structure of the simulation
+ *  (events, observers, replays, traces and checkpoints), once
+ *  the output files are closed, so that the thread can host
+ *  a new simulation.
+ */
+
+void releaseNeuralNetwork (void)
+{
+   releaseEvents();
+   closeCommands();
+   releaseObservers();
+   releaseReplays();
+   releaseTraces();
+   releaseCheckpoints();
+   releaseSynapticLUT();
+   releaseSynapticMatrix();
+   releasePopulations();
+   resetSimulation();
+}
+
+
+/*------------------*
+ *  initParameters  *
+ *------------------*/
+
+/**
+ *   Declaration and definition of the simulation parameters.
+ */
+
+void initParameters (int ArgC, char * const ArgV[])
+
+{
+   IVinteger i[100];
+   IVinteger b[100];
+   IVreal    r[100];
+   char sError[BUFFER_DIM];
+
+   /*** The defaults are restored for the next simulation of the thread. ***/
+   if (!DefaultsSaved) {
+      copyParameters(true);
+      DefaultsSaved = true;
+   }
+
+   /*** List of declarations. ***/
+   addStringVariable  ("NEURONTYPE", &NeuronType, false);
+
+   addStringVariable  ("MODULEFILE", &ModulesFileName, false);
+
+   addStringVariable  ("DELAYDISTRIBTYPE", &DelayDistribType, false);
+   addIntegerVariable ("DELAYNUMBER", &i[1], 1, INT_MAX, false);
+
+   addStringVariable  ("SYNAPTICEXTRACTIONTYPE", &SynapticExtractionType, true);
+   
+   addStringVariable  ("CONNECTIVITYFILE", &ConnectivityFileName, false);
+
+   addStringVariable  ("LOGFILE", &DocFileName, true);
+
+   addRealVariable    ("LIFE", &r[0], 0, (IVreal)1e37, false);
+
+   addIntegerVariable ("NEURONSSEED", &i[2], -INT_MAX, INT_MAX, true);
+   addIntegerVariable ("SYNAPSESSEED", &i[3], -INT_MAX, INT_MAX, true);
+
+   addStringVariable  ("COMMANDFILE", &CommandsFileName, true);
+
+   addBooleanVariable ("OUTRATES", &b[0], true);
+   addStringVariable  ("RATESFILE", &RatesFileName, true);
+   addRealVariable    ("RATESSAMPLING", &r[23], (IVreal)1e-37, (IVreal)1e37, true);
+   addRealVariable    ("STARTTIME", &r[24], (IVreal)-1e37, (IVreal)1e37, true);
+
+   addBooleanVariable ("OUTSYNAPSES", &b[1], true);
+   addStringVariable  ("SYNAPSESFILE", &SynapsesFileName, true);
+   addIntegerVariable ("PRESTART", &i[5], 0, INT_MAX, true);
+   addIntegerVariable ("PREEND", &i[6], 0, INT_MAX, true);
+   addIntegerVariable ("POSTSTART", &i[7], 0, INT_MAX, true);
+   addIntegerVariable ("POSTEND", &i[8], 0, INT_MAX, true);
+
+   addBooleanVariable ("OUTSPIKES", &b[2], true);
+   addStringVariable  ("SPIKESFILE", &SpikesFileName, true);
+   addIntegerVariable ("NEURONSTART", &i[9], 0, INT_MAX, true);
+   addIntegerVariable ("NEURONEND", &i[10], 0, INT_MAX, true);
+   addStringVariable  ("SPIKESFORMAT", &SpikesFormat, true);
+   addRealVariable    ("SPIKESTICK", &r[47], (IVreal)1e-37, (IVreal)1e37, true);
+
+   addBooleanVariable ("OUTSYNSTATE", &b[3], true);
+   addStringVariable  ("SYNSTATEFILE", &SynStateFileName, true);
+   addIntegerVariable ("SSPRESTART", &i[11], 0, INT_MAX, true);
+   addIntegerVariable ("SSPREEND", &i[12], 0, INT_MAX, true);
+   addIntegerVariable ("SSPOSTSTART", &i[13], 0, INT_MAX, true);
+   addIntegerVariable ("SSPOSTEND", &i[14], 0, INT_MAX, true);
+
+   addBooleanVariable ("OUTNEUSTATE", &b[4], true);
+   addStringVariable  ("NEUSTATEFILE", &NeuStateFileName, true);
+   addIntegerVariable ("NSSTART", &i[15], 0, INT_MAX, true);
+   addIntegerVariable ("NSEND", &i[16], 0, INT_MAX, true);
+
+   addBooleanVariable ("OUTSYNTRANS", &b[5], true);
+   addStringVariable  ("SYNTRANSFILE", &SynTransFileName, true);
+   addRealVariable    ("SYNTRANSSAMPLING", &r[45], (IVreal)1e-37, (IVreal)1e37, true);
+
+   addBooleanVariable ("OUTSYNSTRUCT", &b[6], true);
+   addStringVariable  ("SYNSTRUCTFILE", &SynStructFileName, true);
+
+   addBooleanVariable ("OUTSYNDETTRANS", &b[7], true);
+   addStringVariable  ("SYNDETTRANSFILE", &detailSynTransFileName, true);
+
+   addBooleanVariable ("OUTAFFCURR", &b[8], true);
+   addStringVariable  ("AFFCURRFILE", &CurrentFileName, true);
+   addRealVariable    ("AFFCURRSAMPLING", &r[46], (IVreal)1e-37, (IVreal)1e37, true);
+   addIntegerVariable ("ACNEURON", &i[17], 0, INT_MAX, true);
+
+   addBooleanVariable ("OUTCONTAINER", &b[10], true);
+   addStringVariable  ("CONTAINERFILE", &ContainerFileName, true);
+
+   addBooleanVariable ("ASYNCOUTPUT", &b[9], true);
+   addIntegerVariable ("OUTBUFFERSIZE", &i[18], 1, 1024, true);
+   addStringVariable  ("OUTBACKPRESSURE", &OutBackPressure, true);
+
+   addStringVariable  ("CHECKPOINTFILE", &CheckpointFileName, true);
+   addRealVariable    ("CHECKPOINTPERIOD", &r[48], 0, (IVreal)1e37, true);
+   addIntegerVariable ("CHECKPOINTINCREMENTS", &i[19], 0, INT_MAX, true);
+   addStringVariable  ("RESTARTFILE", &RestartFileName, true);
+
+   addIntegerVariable ("ENSEMBLESIZE", &i[20], 0, INT_MAX, true);
+   addIntegerVariable ("ENSEMBLEJOBS", &i[21], 0, INT_MAX, true);
+   addStringVariable  ("ENSEMBLEDIRECTORY", &EnsembleDirectory, true);
+   addStringVariable  ("ENSEMBLECOMMANDFILE", &EnsembleCommandFile, true);
+
+   addBooleanVariable ("HWCOUNTERS", &b[11], true);
+   addStringVariable  ("HWCOUNTERSFILE", &HWCountersFileName, true);
+   addRealVariable    ("HWCOUNTERSSAMPLING", &r[49], (IVreal)1e-37, (IVreal)1e37, true);
+
+   addBooleanVariable ("TELEMETRY", &b[12], true);
+   addRealVariable    ("TELEMETRYSAMPLING", &r[50], (IVreal)1e-37, (IVreal)1e37, true);
+
+   addStringVariable  ("CONTROLSOCKET", &ControlSocketName, true);
+
+   addRealVariable    ("DRYRUNRATE", &r[51], 0, (IVreal)1e37, true);
+
+   /*** Declaration of parameters and error parsing. ***/
+   if (readDefinitionFile(INIT_FILE)) exit(1);
+   if (readCommandLineDefinition(ArgC, ArgV)) exit(1);
+   if (isDefinitionCompleted()) exit(1);
+
+   /*** Parameters setting. ***/
+   addIntegerVariable ("NEURONSSEED", &i[2], -INT_MAX, INT_MAX, true);
+   addIntegerVariable ("SYNAPSESSEED", &i[3], -INT_MAX, INT_MAX, true);
+
+   DelayNumber = i[1];
+
+   Life = r[0];
+
+   /*** Seeds ***/
+   if (isDefined("NEURONSSEED")) NeuronsSeed = i[2];
+   if (isDefined("SYNAPSESSEED")) SynapsesSeed = i[3];
+
+   /*** Command file not specified: the standard input will be ***
+    *** assumed as input file.                                 ***/
+   if (!isDefined("COMMANDFILE")) {
+      CommandsFileName = getMemory(1,"(initParameters): Not enough memory\n");
+      CommandsFileName[0] = '\0';
+   }
+
+   /*** Command file not specified: the standard input will be ***
+    *** assumed as input file.                                 ***/
+   if (!isDefined("LOGFILE")) {
+      DocFileName = DEFAULT_LOG_FILENAME;
+   }
+
+   /***                                                       ***
+    *** Sets constants and function pointers dependent on the ***
+    *** type of choosen neuron.                               ***
+    ***                                                       ***/
+   if (setNeuronType()) {
+      sprintf(sError, "Neuron type '%s' unknown .\n", NeuronType);
+      printFatalError("initParameters", sError);
+   }
+
+
+   /***                                                  ***
+    *** Sets the function pointers dependent on the      ***
+    *** type of choosen transmission delay distribution. ***
+    ***                                                  ***/
+   if (setDelayDistributionType()) {
+      sprintf(sError, "Delay distribution type '%s' unknown .\n", DelayDistribType);
+      printFatalError("initParameters", sError);
+   }
+
+
+   /***                                                  ***
+    *** Sets the function pointers dependent on the      ***
+    *** type of synaptic extraction choosen.             ***
+    ***                                                  ***/
+   if (setSynapticExtractionType()) {
+      sprintf(sError, "Synaptic extraction type '%s' unknown .\n", SynapticExtractionType);
+      printFatalError("initParameters", sError);
+   }
+
+
+   /***                                                  ***/
+   /*** loading populations and connectivity definition. ***/
+   /***                                                  ***/
+   if (readArrayDefinition (ModulesFileName, loadPopulationsDefinition))
+      printFatalError("initParameters", "Bad population definition.\n");
+   
+   if (readArrayDefinition (ConnectivityFileName, loadConnectivityDefinition))
+      printFatalError("initParameters", "Bad connectivity definition.\n");
+
+
+   /***                                                   ***/
+   /*** Reading parameters for monitoring the simulation. ***/
+   /***                                                   ***/
+
+   /*** Rates Output. ***/
+   if (isDefined("OUTRATES")) {
+      RatesResults = b[0];
+      if (isDefined("RATESSAMPLING")) RatesSampling = r[23];
+      if (isDefined("STARTTIME"))     RatesStartTime = r[24];
+   } else
+      RatesResults = false;
+
+   /*** Synapses Output. ***/
+   if (isDefined("OUTSYNAPSES")) {
+      if (SynapsesResults = b[1]) {
+         if (isDefined("PRESTART"))  SynapsePreStart = i[5];
+         if (isDefined("PREEND"))    SynapsePreEnd = i[6];
+         if (SynapsePreStart > SynapsePreEnd ||
+             SynapsePreEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in synapses (A).\n");
+         if (isDefined("POSTSTART")) SynapsePostStart = i[7];
+         if (isDefined("POSTEND"))   SynapsePostEnd = i[8];
+         if (SynapsePostStart > SynapsePostEnd ||
+             SynapsePostEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in synapses (B).\n");
+      }
+   } else
+      SynapsesResults = false;
+
+   /*** Spikes Output. ***/
+   if (isDefined("OUTSPIKES")) {
+      if (SpikesResults = b[2]) {
+         if (isDefined("NEURONSTART"))  SpikeStart = i[9];
+         if (isDefined("NEURONEND"))    SpikeEnd = i[10];
+         if (SpikeStart > SpikeEnd ||
+             SpikeEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in spikes.\n");
+         if (strcmp(SpikesFormat, "TEXT") && strcmp(SpikesFormat, "VARINT") && strcmp(SpikesFormat, "RICE")) {
+            sprintf(sError, "Spikes format '%s' unknown (TEXT, VARINT or RICE).\n", SpikesFormat);
+            printFatalError("initParameters", sError);
+         }
+         if (isDefined("SPIKESTICK")) SpikesTick = r[47];
+      }
+   } else
+      SpikesResults = false;
+
+
+   /*** Asynchronous SYNAPTIC STATE logging. ***/
+   if (isDefined("OUTSYNSTATE")) {
+      if (SynStateResults = b[3]) {
+         if (isDefined("SSPRESTART"))  SynStatePreStart = i[11];
+         if (isDefined("SSPREEND"))    SynStatePreEnd = i[12];
+         if (SynStatePreStart > SynStatePreEnd ||
+             SynStatePreEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in synapses (D).\n");
+         if (isDefined("SSPOSTSTART")) SynStatePostStart = i[13];
+         if (isDefined("SSPOSTEND"))   SynStatePostEnd = i[14];
+         if (SynStatePostStart > SynStatePostEnd ||
+             SynStatePostEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in synapses (E).\n");
+      }
+   } else
+      SynStateResults = false;
+
+   /*** Asynchronous NEURONAL STATE logging. ***/
+   if (isDefined("OUTNEUSTATE")) {
+      if (NeuStateResults = b[4]) {
+         if (isDefined("NSSTART"))  NeuStateStart = i[15];
+         if (isDefined("NSEND"))    NeuStateEnd = i[16];
+         if (NeuStateStart > NeuStateEnd ||
+             NeuStateEnd >= NumNeurons)
+            printFatalError("initParameters", "Bad neurons range in synapses (F).\n");
+      }
+   } else
+      NeuStateResults = false;
+
+   /*** Synaptic transition number logging. ***/
+   if (isDefined("OUTSYNTRANS")) {
+      if (SynTransResults = b[5])
+         if (isDefined("SYNTRANSSAMPLING"))  SynTransSampling = r[45];
+   } else
+      SynTransResults = false;
+
+   /*** Synaptic matrix prints at population level. ***/
+   if (isDefined("OUTSYNSTRUCT")) {
+      SynStructResults = b[6];
+   } else
+      SynStructResults = false;
+
+   /*** Detailed synaptic transition logging. ***/
+   if (isDefined("OUTSYNDETTRANS")) {
+      detailSynTransResults = b[7];
+   } else
+      detailSynTransResults = false;
+
+   /*** Afferent current logging. ***/
+   if (isDefined("OUTAFFCURR")) {
+      if (CurrentResults = b[8]) {
+         if (isDefined("AFFCURRSAMPLING")) CurrentSampling = r[46];
+         if (isDefined("ACNEURON")) CurrentNeuron = i[17];
+         if (CurrentNeuron >= NumNeurons)            
+            printFatalError("initParameters", "Incorrect neuron number (ACNEURON).\n");
+      }
+   } else
+      CurrentResults = false;
+
+   /*** Results container. ***/
+   if (isDefined("OUTCONTAINER")) {
+      ContainerResults = b[10];
+   } else
+      ContainerResults = false;
+
+   /*** Asynchronous writing of the log files. ***/
+   if (isDefined("ASYNCOUTPUT")) AsyncOutput = b[9];
+   if (isDefined("OUTBUFFERSIZE")) OutBufferSize = i[18];
+   if (strcmp(OutBackPressure, "BLOCK") && strcmp(OutBackPressure, "DROP")) {
+      sprintf(sError, "Back-pressure policy '%s' unknown (BLOCK or DROP).\n", OutBackPressure);
+      printFatalError("initParameters", sError);
+   }
+
+   /*** Checkpoints. ***/
+   if (isDefined("CHECKPOINTPERIOD")) CheckpointPeriod = r[48];
+   if (isDefined("CHECKPOINTINCREMENTS")) CheckpointIncrements = i[19];
+
+   /*** Ensemble of simulations. ***/
+   if (isDefined("ENSEMBLESIZE")) EnsembleSize = i[20];
+   if (isDefined("ENSEMBLEJOBS")) EnsembleJobs = i[21];
+   if (EnsembleSize > 0 && strstr(EnsembleDirectory, "%d") == NULL) {
+      sprintf(sError, "The directory of the ensemble members '%s' lacks '%%d'.\n", EnsembleDirectory);
+      printFatalError("initParameters", sError);
+   }
+
+   /*** Hardware counters. ***/
+   if (isDefined("HWCOUNTERS")) HWCounters = b[11];
+   if (isDefined("HWCOUNTERSSAMPLING")) HWCountersSampling = r[49];
+
+   /*** Telemetry segment. ***/
+   if (isDefined("TELEMETRY")) Telemetry = b[12];
+   if (isDefined("TELEMETRYSAMPLING")) TelemetrySampling = r[50];
+
+   /*** Pre-flight estimate. ***/
+   if (isDefined("DRYRUNRATE")) DryRunRate = r[51];
+}
+
+
+/*---------------------*
+ *  releaseParameters  *
+ *---------------------*/
+
+/**
+ *   Frees the definitions read by initParameters and
+ *   restores the default values of the parameters.
+ */
+
+void releaseParameters (void)
+{
+   if (!isDefined("COMMANDFILE")) {
+      free(CommandsFileName);
+      releaseMemory(1, MEMORY_OTHER);
+   }
+   clearDefinitions();
+   copyParameters(false);
+}
+
+
+
+#undef PARAMETER
+#undef DEFAULTS_SIZE
+#undef BUFFER_DIM
+
@@ -1,41 +1,70 @@
-/*
- *
- *   init.h
- *
- *   Library of functions to read definition files to 
- *   initialize the data structures needed to the simulation
- *
- *   Project: PERSEO 2.x
- *
- */
-
-
-
-#ifndef __INIT_H__
-#define __INIT_H__
-
-
-
-/**
- *   Crea e inizializza le strutture che ospitano la rete
- *   e stampa evenutali errori, in conseguenza dei quali
- *   viene terminato il programma.
- */
-
-void initNeuralNetwork (void);
-
-
-
-/**
- *   Inizializzazione di parametri ridondanti della rete a
- *   partire dai valori di default e da quelli specificati
- *   dall'utente.
- *   Le frequenze sono espresse in spikes/s, mentre i tempi
- *   in ms.
- */
-
-void initParameters (int ArgC, char * ArgV[]);
-
-
-
+/*
+ *
+ *   init.h
+ *
+ *   Library of functions to read definition files to 
+ *   initialize the data structures needed to the simulation
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __INIT_H__
+#define __INIT_H__
+
+
+
+/**
+ *   Crea e inizializza le strutture che ospitano la rete
+ *   e stampa evenutali errori, in conseguenza dei quali
+ *   viene terminato il programma.
+ */
+
+void initNeuralNetwork (void);
+
+
+/**
+ *   Frees the network and every structure of the simulation
+ *   (events, observers, replays, traces and checkpoints), once
+ *   the output files are closed, so that the thread can host
+ *   a new simulation.
+ */
+
+void releaseNeuralNetwork (void);
+
+
+
+/**
+ *   Sets the state of the neurons and the random streams
+ *   of the external spikes drawn from the seed <Seed>,
+ *   which becomes NeuronsSeed. The network has to be
+ *   already created.
+ */
+
+void resetNeurons (int Seed);
+
+
+
+/**
+ *   Inizializzazione di parametri ridondanti della rete a
+ *   partire dai valori di default e da quelli specificati
+ *   dall'utente.
+ *   Le frequenze sono espresse in spikes/s, mentre i tempi
+ *   in ms.
+ */
+
+void initParameters (int ArgC, char * const ArgV[]);
+
+
+/**
+ *   Frees the definitions read by initParameters and
+ *   restores the default values of the parameters.
+ */
+
+void releaseParameters (void);
+
+
+
 #endif /* __INIT_H__ */
\ No newline at end of file
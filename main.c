@@ -0,0 +1,102 @@
+/*
+ *
+ *   main.c
+ *
+ *   The main function of the perseo program, running a single
+ *   simulation, or an ensemble of them, on the library of the
+ *   simulator (libperseo.a).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "timer.h"
+
+#include "perseo.h"
+#include "init.h"
+#include "results.h"
+#include "commands.h"
+#include "checkpoint.h"
+#include "ensemble.h"
+#include "dryrun.h"
+
+
+
+/*----------*
+ *          *
+ *   MAIN   *
+ *          *
+ *----------*/
+
+/**
+ *  Loads and interprets definition and command files, 
+ *  builds data structure for the simulation and
+ *  starts the integration of the system dynamics.
+ *  With the option --dry-run it only writes on stdout
+ *  the estimate of the network (see dryrun.h), failing
+ *  if the network does not fit the physical memory.
+ */
+
+int main (int ArgC, char * ArgV[])
+{
+   char OutString[40] = "";
+   int i, j;
+
+#ifdef PRINT_STATUS
+   printProgramPresentation();
+#endif
+
+   /*** The option --dry-run is not a parameter definition. ***/
+   for (i=j=1; i<ArgC; i++)
+      if (strcmp(ArgV[i], "--dry-run") == 0)
+         DryRun = true;
+      else
+         ArgV[j++] = ArgV[i];
+   ArgC = j;
+
+   /***  Simulation boot... ***/
+   initParameters (ArgC, ArgV);
+
+   /*** ...or only the estimate of the network from its definition. ***/
+   if (DryRun)
+      return dryRun(stdout) ? EXIT_FAILURE : 0;
+   openRestart();
+
+   /*** ...or of an ensemble of simulations on the same network. ***/
+   if (EnsembleSize > 0) {
+      runEnsemble();
+      return 0;
+   }
+   openOutputFiles();
+
+#ifdef PRINT_STATUS
+   startTimer();
+#endif
+
+   initNeuralNetwork();
+   readCommands(NULL);
+   attachObservers();
+
+#ifdef PRINT_STATUS
+   elapseTimer();
+   fprintf(stderr, "\n\nElapsed Time: %ss\n", timer(OutString));
+#endif
+
+   /*** Simulation start... ***/
+   if (!QuitSimulation) 
+      simulation();
+
+   /*** Simulation shutdown... ***/
+   closeOutputFiles();
+   waitBranches();
+   waitExternalCommands();
+
+   return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ *
+ *   memusage.c
+ *
+ *   Library accounting the memory allocated by Perseo for
+ *   each subsystem (see memusage.h).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "types.h"
+#include "perseo.h"
+#include "memusage.h"
+
+
+
+/*----------------------*
+ *   GLOBAL VARIABLES   *
+ *----------------------*/
+
+PERSEO_LOCAL uint64_t MemoryAmount = 0; /* The amount of memory allocated by Perseo. */
+PERSEO_LOCAL uint64_t   MemoryPeak = 0; /* Maximum of MemoryAmount since the start. */
+PERSEO_LOCAL memory_usage MemoryUsage[MEMORY_AREAS]; /* Usage of each area. */
+
+/*** Names of the areas, in the order of the MEMORY_* ids. ***/
+const char *MemoryAreaNames[MEMORY_AREAS] = {"Other", "Neurons", "Populations", "Indices", "Synapses",
+                                             "Tables", "Queues", "Events", "Output", "Build"};
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*--------------*
+ *  chargeArea  *
+ *--------------*/
+
+/**
+ *  Charges <Size> bytes to the area <Area>, updating the
+ *  peaks.
+ */
+
+static void chargeArea(size_t Size,
+                       int    Area)
+{
+   memory_usage *u = &MemoryUsage[Area];
+
+   u->Bytes += Size;
+   if (u->Bytes > u->Peak)
+      u->Peak = u->Bytes;
+   MemoryAmount += Size;
+   if (MemoryAmount > MemoryPeak)
+      MemoryPeak = MemoryAmount;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*-----------------*
+ *  getAreaMemory  *
+ *-----------------*/
+
+/**
+ *  As getMemory, charging the <Size> bytes to the area
+ *  <Area>.
+ */
+
+void *getAreaMemory(size_t        Size, // Size in byte of memory to allocate.
+                    int           Area, // Area charged (MEMORY_*).
+                    char *ErrorMessage) // Error message if the allocation process fails.
+{
+   void *ptr;
+
+   if ((ptr = malloc(Size)) == NULL) {
+#ifdef PRINT_ERROR
+      fprintf(stderr, "\n%s", ErrorMessage);
+#endif
+      exit( EXIT_FAILURE );
+   }
+   chargeArea(Size, Area);
+   MemoryUsage[Area].Allocations++;
+
+   return ptr;
+}
+
+
+/*-------------*
+ *  getMemory  *
+ *-------------*/
+
+/**
+ *  It is a customized version of standard malloc function
+ *  which return a pointer to the allocated memory of size
+ *  <Size>, charged to MEMORY_OTHER. In addion updates a
+ *  counter of memory usage and exit program with an error
+ *  message <ErrorMessage>.
+ */
+
+void *getMemory(size_t        Size, // Size in byte of memory to allocate.
+                char *ErrorMessage) // Error message if the allocation process fails.
+{
+   return getAreaMemory(Size, MEMORY_OTHER, ErrorMessage);
+}
+
+
+/*----------------*
+ *  resizeMemory  *
+ *----------------*/
+
+/**
+ *  Resizes from <OldSize> to <NewSize> bytes the block <Ptr>
+ *  of the area <Area> (allocating it if NULL), as realloc.
+ *  Exits with the error message <ErrorMessage> on failure.
+ */
+
+void *resizeMemory(void          *Ptr, // Block to resize, or NULL.
+                   size_t     OldSize, // Present size of the block.
+                   size_t     NewSize, // New size of the block.
+                   int           Area, // Area charged (MEMORY_*).
+                   char *ErrorMessage) // Error message if the allocation process fails.
+{
+   void *ptr;
+
+   if ((ptr = realloc(Ptr, NewSize)) == NULL) {
+#ifdef PRINT_ERROR
+      fprintf(stderr, "\n%s", ErrorMessage);
+#endif
+      exit( EXIT_FAILURE );
+   }
+   if (Ptr == NULL) {
+      OldSize = 0;
+      MemoryUsage[Area].Allocations++;
+   }
+   if (NewSize >= OldSize)
+      chargeArea(NewSize - OldSize, Area);
+   else {
+      MemoryUsage[Area].Bytes -= OldSize - NewSize;
+      MemoryAmount -= OldSize - NewSize;
+   }
+
+   return ptr;
+}
+
+
+/*-----------------*
+ *  releaseMemory  *
+ *-----------------*/
+
+/**
+ *  Releases from the area <Area> a block of <Size> bytes,
+ *  freed by the caller.
+ */
+
+void releaseMemory(size_t Size,
+                   int    Area)
+{
+   MemoryUsage[Area].Bytes -= Size;
+   MemoryUsage[Area].Frees++;
+   MemoryAmount -= Size;
+}
+
+
+/*--------------------*
+ *  mergeMemoryUsage  *
+ *--------------------*/
+
+/**
+ *  Charges to the areas of the calling thread the memory
+ *  left allocated in <Usage> by a helper thread (the writer
+ *  one), whose blocks are then freed by the calling thread.
+ *  The peaks of the helper thread are not merged.
+ */
+
+void mergeMemoryUsage(memory_usage *Usage)
+{
+   int a;
+
+   for (a=0; a<MEMORY_AREAS; a++) {
+      chargeArea(Usage[a].Bytes, a);
+      MemoryUsage[a].Allocations += Usage[a].Allocations;
+      MemoryUsage[a].Frees += Usage[a].Frees;
+   }
+}
+
+
+/*--------------------*
+ *  resetMemoryUsage  *
+ *--------------------*/
+
+/**
+ *  Restarts the peaks and the counts of allocations and
+ *  frees from the memory still allocated, for a new
+ *  simulation of the thread.
+ */
+
+void resetMemoryUsage()
+{
+   int k;
+
+   for (k=0; k<MEMORY_AREAS; k++) {
+      MemoryUsage[k].Peak = MemoryUsage[k].Bytes;
+      MemoryUsage[k].Allocations = 0;
+      MemoryUsage[k].Frees = 0;
+   }
+   MemoryPeak = MemoryAmount;
+}
+
+
+/*--------------------*
+ *  printMemoryUsage  *
+ *--------------------*/
+
+/**
+ *  Writes in <File> the usage of each area and the total,
+ *  a line "# MEMORY <When> <Area> <Bytes> <Peak> <Allocations>
+ *  <Frees>" each, to be easily parsed.
+ */
+
+void printMemoryUsage(FILE *File,
+                      char *When)
+{
+   uint64_t Allocations = 0, Frees = 0;
+   int k;
+
+   if (File == NULL)
+      return;
+
+   fprintf(File, "#----------\n");
+   fprintf(File, "# Memory usage (%s): bytes, peak bytes, allocations and frees of each area.\n", When);
+   for (k=0; k<MEMORY_AREAS; k++) {
+      fprintf(File, "# MEMORY %s %s %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", When, MemoryAreaNames[k],
+              MemoryUsage[k].Bytes, MemoryUsage[k].Peak, MemoryUsage[k].Allocations, MemoryUsage[k].Frees);
+      Allocations += MemoryUsage[k].Allocations;
+      Frees += MemoryUsage[k].Frees;
+   }
+   fprintf(File, "# MEMORY %s Total %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n\n", When,
+           MemoryAmount, MemoryPeak, Allocations, Frees);
+   fflush(File);
+}
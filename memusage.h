@@ -0,0 +1,158 @@
+/*
+ *
+ *   memusage.h
+ *
+ *   Library accounting the memory allocated by Perseo. The
+ *   bytes, their peak and the number of allocations and frees
+ *   are kept in 64 bits for each subsystem (area) of the
+ *   simulator, besides their total MemoryAmount. Each block
+ *   is charged to an area when allocated (getAreaMemory or
+ *   resizeMemory) and is released from the same area when
+ *   freed (releaseMemory, called next to free). The usage is
+ *   reported in LogFile after the initialization, at the end
+ *   of the run and on demand (PRINT_MEMORY command), and it
+ *   is published by the telemetry and the control socket.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __MEMUSAGE_H__
+#define __MEMUSAGE_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+
+
+/*--------------------*
+ *  GLOBAL CONSTANTS  *
+ *--------------------*/
+
+/*** Areas of the memory accounting. ***/
+#define MEMORY_OTHER        0 /* Anything else (definitions, parameters, checkpoints...). */
+#define MEMORY_NEURONS      1 /* Neurons and their state variables. */
+#define MEMORY_POPULATIONS  2 /* Populations, connectivity blocks and rate modulations. */
+#define MEMORY_INDICES      3 /* Synaptic matrix: layers, axon segments, post-synaptic offsets and exceptions. */
+#define MEMORY_SYNAPSES     4 /* Payloads of the synapses (efficacies and states). */
+#define MEMORY_TABLES       5 /* Look-up tables of the synaptic efficacies. */
+#define MEMORY_QUEUES       6 /* Queues of the spikes of the delay layers. */
+#define MEMORY_EVENTS       7 /* Events of the protocol and their sorted queue. */
+#define MEMORY_OUTPUT       8 /* Buffers of the log files and of the observers. */
+#define MEMORY_BUILD        9 /* Scratch of the construction of the synaptic matrix. */
+#define MEMORY_AREAS       10 /* Number of areas. */
+
+
+
+/*---------------------*
+ *  GLOBAL DATA TYPES  *
+ *---------------------*/
+
+/**
+ *  Usage of an area of memory.
+ */
+
+typedef struct {
+   uint64_t       Bytes; /* Bytes allocated. */
+   uint64_t        Peak; /* Maximum of Bytes since the start. */
+   uint64_t Allocations; /* Blocks allocated (a resize counts as one). */
+   uint64_t       Frees; /* Blocks released. */
+} memory_usage;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+extern PERSEO_LOCAL uint64_t MemoryAmount; /* The amount of memory allocated by Perseo. */
+extern PERSEO_LOCAL uint64_t   MemoryPeak; /* Maximum of MemoryAmount since the start. */
+extern PERSEO_LOCAL memory_usage MemoryUsage[MEMORY_AREAS]; /* Usage of each area. */
+extern const char *MemoryAreaNames[MEMORY_AREAS]; /* Names of the areas. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  It is a customized version of standard malloc function
+ *  which return a pointer to the allocated memory of size
+ *  <Size>, charged to MEMORY_OTHER. In addion updates a
+ *  counter of memory usage and exit program with an error
+ *  message <ErrorMessage>.
+ */
+
+void *getMemory(size_t        Size,  // Size in byte of memory to allocate.
+                char *ErrorMessage); // Error message if the allocation process fails.
+
+
+/**
+ *  As getMemory, charging the <Size> bytes to the area
+ *  <Area>.
+ */
+
+void *getAreaMemory(size_t        Size,  // Size in byte of memory to allocate.
+                    int           Area,  // Area charged (MEMORY_*).
+                    char *ErrorMessage); // Error message if the allocation process fails.
+
+
+/**
+ *  Resizes from <OldSize> to <NewSize> bytes the block <Ptr>
+ *  of the area <Area> (allocating it if NULL), as realloc.
+ *  Exits with the error message <ErrorMessage> on failure.
+ */
+
+void *resizeMemory(void          *Ptr,  // Block to resize, or NULL.
+                   size_t     OldSize,  // Present size of the block.
+                   size_t     NewSize,  // New size of the block.
+                   int           Area,  // Area charged (MEMORY_*).
+                   char *ErrorMessage); // Error message if the allocation process fails.
+
+
+/**
+ *  Releases from the area <Area> a block of <Size> bytes,
+ *  freed by the caller.
+ */
+
+void releaseMemory(size_t Size,
+                   int    Area);
+
+
+/**
+ *  Charges to the areas of the calling thread the memory
+ *  left allocated in <Usage> by a helper thread (the writer
+ *  one), whose blocks are then freed by the calling thread.
+ */
+
+void mergeMemoryUsage(memory_usage *Usage);
+
+
+/**
+ *  Restarts the peaks and the counts of allocations and
+ *  frees from the memory still allocated, for a new
+ *  simulation of the thread.
+ */
+
+void resetMemoryUsage();
+
+
+/**
+ *  Writes in <File> the usage of each area and the total,
+ *  a line "# MEMORY <When> <Area> <Bytes> <Peak> <Allocations>
+ *  <Frees>" each, to be easily parsed.
+ */
+
+void printMemoryUsage(FILE *File,
+                      char *When);
+
+
+#endif /* __MEMUSAGE_H__ */
@@ -1,281 +1,774 @@
-/**
- *
- *   modules.c
- *
- *   Library of structures and functions to manage 
- *   populations of the network.
- *
- *   Project    PERSEO 2.0
- *
- */
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-#include <math.h>
-
-
-#include "erflib.h"
-#include "randdev.h"
-
-#include "types.h"
-#include "perseo.h"
-#include "neurons.h"
-#include "modules.h"
-#include "events.h"
-
-
-
-#define STRING_SIZE 256
-
-
-
-/*----------------------*
- *   GLOBAL VARIABLES   *
- *----------------------*/
-
-
-/*-----------*
- *  Neurons  *
- *-----------*/
-
-neuron       *Neurons = NULL; /* All neurons in the network. */
-real *NeuronStateVars = NULL; /* Array containing all the state variables of the neurons in the network. */
-indexn     NumNeurons = 0;    /* Total number of neurons in the network. */
-
-
-/*---------------*
- *  Populations  *
- *---------------*/
-
-population *Populations = NULL; /* Array of basic populations defined in the network architecture. */
-real  *PopulationParams = NULL; /* A whole array of the variable parameters for the Populations. */
-int      NumPopulations = 0;    /* Number of basic populations (length of Populations). */
-
-char   *ModulesFileName = EMPTY_STRING; /* File name containing the definition of the populations ("modules.ini"). */
-
-
-
-/*---------------------*
- *  LOCAL DEFINITIONS  *
- *---------------------*/
-
-
-/* #define BUFFER_SIZE          16 /* Size of the buffer for variable arrays. */ 
-#define BUFFER_SIZE         256 /* Size of the buffer for variable arrays. */ 
-#define BASIC_REAL_PARAMETERS 5 /* Number of real parameters fixed per population definition. */
-
-
-
-/*-----------------------*
- *  FUNCTION DEFINITION  *
- *-----------------------*/
-
-
-/*-----------------------------*
- *  loadPopulationsDefinition  *
- *-----------------------------*/
-
-/**
- *  Adds an element to the <Populations> array, and fills the fields of
- *  the structure <population>.
- */
-
-int loadPopulationsDefinition(int NumRealParams, IVreal *RealParams, 
-                              int NumStringParams, char **StringParams)
-{
-   static int PopulationsSize = 0;
-   
-   population *p;
-   int k;
-
-   /*** Makes room for the new population. ***/
-   NumPopulations++;
-   if (NumPopulations > PopulationsSize) { // More memory is needed?
-      PopulationsSize += BUFFER_SIZE;
-      if (PopulationsSize == BUFFER_SIZE) {
-         Populations = (population *)getMemory(sizeof(population)*PopulationsSize, "ERROR (loadPopulationsDefinition): Out of memory.");
-         PopulationParams = (real *)getMemory(sizeof(real)*PopulationsSize*NumParameters, "ERROR (loadPopulationsDefinition): Out of memory.");
-      } else {
-         Populations = (population *)realloc(Populations, sizeof(population)*PopulationsSize);
-         MemoryAmount += sizeof(population) * BUFFER_SIZE;
-         PopulationParams = (real *)realloc(PopulationParams, sizeof(real)*PopulationsSize*NumParameters);
-         MemoryAmount += sizeof(real) * NumParameters * BUFFER_SIZE;
-         if (Populations == NULL || PopulationParams == NULL)
-            printFatalError("loadPopulationsDefinition", "Out of memory.");
-         for (k=0; k<NumPopulations-1; k++)
-            Populations[k].Parameters = &(PopulationParams[k*NumParameters]);
-      }
-   }
-   p = &(Populations[NumPopulations-1]);
-
-   /*** Definition of the population parameters. ***/
-   if (NumRealParams != NumParameters + BASIC_REAL_PARAMETERS) { // Is number of parameters incorrect?
-      return 1;
-   }
-   p->N = (indexn)RealParams[0];
-   if (p->N <= 0) { // Is a positive integer?
-      return 1;
-   }
-   p->JExt  = (real)RealParams[1];
-   p->DJExt = (real)RealParams[2];
-   p->CExt  = (real)RealParams[3];
-   p->NuExt = (real)RealParams[4];
-   p->Parameters = &(PopulationParams[(NumPopulations-1)*NumParameters]);
-   for (k=0; k<NumParameters; k++)
-      p->Parameters[k] = (real) RealParams[BASIC_REAL_PARAMETERS + k];
-
-   /*** Definition of the fields needed for efficiency. ***/
-   p->InvNuExt = 1000.0 / (p->NuExt*p->CExt*p->N);
-
-   doubleToTimex(START_TIME_OFFSET, p->Emission);
-   p->Emission.Millis -= p->InvNuExt * log(1.0-Random());
-   if (p->Emission.Millis > 1.0) { // Optimization of time representation.
-      k = (int)(p->Emission.Millis);
-      p->Emission.Seconds += k;
-      p->Emission.Millis -= (double)k;
-   }
-
-   doubleToTimex(START_TIME_OFFSET, p->LastUpdate);
-   p->SpikeCounter = 0;
-
-   p->ID = NumPopulations - 1;
-   
-   /*** Definition of the fields needed for efficiency. ***/
-   p->JTab = NULL;
-   if (makeGaussianLUT(&(p->JTab), ANALOG_DEPTH, p->JExt, p->JExt*p->DJExt, 0.0, 2.0*p->JExt))
-      printFatalError("loadPopulationsDefinition", "Out of memory.");
-   
-   /*** Update the total number of neurons in the network. ***/
-   NumNeurons += p->N;
-
-   return 0;
-}
-
-
-
-/*---------------------*
- *  createPopulations  *
- *---------------------*/
-
-/**
- *  Functions called after the populations definition. 
- *  It allocates the array of neurons defining their fields.
- */
-
-void createPopulations ()
-{
-   int n, k, p;
-   indexn i;
-
-   /*** Allocates memory for global variables. ***/
-   Neurons = (neuron *)getMemory(sizeof(neuron) * NumNeurons, "ERROR (createBasicPopulations): Out of memory.");
-   NeuronStateVars = (real *)getMemory(sizeof(real)*NumNeurons * NumNeuronVariables, "ERROR (createBasicPopulations): Out of memory.");
-
-   /*** Definition of the single neurons of the network. ***/
-   n = 0;
-   k = 0;
-   for (p=0; p<NumPopulations; p++) 
-   {
-      Populations[p].Neurons = &(Neurons[n]);
-      for (i=0; i<Populations[p].N; i++) 
-      {
-         Populations[p].Neurons[i].Pop = &(Populations[p]);
-         Populations[p].Neurons[i].Stim = NULL;
-         Populations[p].Neurons[i].StateVar = &(NeuronStateVars[k]);
-         k += NumNeuronVariables;
-         /*** The other fields have to be initialized when the initial ***
-          *** conditions of the network are set (see init.c).          ***/
-      }
-
-      n += Populations[p].N;
-   }
-
-}
-
-
-
-/*----------------------*
- *  getPopulationParam  *
- *----------------------*/
-
-/**
- *  Returns the value of the parameter ParamNum of the 
- *  population Pop, as defined in 'module.ini'.
- *
- *  WARNING: Only parameter n. 4 is managed (NuExt).
- */
-
-double getPopulationParam(int      Pop, /* Population to probe. */
-                          int ParamNum) /* Number of parameter to read. */
-{
-   static population *p;
-   static double    ret;
-
-   if (Pop >= 0 && Pop < NumPopulations) {
-      p = &Populations[Pop];
-
-      if (ParamNum == 4) {// NuExt
-         ret = p->NuExt;
-
-      } else if (ParamNum == 10) { // TauC in the case of VIFCA and LIFCA neurons.
-         if (strcmp(strupr(NeuronType), NT_VIFCA) == 0 || 
-            strcmp(strupr(NeuronType), NT_LIFCA) == 0) { 
-            ret = p->Parameters[ParamNum - BASIC_REAL_PARAMETERS];
-         }
-      }
-
-
-   }
-
-   return ret;
-}
-
-
-/*----------------------*
- *  setPopulationParam  *
- *----------------------*/
-
-/**
- *  Updates online the global parameter of a population, like
- *  the frequency \nu_ext of the external spikes.
- *
- *  WARNING: Only parameter n. 4 is managed (NuExt).
- */
-
-void setPopulationParam(int           Pop, /* Population to update. */
-                        int      ParamNum, /* Number of parameter to change. */
-                        double ParamValue, /* New value to assign to the parameter. */
-                        double       Time) /* Time when the update occur. */
-{
-   static population *p;
-
-   if (Pop >= 0 && Pop < NumPopulations) {
-      p = &Populations[Pop];
-
-      if (ParamNum == 4) { // NuExt
-         p->NuExt = ParamValue;
-         if (p->NuExt <= 0.0) {
-            p->NuExt = 0.0;
-            p->InvNuExt = -1.0; // It is a non sense value.
-            doubleToTimex(Life, p->Emission);
-         } else {
-            p->InvNuExt = 1000.0 / (p->NuExt * p->CExt * p->N);
-            doubleToTimex(Time - p->InvNuExt * log(1-Random()), p->Emission);
-         }
-
-      } else if (ParamNum == 10) { // Is TauC in the case of VIFCA and LIFCA neurons.
-         if ((strcmp(strupr(NeuronType), NT_VIFCA) == 0 || 
-            strcmp(strupr(NeuronType), NT_LIFCA) == 0) && 
-            ParamValue > 0.) { 
-            p->Parameters[ParamNum - BASIC_REAL_PARAMETERS] = ParamValue;
-         }
-      }
-   }
-}
-
-
-
-#undef BASIC_REAL_PARAMETERS
-#undef BUFFER_SIZE
+/**
+ *
+ *   modules.c
+ *
+ *   Library of structures and functions to manage 
+ *   populations of the network.
+ *
+ *   Project    PERSEO 2.0
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+#include "erflib.h"
+#include "randdev.h"
+
+#include "types.h"
+#include "perseo.h"
+#include "neurons.h"
+#include "modules.h"
+#include "events.h"
+#include "checkpoint.h"
+
+
+
+#define STRING_SIZE 256
+
+
+
+/*----------------------*
+ *   GLOBAL VARIABLES   *
+ *----------------------*/
+
+
+/*-----------*
+ *  Neurons  *
+ *-----------*/
+
+PERSEO_LOCAL neuron       *Neurons = NULL; /* All neurons in the network. */
+PERSEO_LOCAL real *NeuronStateVars = NULL; /* Array containing all the state variables of the neurons in the network. */
+PERSEO_LOCAL indexn     NumNeurons = 0;    /* Total number of neurons in the network. */
+
+
+/*---------------*
+ *  Populations  *
+ *---------------*/
+
+PERSEO_LOCAL population *Populations = NULL; /* Array of basic populations defined in the network architecture. */
+PERSEO_LOCAL real  *PopulationParams = NULL; /* A whole array of the variable parameters for the Populations. */
+PERSEO_LOCAL int      NumPopulations = 0;    /* Number of basic populations (length of Populations). */
+
+PERSEO_LOCAL char   *ModulesFileName = EMPTY_STRING; /* File name containing the definition of the populations ("modules.ini"). */
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+
+/* #define BUFFER_SIZE          16 /* Size of the buffer for variable arrays. */ 
+#define BUFFER_SIZE         256 /* Size of the buffer for variable arrays. */ 
+#define BASIC_REAL_PARAMETERS 5 /* Number of real parameters fixed per population definition. */
+
+
+
+/*---------------------*
+ *   LOCAL VARIABLES   *
+ *---------------------*/
+
+static PERSEO_LOCAL int PopulationsSize = 0; /* Number of populations allocated in Populations. */
+
+
+
+/*-----------------------*
+ *  FUNCTION DEFINITION  *
+ *-----------------------*/
+
+
+/*-----------------------------*
+ *  loadPopulationsDefinition  *
+ *-----------------------------*/
+
+/**
+ *  Adds an element to the <Populations> array, and fills the fields of
+ *  the structure <population>.
+ */
+
+int loadPopulationsDefinition(int NumRealParams, IVreal *RealParams, 
+                              int NumStringParams, char **StringParams)
+{
+   population *p;
+   int k;
+
+   /*** Makes room for the new population. ***/
+   NumPopulations++;
+   if (NumPopulations > PopulationsSize) { // More memory is needed?
+      PopulationsSize += BUFFER_SIZE;
+      if (PopulationsSize == BUFFER_SIZE) {
+         Populations = (population *)getAreaMemory(sizeof(population)*PopulationsSize, MEMORY_POPULATIONS,
+                                                   "ERROR (loadPopulationsDefinition): Out of memory.");
+         PopulationParams = (real *)getAreaMemory(sizeof(real)*PopulationsSize*NumParameters, MEMORY_POPULATIONS,
+                                                  "ERROR (loadPopulationsDefinition): Out of memory.");
+      } else {
+         Populations = (population *)resizeMemory(Populations, sizeof(population)*(PopulationsSize-BUFFER_SIZE),
+                                                  sizeof(population)*PopulationsSize, MEMORY_POPULATIONS,
+                                                  "ERROR (loadPopulationsDefinition): Out of memory.");
+         PopulationParams = (real *)resizeMemory(PopulationParams, sizeof(real)*(PopulationsSize-BUFFER_SIZE)*NumParameters,
+                                                 sizeof(real)*PopulationsSize*NumParameters, MEMORY_POPULATIONS,
+                                                 "ERROR (loadPopulationsDefinition): Out of memory.");
+         for (k=0; k<NumPopulations-1; k++)
+            Populations[k].Parameters = &(PopulationParams[k*NumParameters]);
+      }
+   }
+   p = &(Populations[NumPopulations-1]);
+
+   /*** Definition of the population parameters. ***/
+   if (NumRealParams != NumParameters + BASIC_REAL_PARAMETERS) { // Is number of parameters incorrect?
+      return 1;
+   }
+   p->N = (indexn)RealParams[0];
+   if (p->N <= 0) { // Is a positive integer?
+      return 1;
+   }
+   p->JExt  = (real)RealParams[1];
+   p->DJExt = (real)RealParams[2];
+   p->CExt  = (real)RealParams[3];
+   p->NuExt = (real)RealParams[4];
+   p->Parameters = &(PopulationParams[(NumPopulations-1)*NumParameters]);
+   for (k=0; k<NumParameters; k++)
+      p->Parameters[k] = (real) RealParams[BASIC_REAL_PARAMETERS + k];
+
+   /*** Definition of the fields needed for efficiency. ***/
+   p->InvNuExt = 1000.0 / (p->NuExt*p->CExt*p->N);
+
+   doubleToTimex(START_TIME_OFFSET, p->Emission); // The first spike is drawn by initExternalStreams.
+
+   doubleToTimex(START_TIME_OFFSET, p->LastUpdate);
+   p->SpikeCounter = 0;
+   p->SpikeTotal   = 0;
+
+   p->ID = NumPopulations - 1;
+   p->RateMod = NULL;
+   
+   /*** Definition of the fields needed for efficiency. ***/
+   p->JTab = getAreaMemory(sizeof(real) * ANALOG_DEPTH, MEMORY_TABLES, "ERROR (loadPopulationsDefinition): Out of memory.");
+   if (makeGaussianLUT(&(p->JTab), ANALOG_DEPTH, p->JExt, p->JExt*p->DJExt, 0.0, 2.0*p->JExt))
+      printFatalError("loadPopulationsDefinition", "Out of memory.");
+   p->Ext = (ext_buffers *)getAreaMemory(sizeof(ext_buffers), MEMORY_POPULATIONS,
+                                         "ERROR (loadPopulationsDefinition): Out of memory.");
+   
+   /*** Update the total number of neurons in the network. ***/
+   NumNeurons += p->N;
+
+   return 0;
+}
+
+
+
+/*---------------------*
+ *  createPopulations  *
+ *---------------------*/
+
+/**
+ *  Functions called after the populations definition. 
+ *  It allocates the array of neurons defining their fields.
+ */
+
+void createPopulations ()
+{
+   int p;
+   indexn i, n;
+   size_t k; /* Offset of the state variables, NumNeuronVariables per neuron. */
+
+   /*** Allocates memory for global variables. ***/
+   Neurons = (neuron *)getAreaMemory(sizeof(neuron) * NumNeurons, MEMORY_NEURONS, "ERROR (createBasicPopulations): Out of memory.");
+   NeuronStateVars = (real *)getAreaMemory(sizeof(real)*NumNeurons * NumNeuronVariables, MEMORY_NEURONS, "ERROR (createBasicPopulations): Out of memory.");
+
+   /*** Definition of the single neurons of the network. ***/
+   n = 0;
+   k = 0;
+   for (p=0; p<NumPopulations; p++) 
+   {
+      Populations[p].Neurons = &(Neurons[n]);
+      for (i=0; i<Populations[p].N; i++) 
+      {
+         Populations[p].Neurons[i].Pop = &(Populations[p]);
+         Populations[p].Neurons[i].Stim = NULL;
+         Populations[p].Neurons[i].StateVar = &(NeuronStateVars[k]);
+         Populations[p].Neurons[i].Probe = 0;
+         k += NumNeuronVariables;
+         /*** The other fields have to be initialized when the initial ***
+          *** conditions of the network are set (see init.c).          ***/
+      }
+
+      n += Populations[p].N;
+   }
+
+}
+
+
+
+/*-----------------------*
+ *  initExternalStreams  *
+ *-----------------------*/
+
+/**
+ *  Initializes the random streams of the external spikes of
+ *  each population from <Seed>, the subsystem and the 
+ *  population index, and draws the first external spike.
+ *  The spike trains do not depend on the order in which the
+ *  populations and the neurons consume random numbers.
+ */
+
+void initExternalStreams (int Seed)
+{
+   population *p;
+   double      t;
+   int         k;
+
+   for (k=0; k<NumPopulations; k++) {
+      p = &(Populations[k]);
+      InitRandomStream(&(p->Ext->ExtStream), Seed, RS_EXTERNAL, (unsigned int)p->ID);
+      InitRandomStream(&(p->Ext->JExtStream), Seed, RS_JEXT, (unsigned int)p->ID);
+      p->NextInterval = EXT_INTERVALS;
+      p->NextWord = EXT_INTERVALS;
+      p->NextJWord = EXT_INTERVALS;
+
+      t = START_TIME_OFFSET + p->InvNuExt * nextExtInterval(p);
+      doubleToTimex(t, p->Emission);
+   }
+}
+
+
+
+/*----------------------*
+ *  refillExtIntervals  *
+ *----------------------*/
+
+/**
+ *  Refills the buffer Ext->Intervals of the population <p>
+ *  and returns its first element.
+ */
+
+double refillExtIntervals (population *p)
+{
+   expFill(&(p->Ext->ExtStream), p->Ext->Intervals, EXT_INTERVALS);
+   p->NextInterval = 1;
+
+   return p->Ext->Intervals[0];
+}
+
+
+
+/*------------------*
+ *  refillExtWords  *
+ *------------------*/
+
+/**
+ *  Refills the buffer Ext->Words of the population <p>
+ *  and returns its first element.
+ */
+
+uint32_t refillExtWords (population *p)
+{
+   wordFill(&(p->Ext->ExtStream), p->Ext->Words, EXT_INTERVALS);
+   p->NextWord = 1;
+
+   return p->Ext->Words[0];
+}
+
+
+
+/*-------------------*
+ *  refillJExtWords  *
+ *-------------------*/
+
+/**
+ *  Refills the buffer Ext->JWords of the population <p>
+ *  and returns its first element.
+ */
+
+uint32_t refillJExtWords (population *p)
+{
+   wordFill(&(p->Ext->JExtStream), p->Ext->JWords, EXT_INTERVALS);
+   p->NextJWord = 1;
+
+   return p->Ext->JWords[0];
+}
+
+
+
+/*----------------------*
+ *  getPopulationParam  *
+ *----------------------*/
+
+/**
+ *  Returns the value of the parameter ParamNum of the 
+ *  population Pop, as defined in 'module.ini'.
+ *
+ *  WARNING: Only parameter n. 4 is managed (NuExt).
+ */
+
+double getPopulationParam(int      Pop, /* Population to probe. */
+                          int ParamNum) /* Number of parameter to read. */
+{
+   population *p;
+   double    ret = 0.0;
+
+   if (Pop >= 0 && Pop < NumPopulations) {
+      p = &Populations[Pop];
+
+      if (ParamNum == 4) {// NuExt
+         ret = p->NuExt;
+
+      } else if (ParamNum == 10) { // TauC in the case of VIFCA and LIFCA neurons.
+         if (strcmp(strupr(NeuronType), NT_VIFCA) == 0 || 
+            strcmp(strupr(NeuronType), NT_LIFCA) == 0) { 
+            ret = p->Parameters[ParamNum - BASIC_REAL_PARAMETERS];
+         }
+      }
+
+
+   }
+
+   return ret;
+}
+
+
+/*----------------------*
+ *  setPopulationParam  *
+ *----------------------*/
+
+/**
+ *  Updates online the global parameter of a population, like
+ *  the frequency \nu_ext of the external spikes.
+ *
+ *  WARNING: Only parameter n. 4 is managed (NuExt).
+ */
+
+void setPopulationParam(int           Pop, /* Population to update. */
+                        int      ParamNum, /* Number of parameter to change. */
+                        double ParamValue, /* New value to assign to the parameter. */
+                        double       Time) /* Time when the update occur. */
+{
+   population *p;
+   double      t;
+
+   if (Pop >= 0 && Pop < NumPopulations) {
+      p = &Populations[Pop];
+
+      if (ParamNum == 4) { // NuExt
+         p->NuExt = ParamValue;
+         if (p->NuExt <= 0.0) {
+            p->NuExt = 0.0;
+            p->InvNuExt = -1.0; // It is a non sense value.
+            doubleToTimex(Life, p->Emission);
+         } else {
+            if (p->RateMod != NULL) // External spikes are thinned from the maximum frequency.
+               p->InvNuExt = 1000.0 / (p->NuExt * p->RateMod->MaxGain * p->CExt * p->N);
+            else
+               p->InvNuExt = 1000.0 / (p->NuExt * p->CExt * p->N);
+            t = Time + p->InvNuExt * nextExtInterval(p); // doubleToTimex evaluates it twice.
+            doubleToTimex(t, p->Emission);
+         }
+
+      } else if (ParamNum == 10) { // Is TauC in the case of VIFCA and LIFCA neurons.
+         if ((strcmp(strupr(NeuronType), NT_VIFCA) == 0 || 
+            strcmp(strupr(NeuronType), NT_LIFCA) == 0) && 
+            ParamValue > 0.) { 
+            p->Parameters[ParamNum - BASIC_REAL_PARAMETERS] = ParamValue;
+         }
+      }
+   }
+}
+
+
+
+/*---------------*
+ *  getRateGain  *
+ *---------------*/
+
+/**
+ *  Returns the gain of the external spike frequency of a
+ *  population modulated by <rm> at the absolute time <Time>.
+ *  Successive calls have to be in increasing time order.
+ */
+
+double getRateGain(rate_modulation *rm,  /* Modulation to evaluate. */
+                   double         Time)  /* Absolute time. */
+{
+   double t, g;
+   int    k;
+
+   t = Time - rm->T0;
+
+   if (rm->Type == RM_SINUSOID) {
+      g = 1.0 + rm->A * sin(6.283185307179586477 * t / rm->Period + rm->Phi);
+
+   } else if (rm->Type == RM_LINEAR) {
+      /*** Moves the cursor to the segment [Time[k], Time[k+1]) containing t. ***/
+      while (rm->Cursor < rm->NumPoints - 1 && rm->Time[rm->Cursor + 1] <= t)
+         rm->Cursor++;
+      k = rm->Cursor;
+      if (t <= rm->Time[0])
+         g = rm->Gain[0];
+      else if (k == rm->NumPoints - 1)
+         g = rm->Gain[k];
+      else
+         g = rm->Gain[k] + (rm->Gain[k+1] - rm->Gain[k]) * (t - rm->Time[k]) / (rm->Time[k+1] - rm->Time[k]);
+
+   } else { // RM_TABLE
+      k = t > 0.0 ? (int)(t / rm->Dt) : 0;
+      if (k >= rm->NumPoints)
+         k = rm->NumPoints - 1;
+      g = rm->Gain[k];
+   }
+
+   return g > 0.0 ? g : 0.0;
+}
+
+
+/*----------------------*
+ *  freeRateModulation  *
+ *----------------------*/
+
+/**
+ *  Frees the memory allocated for the rate modulation <rm>.
+ */
+
+void freeRateModulation(rate_modulation *rm)
+{
+   if (rm == NULL)
+      return;
+
+   if (rm->Time != NULL) {
+      free(rm->Time);
+      releaseMemory(sizeof(double) * rm->NumPoints, MEMORY_POPULATIONS);
+   }
+   if (rm->Gain != NULL) {
+      free(rm->Gain);
+      releaseMemory(sizeof(double) * rm->NumPoints, MEMORY_POPULATIONS);
+   }
+   free(rm);
+   releaseMemory(sizeof(rate_modulation), MEMORY_POPULATIONS);
+}
+
+
+/*----------------------*
+ *  releasePopulations  *
+ *----------------------*/
+
+/**
+ *  Frees the neurons and the populations, with their tables
+ *  and rate modulations, so that a new network can be loaded.
+ */
+
+void releasePopulations ()
+{
+   int p;
+
+   for (p=0; p<NumPopulations; p++) {
+      free(Populations[p].JTab);
+      releaseMemory(sizeof(real) * ANALOG_DEPTH, MEMORY_TABLES);
+      free(Populations[p].Ext);
+      releaseMemory(sizeof(ext_buffers), MEMORY_POPULATIONS);
+      freeRateModulation(Populations[p].RateMod);
+   }
+   if (PopulationsSize > 0) {
+      free(Populations);
+      free(PopulationParams);
+      releaseMemory(sizeof(population)*PopulationsSize, MEMORY_POPULATIONS);
+      releaseMemory(sizeof(real)*PopulationsSize*NumParameters, MEMORY_POPULATIONS);
+   }
+   if (Neurons != NULL) {
+      free(Neurons);
+      free(NeuronStateVars);
+      releaseMemory(sizeof(neuron) * NumNeurons, MEMORY_NEURONS);
+      releaseMemory(sizeof(real)*NumNeurons * NumNeuronVariables, MEMORY_NEURONS);
+   }
+   Populations = NULL;
+   PopulationParams = NULL;
+   Neurons = NULL;
+   NeuronStateVars = NULL;
+   NumPopulations = PopulationsSize = 0;
+   NumNeurons = 0;
+}
+
+
+/*---------------------*
+ *  setRateModulation  *
+ *---------------------*/
+
+/**
+ *  Sets the time-varying modulation of the external spike 
+ *  frequency of the population <Pop> starting from <Time>,
+ *  as specified in the string <Spec>:
+ *
+ *     SINUSOID <fT> <fPhi> <fA>
+ *     LINEAR <ft1> <fg1> <ft2> <fg2> ...
+ *     TABLE <sFile> <fDt>
+ *     NONE
+ *
+ *  Returns 1 if <Spec> is not correct, 0 otherwise.
+ */
+
+int setRateModulation(int      Pop, /* Population to modulate. */
+                      char   *Spec, /* Modulation definition. */
+                      double  Time) /* Time when the modulation starts. */
+{
+   rate_modulation *rm;
+   population       *p;
+   char  Type[STRING_SIZE];
+   char  FileName[STRING_SIZE];
+   FILE *GainFile;
+   char *pSpec;
+   double   t, g;
+   int   n, k, Size;
+
+   if (Pop < 0 || Pop >= NumPopulations)
+      return 1;
+   p = &Populations[Pop];
+
+   if (sscanf(Spec, "%s%n", Type, &n) != 1)
+      return 1;
+   pSpec = Spec + n;
+   strupr(Type);
+
+   /*** Builds the new modulation, if any. ***/
+   rm = NULL;
+   if (strcmp(Type, RMT_NONE) != 0) {
+      rm = (rate_modulation *)getAreaMemory(sizeof(rate_modulation), MEMORY_POPULATIONS, "ERROR (setRateModulation): Out of memory.");
+      rm->T0 = Time;
+      rm->NumPoints = 0;
+      rm->Cursor = 0;
+      rm->Time = NULL;
+      rm->Gain = NULL;
+
+      if (strcmp(Type, RMT_SINUSOID) == 0) {
+         rm->Type = RM_SINUSOID;
+         if (sscanf(pSpec, "%lf %lf %lf", &(rm->Period), &(rm->Phi), &(rm->A)) != 3 || rm->Period <= 0.0) {
+            freeRateModulation(rm);
+            return 1;
+         }
+         rm->MaxGain = 1.0 + fabs(rm->A);
+
+      } else if (strcmp(Type, RMT_LINEAR) == 0) {
+         rm->Type = RM_LINEAR;
+
+         /*** Counts the nodes, then loads them. ***/
+         for (Size=0, Spec=pSpec; sscanf(Spec, "%lf %lf%n", &t, &g, &n) == 2; Size++)
+            Spec += n;
+         if (Size == 0) {
+            freeRateModulation(rm);
+            return 1;
+         }
+         rm->NumPoints = Size;
+         rm->Time = (double *)getAreaMemory(sizeof(double) * Size, MEMORY_POPULATIONS, "ERROR (setRateModulation): Out of memory.");
+         rm->Gain = (double *)getAreaMemory(sizeof(double) * Size, MEMORY_POPULATIONS, "ERROR (setRateModulation): Out of memory.");
+         for (k=0, Spec=pSpec; k<Size; k++) {
+            sscanf(Spec, "%lf %lf%n", &(rm->Time[k]), &(rm->Gain[k]), &n);
+            Spec += n;
+            if (k > 0 && rm->Time[k] < rm->Time[k-1]) { // Nodes have to be sorted in time.
+               freeRateModulation(rm);
+               return 1;
+            }
+         }
+
+      } else if (strcmp(Type, RMT_TABLE) == 0) {
+         rm->Type = RM_TABLE;
+         if (sscanf(pSpec, "%s %lf", FileName, &(rm->Dt)) != 2 || rm->Dt <= 0.0 ||
+             (GainFile = fopen(FileName, "rt")) == NULL) {
+            freeRateModulation(rm);
+            return 1;
+         }
+
+         /*** Loads the gains, one per sampling period. ***/
+         Size = 0;
+         while (fscanf(GainFile, "%lf", &g) == 1) {
+            if (rm->NumPoints == Size) { // More memory is needed?
+               Size += BUFFER_SIZE;
+               rm->Gain = (double *)resizeMemory(rm->Gain, sizeof(double) * (Size - BUFFER_SIZE), sizeof(double) * Size,
+                                                 MEMORY_POPULATIONS, "ERROR (setRateModulation): Out of memory.");
+            }
+            rm->Gain[rm->NumPoints++] = g;
+         }
+         fclose(GainFile);
+         if (rm->NumPoints == 0) {
+            freeRateModulation(rm);
+            return 1;
+         }
+         rm->Gain = (double *)resizeMemory(rm->Gain, sizeof(double) * Size, sizeof(double) * rm->NumPoints,
+                                           MEMORY_POPULATIONS, "ERROR (setRateModulation): Out of memory.");
+
+      } else {
+         freeRateModulation(rm);
+         return 1;
+      }
+
+      /*** The upper bound of a piecewise-linear or constant gain is on the nodes, ***
+       *** and it is 0 from the node following the last positive one.           ***/
+      rm->End = HUGE_VAL;
+      if (rm->Type != RM_SINUSOID) {
+         for (k=0, rm->MaxGain=0.0; k<rm->NumPoints; k++)
+            if (rm->Gain[k] > rm->MaxGain)
+               rm->MaxGain = rm->Gain[k];
+         for (k=rm->NumPoints-1; k>=0 && rm->Gain[k]<=0.0; k--)
+            ;
+         if (k < 0)
+            rm->End = -HUGE_VAL;
+         else if (k < rm->NumPoints - 1)
+            rm->End = rm->Type == RM_LINEAR ? rm->Time[k+1] : (k + 1) * rm->Dt;
+      }
+   }
+
+   /*** Replaces the old modulation. ***/
+   freeRateModulation(p->RateMod);
+   p->RateMod = rm;
+
+   /*** Draws the next external spike from the maximum frequency. ***/
+   if (p->NuExt <= 0.0 || (rm != NULL && rm->MaxGain <= 0.0)) {
+      p->InvNuExt = -1.0; // It is a non sense value.
+      doubleToTimex(Life, p->Emission);
+   } else {
+      p->InvNuExt = 1000.0 / (p->NuExt * (rm != NULL ? rm->MaxGain : 1.0) * p->CExt * p->N);
+      t = Time + p->InvNuExt * nextExtInterval(p);
+      doubleToTimex(t, p->Emission);
+   }
+
+   return 0;
+}
+
+
+/*-------------------------*
+ *  checkpointPopulations  *
+ *-------------------------*/
+
+/**
+ *  Writes on <File> the dynamic state of the populations
+ *  (external spike streams and rate modulations included)
+ *  and of the neurons. Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointPopulations(FILE *File)
+{
+   population      *p;
+   rate_modulation *rm;
+   indexn  i;
+   int     k;
+
+   for (k=0; k<NumPopulations; k++) {
+      p = &Populations[k];
+      if (writeCheckpointData(File, &(p->InvNuExt), sizeof(p->InvNuExt)) ||
+          writeCheckpointData(File, &(p->NuExt), sizeof(p->NuExt)) ||
+          writeCheckpointData(File, &(p->Emission), sizeof(p->Emission)) ||
+          writeCheckpointData(File, &(p->LastUpdate), sizeof(p->LastUpdate)) ||
+          writeCheckpointData(File, &(p->SpikeCounter), sizeof(p->SpikeCounter)) ||
+          writeCheckpointData(File, &(p->Ext->ExtStream), sizeof(p->Ext->ExtStream)) ||
+          writeCheckpointData(File, &(p->Ext->JExtStream), sizeof(p->Ext->JExtStream)) ||
+          writeCheckpointData(File, p->Ext->Intervals, sizeof(p->Ext->Intervals)) ||
+          writeCheckpointData(File, &(p->NextInterval), sizeof(p->NextInterval)) ||
+          writeCheckpointData(File, p->Ext->Words, sizeof(p->Ext->Words)) ||
+          writeCheckpointData(File, &(p->NextWord), sizeof(p->NextWord)) ||
+          writeCheckpointData(File, p->Ext->JWords, sizeof(p->Ext->JWords)) ||
+          writeCheckpointData(File, &(p->NextJWord), sizeof(p->NextJWord)) ||
+          writeCheckpointData(File, p->Parameters, sizeof(real) * NumParameters))
+         return 1;
+
+      /*** The rate modulation, with its nodes. ***/
+      rm = p->RateMod;
+      i = rm != NULL;
+      if (writeCheckpointData(File, &i, sizeof(i)))
+         return 1;
+      if (rm != NULL)
+         if (writeCheckpointData(File, rm, sizeof(rate_modulation)) ||
+             (rm->Time != NULL && writeCheckpointData(File, rm->Time, sizeof(double) * rm->NumPoints)) ||
+             (rm->Gain != NULL && writeCheckpointData(File, rm->Gain, sizeof(double) * rm->NumPoints)))
+            return 1;
+   }
+
+   /*** The neurons. ***/
+   if (writeCheckpointData(File, NeuronStateVars, sizeof(real) * NumNeuronVariables * NumNeurons))
+      return 1;
+   for (i=0; i<NumNeurons; i++)
+      if (writeCheckpointData(File, &(Neurons[i].Tr), sizeof(timex)) ||
+          writeCheckpointData(File, &(Neurons[i].Te), sizeof(timex)) ||
+          writeCheckpointData(File, &(Neurons[i].LastUpdate), sizeof(timex)))
+         return 1;
+
+   return 0;
+}
+
+
+/*----------------------*
+ *  restorePopulations  *
+ *----------------------*/
+
+/**
+ *  Reads from <File> the state of the populations and of
+ *  the neurons written by checkpointPopulations.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int restorePopulations(FILE *File)
+{
+   population      *p;
+   rate_modulation *rm;
+   indexn  i;
+   int     k;
+
+   for (k=0; k<NumPopulations; k++) {
+      p = &Populations[k];
+      if (readCheckpointData(File, &(p->InvNuExt), sizeof(p->InvNuExt)) ||
+          readCheckpointData(File, &(p->NuExt), sizeof(p->NuExt)) ||
+          readCheckpointData(File, &(p->Emission), sizeof(p->Emission)) ||
+          readCheckpointData(File, &(p->LastUpdate), sizeof(p->LastUpdate)) ||
+          readCheckpointData(File, &(p->SpikeCounter), sizeof(p->SpikeCounter)) ||
+          readCheckpointData(File, &(p->Ext->ExtStream), sizeof(p->Ext->ExtStream)) ||
+          readCheckpointData(File, &(p->Ext->JExtStream), sizeof(p->Ext->JExtStream)) ||
+          readCheckpointData(File, p->Ext->Intervals, sizeof(p->Ext->Intervals)) ||
+          readCheckpointData(File, &(p->NextInterval), sizeof(p->NextInterval)) ||
+          readCheckpointData(File, p->Ext->Words, sizeof(p->Ext->Words)) ||
+          readCheckpointData(File, &(p->NextWord), sizeof(p->NextWord)) ||
+          readCheckpointData(File, p->Ext->JWords, sizeof(p->Ext->JWords)) ||
+          readCheckpointData(File, &(p->NextJWord), sizeof(p->NextJWord)) ||
+          readCheckpointData(File, p->Parameters, sizeof(real) * NumParameters) ||
+          readCheckpointData(File, &i, sizeof(i)))
+         return 1;
+
+      /*** The rate modulation, with its nodes. ***/
+      freeRateModulation(p->RateMod);
+      p->RateMod = NULL;
+      if (i) {
+         rm = (rate_modulation *)getAreaMemory(sizeof(rate_modulation), MEMORY_POPULATIONS, "ERROR (restorePopulations): Out of memory.");
+         if (readCheckpointData(File, rm, sizeof(rate_modulation))) {
+            free(rm);
+            releaseMemory(sizeof(rate_modulation), MEMORY_POPULATIONS);
+            return 1;
+         }
+         if (rm->Time != NULL) {
+            rm->Time = (double *)getAreaMemory(sizeof(double) * rm->NumPoints, MEMORY_POPULATIONS, "ERROR (restorePopulations): Out of memory.");
+            if (readCheckpointData(File, rm->Time, sizeof(double) * rm->NumPoints))
+               return 1;
+         }
+         if (rm->Gain != NULL) {
+            rm->Gain = (double *)getAreaMemory(sizeof(double) * rm->NumPoints, MEMORY_POPULATIONS, "ERROR (restorePopulations): Out of memory.");
+            if (readCheckpointData(File, rm->Gain, sizeof(double) * rm->NumPoints))
+               return 1;
+         }
+         p->RateMod = rm;
+      }
+   }
+
+   /*** The neurons. ***/
+   if (readCheckpointData(File, NeuronStateVars, sizeof(real) * NumNeuronVariables * NumNeurons))
+      return 1;
+   for (i=0; i<NumNeurons; i++)
+      if (readCheckpointData(File, &(Neurons[i].Tr), sizeof(timex)) ||
+          readCheckpointData(File, &(Neurons[i].Te), sizeof(timex)) ||
+          readCheckpointData(File, &(Neurons[i].LastUpdate), sizeof(timex)))
+         return 1;
+
+   return 0;
+}
+
+
+
+#undef BASIC_REAL_PARAMETERS
+#undef BUFFER_SIZE
 #undef STRING_SIZE
\ No newline at end of file
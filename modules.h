@@ -1,136 +1,302 @@
-/**
- *
- *   modules.h
- *
- *   Library of structures and functions to manage 
- *   populations of the network.
- *
- *   Project: PERSEO 2.0
- *
- */
-
-
-
-#ifndef __MODULES_H__
-#define __MODULES_H__
-
-
-
-#include "invar.h"
-
-#include "types.h"
-#include "stimuli.h"
-
-
-
-/**
- *  The structure defining a generic neuron.
- */
-
-typedef struct _neuron {
-    struct _population *Pop; /* Population the neuron belongs to. */
-           stimulus   *Stim; /* Stimulus, if any, affecting the neuron. */
-           real   *StateVar; /* Array of neuron state variables (NumNeuronVariables elements). */
-           timex         Tr; /* Arriving time of the last pre-synaptic spike. */
-           timex         Te; /* Emission time of the last spike. */
-           timex LastUpdate; /* Time of last update of the fields in the structure. */
-        } neuron;
-
-
-/**
- *  The structure defining a generic population.
- */
-
-typedef struct _population {
-        /*** Fields needed for making the simulation efficient. ***/
-        real    InvNuExt; /* Reciprocal of the external spike frequency (1/NuExt). */
-        timex   Emission; /* Time when the last external spike was received. */
-        timex LastUpdate; /* Time of the last update of local variables (SpikeCounter). */
-        int SpikeCounter; /* Number of spikes emitted . */
-        real       *JTab; /* Look-up table for synaptic efficacy with external neurons. */
-        int           ID; /* Corresponding index in the Populations array. */
-
-        /*** Population parameters. ***/
-        real *Parameters; /* Array of parameters needed for the evolution of neuron dynamics. */
-        real        CExt;
-        real       NuExt;
-        real        JExt;
-        real       DJExt;
-        indexn         N; /* Number of neuron in population. */
-
-        struct _neuron  *Neurons; /* Neuron array belonging to the population. */
-}  population;
-
-
-
-/*--------------------*
- *  GLOBAL VARIABLES  *
- *--------------------*/
-
-
-/*-----------*
- *  Neurons  *
- *-----------*/
-
-extern neuron       *Neurons;   /* All neurons in the network. */
-extern real *NeuronStateVars;   /* Array containing all the state variables of the neurons in the network. */
-extern indexn     NumNeurons;   /* Total number of neurons in the network. */
-
-
-/*---------------*
- *  Populations  *
- *---------------*/
-
-extern population *Populations; /* Array of basic populations defined in the network architecture. */
-extern int      NumPopulations; /* Number of basic populations (length of Populations). */
-
-extern char   *ModulesFileName; /* File name containing the definition of the populations ("modules.ini"). */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-
-/**
- *  Adds an element to the <Populations> array, and fills the fields of
- *  the structure <population>.
- */
-int loadPopulationsDefinition(int NumRealParams, IVreal *RealParams, 
-                              int NumStringParams, char **StringParams);
-
-
-/**
- *  Functions called after the populations definition. 
- *  It allocates the array of neurons defining their fields.
- */
-void createPopulations ();
-
-
-/**
- *  Returns the value of the parameter ParamNum of the 
- *  population Pop, as defined in 'module.ini'.
- *
- *  WARNING: Only parameter n. 4 is managed (NuExt).
- */
-
-double getPopulationParam(int      Pop,  /* Population to probe. */
-                          int ParamNum); /* Number of parameter to read. */
-
-
-/**
- *  Updates online the global parameter of a population, like
- *  the frequency \nu_ext of the external spikes.
- *
- *  WARNING: Only parameter n. 4 is managed (NuExt).
- */
-
-void setPopulationParam(int           Pop,  /* Population to update. */
-                        int      ParamNum,  /* Number of parameter to change. */
-                        double ParamValue,  /* New value to assign to the parameter. */
-                        double       Time); /* Time when the update occur. */
-
-
-
+/**
+ *
+ *   modules.h
+ *
+ *   Library of structures and functions to manage 
+ *   populations of the network.
+ *
+ *   Project: PERSEO 2.0
+ *
+ */
+
+
+
+#ifndef __MODULES_H__
+#define __MODULES_H__
+
+
+
+#include <stdio.h>
+
+#include "invar.h"
+
+#include "types.h"
+#include "randdev.h"
+#include "stimuli.h"
+
+
+
+/**
+ *  The structure defining a generic neuron.
+ */
+
+typedef struct _neuron {
+    struct _population *Pop; /* Population the neuron belongs to. */
+           stimulus   *Stim; /* Stimulus, if any, affecting the neuron. */
+           real   *StateVar; /* Array of neuron state variables (NumNeuronVariables elements). */
+           timex         Tr; /* Arriving time of the last pre-synaptic spike. */
+           timex         Te; /* Emission time of the last spike. */
+           timex LastUpdate; /* Time of last update of the fields in the structure. */
+   unsigned char      Probe; /* Probes attached by the observers (PROBE_* flags). */
+        } neuron;
+
+
+/*** Probes attachable to a neuron (see attachObservers in results.c). ***/
+#define PROBE_STATE    0x01 /* Logs the state updates of the neuron. */
+#define PROBE_CURRENT  0x02 /* Accumulates the afferent current of the neuron. */
+#define PROBE_SPIKES   0x04 /* Logs the spikes emitted by the neuron. */
+#define PROBE_SYN_POST 0x08 /* Logs the updates of the synapses with post-synaptic neuron ... */
+#define PROBE_SYN_PRE  0x10 /* ... and pre-synaptic neuron both probed. */
+
+
+/*** RateModulationType ***/
+#define RMT_SINUSOID "SINUSOID" /* NuExt (1 + A sin(2 pi (t-T0)/Period + Phi)). */
+#define RMT_LINEAR   "LINEAR"   /* Piecewise-linear gain through (t_k, g_k) nodes. */
+#define RMT_TABLE    "TABLE"    /* Piecewise-constant gain sampled every Dt ms. */
+#define RMT_NONE     "NONE"     /* Removes the modulation. */
+
+#define RM_SINUSOID 1
+#define RM_LINEAR   2
+#define RM_TABLE    3
+
+
+/**
+ *  Time-varying modulation of the frequency of the external 
+ *  spikes received by a population: NuExt(t) = NuExt Gain(t).
+ *  External spikes are drawn at the frequency NuExt MaxGain 
+ *  and thinned keeping each one with probability 
+ *  Gain(t)/MaxGain, so that the statistics of the 
+ *  inhomogeneous Poisson process are exact.
+ */
+
+typedef struct _rate_modulation {
+        int        Type; /* RM_SINUSOID, RM_LINEAR or RM_TABLE. */
+        double       T0; /* Absolute time when the modulation starts. */
+        double  MaxGain; /* Upper bound of Gain(t). */
+        double      End; /* Time relative to T0 from which Gain(t) stays 0, HUGE_VAL if never. */
+        double   Period; /* Period of the sinusoid (RM_SINUSOID). */
+        double      Phi; /* Phase shift of the sinusoid (RM_SINUSOID). */
+        double        A; /* Amplitude of the sinusoid (RM_SINUSOID). */
+        double       Dt; /* Sampling period of the table (RM_TABLE). */
+        int   NumPoints; /* Number of elements in Time and Gain. */
+        double    *Time; /* Node times relative to T0 (RM_LINEAR). */
+        double    *Gain; /* Node gains (RM_LINEAR and RM_TABLE). */
+        int      Cursor; /* Last visited node, time only increases. */
+}  rate_modulation;
+
+
+#define EXT_INTERVALS 256 /* Length of the buffer of pre-drawn external inter-spike intervals. */
+
+
+/**
+ *  The random streams of the external spikes of a population
+ *  and the buffers they refill in batch, allocated out of
+ *  the population structure to keep it small.
+ */
+
+typedef struct _ext_buffers {
+        rand_stream  ExtStream; /* Random stream of the external spike times and targets. */
+        rand_stream JExtStream; /* Random stream of the external synaptic efficacies. */
+        double Intervals[EXT_INTERVALS]; /* Pre-drawn external intervals in units of InvNuExt. */
+        uint32_t   Words[EXT_INTERVALS]; /* Pre-drawn words of the thinning and of the targets. */
+        uint32_t  JWords[EXT_INTERVALS]; /* Pre-drawn words choosing the external efficacies in JTab. */
+}  ext_buffers;
+
+
+/**
+ *  The structure defining a generic population.
+ */
+
+typedef struct _population {
+        /*** Fields needed for making the simulation efficient, ***
+         *** the ones of the external spikes first.            ***/
+        timex   Emission; /* Time when the last external spike was received. */
+        real    InvNuExt; /* Reciprocal of the external spike frequency (1/NuExt). */
+        int NextInterval; /* Next element of Ext->Intervals to use. */
+        int     NextWord; /* Next element of Ext->Words to use. */
+        int    NextJWord; /* Next element of Ext->JWords to use. */
+        struct _ext_buffers         *Ext; /* Streams and buffers of the external spikes. */
+        struct _rate_modulation *RateMod; /* Time-varying modulation of NuExt, NULL if absent. */
+        real       *JTab; /* Look-up table for synaptic efficacy with external neurons. */
+        timex LastUpdate; /* Time of the last update of local variables (SpikeCounter). */
+        int SpikeCounter; /* Number of spikes emitted . */
+        long  SpikeTotal; /* Number of spikes emitted since the start of the run (see telemetry.h). */
+        int           ID; /* Corresponding index in the Populations array. */
+
+        /*** Population parameters. ***/
+        real *Parameters; /* Array of parameters needed for the evolution of neuron dynamics. */
+        real        CExt;
+        real       NuExt;
+        real        JExt;
+        real       DJExt;
+        indexn         N; /* Number of neuron in population. */
+
+        struct _neuron  *Neurons; /* Neuron array belonging to the population. */
+}  population;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+
+/*-----------*
+ *  Neurons  *
+ *-----------*/
+
+extern PERSEO_LOCAL neuron       *Neurons;   /* All neurons in the network. */
+extern PERSEO_LOCAL real *NeuronStateVars;   /* Array containing all the state variables of the neurons in the network. */
+extern PERSEO_LOCAL indexn     NumNeurons;   /* Total number of neurons in the network. */
+
+
+/*---------------*
+ *  Populations  *
+ *---------------*/
+
+extern PERSEO_LOCAL population *Populations; /* Array of basic populations defined in the network architecture. */
+extern PERSEO_LOCAL int      NumPopulations; /* Number of basic populations (length of Populations). */
+
+extern PERSEO_LOCAL char   *ModulesFileName; /* File name containing the definition of the populations ("modules.ini"). */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+
+/**
+ *  Adds an element to the <Populations> array, and fills the fields of
+ *  the structure <population>.
+ */
+int loadPopulationsDefinition(int NumRealParams, IVreal *RealParams, 
+                              int NumStringParams, char **StringParams);
+
+
+/**
+ *  Functions called after the populations definition. 
+ *  It allocates the array of neurons defining their fields.
+ */
+void createPopulations ();
+
+
+/**
+ *  Frees the neurons and the populations, with their tables
+ *  and rate modulations, so that a new network can be loaded.
+ */
+void releasePopulations ();
+
+
+/**
+ *  Initializes the random streams of the external spikes of
+ *  each population from <Seed>, and draws the first external 
+ *  spike.
+ */
+void initExternalStreams (int Seed);
+
+
+/**
+ *  Returns the next interval between external spikes of the
+ *  population <p>, exponentially distributed with unitary 
+ *  mean, drawn from the buffer Ext->Intervals refilled in
+ *  batch when needed.
+ */
+#define nextExtInterval(p) ((p)->NextInterval < EXT_INTERVALS ? \
+                            (p)->Ext->Intervals[(p)->NextInterval++] : refillExtIntervals(p))
+
+
+/**
+ *  Refills the buffer Ext->Intervals of the population <p>
+ *  and returns its first element.
+ */
+double refillExtIntervals (struct _population *p);
+
+
+/**
+ *  Return the next 32-bit random word of the population <p>
+ *  respectively from the stream of the external spikes 
+ *  (thinning and targets) and from the one of the external
+ *  synaptic efficacies, drawn from the buffers Ext->Words 
+ *  and Ext->JWords refilled in batch when needed. An index
+ *  is drawn from a single word with wordIndex (randdev.h).
+ */
+#define nextExtWord(p) ((p)->NextWord < EXT_INTERVALS ? \
+                        (p)->Ext->Words[(p)->NextWord++] : refillExtWords(p))
+#define nextJExtWord(p) ((p)->NextJWord < EXT_INTERVALS ? \
+                         (p)->Ext->JWords[(p)->NextJWord++] : refillJExtWords(p))
+
+
+/**
+ *  Refill respectively the buffers Ext->Words and Ext->JWords
+ *  of the population <p> and return their first element.
+ */
+uint32_t refillExtWords (struct _population *p);
+uint32_t refillJExtWords (struct _population *p);
+
+
+/**
+ *  Returns the value of the parameter ParamNum of the 
+ *  population Pop, as defined in 'module.ini'.
+ *
+ *  WARNING: Only parameter n. 4 is managed (NuExt).
+ */
+
+double getPopulationParam(int      Pop,  /* Population to probe. */
+                          int ParamNum); /* Number of parameter to read. */
+
+
+/**
+ *  Updates online the global parameter of a population, like
+ *  the frequency \nu_ext of the external spikes.
+ *
+ *  WARNING: Only parameter n. 4 is managed (NuExt).
+ */
+
+void setPopulationParam(int           Pop,  /* Population to update. */
+                        int      ParamNum,  /* Number of parameter to change. */
+                        double ParamValue,  /* New value to assign to the parameter. */
+                        double       Time); /* Time when the update occur. */
+
+
+/**
+ *  Returns the gain of the external spike frequency of a
+ *  population modulated by <rm> at the absolute time <Time>.
+ *  Successive calls have to be in increasing time order.
+ */
+
+double getRateGain(rate_modulation *rm,   /* Modulation to evaluate. */
+                   double         Time);  /* Absolute time. */
+
+
+/**
+ *  Sets the time-varying modulation of the external spike 
+ *  frequency of the population <Pop> starting from <Time>,
+ *  as specified in the string <Spec>:
+ *
+ *     SINUSOID <fT> <fPhi> <fA>
+ *     LINEAR <ft1> <fg1> <ft2> <fg2> ...
+ *     TABLE <sFile> <fDt>
+ *     NONE
+ *
+ *  Returns 1 if <Spec> is not correct, 0 otherwise.
+ */
+
+int setRateModulation(int      Pop,  /* Population to modulate. */
+                      char   *Spec,  /* Modulation definition. */
+                      double  Time); /* Time when the modulation starts. */
+
+
+/**
+ *  Writes on <File> the dynamic state of the populations
+ *  (external spike streams and rate modulations included)
+ *  and of the neurons, and reads it back.
+ *  Returns 1 on error, 0 otherwise (see checkpoint.h).
+ */
+
+int checkpointPopulations(FILE *File);
+int restorePopulations(FILE *File);
+
+
+
 #endif /* __MODULES_H__ */
\ No newline at end of file
@@ -0,0 +1,253 @@
+/*
+ *
+ *   perseo-top.c
+ *
+ *   Shows the progress of the simulations running on the
+ *   machine with Telemetry set (see telemetry.h), reading
+ *   their shared memory segments with no effect on them.
+ *
+ *      perseo-top [-d <seconds>] [-n <updates>] [-p <pid>] [-c]
+ *
+ *   The table of the simulations is updated every <seconds>
+ *   (2 by default) for <updates> times (forever by default,
+ *   1 prints a single table with no screen clearing). With
+ *   -p the rates of the populations, the queues of the delay
+ *   layers and the memory of the simulations of the process
+ *   <pid> are shown too. With -c the segments left by ended
+ *   processes (e.g. killed) are removed.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "telemetry.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define SHM_DIRECTORY "/dev/shm" /* Directory where the segments are listed. */
+#define MAX_SEGMENTS  1024       /* Maximum number of segments shown. */
+#define MAX_RETRIES   1000       /* Attempts to copy a segment not being updated. */
+#define BUFFER_DIM    256        /* Maximum static string size. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*---------------*
+ *  readSegment  *
+ *---------------*/
+
+/**
+ *  Returns a copy of the segment <Name>, taken while the
+ *  simulation was not updating it, or NULL if it is not a
+ *  valid segment. The copy has to be freed.
+ */
+
+static telemetry *readSegment(char *Name)
+{
+   telemetry *Segment, *Copy;
+   struct stat st;
+   uint32_t Sequence;
+   int Fd, k;
+
+   if ((Fd = shm_open(Name, O_RDONLY, 0)) < 0)
+      return NULL;
+   if (fstat(Fd, &st) != 0 || st.st_size < (off_t)sizeof(telemetry) ||
+       (Segment = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, Fd, 0)) == MAP_FAILED) {
+      close(Fd);
+      return NULL;
+   }
+   close(Fd);
+
+   Copy = NULL;
+   if (Segment->Magic == TELEMETRY_MAGIC && Segment->Version == TELEMETRY_VERSION &&
+       Segment->Size <= st.st_size && (Copy = malloc(Segment->Size)) != NULL)
+      for (k=0; k<MAX_RETRIES; k++) {
+         Sequence = Segment->Sequence;
+         __sync_synchronize();
+         if ((Sequence & 1) == 0) {
+            memcpy(Copy, Segment, Segment->Size);
+            __sync_synchronize();
+            if (Segment->Sequence == Sequence)
+               break;
+         }
+         usleep(100);
+      }
+   if (Copy != NULL && k == MAX_RETRIES) {
+      free(Copy);
+      Copy = NULL;
+   }
+
+   munmap(Segment, st.st_size);
+   return Copy;
+}
+
+
+/*------------------*
+ *  formatDuration  *
+ *------------------*/
+
+/**
+ *  Writes in <String> the duration <Seconds> as h:mm:ss.
+ */
+
+static char *formatDuration(char *String, double Seconds)
+{
+   long s = (long)(Seconds + 0.5);
+
+   if (Seconds < 0.0 || Seconds > 1e9)
+      sprintf(String, "-");
+   else
+      sprintf(String, "%ld:%02ld:%02ld", s / 3600, (s / 60) % 60, s % 60);
+   return String;
+}
+
+
+/*----------------*
+ *  printDetails  *
+ *----------------*/
+
+/**
+ *  Prints the rates, the queues and the memory of the
+ *  simulation <T>.
+ */
+
+static void printDetails(telemetry *T)
+{
+   double *Rates = telemetryRates(T);
+   int32_t *Queues = telemetryQueues(T);
+   int k;
+
+   printf("\n%d  %s\n", T->Pid, T->Label);
+   printf("   Spikes managed: %llu, pending events: %d\n", (unsigned long long)T->ManagedSpikes, T->PendingEvents);
+   printf("   Memory (Mbytes):");
+   for (k=0; k<T->NumMemory && k<TELEMETRY_MEMORY; k++)
+      printf(" %.*s %.1f", TELEMETRY_NAME, T->MemoryName[k], T->Memory[k] / 1024.0 / 1024.0);
+   printf("\n   Rates (Hz):");
+   for (k=0; k<T->NumPopulations; k++)
+      printf("%s%d:%.2f", k % 8 == 0 ? "\n     " : "  ", k, Rates[k]);
+   printf("\n   Queues (spikes):");
+   for (k=0; k<T->NumLayers; k++)
+      printf("%s%d:%d", k % 8 == 0 ? "\n     " : "  ", k, Queues[k]);
+   printf("\n");
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   char *Names[MAX_SEGMENTS], Name[BUFFER_DIM], Buffer[BUFFER_DIM];
+   telemetry *Segments[MAX_SEGMENTS], *T;
+   struct dirent *Entry;
+   DIR *Dir;
+   double Delay, Now;
+   long Updates, n;
+   int Pid, NumSegments, k, Opt;
+   int Clean;
+   char *Status;
+   struct timespec ts;
+
+   Delay   = 2.0;
+   Updates = -1;
+   Pid     = -1;
+   Clean   = 0;
+   while ((Opt = getopt(ArgC, ArgV, "d:n:p:c")) != -1)
+      switch (Opt) {
+         case 'd': Delay = atof(optarg); break;
+         case 'n': Updates = atol(optarg); break;
+         case 'p': Pid = atoi(optarg); break;
+         case 'c': Clean = 1; break;
+         default:
+            fprintf(stderr, "Usage: %s [-d <seconds>] [-n <updates>] [-p <pid>] [-c]\n", ArgV[0]);
+            return EXIT_FAILURE;
+      }
+
+   for (n=0; Updates < 0 || n < Updates; n++) {
+      if (n > 0)
+         usleep((useconds_t)(Delay * 1e6));
+
+      /*** Copies the segments. ***/
+      if ((Dir = opendir(SHM_DIRECTORY)) == NULL) {
+         fprintf(stderr, "ERROR (perseo-top): unable to list '%s'.\n", SHM_DIRECTORY);
+         return EXIT_FAILURE;
+      }
+      NumSegments = 0;
+      while ((Entry = readdir(Dir)) != NULL && NumSegments < MAX_SEGMENTS)
+         if (strncmp(Entry->d_name, TELEMETRY_PREFIX + 1, strlen(TELEMETRY_PREFIX) - 1) == 0) {
+            sprintf(Name, "/%.*s", BUFFER_DIM - 2, Entry->d_name);
+            if ((T = readSegment(Name)) == NULL)
+               continue;
+            Names[NumSegments] = strdup(Name);
+            Segments[NumSegments++] = T;
+         }
+      closedir(Dir);
+      clock_gettime(CLOCK_REALTIME, &ts);
+      Now = ts.tv_sec + ts.tv_nsec * 1e-9;
+
+      /*** Removes the segments of the ended processes. ***/
+      if (Clean) {
+         for (k=0; k<NumSegments; k++)
+            if (kill(Segments[k]->Pid, 0) != 0 && errno == ESRCH) {
+               shm_unlink(Names[k]);
+               printf("Removed %s (process %d ended).\n", Names[k], Segments[k]->Pid);
+            }
+         return 0;
+      }
+
+      /*** Prints the table of the simulations. ***/
+      if (Updates != 1)
+         printf("\033[H\033[2J");
+      printf("%d simulations\n\n", NumSegments);
+      printf("%7s %-7s %11s %6s %10s %11s %9s %9s %8s  %s\n",
+             "PID", "STATUS", "TIME(ms)", "LIFE%", "MS/s", "SPIKES/s", "ETA", "MEM(MB)", "AGE(s)", "LABEL");
+      for (k=0; k<NumSegments; k++) {
+         T = Segments[k];
+         if (kill(T->Pid, 0) != 0 && errno == ESRCH)
+            Status = "dead";
+         else
+            Status = T->Status == TELEMETRY_ENDED ? "ended" : "running";
+         printf("%7d %-7s %11.7g %6.1f %10.4g %11.4g %9s %9.1f %8.0f  %s\n",
+                T->Pid, Status, T->NetworkTime, T->Life > 0.0 ? 100.0 * T->NetworkTime / T->Life : 0.0,
+                T->Speed, T->SpikeRate, formatDuration(Buffer, T->ETA),
+                T->Memory[0] / 1024.0 / 1024.0, Now - T->Wall, T->Label);
+      }
+      for (k=0; k<NumSegments; k++)
+         if (Segments[k]->Pid == Pid)
+            printDetails(Segments[k]);
+      fflush(stdout);
+
+      for (k=0; k<NumSegments; k++) {
+         free(Segments[k]);
+         free(Names[k]);
+      }
+   }
+
+   return 0;
+}
+
+
+
+#undef SHM_DIRECTORY
+#undef MAX_SEGMENTS
+#undef MAX_RETRIES
+#undef BUFFER_DIM
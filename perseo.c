@@ -1,527 +1,637 @@
-/*
- *
- *   perseo.c
- *
- *   The core of the simulation where the external spikes are created 
- *   and managed, and the dynamic variables are updated.
- *   The main function is here.
- *
- *   Project: PERSEO 2.x
- *
- */
-
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <math.h>
-#include <signal.h>
-
-#include "types.h"
-#include "queue.h"
-#include "timer.h"
-#include "invar.h"
-#include "randdev.h"
-
-#include "perseo.h"
-#include "init.h"
-#include "results.h"
-#include "stimuli.h"
-#include "events.h"
-#include "commands.h"
-
-#include "modules.h"
-#include "delays.h"
-#include "neurons.h"
-
-
-
-/*----------------*
- *  LOCAL MACROS  *
- *-------------- -*/
-
-#define NULL_LAYER -1   /* The null pointer to a delay layer. */
-
-
-
-/*----------------------*
- *   GLOBAL VARIABLES   *
- *----------------------*/
-
-real                 Life;         /* Life time of the simulation in ms. */
-int           NeuronsSeed;         /* Seed of pseudo-random number generator for the initialization of neuron states. */
-int          SynapsesSeed;         /* Seed of pseudo-random number generator for the initialization of synapse states. */
-boolean    QuitSimulation = false; /* If true the simulation interrupts. Is changed *
-                                    * when a signal is sent to the process.         */
-unsigned int MemoryAmount = 0;     /* The amount of memory allocated by Perseo. */
-
-
-
-/*-------------------*
- *  LOCAL VARIABLES  *
- *-------------------*/
-
-int OldestLayer = NULL_LAYER; /* The delay layer containing the oldest spike. */
-void findOldestLayer ();      /* Local function used in a global function. */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/*-----------------------*
- *  interruptSimulation  *
- *-----------------------*/
-
-/**
- *  Management of the external interrupt signals (^C or stop 
- *  signals from other processes).
- */
-
-void interruptSimulation (int Signal)
-{
-   QuitSimulation = true;
-   if (Signal == SIGINT)
-      fprintf (stderr, "\nSimulation manual stopping (^C).\n");
-   else
-      fprintf (stderr, "\nSimulation manual stopping.\n");
-}
-
-
-/*--------------*
- *  printError  *
- *--------------*/
-
-/**
- *  Prints an error on stderr, without
- *  closing the application.
- */
-
-void printError(char *FunctionName, char *ErrorMessage)
-{
-#ifdef PRINT_ERROR
-   fprintf(stderr, "ERROR (%s): %s", FunctionName, ErrorMessage);
-#endif
-}
-
-
-/*-------------------*
- *  printFatalError  *
- *-------------------*/
-
-/**
- *  Prints a fatal error on stderr and
- *  close the application.
- */
-
-void printFatalError(char *FunctionName, char *ErrorMessage)
-{
-#ifdef PRINT_ERROR
-   fprintf(stderr, "\nERROR (%s): %s", FunctionName, ErrorMessage);
-#endif
-
-   exit( EXIT_FAILURE );
-}
-
-
-/*-------------*
- *  getMemory  *
- *-------------*/
-
-/**
- *  It is a customized version of standard malloc function
- *  which return a pointer to the allocated memory of size
- *  <Size>. In addion updates a counter of memory usage and
- *  exit program with an error message <ErrorMessage>.
- */
-
-void *getMemory(size_t        Size, // Size in byte of memory to allocate.
-                char *ErrorMessage) // Error message if the allocation process fails.
-{
-   static void *ptr;
-            
-   if ((ptr = malloc(Size)) == NULL) {
-#ifdef PRINT_ERROR
-      fprintf(stderr, "\n%s", ErrorMessage);
-#endif
-      exit( EXIT_FAILURE );
-   } else {
-#ifdef PRINT_STATUS
-      MemoryAmount += Size;
-#endif
-   }
-
-   return ptr;
-}
-
-
-/*----------------*
- *   addNewSpike  *
- *----------------*/
-
-/**
- *  Adds an event to the queue of the selected layer.
- */
-
-void addNewSpike (
-                  indexn n,   /* Emitting neuron.                       */
-                  timex  t,   /* Emission time                          */
-                  real ISI,   /* ISI from the last event.               */
-                  int    l    /* Delay layer where the event is loaded. */
-                 )
-{
-   static spike sp;   /* Local variable . */
-   
-   /*** TEMP: Some output... It should be managed using the event queue. ***/
-   if (l==0) {
-      if (RatesResults) updateRates(n);
-      if (SpikesResults) outSpike(n, t);
-   }
-
-   /*** Boot. ***/
-   sp.Emission = t;
-   sp.Neuron   = n;
-   sp.ISI      = ISI;
-
-   /*** Is the queue of the layer empty? ***/
-   if (SynapticMatrix[l].Empty) {
-      SynapticMatrix[l].Spike = sp;
-      SynapticMatrix[l].Empty = false;
-      findOldestLayer();
-   } else
-      putQueueElement(&(SynapticMatrix[l].Queue), &sp);
-}
-
-
-/*-------------------*
- *  LOCAL FUNCTIONS  *
- *-------------------*/
-
-
-/*----------------------*
- *  ariseExternalSpike  *
- *----------------------*/
-
-/**
- *  Extract the oldest external spikes loaded in different 
- *  populations, storing it in *ExtSpike. A new
- *  external spike is scheduled with an exponential interval
- *  (external spike trains are indendent Poissonian processes).
- *  The receiving neuron is selected randomly from the ones
- *  belonging to the related population.
- */
-
-void ariseExternalSpike (spike * ExtSpike)
-{
-   static int             i,j,k; /* Local variables. */
-   static int         OldestPop;
-   static timex *OldestEmission;
-
-   /*** TEMP: The search code has to be optimized using AVL ***
-    ***       tree expecially for large population numbers. ***/
-
-   /*** Search for the oldest external spike. ***/
-   OldestEmission = &(Populations[0].Emission);
-   OldestPop = 0;
-   for (i=1; i<NumPopulations; i++)
-     if (diffTimex(*OldestEmission,Populations[i].Emission)>0.0) {
-       OldestPop = i;
-       OldestEmission = &(Populations[i].Emission);
-     }
-
-   /*** Select the receiving post-synaptic neuron... ***/
-   ExtSpike->Emission = *OldestEmission;
-   j = (indexn)(Populations[OldestPop].N * Random());
-   ExtSpike->Neuron = (indexn)(&(Populations[OldestPop].Neurons[j]) - Neurons);
-
-   /*** Time to the next external spike delivered to the ***
-    *** population with the oldest external spike.       ***/
-   Populations[OldestPop].Emission.Millis -= Populations[OldestPop].InvNuExt * log(1-Random());
-
-   /*** Compression of the time representation. ***/
-   if (Populations[OldestPop].Emission.Millis > 1.0) {
-      i = (int)(Populations[OldestPop].Emission.Millis);
-      Populations[OldestPop].Emission.Seconds += i;
-      Populations[OldestPop].Emission.Millis -= (double)i;
-   }
-}
-
-
-/*----------------------*
- *  whereIsOldestSpike  *
- *----------------------*/
-
-/**
- *  Return the Layer index containing the oldest 
- *  spike to manage. It is NULL_LAYER if no recurrent
- *  spikes are available or the oldest spike is external. 
- */
-
-int whereIsOldestSpike (spike * ExtSpike)
-{
-   /*** Are recurrent spikes available? ***/
-   if (OldestLayer == NULL_LAYER)
-      return NULL_LAYER;
-   else
-      /*** Is the oldest external spike older than the internal one? ***/
-      if (diffTimex(ExtSpike->Emission, SynapticMatrix[OldestLayer].Spike.Emission) <= 0.0)
-         return NULL_LAYER;
-
-   /*** The oldest spikes is recurrent. ***/
-   return OldestLayer;
-}
-
-
-
-/*--------------------*
- *   findOldestLayer  *
- *--------------------*/
-
-/**
- *   Determina il Layer che ha l'impulso da gestire piu'   *
- *   vecchio aggiornando la variabile OldestLayer.         *
- */
-
-void findOldestLayer ()
-{
-   static int   i;
-   static timex t;
-
-   /*** Which layer have the oldest spike to manage? ***/
-   OldestLayer = NULL_LAYER;
-   doubleToTimex(Life + 100.0, t); /* A maximum time not reachable. */
-   for (i=0; i<DelayNumber; i++)
-      if (diffTimex(t, SynapticMatrix[i].Spike.Emission) > 0.0 &&
-          !SynapticMatrix[i].Empty) {
-         OldestLayer = i;
-         t           = SynapticMatrix[i].Spike.Emission;
-      }
-}
-
-
-/*----------------------*
- *  endSpikeManagement  *
- *----------------------*/
-
-/**
- *  Moves the managed event to the next layer and 
- *  gets the next event of the layer queue.
- */
-
-void endSpikeManagement (int DelayLayer)
-{
-   /*** Moves the managed event to the next layer. ***/
-   if (DelayLayer < DelayNumber-1) {
-      SynapticMatrix[DelayLayer].Spike.Emission.Millis += DelayStep;
-      addNewSpike(SynapticMatrix[DelayLayer].Spike.Neuron,
-                  SynapticMatrix[DelayLayer].Spike.Emission,
-                  SynapticMatrix[DelayLayer].Spike.ISI, DelayLayer+1);
-   }
-
-   /*** Gets the next event of the layer queue. ***/
-   if (isQueueEmpty(SynapticMatrix[DelayLayer].Queue))
-      SynapticMatrix[DelayLayer].Empty = true;
-   else
-      getQueueElement(&(SynapticMatrix[DelayLayer].Queue), 
-                      &(SynapticMatrix[DelayLayer].Spike));
-
-   findOldestLayer();
-}
-
-
-
-/*--------------*
- *  simulation  *
- *--------------*/
-
-/**   
- *  Computes the dynamic evolution of the initialized
- *  network of neurons. This is the core function of 
- *  PERSEO which integrates in an asynchronous way the
- *  dynamical equation of the system.
- */
-
-void simulation (void)
-{
-   int              l; /* Delay layer having the oldest spike. */
-   spike     ExtSpike; /* The external spike to manage. */
-   spike     IntSpike; /* The internal spike (from a local neuron) to manage. */
-   axon_segment * Pre; /* Pointer to the "axon" of the emitting neuron. */
-   indexn           i; /* Scanning index of the synapses on the Pre axon. */
-   int           Post; /* Post synaptic neuron to update. */
-   indexn      nExcep; /* Number of the exceptions on the Pre axon. */
-   real          Time; /* The actual network simulation time in ms. */
-   byte         *pSyn; /* Pointer to a synapse. */
-   char OutString[40]; /* Output local variable. */
-
-
-#ifdef PRINT_STATUS
-   double    Status = 0.0;    /* Progress status. */
-   double IncStatus = 10.0;/* Sampling period of the progress status. */
-#endif
-
-   /*** Initializes local variables. ***/
-   Time = START_TIME_OFFSET;
-   ariseExternalSpike(&ExtSpike);
-   OutString[0] = '\0';
-
-   /*** TEMP: Some output... It should be managed using the event queue. ***/
-   if (SynapsesResults) outSynapses(0);
-
-#ifdef PRINT_STATUS
-   startTimer();
-
-   /*** Shows on the console the progress status. ***/
-   fprintf(stderr, "\n\nNetwork Time %.7g ms (Memory: %g Mbytes)\r", Status, (real)MemoryAmount/1024.0/1024.0);
-#endif
-
-   /*** TEMP: Some output... It should be managed using the event queue. ***/
-   if (SynStateResults) flushSynapticState(Time);
-   if (NeuStateResults) flushNeuronalState(Time);
-
-   /*** Main loop managing the spikes and events in the simulation. ***/
-   while (Life > Time && !QuitSimulation) {
-
-      /*** Manages all the events, if any, with time label lower than Time. ***/
-      manageEvent(Time);
-
-      /*** Is the oldest spike from outside? ***/
-      l = whereIsOldestSpike(&ExtSpike);
-      if (l == NULL_LAYER) {
-
-         /*** The spike to manage comes from outside. ***/
-         Time = timexToDouble(ExtSpike.Emission);
-
-         /*** TEMP: Some output... It should be managed using the event queue. ***/
-         if (RatesResults) outRates(Time);
-         if (CurrentResults) outCurrent(Time);
-
-         /*** Updates the neuron state. ***/
-         (*updateNeuronState)(ExtSpike.Neuron, NULL, &ExtSpike);
-
-         /*** Gets a new external spike. ***/
-         ariseExternalSpike(&ExtSpike);
-
-      } else {
-
-         /*** The spike to manage comes from a neuron of the network. ***/
-         IntSpike  = SynapticMatrix[l].Spike;
-         Pre = &(SynapticMatrix[l].Pre[IntSpike.Neuron]);
-         Time = timexToDouble(IntSpike.Emission);
-
-         /*** TEMP: Some output... It should be managed using the event queue. ***/
-         if (RatesResults) outRates(Time);
-         if (SynTransResults) outSynTrans(Time);
-         if (CurrentResults) outCurrent(Time);
-         
-         /*** Loop on the synaptically connected post-synaptic neurons. ***/
-         Post   = -1;
-         nExcep = 0;
-         pSyn = Pre->Synapses;
-         for (i=0; i<Pre->NumSynapses; i++) {
-
-            /*** Computes the next post-synaptic neuron index. ***/
-            if (Pre->DPost[i] != EXCEPTION)
-               Post += Pre->DPost[i];
-            else
-               Post = Pre->Exception[nExcep++];
-
-            /*** Updates the neuron state. ***/
-            (*updateNeuronState)(Post, pSyn, &IntSpike);
-
-            /*** Points to the next synapse on the axon. ***/
-            pSyn += Connectivity[Neurons[Post].Pop->ID][Neurons[IntSpike.Neuron].Pop->ID]->SynapseSize;
-         }
-
-         /*** Updates the queue of the delay layer from which the managed spikes comes. ***/
-         endSpikeManagement(l);
-      }
-
-#ifdef PRINT_STATUS
-      /*** Shows on the console the progress status. ***/
-      if (Time > Status + IncStatus) {
-         Status = (int)(Time / IncStatus) * IncStatus;
-         fprintf(stderr, "Network Time %.7g ms (Memory: %g Mbytes)\r", Status, (real)MemoryAmount/1024.0/1024.0);
-
-      }
-#endif
-
-      /*** Reads new commands from the corresponding input file. ***/
-      readCommands(&Time);
-   }
-
-   /*** TEMP: Some output... It should be managed using the event queue. ***/
-   if (Time > Life) {
-      if (SynStateResults) flushSynapticState(Life);
-      if (NeuStateResults) flushNeuronalState(Life);
-   } else {
-      if (SynStateResults) flushSynapticState(Time);
-      if (NeuStateResults) flushNeuronalState(Time);
-   }
-
-
-#ifdef PRINT_STATUS
-   /*** Shows on the console the progress status. ***/
-   fprintf(stderr, "Network Time %.7g ms (Memory: %g Mbytes)\r", Life, (real)MemoryAmount/1024.0/1024.0);
-
-   elapseTimer();
-   fprintf(stderr, "\n\nElapsed Time: %ss\n", timer(OutString));
-#endif
-
-   /*** TEMP: Some output... It should be managed using the event queue. ***/
-   if (SynapsesResults) outSynapses(Life);
-}
-
-
-
-/*----------*
- *          *
- *   MAIN   *
- *          *
- *----------*/
-
-/**
- *  Loads and interprets definition and command files, 
- *  builds data structure for the simulation and
- *  starts the integration of the system dynamics.
- */
-
-int main (int ArgC, char * ArgV[])
-{
-   char OutString[40] = "";
-
-#ifdef PRINT_STATUS
-   printProgramPresentation();
-#endif
-
-   /***  Simulation boot... ***/
-   initParameters (ArgC, ArgV);
-   openOutputFiles();
-
-#ifdef PRINT_STATUS
-   startTimer();
-#endif
-
-   initNeuralNetwork();
-   readCommands(NULL);
-
-#ifdef PRINT_STATUS
-   elapseTimer();
-   fprintf(stderr, "\n\nElapsed Time: %ss\n", timer(OutString));
-#endif
-
-   /*** Simulation start... ***/
-   if (!QuitSimulation) 
-      simulation();
-
-   /*** Simulation shutdown... ***/
-   closeOutputFiles();
-
-   return 0;
-}
-
-
-
-#undef NULL_LAYER
+/*
+ *
+ *   perseo.c
+ *
+ *   The core of the simulation where the external spikes are created 
+ *   and managed, and the dynamic variables are updated.
+ *   The main function is in main.c.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+
+#include "types.h"
+#include "queue.h"
+#include "timer.h"
+#include "invar.h"
+#include "randdev.h"
+
+#include "perseo.h"
+#include "init.h"
+#include "results.h"
+#include "stimuli.h"
+#include "events.h"
+#include "commands.h"
+
+#include "modules.h"
+#include "connectivity.h"
+#include "delays.h"
+#include "neurons.h"
+#include "replay.h"
+#include "checkpoint.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "control.h"
+
+
+
+/*----------------*
+ *  LOCAL MACROS  *
+ *-------------- -*/
+
+#define NULL_LAYER -1   /* The null pointer to a delay layer. */
+
+
+
+/*----------------------*
+ *   GLOBAL VARIABLES   *
+ *----------------------*/
+
+PERSEO_LOCAL real                 Life;         /* Life time of the simulation in ms. */
+PERSEO_LOCAL int           NeuronsSeed;         /* Seed of pseudo-random number generator for the initialization of neuron states. */
+PERSEO_LOCAL int          SynapsesSeed;         /* Seed of pseudo-random number generator for the initialization of synapse states. */
+PERSEO_LOCAL boolean    QuitSimulation = false; /* If true the simulation interrupts. Is changed *
+                                                 * when a signal is sent to the process.         */
+
+volatile sig_atomic_t InterruptSignals = 0; /* Interrupt signals received by the process, polled *
+                                             * by every simulation thread (see pollInterrupt).   */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+PERSEO_LOCAL int OldestLayer = NULL_LAYER; /* The delay layer containing the oldest spike. */
+void findOldestLayer ();      /* Local function used in a global function. */
+
+static PERSEO_LOCAL real   NetworkTime; /* The network time reached by the simulation in ms. */
+static PERSEO_LOCAL sig_atomic_t SeenInterrupts = 0; /* InterruptSignals already handled by the thread. */
+static PERSEO_LOCAL spike NextExtSpike; /* The next external spike to manage. */
+
+#ifdef PRINT_STATUS
+static PERSEO_LOCAL double    Status = 0.0;  /* Progress status. */
+static PERSEO_LOCAL double IncStatus = 10.0; /* Sampling period of the progress status. */
+#endif
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*-----------------------*
+ *  interruptSimulation  *
+ *-----------------------*/
+
+/**
+ *  Management of the external interrupt signals (^C or stop 
+ *  signals from other processes). The handler may run on any
+ *  thread, so it only counts the signal in the process-wide
+ *  InterruptSignals, polled by the simulation threads.
+ */
+
+void interruptSimulation (int Signal)
+{
+   InterruptSignals++;
+   if (Signal == SIGINT)
+      fprintf (stderr, "\nSimulation manual stopping (^C).\n");
+   else
+      fprintf (stderr, "\nSimulation manual stopping.\n");
+}
+
+
+/*-----------------*
+ *  pollInterrupt  *
+ *-----------------*/
+
+/**
+ *  Sets QuitSimulation if an interrupt signal came since the
+ *  thread started its simulation, and returns it.
+ */
+
+boolean pollInterrupt (void)
+{
+   if (InterruptSignals != SeenInterrupts)
+      QuitSimulation = true;
+
+   return QuitSimulation;
+}
+
+
+/*--------------*
+ *  printError  *
+ *--------------*/
+
+/**
+ *  Prints an error on stderr, without
+ *  closing the application.
+ */
+
+void printError(char *FunctionName, char *ErrorMessage)
+{
+#ifdef PRINT_ERROR
+   fprintf(stderr, "ERROR (%s): %s", FunctionName, ErrorMessage);
+#endif
+}
+
+
+/*-------------------*
+ *  printFatalError  *
+ *-------------------*/
+
+/**
+ *  Prints a fatal error on stderr and
+ *  close the application.
+ */
+
+void printFatalError(char *FunctionName, char *ErrorMessage)
+{
+#ifdef PRINT_ERROR
+   fprintf(stderr, "\nERROR (%s): %s", FunctionName, ErrorMessage);
+#endif
+
+   exit( EXIT_FAILURE );
+}
+
+
+/*----------------*
+ *   addNewSpike  *
+ *----------------*/
+
+/**
+ *  Adds an event to the queue of the selected layer.
+ */
+
+void addNewSpike (
+                  indexn n,   /* Emitting neuron.                       */
+                  timex  t,   /* Emission time                          */
+                  real ISI,   /* ISI from the last event.               */
+                  int    l    /* Delay layer where the event is loaded. */
+                 )
+{
+   spike sp;   /* Local variable . */
+   
+   /*** Counts the emitted spikes and serves the spike probes. ***/
+   if (l==0) {
+      Neurons[n].Pop->SpikeCounter++;
+      Neurons[n].Pop->SpikeTotal++;
+      if (Neurons[n].Probe & PROBE_SPIKES) outSpike(n, t);
+      profileCount(EmittedSpikes, 1);
+   }
+   profileLayer(QueuePushes, l);
+
+   /*** Boot. ***/
+   sp.Emission = t;
+   sp.Neuron   = n;
+   sp.ISI      = ISI;
+
+   /*** Is the queue of the layer empty? ***/
+   if (SynapticMatrix[l].Empty) {
+      SynapticMatrix[l].Spike = sp;
+      SynapticMatrix[l].Empty = false;
+      findOldestLayer();
+   } else
+      putQueueElement(&(SynapticMatrix[l].Queue), &sp);
+}
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+
+/*----------------------*
+ *  ariseExternalSpike  *
+ *----------------------*/
+
+/**
+ *  Extract the oldest external spikes loaded in different 
+ *  populations, storing it in *ExtSpike. A new
+ *  external spike is scheduled with an exponential interval
+ *  (external spike trains are indendent Poissonian processes).
+ *  The receiving neuron is selected randomly from the ones
+ *  belonging to the related population.
+ *  If the external frequency of the population is modulated 
+ *  in time, the spike is kept with probability Gain(t)/MaxGain
+ *  (thinning), otherwise a new candidate is searched for, up
+ *  to Life or to QuitSimulation.
+ */
+
+void ariseExternalSpike (spike * ExtSpike)
+{
+   int                 i; /* Local variables. */
+   indexn              j; /* Receiving neuron in the population. */
+   double              t; /* Time of the candidate spike. */
+   int         OldestPop;
+   timex *OldestEmission;
+   population         *p;
+   boolean      Accepted;
+
+   do {
+
+      /*** TEMP: The search code has to be optimized using AVL ***
+       ***       tree expecially for large population numbers. ***/
+
+      /*** Search for the oldest external spike. ***/
+      OldestEmission = &(Populations[0].Emission);
+      OldestPop = 0;
+      for (i=1; i<NumPopulations; i++)
+        if (diffTimex(*OldestEmission,Populations[i].Emission)>0.0) {
+          OldestPop = i;
+          OldestEmission = &(Populations[i].Emission);
+        }
+      p = &(Populations[OldestPop]);
+
+      /*** Thinning of the time-varying external spike train. ***/
+      t = timexToDouble(p->Emission);
+      Accepted = p->RateMod == NULL ||
+                 nextExtWord(p) * (1.0 / 4294967296.0) * p->RateMod->MaxGain < getRateGain(p->RateMod, t);
+
+      /*** A candidate at Life is kept as the last spike, as no other can come ***
+       *** before, and a population whose gain stays 0 is parked at Life.     ***/
+      if (!Accepted) {
+         if (t >= Life || QuitSimulation)
+            Accepted = true;
+         else if (t - p->RateMod->T0 >= p->RateMod->End) {
+            doubleToTimex(Life, p->Emission);
+            continue;
+         }
+      }
+
+      /*** Select the receiving post-synaptic neuron... ***/
+      if (Accepted) {
+         ExtSpike->Emission = *OldestEmission;
+         j = (indexn)wordIndex(nextExtWord(p), p->N);
+         ExtSpike->Neuron = (indexn)(&(p->Neurons[j]) - Neurons);
+      }
+
+      /*** Time to the next external spike delivered to the ***
+       *** population with the oldest external spike.       ***/
+      p->Emission.Millis += p->InvNuExt * nextExtInterval(p);
+
+      /*** Compression of the time representation. ***/
+      if (p->Emission.Millis > 1.0) {
+         i = (int)(p->Emission.Millis);
+         p->Emission.Seconds += i;
+         p->Emission.Millis -= (double)i;
+      }
+
+   } while (!Accepted);
+}
+
+
+/*----------------------*
+ *  whereIsOldestSpike  *
+ *----------------------*/
+
+/**
+ *  Return the Layer index containing the oldest 
+ *  spike to manage. It is NULL_LAYER if no recurrent
+ *  spikes are available or the oldest spike is external. 
+ */
+
+int whereIsOldestSpike (spike * ExtSpike)
+{
+   /*** Are recurrent spikes available? ***/
+   if (OldestLayer == NULL_LAYER)
+      return NULL_LAYER;
+   else
+      /*** Is the oldest external spike older than the internal one? ***/
+      if (diffTimex(ExtSpike->Emission, SynapticMatrix[OldestLayer].Spike.Emission) <= 0.0)
+         return NULL_LAYER;
+
+   /*** The oldest spikes is recurrent. ***/
+   return OldestLayer;
+}
+
+
+
+/*--------------------*
+ *   findOldestLayer  *
+ *--------------------*/
+
+/**
+ *   Determina il Layer che ha l'impulso da gestire piu'   *
+ *   vecchio aggiornando la variabile OldestLayer.         *
+ */
+
+void findOldestLayer ()
+{
+   int   i;
+   timex t;
+
+   /*** Which layer have the oldest spike to manage? ***/
+   OldestLayer = NULL_LAYER;
+   doubleToTimex(Life + 100.0, t); /* A maximum time not reachable. */
+   for (i=0; i<DelayNumber; i++)
+      if (diffTimex(t, SynapticMatrix[i].Spike.Emission) > 0.0 &&
+          !SynapticMatrix[i].Empty) {
+         OldestLayer = i;
+         t           = SynapticMatrix[i].Spike.Emission;
+      }
+}
+
+
+/*----------------------*
+ *  endSpikeManagement  *
+ *----------------------*/
+
+/**
+ *  Moves the managed event to the next layer and 
+ *  gets the next event of the layer queue.
+ */
+
+void endSpikeManagement (int DelayLayer)
+{
+   profileLayer(QueuePops, DelayLayer);
+
+   /*** Moves the managed event to the next layer. ***/
+   if (DelayLayer < DelayNumber-1) {
+      SynapticMatrix[DelayLayer].Spike.Emission.Millis += DelayStep;
+      addNewSpike(SynapticMatrix[DelayLayer].Spike.Neuron,
+                  SynapticMatrix[DelayLayer].Spike.Emission,
+                  SynapticMatrix[DelayLayer].Spike.ISI, DelayLayer+1);
+   }
+
+   /*** Gets the next event of the layer queue. ***/
+   if (isQueueEmpty(SynapticMatrix[DelayLayer].Queue))
+      SynapticMatrix[DelayLayer].Empty = true;
+   else
+      getQueueElement(&(SynapticMatrix[DelayLayer].Queue), 
+                      &(SynapticMatrix[DelayLayer].Spike));
+
+   findOldestLayer();
+}
+
+
+
+/*-------------------*
+ *  startSimulation  *
+ *-------------------*/
+
+/**
+ *  Prepares the evolution of the initialized network: draws
+ *  the first external spike, or loads the state from the
+ *  restart file, and writes the initial outputs. Returns the
+ *  network time in ms.
+ */
+
+real startSimulation (void)
+{
+#ifdef PRINT_PROFILE
+   startProfile();
+#endif
+
+   /*** Initializes the state of the loop, or loads it from the restart file. ***/
+   if (isRestarting()) {
+      restoreCheckpoint(&NetworkTime, &NextExtSpike);
+      findOldestLayer();
+   } else {
+      NetworkTime = START_TIME_OFFSET;
+      ariseExternalSpike(&NextExtSpike);
+   }
+   initCheckpoints(NetworkTime);
+   startTelemetry(NetworkTime);
+   startControl();
+   printMemoryUsage(DocFile, "init");
+
+   /*** TEMP: Some output... It should be managed using the event queue. ***/
+   if (SynapsesResults && !isRestarting()) outSynapses(0);
+
+#ifdef PRINT_STATUS
+   startTimer();
+
+   /*** Shows on the console the progress status. ***/
+   Status = 0.0;
+   fprintf(stderr, "\n\nNetwork Time %.7g ms (Memory: %g Mbytes)\r", Status, (real)MemoryAmount/1024.0/1024.0);
+#endif
+
+   /*** TEMP: Some output... It should be managed using the event queue. ***/
+   if (SynStateResults && !isRestarting()) flushSynapticState(NetworkTime);
+   if (NeuStateResults && !isRestarting()) flushNeuronalState(NetworkTime);
+
+   return NetworkTime;
+}
+
+
+/*---------------------*
+ *  advanceSimulation  *
+ *---------------------*/
+
+/**   
+ *  Computes the dynamic evolution of the network, managing
+ *  the spikes and the events up to the first one not older
+ *  than <Until> ms (at most Life), or to QuitSimulation.
+ *  This is the core function of PERSEO which integrates in 
+ *  an asynchronous way the dynamical equation of the system.
+ *  Successive calls go on as a single one up to the last
+ *  <Until>. Returns the network time reached in ms.
+ */
+
+real advanceSimulation (real Until)
+{
+   int              l; /* Delay layer having the oldest spike. */
+   spike     ExtSpike; /* The external spike to manage. */
+   spike   *pExtSpike; /* The oldest between the external and the replayed spike. */
+   spike     IntSpike; /* The internal spike (from a local neuron) to manage. */
+   axon_segment * Pre; /* Pointer to the "axon" of the emitting neuron. */
+   indexn           i; /* Scanning index of the synapses on the Pre axon. */
+   indexn        Post; /* Post synaptic neuron to update. */
+   indexn      nExcep; /* Number of the exceptions on the Pre axon. */
+   real          Time; /* The actual network simulation time in ms. */
+   byte         *pSyn; /* Pointer to a synapse. */
+
+   /*** The state of the loop is kept in local variables. ***/
+   Time     = NetworkTime;
+   ExtSpike = NextExtSpike;
+   if (Until > Life)
+      Until = Life;
+
+   /*** Main loop managing the spikes and events in the simulation. ***/
+   while (Until > Time && !pollInterrupt()) {
+      profileIteration();
+
+      /*** Is the oldest spike from outside a replayed one? ***/
+      pExtSpike = &ExtSpike;
+      if (!ReplayEmpty && diffTimex(ExtSpike.Emission, ReplaySpike.Emission) > 0.0)
+         pExtSpike = &ReplaySpike;
+
+      /*** Is the oldest spike from outside? ***/
+      l = whereIsOldestSpike(pExtSpike);
+      if (l == NULL_LAYER) {
+
+         /*** The spike to manage comes from outside. ***/
+         Time = timexToDouble(pExtSpike->Emission);
+         profilePhase(PHASE_QUEUES);
+
+         /*** Manages all the events, if any, with time label lower than Time. ***/
+         manageEvent(Time);
+         profilePhase(PHASE_EVENTS);
+
+         /*** Updates the neuron state. ***/
+         (*updateNeuronState)(pExtSpike->Neuron, NULL, pExtSpike);
+         profilePhase(PHASE_NEURONS);
+
+         /*** Gets a new external or replayed spike. ***/
+         if (pExtSpike == &ExtSpike)
+            ariseExternalSpike(&ExtSpike);
+         else
+            nextReplaySpike();
+         profileCount(ExternalSpikes, 1);
+         profilePhase(PHASE_EXTERNAL);
+
+      } else {
+
+         /*** The spike to manage comes from a neuron of the network. ***/
+         IntSpike  = SynapticMatrix[l].Spike;
+         Pre = &(SynapticMatrix[l].Pre[IntSpike.Neuron]);
+         Time = timexToDouble(IntSpike.Emission);
+         profilePhase(PHASE_QUEUES);
+
+         /*** Manages all the events, if any, with time label lower than Time. ***/
+         manageEvent(Time);
+         profilePhase(PHASE_EVENTS);
+
+         /*** Loop on the synaptically connected post-synaptic neurons. ***/
+         Post   = -1;
+         nExcep = 0;
+         pSyn = Pre->Synapses;
+         for (i=0; i<Pre->NumSynapses; i++) {
+
+            /*** Computes the next post-synaptic neuron index. ***/
+            Post = nextPostSynaptic(Pre->DPost, Pre->Exception, i, Post, &nExcep);
+
+            /*** Updates the neuron state. ***/
+            (*updateNeuronState)(Post, pSyn, &IntSpike);
+
+            /*** Points to the next synapse on the axon. ***/
+            pSyn += Connectivity[Neurons[Post].Pop->ID][Neurons[IntSpike.Neuron].Pop->ID]->SynapseSize;
+         }
+         profileCount(RecurrentSpikes, 1);
+         profileCount(SynapsesDelivered, Pre->NumSynapses);
+         profilePhase(PHASE_DELIVERY);
+
+         /*** Updates the queue of the delay layer from which the managed spikes comes. ***/
+         endSpikeManagement(l);
+         profilePhase(PHASE_QUEUES);
+      }
+
+#ifdef PRINT_STATUS
+      /*** Shows on the console the progress status. ***/
+      if (Time > Status + IncStatus) {
+         Status = (int)(Time / IncStatus) * IncStatus;
+         fprintf(stderr, "Network Time %.7g ms (Memory: %g Mbytes)\r", Status, (real)MemoryAmount/1024.0/1024.0);
+
+      }
+#endif
+
+      /*** Reads new commands from the corresponding input file. ***/
+      readCommands(&Time);
+      profilePhase(PHASE_COMMANDS);
+
+      /*** Saves the state of the simulation, if required. ***/
+      if (pollCheckpointSignal() || Time >= NextCheckpointTime)
+         writeCheckpoint(Time, &ExtSpike);
+      profilePhase(PHASE_CHECKPOINT);
+      profileSample(Time);
+      telemetrySample(Time);
+   }
+
+   NetworkTime  = Time;
+   NextExtSpike = ExtSpike;
+
+   return Time;
+}
+
+
+/*-----------------*
+ *  endSimulation  *
+ *-----------------*/
+
+/**
+ *  Writes the final outputs of the simulation, at the
+ *  network time reached or at Life if it was passed.
+ */
+
+void endSimulation (void)
+{
+   char OutString[40]; /* Output local variable. */
+
+   endControl();
+
+   /*** TEMP: Some output... It should be managed using the event queue. ***/
+   if (NetworkTime > Life) {
+      if (SynStateResults) flushSynapticState(Life);
+      if (NeuStateResults) flushNeuronalState(Life);
+   } else {
+      if (SynStateResults) flushSynapticState(NetworkTime);
+      if (NeuStateResults) flushNeuronalState(NetworkTime);
+   }
+
+
+#ifdef PRINT_STATUS
+   /*** Shows on the console the progress status. ***/
+   fprintf(stderr, "Network Time %.7g ms (Memory: %g Mbytes)\r", Life, (real)MemoryAmount/1024.0/1024.0);
+
+   OutString[0] = '\0';
+   elapseTimer();
+   fprintf(stderr, "\n\nElapsed Time: %ss\n", timer(OutString));
+#endif
+
+   /*** TEMP: Some output... It should be managed using the event queue. ***/
+   if (SynapsesResults) outSynapses(Life);
+
+   endTelemetry(NetworkTime > Life ? Life : NetworkTime);
+
+#ifdef PRINT_PROFILE
+   endProfile(NetworkTime > Life ? Life : NetworkTime);
+#endif
+   printMemoryUsage(DocFile, "end");
+}
+
+
+/*-------------------*
+ *  resetSimulation  *
+ *-------------------*/
+
+/**
+ *  Clears the state of the evolution left by a simulation,
+ *  so that the thread can host a new one.
+ */
+
+void resetSimulation (void)
+{
+   QuitSimulation = false;
+   SeenInterrupts = InterruptSignals;
+   OldestLayer = NULL_LAYER;
+}
+
+
+/*--------------*
+ *  simulation  *
+ *--------------*/
+
+/**   
+ *  Computes the dynamic evolution of the initialized
+ *  network of neurons, up to Life or to QuitSimulation.
+ */
+
+void simulation (void)
+{
+   startSimulation();
+   advanceSimulation(Life);
+   endSimulation();
+}
+
+
+
+#undef NULL_LAYER
@@ -1,113 +1,176 @@
-/*
- *
- *   perseo.h
- *
- *   the header file of the simulation core where the external spikes are created 
- *   and managed, and the dynamic variables are updated.
- *   The main function is here.
- *
- *   Project: PERSEO 2.x
- *
- */
-
-
-
-#ifndef __PERSEO_H__
-#define __PERSEO_H__
-
-
-
-#include "types.h"
-#include "invar.h"
-
-
-
-/*--------------------*
- *  GLOBAL CONSTANTS  *
- *--------------------*/
-
-#define PRINT_ERROR    /* If defined activates the error print. */
-#define PRINT_STATUS   /* If defined prints the simulation status at real-time. */
-// #define PRINT_DEBUG    /* If defined prints debug information. */
-
-#define EXCEPTION         0   /* An element in the axon coding an addressing exception:   *
-                               * two post-synaptic neurons are farther than MAX_DISTANCE  */
-#define ANALOG_DEPTH    256   /* Max number of synaptic efficacies values allowed in a connectivity block. */
-#define START_TIME_OFFSET 0.0 /* Starting time for the simulation. */
-
-#define INIT_FILE "perseo.ini"       /* Definition file to define the system and simulation properties. */
-
-#define VERSION "2.1.3i, June 24th, 2013"   /* Version number and date. */
-#define AUTHORS "M. Mattia" /* Author list. */
-#define REFERENCES "M. Mattia, P. Del Giudice. Neural Comput. 2000;12(10):2305-29"
-#define ACKNOWLEDGEMENTS "P. Del Giudice, G. Gigante, M. Pannunzi" /* Acknowledgement list. */
-// #define AUTHORS "Maurizio Mattia and Paolo Del Giudice" /* Author list. */
-
-
-
-/*----------------------*
- *   GLOBAL VARIABLES   *
- *----------------------*/
-
-extern real                 Life; /* Life time of the simulation in ms. */
-extern int           NeuronsSeed; /* Seed of pseudo-random number generator for the initialization of neuron states. */
-extern int          SynapsesSeed; /* Seed of pseudo-random number generator for the initialization of synapse states. */
-extern boolean    QuitSimulation; /* If true the simulation interrupts. Is changed *
-                                   * when a signal is sent to the process.         */
-extern unsigned int MemoryAmount; /* The amount of memory allocated by Perseo. */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-/**
- *  Management of the external interrupt signals (^C or stop 
- *  signals from other processes).
- */
-
-void interruptSimulation (int Signal);
-
-
-/**
- *  Prints an error on stderr, without
- *  closing the application.
- */
-
-void printError(char *FunctionName, char *ErrorMessage);
-
-
-/**
- *  Prints a fatal error on stderr and
- *  close the application.
- */
-
-void printFatalError(char *FunctionName, char *ErrorMessage);
-
-
-/**
- *  It is a customized version of standard malloc function
- *  which return a pointer to the allocated memory of size
- *  <Size>. In addion updates a counter of memory usage and
- *  exit program with an error message <ErrorMessage>.
- */
-
-void *getMemory(size_t        Size,  // Size in byte of memory to allocate.
-                char *ErrorMessage); // Error message if the allocation process fails.
-
-
-/**
- *  Adds an event to the queue of the selected layer.
- */
-
-void addNewSpike (
-                  indexn n,   /* Emitting neuron.                 */
-                  timex  t,   /* Emission time                    */
-                  real ISI,   /* ISI from the last event.         */
-                  int    l    /* Layer where the event is loaded. */
-                 );
-
-
-
+/*
+ *
+ *   perseo.h
+ *
+ *   the header file of the simulation core where the external spikes are created 
+ *   and managed, and the dynamic variables are updated.
+ *   The main function is in main.c.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __PERSEO_H__
+#define __PERSEO_H__
+
+
+
+#include <signal.h>
+
+#include "types.h"
+#include "invar.h"
+#include "memusage.h"
+
+
+
+/*--------------------*
+ *  GLOBAL CONSTANTS  *
+ *--------------------*/
+
+#define PRINT_ERROR    /* If defined activates the error print. */
+#define PRINT_STATUS   /* If defined prints the simulation status at real-time. */
+#define PRINT_PROFILE  /* If defined reports in LogFile a profile of the simulation loop (see profile.h). */
+// #define PRINT_DEBUG    /* If defined prints debug information. */
+
+#define EXCEPTION         0   /* An element in the axon coding an addressing exception:   *
+                               * two post-synaptic neurons are farther than MAX_DISTANCE  */
+#define MAX_DISTANCE    255   /* Max distance between two consecutive post-synaptic neurons *
+                               * for compression purpose.                                   */
+#define ANALOG_DEPTH    256   /* Max number of synaptic efficacies values allowed in a connectivity block. */
+#define START_TIME_OFFSET 0.0 /* Starting time for the simulation. */
+
+/*** Inlines the kernels specialized with constant arguments (see neurons.c). ***/
+#ifdef __GNUC__
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE static __inline
+#endif
+
+#define RS_EXTERNAL       1   /* Subsystem id of the random streams of the external spike trains. */
+#define RS_JEXT           2   /* Subsystem id of the random streams of the external synaptic efficacies. */
+#define RS_CONNECTIVITY   3   /* Subsystem id of the random streams of the synaptic contacts. */
+#define RS_DELAYS         4   /* Subsystem id of the random streams of the transmission delays. */
+#define RS_SYNAPSES       5   /* Subsystem id of the random streams of the initial synaptic states. */
+
+#define INIT_FILE "perseo.ini"       /* Definition file to define the system and simulation properties. */
+
+#define VERSION "2.1.3i, June 24th, 2013"   /* Version number and date. */
+#define AUTHORS "M. Mattia" /* Author list. */
+#define REFERENCES "M. Mattia, P. Del Giudice. Neural Comput. 2000;12(10):2305-29"
+#define ACKNOWLEDGEMENTS "P. Del Giudice, G. Gigante, M. Pannunzi" /* Acknowledgement list. */
+// #define AUTHORS "Maurizio Mattia and Paolo Del Giudice" /* Author list. */
+
+
+
+/*----------------------*
+ *   GLOBAL VARIABLES   *
+ *----------------------*/
+
+extern PERSEO_LOCAL real                 Life; /* Life time of the simulation in ms. */
+extern PERSEO_LOCAL int           NeuronsSeed; /* Seed of pseudo-random number generator for the initialization of neuron states. */
+extern PERSEO_LOCAL int          SynapsesSeed; /* Seed of pseudo-random number generator for the initialization of synapse states. */
+extern PERSEO_LOCAL boolean    QuitSimulation; /* If true the simulation interrupts. Is changed *
+                                                * when a signal is sent to the process.         */
+
+extern volatile sig_atomic_t InterruptSignals; /* Interrupt signals received by the process, polled *
+                                                * by every simulation thread (see pollInterrupt).   */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Management of the external interrupt signals (^C or stop 
+ *  signals from other processes).
+ */
+
+void interruptSimulation (int Signal);
+
+
+/**
+ *  Sets QuitSimulation if an interrupt signal came since the
+ *  thread started its simulation, and returns it.
+ */
+
+boolean pollInterrupt (void);
+
+
+/**
+ *  Prints an error on stderr, without
+ *  closing the application.
+ */
+
+void printError(char *FunctionName, char *ErrorMessage);
+
+
+/**
+ *  Prints a fatal error on stderr and
+ *  close the application.
+ */
+
+void printFatalError(char *FunctionName, char *ErrorMessage);
+
+
+/**
+ *  Adds an event to the queue of the selected layer.
+ */
+
+void addNewSpike (
+                  indexn n,   /* Emitting neuron.                 */
+                  timex  t,   /* Emission time                    */
+                  real ISI,   /* ISI from the last event.         */
+                  int    l    /* Layer where the event is loaded. */
+                 );
+
+
+/**
+ *  Computes the dynamic evolution of the initialized
+ *  network of neurons, up to Life or to QuitSimulation.
+ */
+
+void simulation (void);
+
+
+/**
+ *  Prepares the evolution of the initialized network: draws
+ *  the first external spike, or loads the state from the
+ *  restart file, and writes the initial outputs. Returns the
+ *  network time in ms.
+ */
+
+real startSimulation (void);
+
+
+/**
+ *  Computes the dynamic evolution of the network, managing
+ *  the spikes and the events up to the first one not older
+ *  than <Until> ms (at most Life), or to QuitSimulation.
+ *  Successive calls go on as a single one up to the last
+ *  <Until>. Returns the network time reached in ms.
+ */
+
+real advanceSimulation (real Until);
+
+
+/**
+ *  Writes the final outputs of the simulation, at the
+ *  network time reached or at Life if it was passed.
+ */
+
+void endSimulation (void);
+
+
+/**
+ *  Clears the state of the evolution left by a simulation,
+ *  so that the thread can host a new one.
+ */
+
+void resetSimulation (void);
+
+
+
 #endif /* __PERSEO_H__ */
\ No newline at end of file
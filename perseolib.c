@@ -0,0 +1,426 @@
+/*
+ *
+ *   perseolib.c
+ *
+ *   Interface of the library of the simulator (libperseo.a),
+ *   to embed simulations in other programs, each one in its
+ *   own thread.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "invar.h"
+
+#include "perseo.h"
+#include "init.h"
+#include "modules.h"
+#include "neurons.h"
+#include "connectivity.h"
+#include "results.h"
+#include "commands.h"
+#include "checkpoint.h"
+#include "ensemble.h"
+#include "perseolib.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+/**
+ *  The simulation of a thread. Its state is in the variables
+ *  of the modules, local to the thread.
+ */
+
+struct perseo_sim_struct {
+   boolean Started; /* It is true once the evolution started. */
+   boolean   Ended; /* It is true once the final outputs were written. */
+   double     Time; /* Network time reached in ms. */
+};
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL perseo_sim *Current = NULL; /* The simulation of the thread. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------*
+ *  isHosted  *
+ *------------*/
+
+/**
+ *  Returns true if <Sim> is the simulation of the calling
+ *  thread, otherwise reports the error for <FunctionName>.
+ */
+
+static boolean isHosted(perseo_sim         *Sim,
+                        char *FunctionName)
+{
+   if (Sim == NULL || Sim != Current) {
+      printError(FunctionName, "the simulation is not hosted by the calling thread.\n");
+      return false;
+   }
+
+   return true;
+}
+
+
+/*-----------------*
+ *  startIfNeeded  *
+ *-----------------*/
+
+/**
+ *  Starts the evolution of <Sim> at its first step.
+ */
+
+static void startIfNeeded(perseo_sim *Sim)
+{
+   if (!Sim->Started) {
+      Sim->Time = startSimulation();
+      Sim->Started = true;
+   }
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*----------------*
+ *  perseoCreate  *
+ *----------------*/
+
+/**
+ *  Creates in the calling thread a simulation defined by
+ *  INIT_FILE and by the definitions in <ArgV>, building its
+ *  network as main() does. Returns NULL if the thread
+ *  hosts a simulation not destroyed or an ensemble is asked.
+ */
+
+perseo_sim *perseoCreate(int           ArgC, /* Number of definitions, plus one. */
+                         char * const ArgV[]) /* Definitions "NAME=value". */
+{
+   perseo_sim *Sim;
+
+   if (Current != NULL) {
+      printError("perseoCreate", "the thread already hosts a simulation.\n");
+      return NULL;
+   }
+
+   initParameters(ArgC, ArgV);
+   if (EnsembleSize > 0) {
+      printError("perseoCreate", "the ensembles run only in the perseo program.\n");
+      releaseNeuralNetwork();
+      releaseParameters();
+      return NULL;
+   }
+   openRestart();
+   openOutputFiles();
+   initNeuralNetwork();
+   readCommands(NULL);
+   attachObservers();
+
+   Sim = getMemory(sizeof(perseo_sim), "ERROR (perseoCreate): Out of memory.\n");
+   Sim->Started = false;
+   Sim->Ended   = false;
+   Sim->Time    = 0.0;
+   Current = Sim;
+
+   return Sim;
+}
+
+
+/*-------------*
+ *  perseoRun  *
+ *-------------*/
+
+/**
+ *  Runs the simulation <Sim> up to its life time, or to its
+ *  interruption, and writes its final outputs. Returns 1 on
+ *  error, 0 otherwise.
+ */
+
+int perseoRun(perseo_sim *Sim)
+{
+   if (!isHosted(Sim, "perseoRun"))
+      return 1;
+   if (Sim->Ended) {
+      printError("perseoRun", "the simulation already ended.\n");
+      return 1;
+   }
+
+   if (!QuitSimulation) {
+      startIfNeeded(Sim);
+      Sim->Time = advanceSimulation(Life);
+      endSimulation();
+   }
+   Sim->Ended = true;
+
+   return 0;
+}
+
+
+/*-----------------*
+ *  perseoAdvance  *
+ *-----------------*/
+
+/**
+ *  Advances the simulation <Sim> up to the first spike or
+ *  event not older than <Time> ms. Returns 1 on error, 0
+ *  otherwise.
+ */
+
+int perseoAdvance(perseo_sim *Sim, 
+                  double     Time) /* Network time to reach in ms. */
+{
+   if (!isHosted(Sim, "perseoAdvance"))
+      return 1;
+   if (Sim->Ended) {
+      printError("perseoAdvance", "the simulation already ended.\n");
+      return 1;
+   }
+
+   startIfNeeded(Sim);
+   Sim->Time = advanceSimulation(Time);
+
+   return 0;
+}
+
+
+/*--------------*
+ *  perseoTime  *
+ *--------------*/
+
+/**
+ *  Returns the network time in ms reached by <Sim>.
+ */
+
+double perseoTime(perseo_sim *Sim)
+{
+   if (!isHosted(Sim, "perseoTime"))
+      return -1.0;
+
+   return Sim->Time;
+}
+
+
+/*------------------------*
+ *  perseoNumPopulations  *
+ *------------------------*/
+
+/**
+ *  Returns the number of populations of <Sim>.
+ */
+
+int perseoNumPopulations(perseo_sim *Sim)
+{
+   if (!isHosted(Sim, "perseoNumPopulations"))
+      return -1;
+
+   return NumPopulations;
+}
+
+
+/*---------------------------*
+ *  perseoPopulationNeurons  *
+ *---------------------------*/
+
+/**
+ *  Returns the number of neurons of the population <Pop>,
+ *  setting in <First> the index of its first neuron.
+ */
+
+indexn perseoPopulationNeurons(perseo_sim *Sim, 
+                               int         Pop, /* Population to probe. */
+                               indexn   *First) /* Index of its first neuron. */
+{
+   if (!isHosted(Sim, "perseoPopulationNeurons") || Pop < 0 || Pop >= NumPopulations)
+      return 0;
+
+   *First = (indexn)(Populations[Pop].Neurons - Neurons);
+   return Populations[Pop].N;
+}
+
+
+/*----------------------*
+ *  perseoSpikeCounter  *
+ *----------------------*/
+
+/**
+ *  Returns a pointer to the counter of the spikes emitted
+ *  by the population <Pop>.
+ */
+
+const int *perseoSpikeCounter(perseo_sim *Sim, 
+                              int         Pop) /* Population to probe. */
+{
+   if (!isHosted(Sim, "perseoSpikeCounter") || Pop < 0 || Pop >= NumPopulations)
+      return NULL;
+
+   return &(Populations[Pop].SpikeCounter);
+}
+
+
+/*----------------------*
+ *  perseoNumStateVars  *
+ *----------------------*/
+
+/**
+ *  Returns the number of state variables of a neuron.
+ */
+
+int perseoNumStateVars(perseo_sim *Sim)
+{
+   if (!isHosted(Sim, "perseoNumStateVars"))
+      return -1;
+
+   return NumNeuronVariables;
+}
+
+
+/*---------------------*
+ *  perseoNeuronState  *
+ *---------------------*/
+
+/**
+ *  Fills <StateVars> with the state of the neuron <i> at the
+ *  network time reached, returning their number.
+ */
+
+int perseoNeuronState(perseo_sim *Sim, 
+                      indexn        i, /* Neuron to probe. */
+                      real *StateVars) /* State variables of the neuron. */
+{
+   neuron_state ns;
+   timex t;
+
+   if (!isHosted(Sim, "perseoNeuronState") || i >= NumNeurons)
+      return -1;
+
+   ns.StateVars = StateVars;
+   doubleToTimex(Sim->Time, t);
+   (*getNeuronState)(i, t, &ns);
+
+   return ns.NumStateVars;
+}
+
+
+/*-------------------*
+ *  perseoSynStruct  *
+ *-------------------*/
+
+/**
+ *  Returns the number of synapses from <Pre> to <Post> in
+ *  each long-term state, setting their number in <NumStates>.
+ */
+
+const indexn *perseoSynStruct(perseo_sim *Sim, 
+                              int        Post, /* Post-synaptic population. */
+                              int         Pre, /* Pre-synaptic population. */
+                              int *NumStates)  /* Number of long-term states. */
+{
+   connectivity *c;
+
+   if (!isHosted(Sim, "perseoSynStruct") ||
+       Post < 0 || Post >= NumPopulations || Pre < 0 || Pre >= NumPopulations)
+      return NULL;
+   if ((c = Connectivity[Post][Pre]) == NULL)
+      return NULL;
+
+   *NumStates = c->NumSynapseStableState;
+   return countSynStruct(Sim->Time)[c->ID];
+}
+
+
+/*----------------------------*
+ *  perseoSetPopulationParam  *
+ *----------------------------*/
+
+/**
+ *  Changes the parameter <ParamNum> of the population <Pop>.
+ */
+
+int perseoSetPopulationParam(perseo_sim *Sim, 
+                             int         Pop, /* Population to update. */
+                             int    ParamNum, /* Number of parameter to change. */
+                             double    Value) /* New value of the parameter. */
+{
+   if (!isHosted(Sim, "perseoSetPopulationParam"))
+      return 1;
+
+   setPopulationParam(Pop, ParamNum, Value, Sim->Time);
+
+   return 0;
+}
+
+
+/*------------------------------*
+ *  perseoSetConnectivityParam  *
+ *------------------------------*/
+
+/**
+ *  Changes the parameter <ParamNum> of the synapses from
+ *  <Pre> to <Post>.
+ */
+
+int perseoSetConnectivityParam(perseo_sim *Sim, 
+                               int        Post, /* Post-synaptic population. */
+                               int         Pre, /* Pre-synaptic population. */
+                               int    ParamNum, /* Number of parameter to change. */
+                               double    Value) /* New value of the parameter. */
+{
+   if (!isHosted(Sim, "perseoSetConnectivityParam"))
+      return 1;
+
+   setConnectivityParam(Post, Pre, ParamNum, Value, Sim->Time);
+
+   return 0;
+}
+
+
+/*-----------------*
+ *  perseoDestroy  *
+ *-----------------*/
+
+/**
+ *  Writes the final outputs of the simulation <Sim>, if it
+ *  did not end, closes its log files, waits for its branches
+ *  and frees the network, the handle and the definitions, so
+ *  that the thread can host a new simulation.
+ */
+
+void perseoDestroy(perseo_sim *Sim)
+{
+   if (!isHosted(Sim, "perseoDestroy"))
+      return;
+
+   if (Sim->Started && !Sim->Ended)
+      endSimulation();
+   closeOutputFiles();
+   waitBranches();
+   releaseNeuralNetwork();
+
+   free(Sim);
+   releaseMemory(sizeof(perseo_sim), MEMORY_OTHER);
+   Current = NULL;
+
+   releaseParameters();
+   resetMemoryUsage();
+}
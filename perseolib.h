@@ -0,0 +1,208 @@
+/*
+ *
+ *   perseolib.h
+ *
+ *   Interface of the library of the simulator (libperseo.a),
+ *   to embed simulations in other programs. The state of a
+ *   simulation is local to the thread creating it (see
+ *   PERSEO_LOCAL in types.h), so that many simulations can
+ *   run at once in the same process, each one in its own
+ *   thread. As the state of the modules is global to the
+ *   thread, a thread hosts one simulation at a time: once
+ *   destroyed, the thread can create a new one.
+ *
+ *   A simulation can be advanced step by step, reading its
+ *   observables in between straight from the buffers of the
+ *   simulator and changing its parameters, as the commands
+ *   of the protocol do, with no file in between.
+ *
+ *   The errors of the simulator are fatal as in the perseo
+ *   program: they are reported on stderr and end the process.
+ *   The ensembles and the BRANCH command fork the process,
+ *   so they are meant for the perseo program only.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __PERSEOLIB_H__
+#define __PERSEOLIB_H__
+
+
+
+#include "types.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Handle of a simulation, bound to the thread creating it.
+ */
+
+typedef struct perseo_sim_struct perseo_sim;
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Creates in the calling thread a simulation defined by
+ *  INIT_FILE and by the definitions in <ArgV> (as on the
+ *  command line of perseo, <ArgV>[0] being neglected, only
+ *  read, so that string literals can be passed): the
+ *  log files are opened, the network is built and the first
+ *  commands are read. Returns NULL if the thread already
+ *  hosts a simulation not destroyed, or an ensemble is asked.
+ */
+
+perseo_sim *perseoCreate(int           ArgC, /* Number of definitions, plus one. */
+                         char * const ArgV[]); /* Definitions "NAME=value". */
+
+
+/**
+ *  Runs the simulation <Sim> up to its life time, or to its
+ *  interruption, and writes its final outputs. It has to be
+ *  called by the thread which created <Sim>, and can follow
+ *  some calls to perseoAdvance. Returns 1 on error, 0
+ *  otherwise.
+ */
+
+int perseoRun(perseo_sim *Sim);
+
+
+/**
+ *  Advances the simulation <Sim> managing the spikes and the
+ *  events up to the first one not older than <Time> ms (at
+ *  most its life time), so that the network time reached can
+ *  slightly exceed <Time>. Successive calls go on exactly as
+ *  a single run. Returns 1 on error, 0 otherwise.
+ */
+
+int perseoAdvance(perseo_sim *Sim, 
+                  double     Time); /* Network time to reach in ms. */
+
+
+/**
+ *  Returns the network time in ms reached by the simulation
+ *  <Sim>, or a negative value on error.
+ */
+
+double perseoTime(perseo_sim *Sim);
+
+
+/**
+ *  Returns the number of populations of the simulation <Sim>,
+ *  or a negative value on error.
+ */
+
+int perseoNumPopulations(perseo_sim *Sim);
+
+
+/**
+ *  Returns the number of neurons of the population <Pop> of
+ *  the simulation <Sim>, and sets in <First> the index of its
+ *  first neuron. Returns 0 on error.
+ */
+
+indexn perseoPopulationNeurons(perseo_sim *Sim, 
+                               int         Pop,  /* Population to probe. */
+                               indexn   *First); /* Index of its first neuron. */
+
+
+/**
+ *  Returns a pointer to the counter of the spikes emitted by
+ *  the population <Pop> of the simulation <Sim>, which goes
+ *  on changing as the simulation advances. The counter is
+ *  reset at each sample of the rates, if they are written.
+ *  Returns NULL on error.
+ */
+
+const int *perseoSpikeCounter(perseo_sim *Sim, 
+                              int         Pop); /* Population to probe. */
+
+
+/**
+ *  Returns the number of state variables of a neuron in the
+ *  simulation <Sim>, or a negative value on error.
+ */
+
+int perseoNumStateVars(perseo_sim *Sim);
+
+
+/**
+ *  Fills <StateVars> with the state of the neuron <i> of the
+ *  simulation <Sim> at the network time reached (the first
+ *  one is the membrane potential, see getNeuronState), and 
+ *  returns the number of state variables filled, at most
+ *  perseoNumStateVars. Returns a negative value on error.
+ */
+
+int perseoNeuronState(perseo_sim *Sim, 
+                      indexn        i,  /* Neuron to probe. */
+                      real *StateVars); /* State variables of the neuron. */
+
+
+/**
+ *  Counts the synapses from the population <Pre> to <Post>
+ *  of the simulation <Sim> in each long-term state at the
+ *  network time reached. Returns a pointer to the counts,
+ *  in a buffer of the simulator overwritten by the next
+ *  call, and sets in <NumStates> their number. Scans the
+ *  whole synaptic matrix. Returns NULL on error, or if the
+ *  populations are not connected.
+ */
+
+const indexn *perseoSynStruct(perseo_sim *Sim, 
+                              int        Post,  /* Post-synaptic population. */
+                              int         Pre,  /* Pre-synaptic population. */
+                              int *NumStates);  /* Number of long-term states. */
+
+
+/**
+ *  Changes at the network time reached the parameter
+ *  <ParamNum> of the population <Pop> of the simulation
+ *  <Sim>, as the command SET_PARAM (see setPopulationParam).
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int perseoSetPopulationParam(perseo_sim *Sim, 
+                             int         Pop,  /* Population to update. */
+                             int    ParamNum,  /* Number of parameter to change. */
+                             double    Value); /* New value of the parameter. */
+
+
+/**
+ *  Changes at the network time reached the parameter
+ *  <ParamNum> of the synapses from the population <Pre>
+ *  to <Post> of the simulation <Sim>, as the command
+ *  SET_PARAM (see setConnectivityParam).
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int perseoSetConnectivityParam(perseo_sim *Sim, 
+                               int        Post,  /* Post-synaptic population. */
+                               int         Pre,  /* Pre-synaptic population. */
+                               int    ParamNum,  /* Number of parameter to change. */
+                               double    Value); /* New value of the parameter. */
+
+
+/**
+ *  Writes the final outputs of the simulation <Sim>, if it
+ *  did not end, closes its log files, waits for its branches
+ *  and frees the whole simulation, network included. It has
+ *  to be called by the thread which created <Sim>, which can
+ *  then create a new simulation, with its own parameters.
+ */
+
+void perseoDestroy(perseo_sim *Sim);
+
+
+
+#endif /* __PERSEOLIB_H__ */
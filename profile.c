@@ -0,0 +1,498 @@
+/*
+ *
+ *   profile.c
+ *
+ *   Library of counters and timers measuring the phases of
+ *   the simulation loop, reported at the end of the run in
+ *   LogFile. The counters are updated at each spike, while
+ *   the phases are timed only on a sample of the spikes (one
+ *   every PROFILE_SAMPLING) to keep the overhead low: the
+ *   wall-clock time of the run is shared among the phases
+ *   in proportion to their sampled time. The hardware
+ *   counters, if asked, are read through perf_event_open.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "types.h"
+
+#include "perseo.h"
+#include "writer.h"
+#include "results.h"
+#include "delays.h"
+#include "profile.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM 256 /* Maximum static string size in the module. */
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+PERSEO_LOCAL profile Profile; /* The counters of the running simulation. */
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL boolean         HWCounters = false;            /* If true the hardware counters are read. */
+PERSEO_LOCAL char   *HWCountersFileName = "hwcounters.dat"; /* Name of the log file of the hardware counters. */
+PERSEO_LOCAL real    HWCountersSampling = 100.0;            /* Sampling period in ms of the hardware counters. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL double    WallStart = 0.0; /* Wall-clock time at the start of the run (s). */
+static PERSEO_LOCAL double     CPUStart = 0.0; /* CPU time at the start of the run (s). */
+static PERSEO_LOCAL double  LapOverhead = 0.0; /* Ticks spent reading the ticks in a lap. */
+static PERSEO_LOCAL int   ProfileLayers = 0;   /* Number of delay layers counted. */
+
+static char *PhaseNames[NUM_PHASES] = {"External", "Neurons", "Delivery", "Queues",
+                                       "Events", "Commands", "Checkpoint"};
+static char *HWNames[NUM_HW_COUNTERS] = {"Cycles", "Instructions", "CacheMisses", "BranchMisses"};
+
+static PERSEO_LOCAL int          HWGroup = -1;   /* Leader of the group of the hardware counters (-1 if not open). */
+static PERSEO_LOCAL int HWFd[NUM_HW_COUNTERS];   /* Descriptor of each counter, -1 if not available. */
+static PERSEO_LOCAL int HWSlot[NUM_HW_COUNTERS]; /* Position of each counter in the group. */
+static PERSEO_LOCAL int          NumHWSlots = 0; /* Number of counters in the group. */
+static PERSEO_LOCAL uint64_t HWLast[NUM_HW_COUNTERS]; /* Counts at the last lap. */
+static PERSEO_LOCAL FILE         *HWFile = NULL; /* Log file of the hardware counters. */
+
+static PERSEO_LOCAL double     RunHW[NUM_PHASES][NUM_HW_COUNTERS]; /* Counts of the sampled iterations in the run. */
+static PERSEO_LOCAL double  PeriodHW[NUM_PHASES][NUM_HW_COUNTERS]; /* Counts of the sampled iterations in the period. */
+static PERSEO_LOCAL uint64_t          RunHWIterations = 0; /* Iterations sampled in the run. */
+static PERSEO_LOCAL uint64_t       PeriodHWIterations = 0; /* Iterations sampled in the period. */
+static PERSEO_LOCAL uint64_t           PeriodStart = 0;    /* Iterations at the start of the period. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------------*
+ *  openHWCounters  *
+ *------------------*/
+
+/**
+ *  Opens the hardware counters of the calling thread as a
+ *  group, so that they are read at once. The counters the
+ *  CPU or the kernel do not allow are left out of the group.
+ *  Returns 1 if not even the cycles can be counted, reporting
+ *  the reason in <Error>, 0 otherwise.
+ */
+
+static int openHWCounters(char *Error)
+{
+#ifdef __linux__
+   struct perf_event_attr pe;
+   uint64_t Configs[NUM_HW_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+   int k;
+
+   NumHWSlots = 0;
+   for (k=0; k<NUM_HW_COUNTERS; k++) {
+      memset(&pe, 0, sizeof(pe));
+      pe.size           = sizeof(pe);
+      pe.type           = PERF_TYPE_HARDWARE;
+      pe.config         = Configs[k];
+      pe.disabled       = (k == 0);
+      pe.exclude_kernel = 1;
+      pe.exclude_hv     = 1;
+      pe.read_format    = PERF_FORMAT_GROUP;
+      HWFd[k] = (int)syscall(SYS_perf_event_open, &pe, 0, -1, HWGroup, 0);
+      if (HWFd[k] < 0) {
+         if (k == 0) {
+            sprintf(Error, "%s", strerror(errno));
+            return 1;
+         }
+         HWSlot[k] = -1;
+      } else {
+         if (k == 0) HWGroup = HWFd[k];
+         HWSlot[k] = NumHWSlots++;
+      }
+   }
+
+   ioctl(HWGroup, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+   ioctl(HWGroup, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+   return 0;
+#else
+   sprintf(Error, "perf_event_open is available only on Linux");
+   return 1;
+#endif
+}
+
+
+/*-------------------*
+ *  closeHWCounters  *
+ *-------------------*/
+
+/**
+ *  Closes the hardware counters.
+ */
+
+static void closeHWCounters()
+{
+#ifdef __linux__
+   int k;
+
+   if (HWGroup < 0)
+      return;
+   for (k=NUM_HW_COUNTERS-1; k>=0; k--)
+      if (HWSlot[k] >= 0)
+         close(HWFd[k]);
+   HWGroup = -1;
+#endif
+}
+
+
+/*------------------*
+ *  readHWCounters  *
+ *------------------*/
+
+/**
+ *  Reads the hardware counters in <Counts>, leaving zero the
+ *  ones not available.
+ */
+
+static void readHWCounters(uint64_t *Counts)
+{
+#ifdef __linux__
+   uint64_t Buffer[NUM_HW_COUNTERS + 1]; // The number of counters and their values.
+   int k;
+
+   if (read(HWGroup, Buffer, sizeof(uint64_t) * (NumHWSlots + 1)) <= 0)
+      Buffer[0] = 0;
+   for (k=0; k<NUM_HW_COUNTERS; k++)
+      Counts[k] = HWSlot[k] >= 0 && HWSlot[k] < (int)Buffer[0] ? Buffer[HWSlot[k] + 1] : 0;
+#endif
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*----------------*
+ *  profileClock  *
+ *----------------*/
+
+/**
+ *  Returns the wall-clock time in s from an arbitrary origin.
+ */
+
+double profileClock ()
+{
+#ifndef _WIN32
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+   return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/*-------------------*
+ *  profileCPUClock  *
+ *-------------------*/
+
+/**
+ *  Returns the CPU time in s spent by the calling thread,
+ *  or by the whole process where it is not available.
+ */
+
+double profileCPUClock ()
+{
+#if !defined(_WIN32) && defined(CLOCK_THREAD_CPUTIME_ID)
+   struct timespec ts;
+
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+   return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/*--------------*
+ *  profileLap  *
+ *--------------*/
+
+/**
+ *  Adds the time from the last lap to the phase <Phase>
+ *  (if not NO_PHASE) and starts a new lap. The hardware
+ *  counters are read on one timed iteration every
+ *  HW_SAMPLING, out of the lap.
+ */
+
+void profileLap (int Phase)
+{
+   uint64_t t = profileTicks();
+   uint64_t Counts[NUM_HW_COUNTERS];
+   int k;
+
+   if (Phase == NO_PHASE) {
+      Profile.TimedIterations++;
+      Profile.HWTimed = HWGroup >= 0 && (Profile.TimedIterations & (HW_SAMPLING-1)) == 0;
+      if (Profile.HWTimed) {
+         readHWCounters(HWLast);
+         RunHWIterations++;
+         PeriodHWIterations++;
+      }
+   } else {
+      Profile.PhaseTicks[Phase] += (double)(t - Profile.LapStart) - LapOverhead;
+      if (Profile.HWTimed) {
+         readHWCounters(Counts);
+         for (k=0; k<NUM_HW_COUNTERS; k++) {
+            RunHW[Phase][k]    += (double)(Counts[k] - HWLast[k]);
+            PeriodHW[Phase][k] += (double)(Counts[k] - HWLast[k]);
+         }
+         memcpy(HWLast, Counts, sizeof(Counts));
+      }
+   }
+   Profile.LapStart = Profile.HWTimed ? profileTicks() : t;
+}
+
+
+/*----------------*
+ *  startProfile  *
+ *----------------*/
+
+/**
+ *  Resets the counters, allocating the ones of the delay
+ *  layers, and starts the clocks of the run.
+ */
+
+void startProfile ()
+{
+   char Error[BUFFER_DIM];
+   uint64_t t, MinLap;
+   int k;
+
+   memset(&Profile, 0, sizeof(Profile));
+   Profile.NextSample = (double)1e37;
+   ProfileLayers = DelayNumber;
+   Profile.QueuePushes = getMemory(sizeof(uint64_t) * ProfileLayers, "ERROR (startProfile): Out of memory.");
+   Profile.QueuePops   = getMemory(sizeof(uint64_t) * ProfileLayers, "ERROR (startProfile): Out of memory.");
+   memset(Profile.QueuePushes, 0, sizeof(uint64_t) * ProfileLayers);
+   memset(Profile.QueuePops, 0, sizeof(uint64_t) * ProfileLayers);
+
+   /*** The cost of a lap is the shortest one with nothing to time. ***/
+   LapOverhead = 0.0;
+   for (MinLap = (uint64_t)-1, k=0; k<1000; k++) {
+      t = profileTicks();
+      profileLap(NO_PHASE);
+      if (Profile.LapStart - t < MinLap)
+         MinLap = Profile.LapStart - t;
+   }
+   LapOverhead = (double)MinLap;
+   Profile.TimedIterations = 0;
+
+   /*** The hardware counters, if asked and available. ***/
+   memset(RunHW, 0, sizeof(RunHW));
+   memset(PeriodHW, 0, sizeof(PeriodHW));
+   RunHWIterations = PeriodHWIterations = PeriodStart = 0;
+   if (HWCounters) {
+      if (openHWCounters(Error)) {
+         fprintf(DocFile, "#----------\n");
+         fprintf(DocFile, "# Hardware counters not available (%s): the run goes on without them.\n\n", Error);
+      } else if ((HWFile = fopen(HWCountersFileName, "wt")) == NULL) {
+         closeHWCounters();
+         printError("startProfile", "unable to open the log file of the hardware counters.\n");
+      } else {
+         fprintf(DocFile, "#----------\n");
+         fprintf(DocFile, "# Out file name: '%s'\n", HWCountersFileName);
+         fprintf(DocFile, "# Hardware counters estimated per phase every %g ms ('n/a' if not available).\n", HWCountersSampling);
+         fprintf(DocFile, "# 1. Time (ms)\n");
+         for (k=0; k<NUM_PHASES; k++)
+            fprintf(DocFile, "# %d-%d. %s, %s, %s and %s in the phase %s\n",
+                    2 + k * NUM_HW_COUNTERS, 1 + (k + 1) * NUM_HW_COUNTERS,
+                    HWNames[0], HWNames[1], HWNames[2], HWNames[3], PhaseNames[k]);
+         fprintf(DocFile, "\n");
+         Profile.NextSample = HWCountersSampling;
+      }
+   }
+
+   WallStart = profileClock();
+   CPUStart  = profileCPUClock();
+}
+
+
+/*-----------------*
+ *  sampleProfile  *
+ *-----------------*/
+
+/**
+ *  Writes a row of the log file of the hardware counters,
+ *  with their estimated counts per phase in the last period,
+ *  and schedules the next sample after the time <Time>.
+ */
+
+void sampleProfile (double Time)
+{
+   double Scale;
+   int k, c;
+
+   if (HWFile == NULL) {
+      Profile.NextSample = (double)1e37;
+      return;
+   }
+
+   Scale = PeriodHWIterations > 0 ? (double)(Profile.Iterations - PeriodStart) / PeriodHWIterations : 0.0;
+   fprintf(HWFile, "%g", Time < Profile.NextSample ? Time : Profile.NextSample);
+   for (k=0; k<NUM_PHASES; k++)
+      for (c=0; c<NUM_HW_COUNTERS; c++)
+         if (HWSlot[c] >= 0)
+            fprintf(HWFile, " %.6g", PeriodHW[k][c] * Scale);
+         else
+            fprintf(HWFile, " n/a");
+   fprintf(HWFile, "\n");
+   fflush(HWFile); // Nothing is left in the buffer at a fork.
+
+   memset(PeriodHW, 0, sizeof(PeriodHW));
+   PeriodHWIterations = 0;
+   PeriodStart = Profile.Iterations;
+   while (Profile.NextSample <= Time)
+      Profile.NextSample += HWCountersSampling;
+}
+
+
+/*---------------*
+ *  forkProfile  *
+ *---------------*/
+
+/**
+ *  In a process forked by the simulation, opens again the
+ *  hardware counters, which count the parent, and moves their
+ *  log file to a new one with <Prefix> in front of the name.
+ */
+
+void forkProfile (char *Prefix)
+{
+   char Error[BUFFER_DIM];
+   char *Name;
+
+   if (HWFile == NULL)
+      return;
+
+   closeHWCounters();
+   Name = getMemory(strlen(Prefix) + strlen(HWCountersFileName) + 1, "ERROR (forkProfile): Out of memory.");
+   sprintf(Name, "%s%s", Prefix, HWCountersFileName);
+   if (moveLogFile(HWFile, HWCountersFileName, Name) || openHWCounters(Error)) {
+      printError("forkProfile", "unable to count the branch with the hardware counters.\n");
+      fclose(HWFile);
+      HWFile = NULL;
+   }
+   HWCountersFileName = Name;
+}
+
+
+/*--------------*
+ *  endProfile  *
+ *--------------*/
+
+/**
+ *  Writes in LogFile the summary of the counters and of the
+ *  phase times of the run, reaching the network time <Time>,
+ *  and frees the counters of the delay layers. Each value is
+ *  on a line "# PROFILE <Name> <Value>", to be easily parsed.
+ */
+
+void endProfile (double Time)
+{
+   double Wall, CPU, Scale, Managed, Ticks;
+   int k, c;
+
+   if (Profile.QueuePops == NULL)
+      return;
+
+   Wall  = profileClock() - WallStart;
+   CPU   = profileCPUClock() - CPUStart;
+   Managed = (double)(Profile.ExternalSpikes + Profile.RecurrentSpikes);
+
+   /*** The wall-clock time is shared among the phases: the laps ***
+    *** cost more in the loop than in the calibration.           ***/
+   for (Ticks = 0.0, k=0; k<NUM_PHASES; k++) {
+      if (Profile.PhaseTicks[k] < 0.0)
+         Profile.PhaseTicks[k] = 0.0;
+      Ticks += Profile.PhaseTicks[k];
+   }
+   Scale = Ticks > 0.0 ? Wall / Ticks : 0.0; // From ticks to s.
+
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Profile of the simulation loop up to %.7g ms (phases sampled on 1 iteration every %d).\n",
+           Time, PROFILE_SAMPLING);
+   fprintf(DocFile, "# PROFILE WallTime %g s\n", Wall);
+   fprintf(DocFile, "# PROFILE CPUTime %g s\n", CPU);
+   fprintf(DocFile, "# PROFILE ExternalSpikes %" PRIu64 "\n", Profile.ExternalSpikes);
+   fprintf(DocFile, "# PROFILE RecurrentSpikes %" PRIu64 "\n", Profile.RecurrentSpikes);
+   fprintf(DocFile, "# PROFILE SynapsesDelivered %" PRIu64 "\n", Profile.SynapsesDelivered);
+   fprintf(DocFile, "# PROFILE EmittedSpikes %" PRIu64 "\n", Profile.EmittedSpikes);
+   fprintf(DocFile, "# PROFILE ManagedEvents %" PRIu64 "\n", Profile.ManagedEvents);
+   fprintf(DocFile, "# PROFILE SpikesPerSecond %g\n", Wall > 0.0 ? Managed / Wall : 0.0);
+   fprintf(DocFile, "# PROFILE NetworkTimePerSecond %g ms\n", Wall > 0.0 ? Time / Wall : 0.0);
+   fprintf(DocFile, "# PROFILE NsPerSynapse %g\n", Profile.SynapsesDelivered > 0 ?
+           Profile.PhaseTicks[PHASE_DELIVERY] * Scale * 1e9 / Profile.SynapsesDelivered : 0.0);
+   for (k=0; k<NUM_PHASES; k++)
+      fprintf(DocFile, "# PROFILE Phase%s %g s\n", PhaseNames[k], Profile.PhaseTicks[k] * Scale);
+   for (k=0; k<ProfileLayers; k++)
+      fprintf(DocFile, "# PROFILE Layer%d %" PRIu64 " pushes %" PRIu64 " pops\n",
+              k, Profile.QueuePushes[k], Profile.QueuePops[k]);
+
+   /*** Hardware counters per phase, estimated from the sampled iterations. ***/
+   if (HWFile != NULL) {
+      if (PeriodHWIterations > 0)
+         sampleProfile(Time);
+      Scale = RunHWIterations > 0 ? (double)Profile.Iterations / RunHWIterations : 0.0;
+      for (k=0; k<NUM_PHASES; k++) {
+         for (c=0; c<NUM_HW_COUNTERS; c++)
+            if (HWSlot[c] >= 0)
+               fprintf(DocFile, "# PROFILE HW%s%s %.6g\n", PhaseNames[k], HWNames[c], RunHW[k][c] * Scale);
+         if (HWSlot[HW_INSTRUCTIONS] >= 0 && RunHW[k][HW_CYCLES] > 0.0)
+            fprintf(DocFile, "# PROFILE HW%sIPC %.4g\n", PhaseNames[k], RunHW[k][HW_INSTRUCTIONS] / RunHW[k][HW_CYCLES]);
+      }
+      fclose(HWFile);
+      HWFile = NULL;
+   }
+   closeHWCounters();
+   fprintf(DocFile, "\n");
+   fflush(DocFile);
+
+   free(Profile.QueuePushes);
+   free(Profile.QueuePops);
+   releaseMemory(sizeof(uint64_t) * ProfileLayers, MEMORY_OTHER);
+   releaseMemory(sizeof(uint64_t) * ProfileLayers, MEMORY_OTHER);
+   Profile.QueuePushes = NULL;
+   Profile.QueuePops   = NULL;
+}
+
+
+
+#undef BUFFER_DIM
@@ -0,0 +1,238 @@
+/*
+ *
+ *   profile.h
+ *
+ *   Library of counters and timers measuring the phases of
+ *   the simulation loop, reported at the end of the run in
+ *   LogFile. The counters are updated at each spike, while
+ *   the phases are timed only on a sample of the spikes (one
+ *   every PROFILE_SAMPLING) to keep the overhead low: the
+ *   wall-clock time of the run is shared among the phases
+ *   in proportion to their sampled time. The phases are timed
+ *   with the time-stamp counter of the CPU where available
+ *   (x86), subtracting the cost of reading it.
+ *   On Linux the hardware counters of the CPU (cycles,
+ *   instructions, cache and branch misses) can be attributed
+ *   to the phases too (HWCounters in INIT_FILE), reading them
+ *   through perf_event_open on a sample of the timed spikes.
+ *   The module is active only if PRINT_PROFILE is defined
+ *   in perseo.h.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+
+
+#include <stdint.h>
+
+#include "types.h"
+#include "perseo.h"
+
+
+
+/*--------------------*
+ *  GLOBAL CONSTANTS  *
+ *--------------------*/
+
+/*** Phases of the simulation loop. ***/
+#define PHASE_EXTERNAL   0 /* Generation of the external and replayed spikes. */
+#define PHASE_NEURONS    1 /* Update of the neurons receiving the external spikes. */
+#define PHASE_DELIVERY   2 /* Delivery of the recurrent spikes (neuron and synapse updates). */
+#define PHASE_QUEUES     3 /* Management of the queues of the delay layers. */
+#define PHASE_EVENTS     4 /* Events of the protocol, including the sampled outputs. */
+#define PHASE_COMMANDS   5 /* Polling of the command file. */
+#define PHASE_CHECKPOINT 6 /* Writing of the checkpoints. */
+#define NUM_PHASES       7 /* Number of phases. */
+#define NO_PHASE        -1 /* Start of a timed spike. */
+
+#define PROFILE_SAMPLING 256 /* A spike every PROFILE_SAMPLING is timed (a power of 2). */
+#define HW_SAMPLING       16 /* A timed spike every HW_SAMPLING reads the hardware counters (a power of 2). */
+
+/*** Hardware counters. ***/
+#define HW_CYCLES        0 /* CPU cycles. */
+#define HW_INSTRUCTIONS  1 /* Instructions retired. */
+#define HW_CACHE_MISSES  2 /* Misses of the last level cache. */
+#define HW_BRANCH_MISSES 3 /* Mispredicted branches. */
+#define NUM_HW_COUNTERS  4 /* Number of hardware counters. */
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Counters and timers of the simulation loop.
+ */
+
+typedef struct {
+   uint64_t    ExternalSpikes; /* External and replayed spikes managed. */
+   uint64_t   RecurrentSpikes; /* Recurrent spikes managed, one per delay layer crossed. */
+   uint64_t SynapsesDelivered; /* Synapses transmitting the recurrent spikes. */
+   uint64_t     EmittedSpikes; /* Spikes emitted by the neurons of the network. */
+   uint64_t     ManagedEvents; /* Events handled by manageEvent. */
+   uint64_t      *QueuePushes; /* Spikes entered in each delay layer. */
+   uint64_t        *QueuePops; /* Spikes managed by each delay layer. */
+   uint64_t        Iterations; /* Iterations of the simulation loop. */
+   uint64_t   TimedIterations; /* Iterations timed. */
+   double PhaseTicks[NUM_PHASES]; /* Ticks spent in each phase by the timed iterations. */
+   uint64_t          LapStart; /* Tick of the start of the phase being timed. */
+   boolean              Timed; /* It is true if the present iteration is timed. */
+   boolean            HWTimed; /* It is true if the present iteration reads the hardware counters. */
+   double          NextSample; /* Network time of the next periodic sample in ms. */
+} profile;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+extern PERSEO_LOCAL profile Profile; /* The counters of the running simulation. */
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL boolean         HWCounters; /* If true the hardware counters are read. */
+extern PERSEO_LOCAL char   *HWCountersFileName; /* Name of the log file of the hardware counters. */
+extern PERSEO_LOCAL real    HWCountersSampling; /* Sampling period in ms of the hardware counters. */
+
+
+
+/*-----------------*
+ *  GLOBAL MACROS  *
+ *-----------------*/
+
+#ifdef PRINT_PROFILE
+
+/**
+ *  Adds <n> to the counter <Counter> of Profile.
+ */
+
+#define profileCount(Counter, n) (Profile.Counter += (n))
+
+
+/**
+ *  Increments the counter <Counter> of the delay layer <l>.
+ */
+
+#define profileLayer(Counter, l) (Profile.Counter[l]++)
+
+
+/**
+ *  Starts an iteration of the simulation loop, timing it if
+ *  it is one out of PROFILE_SAMPLING.
+ */
+
+#define profileIteration() \
+   ((Profile.Timed = ((++Profile.Iterations & (PROFILE_SAMPLING-1)) == 0)) ? profileLap(NO_PHASE) : (void)0)
+
+
+/**
+ *  Ends the phase <Phase> of a timed iteration.
+ */
+
+#define profilePhase(Phase) (Profile.Timed ? profileLap(Phase) : (void)0)
+
+
+/**
+ *  Ends an iteration of the simulation loop at the network
+ *  time <Time>, sampling the counters if a period elapsed.
+ */
+
+#define profileSample(Time) (Profile.Timed && (Time) >= Profile.NextSample ? sampleProfile(Time) : (void)0)
+
+#else
+
+#define profileCount(Counter, n)
+#define profileLayer(Counter, l)
+#define profileIteration()
+#define profilePhase(Phase)
+#define profileSample(Time)
+
+#endif
+
+
+
+/**
+ *  Returns the ticks of the clock timing the phases.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define profileTicks() ((uint64_t)__builtin_ia32_rdtsc())
+#else
+#define profileTicks() ((uint64_t)(profileClock() * 1e9))
+#endif
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Returns the wall-clock time in s from an arbitrary origin.
+ */
+
+double profileClock ();
+
+
+/**
+ *  Returns the CPU time in s spent by the calling thread.
+ */
+
+double profileCPUClock ();
+
+
+/**
+ *  Adds the ticks from the last lap to the phase <Phase>
+ *  (if not NO_PHASE) and starts a new lap.
+ */
+
+void profileLap (int Phase);
+
+
+/**
+ *  Resets the counters, allocating the ones of the delay
+ *  layers, and starts the clocks of the run. If HWCounters
+ *  is set, opens the hardware counters and their log file:
+ *  if they are not available, the run goes on without them.
+ */
+
+void startProfile ();
+
+
+/**
+ *  Writes a row of the log file of the hardware counters,
+ *  with their estimated counts per phase in the last period,
+ *  and schedules the next sample after the time <Time>.
+ */
+
+void sampleProfile (double Time);
+
+
+/**
+ *  In a process forked by the simulation, opens again the
+ *  hardware counters, which count the parent, and moves their
+ *  log file to a new one with <Prefix> in front of the name.
+ */
+
+void forkProfile (char *Prefix);
+
+
+/**
+ *  Writes in LogFile the summary of the counters and of the
+ *  phase times of the run, reaching the network time <Time>,
+ *  and frees the counters of the delay layers. Each value is
+ *  on a line "# PROFILE <Name> <Value>", to be easily parsed.
+ */
+
+void endProfile (double Time);
+
+
+
+#endif /* __PROFILE_H__ */
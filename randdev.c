@@ -1,420 +1,840 @@
-/*
- *
- *   randdev.c
- *
- *     Library providing functions generating pseudo-random
- *   number from different probability distributions (RANDom
- *   DEViations).
- *
- *   Realized by Maurizio Mattia
- *   Started November 21st, 1993
- *
- */
-
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <math.h>
-#include <time.h>
-#include "randdev.h"
-
-
-
-/*---------------------*
- *  LOCAL DEFINITIONS  *
- *---------------------*/
-
-static int    TimeSeed = 0;      /* Seme funzione del tempo del generatore. */
-static int rand49_idum = -77531; /* Varibile di appoggio per gli algoritmi. */
-
-
-
-/*--------------------*
- *  GLOBAL FUNCTIONS  *
- *--------------------*/
-
-#ifdef RAND2
-
-/*------------------------------------------------*
- *                                                *
- *   rand2 e Random                               *
- *                                                *
- *   Riporta  un float casuale  nell'intervallo   *
- *   [0,1[ con DISTRIBUZIONE UNIFORME. L'algo-    *
- *   ritmo usato e' da rand2 nel Numerical Reci-  *
- *   pice.                                        *
- *   NOTA: gli int devono essere a 32bit (Watcom  *
- *         e Unix, no Borland).                   *
- *------------------------------------------------*/
-
-#define M 714025
-#define IA 1366
-#define IC 150889
-
-double rand2 (int * idum) {
-
-	static long iy,ir[98];
-	static int iff=0;
-	int j;
-
-	if (*idum < 0  || iff == 0) {
-		iff=1;
-		if ((*idum=(IC-(*idum)) % M) < 0) *idum = -(*idum);
-		for (j=1;j<=97;j++) {
-			*idum=(IA*(*idum)+IC) % M;
-			ir[j]=(*idum);
-		}
-		*idum=(IA*(*idum)+IC) % M;
-		iy=(*idum);
-	}
-	j=(int)(1 + 97.0*iy/M);
-	if (j > 97 || j < 1) printf("RAN2: This cannot happen.");
-	iy=ir[j];
-	*idum=(IA*(*idum)+IC) % M;
-	ir[j]=(*idum);
-	return (double) iy/M;
-}
-
-#undef M
-#undef IA
-#undef IC
-
-double Random (void)  { return rand2(&rand49_idum); }
-
-#endif
-
-
-
-#ifdef RAND3
-
-/*------------------------------------------------------*
- *                                                      *
- *   rand3 e Random                                     *
- *                                                      *
- *   Riporta  un float casuale  nell'intervallo         *
- *   [0,1[ con DISTRIBUZIONE UNIFORME.                  *
- *   E' l'algoritmo preso da numerical recipice dovuto  *
- *   a knuth e nominato ran3. E' molto veloce ma poco   *
- *   studiato (non sanno bene che tipo di correlazioni  *
- *   puo' indurre).                                     *
- *   NOTA: gli int devono essere a 32bit (Watcom        *
- *         e Unix, no Borland). Altrimenti dove e' com- *
- *         mentato 'long' inserire 'long'.              *
- *------------------------------------------------------*/
-
-#define MBIG 1000000000
-#define MSEED 161803398
-#define MZ 0
-#define FAC (1.0/(double)MBIG)
-
-
-double rand3(int * idum)
-{
-   static int  inext, inextp;
-   static int  ma[56];        /*** long ***/
-   static int  iff = 0;
-          int  mj, mk;        /*** long ***/
-          int  i, ii, k;
-/*** Da togliere in fase di debug.
-   double out;
-***/
-
-   /*** Percorso di inizializzazione. ***/
-   if (*idum < 0 || iff == 0) {
-      iff=1;
-      mj=MSEED-(*idum < 0 ? -*idum : *idum);
-
-      /*** Modifica mia. ***/
-      mj = (mj < 0 ? -mj : mj); /*** Questa aggiunta l'ho fatta io, perche' ***
-                                 *** se non ci fosse non vengono numeri tra ***
-                                 *** 0.0 e 1.0. Io penso che in NR ci sia   ***
-                                 *** un errore di interpretazione sul si-   ***
-                                 *** gnificato di '%': pensano che riporti  ***
-                                 *** sempre un numero positivo.             ***
-                                 *** Se non ci credi prova con questo seed  ***
-                                 *** 878104453 (da passare a setRanomSeed). ***/
-      mj %= MBIG;
-      ma[55]=mj;
-      mk=1;
-      for (i=1;i<=54;i++) {
-         ii=(21*i) % 55;
-         ma[ii]=mk;
-         mk=mj-mk;
-         if (mk < MZ) mk += MBIG;
-         mj=ma[ii];
-      }
-      for (k=1;k<=4;k++)
-         for (i=1;i<=55;i++) {
-            ma[i] -= ma[1+(i+30) % 55];
-            if (ma[i] < MZ) ma[i] += MBIG;
-         }
-      inext=0;
-      inextp=31;
-      *idum=1;
-   }
-
-   if (++inext == 56) inext=1;
-   if (++inextp == 56) inextp=1;
-   mj=ma[inext]-ma[inextp];
-   if (mj < MZ) mj += MBIG;
-   ma[inext]=mj;
-
-/*** Da scommentare in fase di debug.
-   out = mj*FAC;
-   if (out < 0 || out >= 1) {
-      fprintf(stderr, "ERROR: Bad random number.");
-      abort();
-   }
-   return out;
-***/
-
-   return mj*FAC;
-}
-
-#undef MBIG
-#undef MSEED
-#undef MZ
-#undef FAC
-
-double Random (void)  { return rand3(&rand49_idum); }
-
-#endif /* of RAND3 */
-
-
-
-#ifdef RAND1
-
-/*------------------------------------------------*
- *                                                *
- *   UniDev.                                      *
- *                                                *
- *   Riporta  un  int  casuale  nell'intervallo   *
- *   [0,RAND_MAX] con DISTRIBUZIONE UNIFORME.     *
- *   Per inizializzare  il seme del  generatore   *
- *   utilizzare la seguente sintassi:             *
- *      UniDev( &Seed )                           *
- *   dove Seed deve essere una variabile intera   *
- *   contenente il seme iniziale. Per mantenere   *
- *   intatto il seme basta richiamare la funzio-  *
- *   ne con la seguente sintassi:                 *
- *      UniDev( NULL )                            *
- *   Questa procedura si basa sull'algoritmo di   *
- *   BAYS e DURHAM.                               *
- *                                                *
- *   NOTE: Il periodo del  generatore e' pratica- *
- *         infinito, ma i numeri forniti non so-  *
- *         no piu' di RAND_MAX+1.                 *
- *         Deve essere usata con i piedi di piom- *
- *         bo quando si utilizzano i bit meno si- *
- *         gnificativi.                           *
- *                                                *
- *------------------------------------------------*/
-
-int UniDev (int * SeedPntr) /* Puntatore al seme del generatore. Se NULL il generatore *
-                             * non viene inizializzato.                                */
-
-{
-   /*** Dichiarazione delle variabili locali. ***/
-   #define SEQUENCE_DIM 98.0
-   static int y, Sequence[(int)SEQUENCE_DIM];
-   static int FirstCall = 1;         /* Prima chiamata della funzione? */
-   static int j;                     /* Contatore.                     */
-
-   /*** Inizializzazione della sequenza. ***/
-   if (SeedPntr != NULL || FirstCall)
-     {
-      FirstCall = 0;
-      if (SeedPntr != NULL) srand(*SeedPntr);
-      for (j=0; j<(int)SEQUENCE_DIM; j++) rand();
-      for (j=0; j<(int)SEQUENCE_DIM; j++) Sequence[j] = rand();
-      y = rand();
-     }
-
-   /*** Generazione del numero ps eudo-casuale. ***/
-   j           = (SEQUENCE_DIM*y)/(RAND_MAX+1);
-   y           = Sequence[j];
-   Sequence[j] = rand();
-   return y;
-}
-
-#endif /* of RAND1 */
-
-
-
-/*----------------------------------------------*
- *                                              *
- *   SetRandomSeed (int Seed)                   *
- *                                              *
- *   Assegna un valore al seme del generatore   *
- *   numeri pseudo-casuali.                     *
- *                                              *
- *----------------------------------------------*/
-
-void SetRandomSeed (int Seed)
-
-{
-   TimeSeed = Seed;
-   
-#ifdef RAND2
-   rand49_idum=-Seed;
-   rand2(&rand49_idum);
-#endif
-#ifdef RAND3
-   rand49_idum=-Seed;
-   rand3(&rand49_idum);
-#endif
-#ifdef RAND1
-   UniDev(&TimeSeed);
-#endif
-}
-
-
-
-/*------------------------------------------------------*
- *   GetRandomSeed ()                                   *
- *                                                      *
- *   Riporta il seme del generatore di numeri pseudo-   *
- *   casuali TimeSeed.                                  *
- *------------------------------------------------------*/
-
-int GetRandomSeed (void)
-
-{
-   return TimeSeed;
-}
-
-
-
-/*----------------------------------------------*
- *                                              *
- *   Randomize.                                 *
- *                                              *
- *   Inizializza in modo casuale (attraverso    *
- *   la funzione time) il generatore di nume-   *
- *   ri pseudo-casuali UniDev.                  *
- *                                              *
- *----------------------------------------------*/
-
-void Randomize (void)
-
-{
-   SetRandomSeed((unsigned)time(NULL));
-}
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   ExpDev.                                      *
- *                                                *
- *   Riporta un numero  casuale reale positivo    *
- *   (float) con  distribuzione esponenziale e    *
- *   media  unitaria, usando come  sorgente di    *
- *   numeri casuali con distribuzione uniforme    *
- *   Random.                                      *
- *     Fun. di distribuzione = e^-x con x>0.0    *
- *   Questa procedura si basa sull'algoritmo di   *
- *   Montecarlo.                                  *
- *                                                *
- *------------------------------------------------*/
-
-double ExpDev ( void )
-
-{
-   /*** Dichiarazione delle variabili locali. ***/
-   double Dum;      /* Variabile di appoggio. */
-
-   /*** Ciclo di generazione del singolo numero. ***/
-   do
-      Dum = (double)Random();
-   while (Dum == 0.0);
-   return (double)-log(Dum);
-}
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   NormDev.                                     *
- *                                                *
- *   Riporta un  numero  casuale reale (float)    *
- *   con distribuzione gaussiana,  media nulla    *
- *   e varianza unitaria. Come sorgente di nu-    *
- *   meri  casuali con  distribuzione uniforme    *
- *   viene usata Random().                        *
- *     Fun. di distr. = 1/(sqrt(2pi))*e^-x^2      *
- *   Questa procedura si basa sull'algoritmo di   *
- *   BOX-MULLER.                                  *
- *                                                *
- *------------------------------------------------*/
-
-double NormDev ( void )
-
-{
-   /*** Dichiarazione delle variabili locali. ***/
-   static int   Set = 0;
-   static double IIran;
-   double Fac, r, v1, v2;
-
-   /*** Decisione su quale set prendere il singolo numero. ***/
-   if (Set == 0)
-     {do
-        {v1 = (double)(2.0 * Random() - 1.0);
-         v2 = (double)(2.0 * Random() - 1.0);
-         r  = v1 * v1 + v2 * v2;}
-      while (r >= 1.0 || r==0.0);
-      Fac   = (double)sqrt(-2.0 * log(r) / r);
-      IIran = v1 * Fac;
-      Set   = 1;
-      return v2 * Fac;}
-   else
-     {Set = 0;
-      return IIran;}
-}
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   BernDev.                                     *
- *                                                *
- *   Riporta un  numero  casuale intero (int)     *
- *   con distribuzione Bernoulliana, con media    *
- *   N*p e varianza N*p*(1-p). Come sorgente di   *
- *   numeri casuali con distribuzione uniforme    *
- *   viene usata Random().                        *
- *                                                *
- *------------------------------------------------*/
-
-int BernDev (int N, double p) 
-
-{
-   static double FDP;     /* Funzione di Distribuzione di Probabilita'. */
-   static double FDC;     /* Funzione di Distribuzione Cumulativa.      */
-   static double r;       /* Numero casuale in [0,1[.                   */
-   static int    n;       /* Numero di eventi da riportare.             */
-   static double q;       /* Prob. di NON emissione di uno spike.       */
-   static double Precision = 0.00001;
-
-   /* Iniz. delle Variab. utili a calcolare la distrib. di Bernoulli. */
-   q = 1.0 - p;
-   FDC = FDP = (double)(exp( N * log(q) ));
-   r   = (double)Random();
-   n   = 0;
-
-   /*** Questa riga e' necessario poiche' nel ciclo successivo. ***
-    *** FDC non tende a 1.0 bensi a qualcosa dell'ordine di     ***
-    *** 1.0-Precision. Altrimenti si possono avere dei loop     ***
-    *** infiniti.                                               ***/
-   if ((1.0-r)<Precision) r = (double)(1.0-Precision);
-
-   /* Estrazione del numero di eventi. */
-   while (r>=FDC) {
-      n++;
-      FDP  *= (double)((N-n+1.)/n * p / q);
-      FDC += FDP;
-   }
-
-   return n;
-}
\ No newline at end of file
+/*
+ *
+ *   randdev.c
+ *
+ *     Library providing functions generating pseudo-random
+ *   number from different probability distributions (RANDom
+ *   DEViations).
+ *
+ *   Realized by Maurizio Mattia
+ *   Started November 21st, 1993
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "randdev.h"
+#include "types.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+static PERSEO_LOCAL int    TimeSeed = 0;      /* Seme funzione del tempo del generatore. */
+static PERSEO_LOCAL int rand49_idum = -77531; /* Varibile di appoggio per gli algoritmi. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+#ifdef RAND2
+
+/*------------------------------------------------*
+ *                                                *
+ *   rand2 e Random                               *
+ *                                                *
+ *   Riporta  un float casuale  nell'intervallo   *
+ *   [0,1[ con DISTRIBUZIONE UNIFORME. L'algo-    *
+ *   ritmo usato e' da rand2 nel Numerical Reci-  *
+ *   pice.                                        *
+ *   NOTA: gli int devono essere a 32bit (Watcom  *
+ *         e Unix, no Borland).                   *
+ *------------------------------------------------*/
+
+#define M 714025
+#define IA 1366
+#define IC 150889
+
+double rand2 (int * idum) {
+
+	static PERSEO_LOCAL long iy,ir[98];
+	static PERSEO_LOCAL int iff=0;
+	int j;
+
+	if (*idum < 0  || iff == 0) {
+		iff=1;
+		if ((*idum=(IC-(*idum)) % M) < 0) *idum = -(*idum);
+		for (j=1;j<=97;j++) {
+			*idum=(IA*(*idum)+IC) % M;
+			ir[j]=(*idum);
+		}
+		*idum=(IA*(*idum)+IC) % M;
+		iy=(*idum);
+	}
+	j=(int)(1 + 97.0*iy/M);
+	if (j > 97 || j < 1) printf("RAN2: This cannot happen.");
+	iy=ir[j];
+	*idum=(IA*(*idum)+IC) % M;
+	ir[j]=(*idum);
+	return (double) iy/M;
+}
+
+#undef M
+#undef IA
+#undef IC
+
+double Random (void)  { return rand2(&rand49_idum); }
+
+#endif
+
+
+
+#ifdef RAND3
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   rand3 e Random                                     *
+ *                                                      *
+ *   Riporta  un float casuale  nell'intervallo         *
+ *   [0,1[ con DISTRIBUZIONE UNIFORME.                  *
+ *   E' l'algoritmo preso da numerical recipice dovuto  *
+ *   a knuth e nominato ran3. E' molto veloce ma poco   *
+ *   studiato (non sanno bene che tipo di correlazioni  *
+ *   puo' indurre).                                     *
+ *   NOTA: gli int devono essere a 32bit (Watcom        *
+ *         e Unix, no Borland). Altrimenti dove e' com- *
+ *         mentato 'long' inserire 'long'.              *
+ *------------------------------------------------------*/
+
+#define MBIG 1000000000
+#define MSEED 161803398
+#define MZ 0
+#define FAC (1.0/(double)MBIG)
+
+
+double rand3(int * idum)
+{
+   static PERSEO_LOCAL int  inext, inextp;
+   static PERSEO_LOCAL int  ma[56];        /*** long ***/
+   static PERSEO_LOCAL int  iff = 0;
+          int  mj, mk;        /*** long ***/
+          int  i, ii, k;
+/*** Da togliere in fase di debug.
+   double out;
+***/
+
+   /*** Percorso di inizializzazione. ***/
+   if (*idum < 0 || iff == 0) {
+      iff=1;
+      mj=MSEED-(*idum < 0 ? -*idum : *idum);
+
+      /*** Modifica mia. ***/
+      mj = (mj < 0 ? -mj : mj); /*** Questa aggiunta l'ho fatta io, perche' ***
+                                 *** se non ci fosse non vengono numeri tra ***
+                                 *** 0.0 e 1.0. Io penso che in NR ci sia   ***
+                                 *** un errore di interpretazione sul si-   ***
+                                 *** gnificato di '%': pensano che riporti  ***
+                                 *** sempre un numero positivo.             ***
+                                 *** Se non ci credi prova con questo seed  ***
+                                 *** 878104453 (da passare a setRanomSeed). ***/
+      mj %= MBIG;
+      ma[55]=mj;
+      mk=1;
+      for (i=1;i<=54;i++) {
+         ii=(21*i) % 55;
+         ma[ii]=mk;
+         mk=mj-mk;
+         if (mk < MZ) mk += MBIG;
+         mj=ma[ii];
+      }
+      for (k=1;k<=4;k++)
+         for (i=1;i<=55;i++) {
+            ma[i] -= ma[1+(i+30) % 55];
+            if (ma[i] < MZ) ma[i] += MBIG;
+         }
+      inext=0;
+      inextp=31;
+      *idum=1;
+   }
+
+   if (++inext == 56) inext=1;
+   if (++inextp == 56) inextp=1;
+   mj=ma[inext]-ma[inextp];
+   if (mj < MZ) mj += MBIG;
+   ma[inext]=mj;
+
+/*** Da scommentare in fase di debug.
+   out = mj*FAC;
+   if (out < 0 || out >= 1) {
+      fprintf(stderr, "ERROR: Bad random number.");
+      abort();
+   }
+   return out;
+***/
+
+   return mj*FAC;
+}
+
+#undef MBIG
+#undef MSEED
+#undef MZ
+#undef FAC
+
+double Random (void)  { return rand3(&rand49_idum); }
+
+#endif /* of RAND3 */
+
+
+
+#ifdef RAND1
+
+/*------------------------------------------------*
+ *                                                *
+ *   UniDev.                                      *
+ *                                                *
+ *   Riporta  un  int  casuale  nell'intervallo   *
+ *   [0,RAND_MAX] con DISTRIBUZIONE UNIFORME.     *
+ *   Per inizializzare  il seme del  generatore   *
+ *   utilizzare la seguente sintassi:             *
+ *      UniDev( &Seed )                           *
+ *   dove Seed deve essere una variabile intera   *
+ *   contenente il seme iniziale. Per mantenere   *
+ *   intatto il seme basta richiamare la funzio-  *
+ *   ne con la seguente sintassi:                 *
+ *      UniDev( NULL )                            *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   BAYS e DURHAM.                               *
+ *                                                *
+ *   NOTE: Il periodo del  generatore e' pratica- *
+ *         infinito, ma i numeri forniti non so-  *
+ *         no piu' di RAND_MAX+1.                 *
+ *         Deve essere usata con i piedi di piom- *
+ *         bo quando si utilizzano i bit meno si- *
+ *         gnificativi.                           *
+ *                                                *
+ *------------------------------------------------*/
+
+int UniDev (int * SeedPntr) /* Puntatore al seme del generatore. Se NULL il generatore *
+                             * non viene inizializzato.                                */
+
+{
+   /*** Dichiarazione delle variabili locali. ***/
+   #define SEQUENCE_DIM 98.0
+   static PERSEO_LOCAL int y, Sequence[(int)SEQUENCE_DIM];
+   static PERSEO_LOCAL int FirstCall = 1;         /* Prima chiamata della funzione? */
+   static PERSEO_LOCAL int j;                     /* Contatore.                     */
+
+   /*** Inizializzazione della sequenza. ***/
+   if (SeedPntr != NULL || FirstCall)
+     {
+      FirstCall = 0;
+      if (SeedPntr != NULL) srand(*SeedPntr);
+      for (j=0; j<(int)SEQUENCE_DIM; j++) rand();
+      for (j=0; j<(int)SEQUENCE_DIM; j++) Sequence[j] = rand();
+      y = rand();
+     }
+
+   /*** Generazione del numero ps eudo-casuale. ***/
+   j           = (SEQUENCE_DIM*y)/(RAND_MAX+1);
+   y           = Sequence[j];
+   Sequence[j] = rand();
+   return y;
+}
+
+#endif /* of RAND1 */
+
+
+
+/*----------------------------------------------*
+ *                                              *
+ *   SetRandomSeed (int Seed)                   *
+ *                                              *
+ *   Assegna un valore al seme del generatore   *
+ *   numeri pseudo-casuali.                     *
+ *                                              *
+ *----------------------------------------------*/
+
+void SetRandomSeed (int Seed)
+
+{
+   TimeSeed = Seed;
+   
+#ifdef RAND2
+   rand49_idum=-Seed;
+   rand2(&rand49_idum);
+#endif
+#ifdef RAND3
+   rand49_idum=-Seed;
+   rand3(&rand49_idum);
+#endif
+#ifdef RAND1
+   UniDev(&TimeSeed);
+#endif
+}
+
+
+
+/*------------------------------------------------------*
+ *   GetRandomSeed ()                                   *
+ *                                                      *
+ *   Riporta il seme del generatore di numeri pseudo-   *
+ *   casuali TimeSeed.                                  *
+ *------------------------------------------------------*/
+
+int GetRandomSeed (void)
+
+{
+   return TimeSeed;
+}
+
+
+
+/*----------------------------------------------*
+ *                                              *
+ *   Randomize.                                 *
+ *                                              *
+ *   Inizializza in modo casuale (attraverso    *
+ *   la funzione time) il generatore di nume-   *
+ *   ri pseudo-casuali UniDev.                  *
+ *                                              *
+ *----------------------------------------------*/
+
+void Randomize (void)
+
+{
+   SetRandomSeed((unsigned)time(NULL));
+}
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   ExpDev.                                      *
+ *                                                *
+ *   Riporta un numero  casuale reale positivo    *
+ *   (float) con  distribuzione esponenziale e    *
+ *   media  unitaria, usando come  sorgente di    *
+ *   numeri casuali con distribuzione uniforme    *
+ *   Random.                                      *
+ *     Fun. di distribuzione = e^-x con x>0.0    *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   Montecarlo.                                  *
+ *                                                *
+ *------------------------------------------------*/
+
+double ExpDev ( void )
+
+{
+   /*** Dichiarazione delle variabili locali. ***/
+   double Dum;      /* Variabile di appoggio. */
+
+   /*** Ciclo di generazione del singolo numero. ***/
+   do
+      Dum = (double)Random();
+   while (Dum == 0.0);
+   return (double)-log(Dum);
+}
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   NormDev.                                     *
+ *                                                *
+ *   Riporta un  numero  casuale reale (float)    *
+ *   con distribuzione gaussiana,  media nulla    *
+ *   e varianza unitaria. Come sorgente di nu-    *
+ *   meri  casuali con  distribuzione uniforme    *
+ *   viene usata Random().                        *
+ *     Fun. di distr. = 1/(sqrt(2pi))*e^-x^2      *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   BOX-MULLER.                                  *
+ *                                                *
+ *------------------------------------------------*/
+
+double NormDev ( void )
+
+{
+   /*** Dichiarazione delle variabili locali. ***/
+   static PERSEO_LOCAL int   Set = 0;
+   static PERSEO_LOCAL double IIran;
+   double Fac, r, v1, v2;
+
+   /*** Decisione su quale set prendere il singolo numero. ***/
+   if (Set == 0)
+     {do
+        {v1 = (double)(2.0 * Random() - 1.0);
+         v2 = (double)(2.0 * Random() - 1.0);
+         r  = v1 * v1 + v2 * v2;}
+      while (r >= 1.0 || r==0.0);
+      Fac   = (double)sqrt(-2.0 * log(r) / r);
+      IIran = v1 * Fac;
+      Set   = 1;
+      return v2 * Fac;}
+   else
+     {Set = 0;
+      return IIran;}
+}
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   BernDev.                                     *
+ *                                                *
+ *   Riporta un  numero  casuale intero (int)     *
+ *   con distribuzione Bernoulliana, con media    *
+ *   N*p e varianza N*p*(1-p). Come sorgente di   *
+ *   numeri casuali con distribuzione uniforme    *
+ *   viene usata Random().                        *
+ *                                                *
+ *------------------------------------------------*/
+
+int BernDev (int N, double p) 
+
+{
+   double FDP;     /* Funzione di Distribuzione di Probabilita'. */
+   double FDC;     /* Funzione di Distribuzione Cumulativa.      */
+   double r;       /* Numero casuale in [0,1[.                   */
+   int    n;       /* Numero di eventi da riportare.             */
+   double q;       /* Prob. di NON emissione di uno spike.       */
+   double Precision = 0.00001;
+
+   /* Iniz. delle Variab. utili a calcolare la distrib. di Bernoulli. */
+   q = 1.0 - p;
+   FDC = FDP = (double)(exp( N * log(q) ));
+   r   = (double)Random();
+   n   = 0;
+
+   /*** Questa riga e' necessario poiche' nel ciclo successivo. ***
+    *** FDC non tende a 1.0 bensi a qualcosa dell'ordine di     ***
+    *** 1.0-Precision. Altrimenti si possono avere dei loop     ***
+    *** infiniti.                                               ***/
+   if ((1.0-r)<Precision) r = (double)(1.0-Precision);
+
+   /* Estrazione del numero di eventi. */
+   while (r>=FDC) {
+      n++;
+      FDP  *= (double)((N-n+1.)/n * p / q);
+      FDC += FDP;
+   }
+
+   return n;
+}
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   Counter-based streams (Philox 4x32-10).            *
+ *                                                      *
+ *------------------------------------------------------*/
+
+#define PHILOX_M0 0xD2511F53u /* Multipliers of the rounds. */
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u /* Weyl sequence increments of the key. */
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+#define LANES (RS_BLOCK / 4)  /* Blocks generated together by PhiloxLanes. */
+#define CHUNK 256             /* Words drawn at once by the ziggurat fills. */
+#define EXP_LAYERS 256        /* Layers of the exponential ziggurat. */
+#define NORM_LAYERS 128       /* Layers of the gaussian ziggurat. */
+#define EXP_R  7.697117470131487    /* Start of the tail of the exponential ziggurat. */
+#define EXP_V  3.949659822581572e-3 /* Area of each layer of the exponential ziggurat. */
+#define NORM_R 3.442619855899       /* Start of the tail of the gaussian ziggurat. */
+#define NORM_V 9.91256303526217e-3  /* Area of each layer of the gaussian ziggurat. */
+#define TO_DOUBLE(a,b) (((a) >> 5) * 67108864.0 + ((b) >> 6)) * (1.0 / 9007199254740992.0)
+
+
+/*** Ziggurat tables, computed at the first use. ***/
+static PERSEO_LOCAL uint32_t KExp[EXP_LAYERS];   /* Thresholds for the fast acceptance. */
+static PERSEO_LOCAL double   WExp[EXP_LAYERS];   /* Widths of the layers over 2^32. */
+static PERSEO_LOCAL double   FExp[EXP_LAYERS];   /* Density at the layer edges. */
+static PERSEO_LOCAL uint32_t KNorm[NORM_LAYERS];
+static PERSEO_LOCAL double   WNorm[NORM_LAYERS];
+static PERSEO_LOCAL double   FNorm[NORM_LAYERS];
+static PERSEO_LOCAL int      ZigguratReady = 0;
+
+
+/*------------------------------------------------------*
+ *   PhiloxLanes                                        *
+ *                                                      *
+ *   Computes in <Out> the 4*LANES words of LANES       *
+ *   blocks of stream <s> with consecutive counters,    *
+ *   block after block, then it advances the counter.   *
+ *   The state of the blocks is kept in local arrays,   *
+ *   which cannot alias <Out>, so that each round is    *
+ *   applied to all the blocks in a loop the compiler   *
+ *   vectorizes already at -O2.                         *
+ *------------------------------------------------------*/
+
+static void PhiloxLanes (rand_stream *s, uint32_t *Out)
+{
+   uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+   uint32_t k0, k1, t0;
+   uint64_t p0, p1;
+   int l, r;
+
+   for (l=0; l<LANES; l++) {
+      t0 = s->Counter[0] + (uint32_t)l;
+      c0[l] = t0;
+      c1[l] = s->Counter[1] + (t0 < s->Counter[0] ? 1 : 0);
+      c2[l] = s->Counter[2];
+      c3[l] = s->Counter[3];
+   }
+   k0 = s->Key[0];
+   k1 = s->Key[1];
+   for (r=0; r<PHILOX_ROUNDS; r++) {
+      for (l=0; l<LANES; l++) {
+         p0 = (uint64_t)PHILOX_M0 * c0[l];
+         p1 = (uint64_t)PHILOX_M1 * c2[l];
+         c0[l] = (uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+         c1[l] = (uint32_t)p1;
+         c2[l] = (uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+         c3[l] = (uint32_t)p0;
+      }
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+   }
+   for (l=0; l<LANES; l++) {
+      Out[4*l]     = c0[l];
+      Out[4*l + 1] = c1[l];
+      Out[4*l + 2] = c2[l];
+      Out[4*l + 3] = c3[l];
+   }
+
+   t0 = s->Counter[0];
+   s->Counter[0] += LANES;
+   if (s->Counter[0] < t0) s->Counter[1]++;
+}
+
+
+/*------------------------------------------------------*
+ *   initZiggurat                                       *
+ *                                                      *
+ *   Computes the tables of the ziggurat algorithm      *
+ *   (Marsaglia and Tsang, J. Stat. Softw. 5(8), 2000)  *
+ *   for the exponential and the gaussian distribu-     *
+ *   tions.                                             *
+ *------------------------------------------------------*/
+
+static void initZiggurat (void)
+{
+   double d, t, q;
+   int    i;
+
+   /*** Exponential distribution, unsigned 32-bit words. ***/
+   d = t = EXP_R;
+   q = EXP_V / exp(-d);
+   KExp[0] = (uint32_t)((d / q) * 4294967296.0);
+   KExp[1] = 0;
+   WExp[0] = q / 4294967296.0;
+   WExp[EXP_LAYERS-1] = d / 4294967296.0;
+   FExp[0] = 1.0;
+   FExp[EXP_LAYERS-1] = exp(-d);
+   for (i=EXP_LAYERS-2; i>=1; i--) {
+      d = -log(EXP_V / d + exp(-d));
+      KExp[i+1] = (uint32_t)((d / t) * 4294967296.0);
+      t = d;
+      FExp[i] = exp(-d);
+      WExp[i] = d / 4294967296.0;
+   }
+
+   /*** Gaussian distribution, signed 32-bit words. ***/
+   d = t = NORM_R;
+   q = NORM_V / exp(-0.5 * d * d);
+   KNorm[0] = (uint32_t)((d / q) * 2147483648.0);
+   KNorm[1] = 0;
+   WNorm[0] = q / 2147483648.0;
+   WNorm[NORM_LAYERS-1] = d / 2147483648.0;
+   FNorm[0] = 1.0;
+   FNorm[NORM_LAYERS-1] = exp(-0.5 * d * d);
+   for (i=NORM_LAYERS-2; i>=1; i--) {
+      d = sqrt(-2.0 * log(NORM_V / d + exp(-0.5 * d * d)));
+      KNorm[i+1] = (uint32_t)((d / t) * 2147483648.0);
+      t = d;
+      FNorm[i] = exp(-0.5 * d * d);
+      WNorm[i] = d / 2147483648.0;
+   }
+
+   ZigguratReady = 1;
+}
+
+
+/*------------------------------------------------------*
+ *   expFix                                             *
+ *                                                      *
+ *   Slow path of the exponential ziggurat, for the     *
+ *   word <w> rejected by the fast test.                *
+ *------------------------------------------------------*/
+
+static double expFix (rand_stream *s, uint32_t w)
+{
+   double x;
+   int    i;
+
+   for (;;) {
+      i = w & (EXP_LAYERS-1);
+      if (w < KExp[i])
+         return w * WExp[i];
+      if (i == 0)
+         return EXP_R - log(1.0 - StreamRandom(s));
+      x = w * WExp[i];
+      if (FExp[i] + StreamRandom(s) * (FExp[i-1] - FExp[i]) < exp(-x))
+         return x;
+      w = StreamWord(s);
+   }
+}
+
+
+/*------------------------------------------------------*
+ *   normFix                                            *
+ *                                                      *
+ *   Slow path of the gaussian ziggurat, for the word   *
+ *   <w> rejected by the fast test.                     *
+ *------------------------------------------------------*/
+
+static double normFix (rand_stream *s, uint32_t w)
+{
+   double x, y;
+   int32_t h;
+   int     i;
+
+   for (;;) {
+      h = (int32_t)w;
+      i = h & (NORM_LAYERS-1);
+      if ((h < 0 ? -(uint32_t)h : (uint32_t)h) < KNorm[i])
+         return h * WNorm[i];
+      x = h * WNorm[i];
+      if (i == 0) {
+         do {
+            x = -log(1.0 - StreamRandom(s)) / NORM_R;
+            y = -log(1.0 - StreamRandom(s));
+         } while (y + y < x * x);
+         return h > 0 ? NORM_R + x : -NORM_R - x;
+      }
+      if (FNorm[i] + StreamRandom(s) * (FNorm[i-1] - FNorm[i]) < exp(-0.5 * x * x))
+         return x;
+      w = StreamWord(s);
+   }
+}
+
+
+/*------------------------------------------------------*
+ *   InitRandomStream                                   *
+ *                                                      *
+ *   Initializes the stream <s> identified by the seed  *
+ *   <Seed>, the subsystem <Subsystem> and the id <Id>  *
+ *   (for instance a population or a neuron index).     *
+ *------------------------------------------------------*/
+
+void InitRandomStream (rand_stream *s, int Seed, int Subsystem, uint64_t Id)
+{
+   s->Key[0] = (uint32_t)Seed;
+   s->Key[1] = (uint32_t)Subsystem;
+   s->Counter[0] = 0;
+   s->Counter[1] = 0;
+   s->Counter[2] = (uint32_t)Id;
+   s->Counter[3] = (uint32_t)(Id >> 32);
+   s->Used = RS_BLOCK;
+}
+
+
+/*------------------------------------------------------*
+ *   StreamWord                                         *
+ *                                                      *
+ *   Returns the next 32-bit word of the stream <s>.    *
+ *------------------------------------------------------*/
+
+uint32_t StreamWord (rand_stream *s)
+{
+   if (s->Used >= RS_BLOCK) {
+      PhiloxLanes(s, s->Block);
+      s->Used = 0;
+   }
+
+   return s->Block[s->Used++];
+}
+
+
+/*------------------------------------------------------*
+ *   StreamRandom                                       *
+ *                                                      *
+ *   Returns the next number of the stream <s> in the   *
+ *   interval [0,1[ with UNIFORM distribution and 53    *
+ *   random bits.                                       *
+ *------------------------------------------------------*/
+
+double StreamRandom (rand_stream *s)
+{
+   uint32_t a;
+
+   a = StreamWord(s);
+
+   return TO_DOUBLE(a, StreamWord(s));
+}
+
+
+/*------------------------------------------------------*
+ *   StreamExpDev                                       *
+ *                                                      *
+ *   Returns the next number of the stream <s> with     *
+ *   EXPONENTIAL distribution and unitary mean, with    *
+ *   the ziggurat algorithm.                            *
+ *------------------------------------------------------*/
+
+double StreamExpDev (rand_stream *s)
+{
+   uint32_t w;
+
+   if (!ZigguratReady) initZiggurat();
+   w = StreamWord(s);
+   if (w < KExp[w & (EXP_LAYERS-1)])
+      return w * WExp[w & (EXP_LAYERS-1)];
+
+   return expFix(s, w);
+}
+
+
+/*------------------------------------------------------*
+ *   StreamNormDev                                      *
+ *                                                      *
+ *   Returns the next number of the stream <s> with     *
+ *   GAUSSIAN distribution, null mean and unitary va-   *
+ *   riance, with the ziggurat algorithm.               *
+ *------------------------------------------------------*/
+
+double StreamNormDev (rand_stream *s)
+{
+   int32_t h;
+
+   if (!ZigguratReady) initZiggurat();
+   h = (int32_t)StreamWord(s);
+   if ((h < 0 ? -(uint32_t)h : (uint32_t)h) < KNorm[h & (NORM_LAYERS-1)])
+      return h * WNorm[h & (NORM_LAYERS-1)];
+
+   return normFix(s, (uint32_t)h);
+}
+
+
+/*------------------------------------------------------*
+ *   wordFill                                           *
+ *                                                      *
+ *   Fills the array <w> with the next <n> words of the *
+ *   stream <s>, in the same order of StreamWord.       *
+ *------------------------------------------------------*/
+
+void wordFill (rand_stream *s, uint32_t *w, int n)
+{
+   int i, m;
+
+   for (i=0; i<n; i+=m) {
+      if (s->Used >= RS_BLOCK) {
+         PhiloxLanes(s, s->Block);
+         s->Used = 0;
+      }
+      m = RS_BLOCK - s->Used < n - i ? RS_BLOCK - s->Used : n - i;
+      memcpy(w + i, s->Block + s->Used, sizeof(uint32_t) * m);
+      s->Used += m;
+   }
+}
+
+
+/*------------------------------------------------------*
+ *   randomFill                                         *
+ *                                                      *
+ *   Fills the array <x> with <n> numbers of the stream *
+ *   <s> with UNIFORM distribution in [0,1[.            *
+ *------------------------------------------------------*/
+
+void randomFill (rand_stream *s, double *x, int n)
+{
+   int i, l, m;
+
+   for (i=0; i<n; i+=m) {
+
+      /*** Pairs of words left in the buffer of the stream. ***/
+      m = (RS_BLOCK - s->Used) / 2;
+      if (m == 0) {
+         x[i] = StreamRandom(s);
+         m = 1;
+         continue;
+      }
+      if (m > n - i) m = n - i;
+      for (l=0; l<m; l++)
+         x[i + l] = TO_DOUBLE(s->Block[s->Used + 2*l], s->Block[s->Used + 2*l + 1]);
+      s->Used += 2*m;
+   }
+}
+
+
+/*------------------------------------------------------*
+ *   expFill                                            *
+ *                                                      *
+ *   Fills the array <x> with <n> numbers of the stream *
+ *   <s> with EXPONENTIAL distribution and unitary      *
+ *   mean. The words are drawn in chunks, then the fast *
+ *   test of the ziggurat is applied to the whole chunk *
+ *   and the few rejected words (about 1.2%) take the   *
+ *   slow path.                                         *
+ *------------------------------------------------------*/
+
+void expFill (rand_stream *s, double *x, int n)
+{
+   uint32_t w[CHUNK];
+   int    i, j, m;
+
+   if (!ZigguratReady) initZiggurat();
+   for (i=0; i<n; i+=m) {
+      m = n - i < CHUNK ? n - i : CHUNK;
+      wordFill(s, w, m);
+      for (j=0; j<m; j++)
+         x[i+j] = w[j] * WExp[w[j] & (EXP_LAYERS-1)];
+      for (j=0; j<m; j++)
+         if (w[j] >= KExp[w[j] & (EXP_LAYERS-1)])
+            x[i+j] = expFix(s, w[j]);
+   }
+}
+
+
+/*------------------------------------------------------*
+ *   normFill                                           *
+ *                                                      *
+ *   Fills the array <x> with <n> numbers of the stream *
+ *   <s> with GAUSSIAN distribution, null mean and      *
+ *   unitary variance, as expFill.                      *
+ *------------------------------------------------------*/
+
+void normFill (rand_stream *s, double *x, int n)
+{
+   uint32_t w[CHUNK];
+   int32_t  h;
+   int   i, j, m;
+
+   if (!ZigguratReady) initZiggurat();
+   for (i=0; i<n; i+=m) {
+      m = n - i < CHUNK ? n - i : CHUNK;
+      wordFill(s, w, m);
+      for (j=0; j<m; j++)
+         x[i+j] = (int32_t)w[j] * WNorm[w[j] & (NORM_LAYERS-1)];
+      for (j=0; j<m; j++) {
+         h = (int32_t)w[j];
+         if ((h < 0 ? -(uint32_t)h : (uint32_t)h) >= KNorm[h & (NORM_LAYERS-1)])
+            x[i+j] = normFix(s, w[j]);
+      }
+   }
+}
+
+#undef TO_DOUBLE
+#undef NORM_V
+#undef NORM_R
+#undef EXP_V
+#undef EXP_R
+#undef NORM_LAYERS
+#undef EXP_LAYERS
+#undef CHUNK
+#undef LANES
+#undef PHILOX_ROUNDS
+#undef PHILOX_W1
+#undef PHILOX_W0
+#undef PHILOX_M1
+#undef PHILOX_M0
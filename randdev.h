@@ -1,217 +1,351 @@
-/*------------------------------------------------*
- *                                                *
- *   RANDDEV.H                                    *
- *                                                *
- *   Questa e' l'intestazione della libreria per  *
- *   la generazione di numeri pseudocasuali con   *
- *   varie distribuzioni.                         *
- *                                                *
- *   Realizzato da Mattia Maurizio.               *
- *   Iniziazto il  21 novembre 1993.              *
- *                                                *
- *------------------------------------------------*/
-
-
-/*** Solo una delle tre seguenti define deve esistere. ***/
-#define _RAND1       /* Se e' definita questa variabile un numero pseudo *
-                     * casuale viene generato con l'algoritmo di ran1   *
-                     * di numerical recipice.                           */
-#define _RAND2       /* Se e' definita questa variabile un numero pseudo *
-                     * casuale viene generato con l'algoritmo di ran2.  *
-                     * di numerical recipice.                           */
-#define RAND3      /* Se e' definita questa variabile un numero pseudo *
-                     * casuale viene generato con l'algoritmo di ran3.  *
-                     * di numerical recipice.                           */
-
-
-
-#ifdef RAND2
-
-/*------------------------------------------------*
- *                                                *
- *   Random.                                      *
- *                                                *
- *   Riporta  un float casuale  nell'intervallo   *
- *   [0,1[ con DISTRIBUZIONE UNIFORME. L'algo-    *
- *   ritmo usato e' da rand2 nel Numerical Reci-  *
- *   pice.                                        *
- *   NOTA: gli int devono essere a 32bit (Watcom  *
- *         e Unix, no Borland).                   *
- *------------------------------------------------*/
-
-double rand2 (int * idum);
-
-#endif /* of RAND2 */
-
-
-
-#ifdef RAND3
-
-/*------------------------------------------------------*
- *                                                      *
- *   rand3 e Random                                     *
- *                                                      *
- *   Riporta  un float casuale  nell'intervallo         *
- *   [0,1[ con DISTRIBUZIONE UNIFORME.                  *
- *   E' l'algoritmo preso da numerical recipice dovuto  *
- *   a knuth e nominato ran3. E' molto veloce ma poco   *
- *   studiato (non sanno bene che tipo di correlazioni  *
- *   puo' indurre).                                     *
- *   NOTA: gli int devono essere a 32bit (Watcom        *
- *         e Unix, no Borland).                         *
- *------------------------------------------------------*/
-
-double rand3(int * idum);
-
-#endif
-
-
-
-#ifdef RAND1
-
-/*------------------------------------------------*
- *                                                *
- *   UniDev.                                      *
- *                                                *
- *   Riporta  un  int  casuale  nell'intervallo   *
- *   [0,RAND_MAX] con distrubuzione uniforme.     *
- *   Per inizializzare  il seme del  generatore   *
- *   utilizzare la seguente sintassi:             *
- *      RandBD( &Seed )                           *
- *   dove Seed deve essere una variabile intera   *
- *   contenente il seme iniziale. Per mantenere   *
- *   intatto il seme basta richiamare la funzio-  *
- *   ne con la seguente sintassi:                 *
- *      RansBD( NULL )                            *
- *   Questa procedura si basa sull'algoritmo di   *
- *   BAYS e DURHAM.                               *
- *                                                *
- *   NOTE: Il periodo del  generatore  pratica-  *
- *         infinito, ma i numeri forniti non so-  *
- *         no pi di RAND_MAX+1.                  *
- *         Deve essere usata con i piedi di piom- *
- *         bo quando si utilizzano i bit meno si- *
- *         gnificativi.                           *
- *                                                *
- *------------------------------------------------*/
-
-int UniDev (int * SeedPntr);
-
-#endif
-
-
-
-/*----------------------------------------------*
- *                                              *
- *   SetRandomSeed (int Seed)                   *
- *                                              *
- *   Assegna un valore al seme del generatore   *
- *   numeri pseudo-casuali.                     *
- *                                              *
- *----------------------------------------------*/
-
-void SetRandomSeed (int Seed);
-
-
-
-/*------------------------------------------------------*
- *   GetRandomSeed ()                                   *
- *                                                      *
- *   Riporta il seme del generatore di numeri pseudo-   *
- *   casuali TimeSeed.                                  *
- *------------------------------------------------------*/
-
-int GetRandomSeed (void);
-
-
-
-/*----------------------------------------------*
- *                                              *
- *   Randomize.                                 *
- *                                              *
- *   Inizializza in modo casuale (attraverso    *
- *   la funzione time) il generatore di nume-   *
- *   ri pseudo-casuali UniDev.                  *
- *                                              *
- *----------------------------------------------*/
-
-void Randomize (void);
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   ExpDev.                                      *
- *                                                *
- *   Riporta un numero  casuale reale positivo    *
- *   (float) con  distribuzione esponenziale e    *
- *   media  unitaria, usando come  sorgente di    *
- *   numeri casuali con distribuzione uniforme    *
- *   Random.                                      *
- *     Fun. di distribuzione = e^-x con x>=0.0    *
- *   Questa procedura si basa sull'algoritmo di   *
- *   Montecarlo.                                  *
- *                                                *
- *------------------------------------------------*/
-
-double ExpDev ( void );
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   NormDev.                                     *
- *                                                *
- *   Riporta un  numero  casuale reale (float)    *
- *   con distribuzione gaussiana,  media nulla    *
- *   e varianza unitaria. Come sorgente di nu-    *
- *   meri  casuali con  distribuzione uniforme    *
- *   viene usata Random().                        *
- *     Fun. di distr. = 1/(sqrt(2pi))*e^-x^2      *
- *   Questa procedura si basa sull'algoritmo di   *
- *   BOX-MULLER.                                  *
- *                                                *
- *------------------------------------------------*/
-
-double NormDev ( void );
-
-
-
-/*------------------------------------------------*
- *                                                *
- *   BernDev.                                     *
- *                                                *
- *   Riporta un  numero  casuale intero (int)     *
- *   con distribuzione Bernoulliana, con media    *
- *   N*p e varianza N*p*(1-p). Come sorgente di   *
- *   numeri casuali con distribuzione uniforme    *
- *   viene usata Random().                        *
- *                                                *
- *------------------------------------------------*/
-
-int BernDev (int N, double p) ;
-
-
-
-
-/*----------------------------------------------------*
- *   Macro Utili:                                     *
- *                                                    *
- *     Random    - genera un numero casuale con di-   *
- *                 stribuzione uniforme nell'inter-   *
- *                 vallo [0,1[.                       *
- *----------------------------------------------------*/
-
-#ifdef RAND2
-double Random (void);
-#endif
-
-
-#ifdef RAND3
-double Random (void);
-#endif
-
-
-#ifdef RAND1
-#define Random()   UniDev(NULL)/(RAND_MAX+1.0)
-#endif
+/*------------------------------------------------*
+ *                                                *
+ *   RANDDEV.H                                    *
+ *                                                *
+ *   Questa e' l'intestazione della libreria per  *
+ *   la generazione di numeri pseudocasuali con   *
+ *   varie distribuzioni.                         *
+ *                                                *
+ *   Realizzato da Mattia Maurizio.               *
+ *   Iniziazto il  21 novembre 1993.              *
+ *                                                *
+ *------------------------------------------------*/
+
+
+#ifndef __RANDDEV_H__
+#define __RANDDEV_H__
+
+
+
+#include <stdint.h>
+
+
+
+/*** Solo una delle tre seguenti define deve esistere. ***/
+#define _RAND1       /* Se e' definita questa variabile un numero pseudo *
+                     * casuale viene generato con l'algoritmo di ran1   *
+                     * di numerical recipice.                           */
+#define _RAND2       /* Se e' definita questa variabile un numero pseudo *
+                     * casuale viene generato con l'algoritmo di ran2.  *
+                     * di numerical recipice.                           */
+#define RAND3      /* Se e' definita questa variabile un numero pseudo *
+                     * casuale viene generato con l'algoritmo di ran3.  *
+                     * di numerical recipice.                           */
+
+
+
+#ifdef RAND2
+
+/*------------------------------------------------*
+ *                                                *
+ *   Random.                                      *
+ *                                                *
+ *   Riporta  un float casuale  nell'intervallo   *
+ *   [0,1[ con DISTRIBUZIONE UNIFORME. L'algo-    *
+ *   ritmo usato e' da rand2 nel Numerical Reci-  *
+ *   pice.                                        *
+ *   NOTA: gli int devono essere a 32bit (Watcom  *
+ *         e Unix, no Borland).                   *
+ *------------------------------------------------*/
+
+double rand2 (int * idum);
+
+#endif /* of RAND2 */
+
+
+
+#ifdef RAND3
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   rand3 e Random                                     *
+ *                                                      *
+ *   Riporta  un float casuale  nell'intervallo         *
+ *   [0,1[ con DISTRIBUZIONE UNIFORME.                  *
+ *   E' l'algoritmo preso da numerical recipice dovuto  *
+ *   a knuth e nominato ran3. E' molto veloce ma poco   *
+ *   studiato (non sanno bene che tipo di correlazioni  *
+ *   puo' indurre).                                     *
+ *   NOTA: gli int devono essere a 32bit (Watcom        *
+ *         e Unix, no Borland).                         *
+ *------------------------------------------------------*/
+
+double rand3(int * idum);
+
+#endif
+
+
+
+#ifdef RAND1
+
+/*------------------------------------------------*
+ *                                                *
+ *   UniDev.                                      *
+ *                                                *
+ *   Riporta  un  int  casuale  nell'intervallo   *
+ *   [0,RAND_MAX] con distrubuzione uniforme.     *
+ *   Per inizializzare  il seme del  generatore   *
+ *   utilizzare la seguente sintassi:             *
+ *      RandBD( &Seed )                           *
+ *   dove Seed deve essere una variabile intera   *
+ *   contenente il seme iniziale. Per mantenere   *
+ *   intatto il seme basta richiamare la funzio-  *
+ *   ne con la seguente sintassi:                 *
+ *      RansBD( NULL )                            *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   BAYS e DURHAM.                               *
+ *                                                *
+ *   NOTE: Il periodo del  generatore  pratica-  *
+ *         infinito, ma i numeri forniti non so-  *
+ *         no pi di RAND_MAX+1.                  *
+ *         Deve essere usata con i piedi di piom- *
+ *         bo quando si utilizzano i bit meno si- *
+ *         gnificativi.                           *
+ *                                                *
+ *------------------------------------------------*/
+
+int UniDev (int * SeedPntr);
+
+#endif
+
+
+
+/*----------------------------------------------*
+ *                                              *
+ *   SetRandomSeed (int Seed)                   *
+ *                                              *
+ *   Assegna un valore al seme del generatore   *
+ *   numeri pseudo-casuali.                     *
+ *                                              *
+ *----------------------------------------------*/
+
+void SetRandomSeed (int Seed);
+
+
+
+/*------------------------------------------------------*
+ *   GetRandomSeed ()                                   *
+ *                                                      *
+ *   Riporta il seme del generatore di numeri pseudo-   *
+ *   casuali TimeSeed.                                  *
+ *------------------------------------------------------*/
+
+int GetRandomSeed (void);
+
+
+
+/*----------------------------------------------*
+ *                                              *
+ *   Randomize.                                 *
+ *                                              *
+ *   Inizializza in modo casuale (attraverso    *
+ *   la funzione time) il generatore di nume-   *
+ *   ri pseudo-casuali UniDev.                  *
+ *                                              *
+ *----------------------------------------------*/
+
+void Randomize (void);
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   ExpDev.                                      *
+ *                                                *
+ *   Riporta un numero  casuale reale positivo    *
+ *   (float) con  distribuzione esponenziale e    *
+ *   media  unitaria, usando come  sorgente di    *
+ *   numeri casuali con distribuzione uniforme    *
+ *   Random.                                      *
+ *     Fun. di distribuzione = e^-x con x>=0.0    *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   Montecarlo.                                  *
+ *                                                *
+ *------------------------------------------------*/
+
+double ExpDev ( void );
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   NormDev.                                     *
+ *                                                *
+ *   Riporta un  numero  casuale reale (float)    *
+ *   con distribuzione gaussiana,  media nulla    *
+ *   e varianza unitaria. Come sorgente di nu-    *
+ *   meri  casuali con  distribuzione uniforme    *
+ *   viene usata Random().                        *
+ *     Fun. di distr. = 1/(sqrt(2pi))*e^-x^2      *
+ *   Questa procedura si basa sull'algoritmo di   *
+ *   BOX-MULLER.                                  *
+ *                                                *
+ *------------------------------------------------*/
+
+double NormDev ( void );
+
+
+
+/*------------------------------------------------*
+ *                                                *
+ *   BernDev.                                     *
+ *                                                *
+ *   Riporta un  numero  casuale intero (int)     *
+ *   con distribuzione Bernoulliana, con media    *
+ *   N*p e varianza N*p*(1-p). Come sorgente di   *
+ *   numeri casuali con distribuzione uniforme    *
+ *   viene usata Random().                        *
+ *                                                *
+ *------------------------------------------------*/
+
+int BernDev (int N, double p) ;
+
+
+
+
+/*----------------------------------------------------*
+ *   Macro Utili:                                     *
+ *                                                    *
+ *     Random    - genera un numero casuale con di-   *
+ *                 stribuzione uniforme nell'inter-   *
+ *                 vallo [0,1[.                       *
+ *----------------------------------------------------*/
+
+#ifdef RAND2
+double Random (void);
+#endif
+
+
+#ifdef RAND3
+double Random (void);
+#endif
+
+
+#ifdef RAND1
+#define Random()   UniDev(NULL)/(RAND_MAX+1.0)
+#endif
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   rand_stream                                        *
+ *                                                      *
+ *   Stream of pseudo-random numbers from a counter-    *
+ *   based generator (Philox 4x32-10, Salmon et al.,    *
+ *   SC11, 2011). The n-th number of a stream depends   *
+ *   only on the seed, the subsystem, the stream id     *
+ *   and n, so that streams are independent and their   *
+ *   sequences do not depend on the order of the calls  *
+ *   to other streams.                                  *
+ *                                                      *
+ *------------------------------------------------------*/
+
+#define RS_BLOCK 32 /* Words generated at once by a stream (8 blocks). */
+
+typedef struct {
+   uint32_t          Key[2]; /* Seed and subsystem. */
+   uint32_t      Counter[4]; /* Next block number (0-1) and stream id (2-3). */
+   uint32_t Block[RS_BLOCK]; /* Output of the last blocks generated. */
+   int                 Used; /* Elements of Block already used. */
+} rand_stream;
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   InitRandomStream                                   *
+ *                                                      *
+ *   Initializes the stream <s> identified by the seed  *
+ *   <Seed>, the subsystem <Subsystem> and the id <Id>  *
+ *   (for instance a population or a neuron index).     *
+ *                                                      *
+ *------------------------------------------------------*/
+
+void InitRandomStream (rand_stream *s, int Seed, int Subsystem, uint64_t Id);
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   StreamWord e wordIndex                             *
+ *                                                      *
+ *   StreamWord returns the next 32-bit word of the     *
+ *   stream <s>. wordIndex maps the word <w> on an      *
+ *   index in [0,n[ with a product and a shift (n less  *
+ *   than 2^32), the cheapest way to draw an index      *
+ *   with UNIFORM distribution.                         *
+ *                                                      *
+ *------------------------------------------------------*/
+
+uint32_t StreamWord (rand_stream *s);
+
+#define wordIndex(w, n) ((((uint64_t)(w)) * (n)) >> 32)
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   StreamRandom                                       *
+ *                                                      *
+ *   Returns the next number of the stream <s> in the   *
+ *   interval [0,1[ with UNIFORM distribution and 53    *
+ *   random bits.                                       *
+ *                                                      *
+ *------------------------------------------------------*/
+
+double StreamRandom (rand_stream *s);
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   StreamExpDev e StreamNormDev                       *
+ *                                                      *
+ *   Return the next number of the stream <s> respec-   *
+ *   tively with exponential distribution and unitary   *
+ *   mean and with gaussian distribution, null mean     *
+ *   and unitary variance. They use the ziggurat algo-  *
+ *   rithm (Marsaglia and Tsang, 2000): most numbers    *
+ *   need a single 32-bit word, a product and a compa-  *
+ *   rison, without transcendental functions.           *
+ *                                                      *
+ *------------------------------------------------------*/
+
+double StreamExpDev (rand_stream *s);
+
+double StreamNormDev (rand_stream *s);
+
+
+
+/*------------------------------------------------------*
+ *                                                      *
+ *   wordFill, randomFill, expFill e normFill           *
+ *                                                      *
+ *   wordFill fills the array <w> with the next <n>     *
+ *   words of the stream <s>, as StreamWord. The other  *
+ *   ones fill the array <x> with <n> numbers of <s>,   *
+ *   respectively with uniform distribution in          *
+ *   [0,1[, exponential distribution with unitary mean  *
+ *   and gaussian distribution with null mean and uni-  *
+ *   tary variance. They convert the words generated    *
+ *   in groups of RS_BLOCK, without a call per number.  *
+ *   randomFill gives the same numbers of successive    *
+ *   calls to StreamRandom, while expFill               *
+ *   and normFill use the ziggurat algorithm on chunks  *
+ *   of words and their sequences differ from the ones  *
+ *   of StreamExpDev and StreamNormDev.                 *
+ *                                                      *
+ *------------------------------------------------------*/
+
+void wordFill (rand_stream *s, uint32_t *w, int n);
+
+void randomFill (rand_stream *s, double *x, int n);
+
+void expFill (rand_stream *s, double *x, int n);
+
+void normFill (rand_stream *s, double *x, int n);
+
+
+
+#endif /* __RANDDEV_H__ */
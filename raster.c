@@ -0,0 +1,564 @@
+/*
+ *
+ *   raster.c
+ *
+ *   Library of functions to write and read the compact binary
+ *   spike raster, an alternative to the text log of the
+ *   emitted spikes taking 2-3 bytes per spike.
+ *   The library is shared by Perseo and the reader tools, so
+ *   that it does not depend on the simulator modules.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raster.h"
+#include "types.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_SIZE  1024 /* Size of the buffer for the spikes of a block. */
+#define RICE_ESCAPE    32 /* Quotient from which the value is written verbatim. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL uint64_t  BitAcc;   /* Bits not yet written or read. */
+static PERSEO_LOCAL int      BitCount;  /* Number of bits in BitAcc. */
+static PERSEO_LOCAL size_t   BitPos;    /* Position in the payload. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-----------------*
+ *  compareNeuron  *
+ *-----------------*/
+
+/**
+ *  Orders the spikes of a block by neuron and tick (to write).
+ */
+
+static int compareNeuron(const void *a, const void *b)
+{
+   const raster_spike *x = (const raster_spike *)a;
+   const raster_spike *y = (const raster_spike *)b;
+
+   if (x->Neuron != y->Neuron)
+      return x->Neuron < y->Neuron ? -1 : 1;
+   return x->Offset < y->Offset ? -1 : (x->Offset > y->Offset);
+}
+
+/*---------------*
+ *  compareTime  *
+ *---------------*/
+
+/**
+ *  Orders the spikes of a block by tick and neuron (to read).
+ */
+
+static int compareTime(const void *a, const void *b)
+{
+   const raster_spike *x = (const raster_spike *)a;
+   const raster_spike *y = (const raster_spike *)b;
+
+   if (x->Offset != y->Offset)
+      return x->Offset < y->Offset ? -1 : 1;
+   return x->Neuron < y->Neuron ? -1 : (x->Neuron > y->Neuron);
+}
+
+
+/*--------------*
+ *  varint I/O  *
+ *--------------*/
+
+/**
+ *  Codes <v> as varint in <Buf> from <*Pos>, moving <*Pos>.
+ */
+
+static void putVarint(unsigned char *Buf, size_t *Pos, uint64_t v)
+{
+   while (v >= 0x80) {
+      Buf[(*Pos)++] = (unsigned char)(v | 0x80);
+      v >>= 7;
+   }
+   Buf[(*Pos)++] = (unsigned char)v;
+}
+
+/**
+ *  Decodes in <*v> the varint in <Buf> at <*Pos>, moving <*Pos>
+ *  up to <Len>. Returns 1 if the varint is truncated, 0 otherwise.
+ */
+
+static int getVarint(unsigned char *Buf, size_t *Pos, size_t Len, uint64_t *v)
+{
+   int Shift = 0;
+
+   *v = 0;
+   do {
+      if (*Pos >= Len || Shift > 63)
+         return 1;
+      *v |= (uint64_t)(Buf[*Pos] & 0x7F) << Shift;
+      Shift += 7;
+   } while (Buf[(*Pos)++] & 0x80);
+
+   return 0;
+}
+
+/**
+ *  Writes <v> as varint on <File>.
+ */
+
+static int writeVarint(FILE *File, uint64_t v)
+{
+   unsigned char Buf[10];
+   size_t Pos = 0;
+
+   putVarint(Buf, &Pos, v);
+   return fwrite(Buf, 1, Pos, File) != Pos;
+}
+
+/**
+ *  Reads in <*v> a varint from <File>. Returns -1 at the end
+ *  of file before the first byte, 1 if truncated, 0 otherwise.
+ */
+
+static int readVarint(FILE *File, uint64_t *v)
+{
+   int c, Shift = 0;
+
+   *v = 0;
+   do {
+      if ((c = getc(File)) == EOF)
+         return Shift == 0 ? -1 : 1;
+      if (Shift > 63)
+         return 1;
+      *v |= (uint64_t)(c & 0x7F) << Shift;
+      Shift += 7;
+   } while (c & 0x80);
+
+   return 0;
+}
+
+
+/*------------*
+ *  Rice I/O  *
+ *------------*/
+
+/**
+ *  Appends the <n> (<= 32) lower bits of <v> to the bit stream
+ *  in <Buf>.
+ */
+
+static void putBits(unsigned char *Buf, uint32_t v, int n)
+{
+   BitAcc = (BitAcc << n) | (n < 32 ? v & ((1u << n) - 1) : v);
+   for (BitCount += n; BitCount >= 8; BitCount -= 8)
+      Buf[BitPos++] = (unsigned char)(BitAcc >> (BitCount - 8));
+}
+
+/**
+ *  Appends the Rice code of <v> with parameter <k>.
+ */
+
+static void putRice(unsigned char *Buf, uint32_t v, int k)
+{
+   uint32_t q = v >> k;
+
+   if (q < RICE_ESCAPE) {
+      putBits(Buf, ((1u << q) - 1) << 1, q + 1);
+      if (k > 0)
+         putBits(Buf, v, k);
+   } else {
+      putBits(Buf, 0xFFFFFFFFu, RICE_ESCAPE);
+      putBits(Buf, v, 32);
+   }
+}
+
+/**
+ *  Reads <n> (<= 32) bits from the bit stream in <Buf> of
+ *  <Len> bytes. Returns 1 if the stream ends, 0 otherwise.
+ */
+
+static int getBits(unsigned char *Buf, size_t Len, int n, uint32_t *v)
+{
+   while (BitCount < n) {
+      if (BitPos >= Len)
+         return 1;
+      BitAcc = (BitAcc << 8) | Buf[BitPos++];
+      BitCount += 8;
+   }
+   BitCount -= n;
+   *v = (uint32_t)((BitAcc >> BitCount) & (n < 32 ? (1u << n) - 1 : 0xFFFFFFFFu));
+
+   return 0;
+}
+
+/**
+ *  Decodes in <*v> a Rice code with parameter <k>.
+ *  Returns 1 if the stream ends, 0 otherwise.
+ */
+
+static int getRice(unsigned char *Buf, size_t Len, int k, uint32_t *v)
+{
+   uint32_t q, Bit, r = 0;
+
+   for (q = 0; q < RICE_ESCAPE; q++) {
+      if (getBits(Buf, Len, 1, &Bit))
+         return 1;
+      if (Bit == 0)
+         break;
+   }
+   if (q == RICE_ESCAPE)
+      return getBits(Buf, Len, 32, v);
+   if (k > 0 && getBits(Buf, Len, k, &r))
+      return 1;
+   *v = (q << k) | r;
+
+   return 0;
+}
+
+/**
+ *  Returns the Rice parameter for values with sum <Sum> over
+ *  <n> samples, close to the optimal one for a geometric
+ *  distribution.
+ */
+
+static int riceParameter(uint64_t Sum, size_t n)
+{
+   double Mean = 0.69 * (double)Sum / (double)n;
+   int    k = 0;
+
+   while (k < 31 && (double)(1u << (k + 1)) <= Mean)
+      k++;
+
+   return k;
+}
+
+
+/*--------------*
+ *  writeBlock  *
+ *--------------*/
+
+/**
+ *  Codes and writes the spikes of the block under management.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int writeBlock(raster *r)
+{
+   size_t   Need, Len, k;
+   uint64_t SumD, SumO;
+   uint32_t Prev, d;
+   int      kd, ko;
+
+   if (r->NumSpikes == 0)
+      return 0;
+
+   /*** The payload has room for the longest codes. ***/
+   Need = 8 + 20 * r->NumSpikes;
+   if (Need > r->PayloadSize) {
+      if ((r->Payload = (unsigned char *)realloc(r->Payload, Need)) == NULL)
+         return 1;
+      r->PayloadSize = Need;
+   }
+
+   qsort(r->Spikes, r->NumSpikes, sizeof(raster_spike), compareNeuron);
+
+   Len = 0;
+   if (r->Header.Coding == RASTER_VARINT) {
+      for (Prev = 0, k=0; k<r->NumSpikes; k++) {
+         putVarint(r->Payload, &Len, r->Spikes[k].Neuron - Prev);
+         putVarint(r->Payload, &Len, r->Spikes[k].Offset);
+         Prev = r->Spikes[k].Neuron;
+      }
+   } else {
+      for (SumD = SumO = 0, Prev = 0, k=0; k<r->NumSpikes; k++) {
+         SumD += r->Spikes[k].Neuron - Prev;
+         SumO += r->Spikes[k].Offset;
+         Prev = r->Spikes[k].Neuron;
+      }
+      kd = riceParameter(SumD, r->NumSpikes);
+      ko = riceParameter(SumO, r->NumSpikes);
+      r->Payload[0] = (unsigned char)kd;
+      r->Payload[1] = (unsigned char)ko;
+      BitAcc = 0;
+      BitCount = 0;
+      BitPos = 2;
+      for (Prev = 0, k=0; k<r->NumSpikes; k++) {
+         d = r->Spikes[k].Neuron - Prev;
+         putRice(r->Payload, d, kd);
+         putRice(r->Payload, r->Spikes[k].Offset, ko);
+         Prev = r->Spikes[k].Neuron;
+      }
+      if (BitCount > 0)
+         putBits(r->Payload, 0, 8 - BitCount);
+      Len = BitPos;
+   }
+
+   /*** Block header and payload. ***/
+   if (writeVarint(r->File, (uint64_t)(r->Block - r->LastBlock)) ||
+       writeVarint(r->File, r->NumSpikes) ||
+       writeVarint(r->File, Len) ||
+       fwrite(r->Payload, 1, Len, r->File) != Len)
+      return 1;
+
+   r->LastBlock = r->Block;
+   r->NumSpikes = 0;
+
+   return 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*--------------------*
+ *  openRasterWriter  *
+ *--------------------*/
+
+/**
+ *  Starts the writing of a raster on the binary file <File>
+ *  with coding <Coding> and ticks of <Tick> ms, writing its
+ *  header. Returns 1 if the header cannot be written, 0
+ *  otherwise.
+ */
+
+int openRasterWriter(raster  *r, /* Raster to initialize. */
+                     FILE *File, /* File opened for binary writing. */
+                     int Coding, /* RASTER_VARINT or RASTER_RICE. */
+                     double Tick) /* Tick in ms. */
+{
+   memset(r, 0, sizeof(raster));
+   r->File = File;
+   memcpy(r->Header.Magic, RASTER_MAGIC, 4);
+   r->Header.Version = RASTER_VERSION;
+   r->Header.Coding = Coding;
+   r->Header.BlockTicks = RASTER_BLOCK_TICKS;
+   r->Header.Tick = Tick;
+   r->Header.Zero = 0.0;
+
+   return fwrite(&r->Header, sizeof(raster_header), 1, File) != 1;
+}
+
+
+/*------------------*
+ *  addRasterSpike  *
+ *------------------*/
+
+/**
+ *  Adds to the raster <r> the spike emitted by <Neuron> at
+ *  <Time> ms. The blocks are written as soon as completed.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int addRasterSpike(raster       *r, /* Raster opened for writing. */
+                   uint32_t Neuron, /* Emitting neuron. */
+                   double     Time) /* Emission time in ms. */
+{
+   int64_t Ticks, b;
+
+   Ticks = Time > 0.0 ? (int64_t)(Time / r->Header.Tick + 0.5) : 0;
+   b = Ticks / r->Header.BlockTicks;
+
+   /*** Is the block under management completed? ***/
+   if (r->NumSpikes > 0 && b > r->Block)
+      if (writeBlock(r))
+         return 1;
+
+   /*** Spikes out of order go at the first tick of the current block. ***/
+   if (r->NumSpikes == 0)
+      r->Block = b > r->LastBlock ? b : r->LastBlock;
+   if (b < r->Block)
+      Ticks = r->Block * r->Header.BlockTicks;
+
+   if (r->NumSpikes == r->MaxSpikes) { // More memory is needed?
+      r->Spikes = (raster_spike *)realloc(r->Spikes, sizeof(raster_spike) * (r->MaxSpikes + BUFFER_SIZE));
+      if (r->Spikes == NULL)
+         return 1;
+      r->MaxSpikes += BUFFER_SIZE;
+   }
+   r->Spikes[r->NumSpikes].Neuron = Neuron;
+   r->Spikes[r->NumSpikes++].Offset = (uint32_t)(Ticks - r->Block * r->Header.BlockTicks);
+
+   return 0;
+}
+
+
+/*---------------------*
+ *  closeRasterWriter  *
+ *---------------------*/
+
+/**
+ *  Writes the last block of the raster <r> and frees its
+ *  memory. The file is not closed.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int closeRasterWriter(raster *r)
+{
+   int Error;
+
+   Error = writeBlock(r);
+   closeRasterReader(r);
+
+   return Error;
+}
+
+
+/*--------------------*
+ *  openRasterReader  *
+ *--------------------*/
+
+/**
+ *  Starts the reading of the raster in the binary file
+ *  <File>, reading its header.
+ *  Returns 1 if the file is not a raster, 0 otherwise.
+ */
+
+int openRasterReader(raster  *r, /* Raster to initialize. */
+                     FILE *File) /* File opened for binary reading. */
+{
+   memset(r, 0, sizeof(raster));
+   r->File = File;
+
+   if (fread(&r->Header, sizeof(raster_header), 1, File) != 1 ||
+       memcmp(r->Header.Magic, RASTER_MAGIC, 4) != 0 ||
+       r->Header.Version != RASTER_VERSION ||
+       r->Header.Coding > RASTER_RICE ||
+       r->Header.BlockTicks == 0 ||
+       r->Header.Tick <= 0.0)
+      return 1;
+
+   return 0;
+}
+
+
+/*-------------------*
+ *  readRasterBlock  *
+ *-------------------*/
+
+/**
+ *  Reads from the raster <r> the next block with index not
+ *  lower than <FirstBlock>, skipping without decoding the
+ *  previous ones. The spikes are stored in r->Spikes in
+ *  increasing time, the block index in r->Block.
+ *  Returns the number of spikes read, 0 at the end of the
+ *  file and -1 if the file is corrupted.
+ */
+
+long readRasterBlock(raster         *r, /* Raster opened for reading. */
+                     int64_t FirstBlock) /* First block of interest. */
+{
+   uint64_t Delta, n, Len, v;
+   size_t   Pos, k;
+   uint32_t Prev, d, o;
+   int      End, kd, ko;
+
+   while (1) {
+
+      /*** Block header. ***/
+      if ((End = readVarint(r->File, &Delta)) != 0)
+         return End < 0 ? 0 : -1;
+      if (readVarint(r->File, &n) || readVarint(r->File, &Len))
+         return -1;
+      r->Block = r->LastBlock + (int64_t)Delta;
+      r->LastBlock = r->Block;
+
+      /*** Blocks before the first of interest are skipped. ***/
+      if (r->Block < FirstBlock) {
+         if (fseek(r->File, (long)Len, SEEK_CUR))
+            return -1;
+         continue;
+      }
+
+      /*** Payload loading. ***/
+      if (Len > r->PayloadSize) {
+         if ((r->Payload = (unsigned char *)realloc(r->Payload, Len)) == NULL)
+            return -1;
+         r->PayloadSize = Len;
+      }
+      if (n > r->MaxSpikes) {
+         if ((r->Spikes = (raster_spike *)realloc(r->Spikes, sizeof(raster_spike) * n)) == NULL)
+            return -1;
+         r->MaxSpikes = n;
+      }
+      if (fread(r->Payload, 1, Len, r->File) != Len)
+         return -1;
+
+      /*** Payload decoding. ***/
+      Prev = 0;
+      if (r->Header.Coding == RASTER_VARINT) {
+         for (Pos = 0, k=0; k<n; k++) {
+            if (getVarint(r->Payload, &Pos, Len, &v))
+               return -1;
+            Prev += (uint32_t)v;
+            if (getVarint(r->Payload, &Pos, Len, &v))
+               return -1;
+            r->Spikes[k].Neuron = Prev;
+            r->Spikes[k].Offset = (uint32_t)v;
+         }
+      } else {
+         if (Len < 2)
+            return -1;
+         kd = r->Payload[0];
+         ko = r->Payload[1];
+         BitAcc = 0;
+         BitCount = 0;
+         BitPos = 2;
+         for (k=0; k<n; k++) {
+            if (getRice(r->Payload, Len, kd, &d) || getRice(r->Payload, Len, ko, &o))
+               return -1;
+            Prev += d;
+            r->Spikes[k].Neuron = Prev;
+            r->Spikes[k].Offset = o;
+         }
+      }
+      r->NumSpikes = n;
+
+      qsort(r->Spikes, r->NumSpikes, sizeof(raster_spike), compareTime);
+
+      return (long)n;
+   }
+}
+
+
+/*---------------------*
+ *  closeRasterReader  *
+ *---------------------*/
+
+/**
+ *  Frees the memory of the raster <r> opened for reading.
+ *  The file is not closed.
+ */
+
+void closeRasterReader(raster *r)
+{
+   free(r->Spikes);
+   free(r->Payload);
+   r->Spikes = NULL;
+   r->Payload = NULL;
+   r->MaxSpikes = r->PayloadSize = r->NumSpikes = 0;
+}
+
+
+
+#undef RICE_ESCAPE
+#undef BUFFER_SIZE
@@ -0,0 +1,182 @@
+/*
+ *
+ *   raster.h
+ *
+ *   Library of functions to write and read the compact binary
+ *   spike raster, an alternative to the text log of the
+ *   emitted spikes taking 2-3 bytes per spike.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __RASTER_H__
+#define __RASTER_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Layout of a raster file (header in native byte order):
+ *
+ *    raster_header  (32 bytes, see below)
+ *    block          (repeated until the end of file)
+ *
+ *  Spike times are rounded to integer ticks of Tick ms, and
+ *  the spikes are grouped in blocks of BlockTicks ticks: the
+ *  block b collects the spikes with ticks in
+ *  [b*BlockTicks, (b+1)*BlockTicks). Only blocks with spikes
+ *  are written, in increasing order. A block is:
+ *
+ *    varint  b - b'    Block index minus the one of the previous
+ *                      block (b' = 0 for the first block).
+ *    varint  n         Number of spikes in the block.
+ *    varint  Length    Size in bytes of the payload, so that
+ *                      readers can skip the block.
+ *    payload           The n spikes sorted by neuron and tick,
+ *                      each one coded as the pair
+ *                         d = neuron - previous neuron (0 for the first),
+ *                         o = tick - b*BlockTicks.
+ *
+ *  A varint is an unsigned integer coded in groups of 7 bits,
+ *  least significant first, with the high bit set on all the
+ *  bytes but the last one (LEB128).
+ *  With RASTER_VARINT coding the payload is the sequence of
+ *  the varints d and o. With RASTER_RICE coding (the entropy
+ *  stage) the payload starts with two bytes kd and ko, followed
+ *  by a bit stream (most significant bit first, padded to a
+ *  byte with zeros) of the Rice codes of d with parameter kd
+ *  and o with parameter ko. The Rice code of v with parameter
+ *  k is q = v >> k bits 1 followed by a 0, and the k lower bits
+ *  of v. If q >= 32, 32 bits 1 are followed by v in 32 bits.
+ *  Spikes emitted out of time order are written in the current
+ *  block at its first tick.
+ */
+
+#define RASTER_MAGIC     "PSKR" /* First 4 bytes of the file. */
+#define RASTER_VERSION        1 /* Version of the layout. */
+#define RASTER_VARINT         0 /* Payload of varints. */
+#define RASTER_RICE           1 /* Payload of Rice codes. */
+#define RASTER_BLOCK_TICKS  128 /* Default number of ticks per block. */
+
+typedef struct {
+   char          Magic[4]; /* RASTER_MAGIC. */
+   uint32_t       Version; /* RASTER_VERSION. */
+   uint32_t        Coding; /* RASTER_VARINT or RASTER_RICE. */
+   uint32_t    BlockTicks; /* Ticks per block. */
+   double            Tick; /* Duration of a tick in ms. */
+   double            Zero; /* Reserved, it has to be 0. */
+} raster_header;
+
+
+/**
+ *  A spike in a block: the neuron and the tick offset from
+ *  the block start.
+ */
+
+typedef struct {
+   uint32_t Neuron; /* Emitting neuron. */
+   uint32_t Offset; /* Ticks from the block start. */
+} raster_spike;
+
+
+/**
+ *  A raster file opened for writing or reading, with the
+ *  spikes of the block under management.
+ */
+
+typedef struct {
+   FILE                 *File; /* Raster file. */
+   raster_header       Header; /* Header of the file. */
+   int64_t              Block; /* Index of the block under management. */
+   raster_spike       *Spikes; /* Spikes of the block. */
+   size_t           NumSpikes; /* Number of spikes of the block. */
+   size_t           MaxSpikes; /* Size of the Spikes array. */
+   unsigned char     *Payload; /* Coded payload of the block. */
+   size_t         PayloadSize; /* Size of the Payload array. */
+   int64_t          LastBlock; /* Index of the last block written or read. */
+} raster;
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Starts the writing of a raster on the binary file <File>
+ *  with coding <Coding> and ticks of <Tick> ms, writing its
+ *  header. Returns 1 if the header cannot be written, 0
+ *  otherwise.
+ */
+
+int openRasterWriter(raster  *r, /* Raster to initialize. */
+                     FILE *File, /* File opened for binary writing. */
+                     int Coding, /* RASTER_VARINT or RASTER_RICE. */
+                     double Tick); /* Tick in ms. */
+
+
+/**
+ *  Adds to the raster <r> the spike emitted by <Neuron> at
+ *  <Time> ms. The blocks are written as soon as completed.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int addRasterSpike(raster       *r, /* Raster opened for writing. */
+                   uint32_t Neuron, /* Emitting neuron. */
+                   double     Time); /* Emission time in ms. */
+
+
+/**
+ *  Writes the last block of the raster <r> and frees its
+ *  memory. The file is not closed.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int closeRasterWriter(raster *r);
+
+
+/**
+ *  Starts the reading of the raster in the binary file
+ *  <File>, reading its header.
+ *  Returns 1 if the file is not a raster, 0 otherwise.
+ */
+
+int openRasterReader(raster  *r, /* Raster to initialize. */
+                     FILE *File); /* File opened for binary reading. */
+
+
+/**
+ *  Reads from the raster <r> the next block with index not
+ *  lower than <FirstBlock>, skipping without decoding the
+ *  previous ones. The spikes are stored in r->Spikes in
+ *  increasing time, the block index in r->Block.
+ *  Returns the number of spikes read, 0 at the end of the
+ *  file and -1 if the file is corrupted.
+ */
+
+long readRasterBlock(raster         *r, /* Raster opened for reading. */
+                     int64_t FirstBlock); /* First block of interest. */
+
+
+/**
+ *  Frees the memory of the raster <r> opened for reading.
+ *  The file is not closed.
+ */
+
+void closeRasterReader(raster *r);
+
+
+
+#endif /* __RASTER_H__ */
@@ -0,0 +1,80 @@
+/*
+ *
+ *   raster2spikes.c
+ *
+ *   Converts a binary spike raster logged by Perseo (with
+ *   SpikesFormat 'VARINT' or 'RICE', see raster.h) into the
+ *   text rows "neuron time" of spikes.dat, printed on the
+ *   standard output.
+ *
+ *      raster2spikes <in_file_name> [<t_from> [<t_to>]]
+ *
+ *   Only the spikes with time in [<t_from>, <t_to>) are
+ *   printed. The blocks before <t_from> are skipped without
+ *   decoding them.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "raster.h"
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   FILE    *InFile;
+   raster        r;
+   double   t, tFrom, tTo;
+   long     n, k;
+   long  NumSpikes;
+
+   if (ArgC < 2 || ArgC > 4) {
+      fprintf(stderr, "Usage: %s <in_file_name> [<t_from> [<t_to>]]\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+   tFrom = ArgC >= 3 ? atof(ArgV[2]) : 0.0;
+   tTo = ArgC == 4 ? atof(ArgV[3]) : 1e300;
+
+   if ((InFile = fopen(ArgV[1], "rb")) == NULL) {
+      fprintf(stderr, "ERROR (raster2spikes): unable to open '%s'.\n", ArgV[1]);
+      return EXIT_FAILURE;
+   }
+   if (openRasterReader(&r, InFile)) {
+      fprintf(stderr, "ERROR (raster2spikes): '%s' is not a spike raster.\n", ArgV[1]);
+      fclose(InFile);
+      return EXIT_FAILURE;
+   }
+
+   /*** Decodes a block at a time, from the one containing tFrom. ***/
+   NumSpikes = 0;
+   while ((n = readRasterBlock(&r, (int64_t)(tFrom / r.Header.Tick / r.Header.BlockTicks))) > 0) {
+      for (k=0; k<n; k++) {
+         t = (double)(r.Block * r.Header.BlockTicks + r.Spikes[k].Offset) * r.Header.Tick;
+         if (t < tFrom)
+            continue;
+         if (t >= tTo)
+            break;
+         printf("%u %.7g\n", r.Spikes[k].Neuron, t);
+         NumSpikes++;
+      }
+      if (k < n)
+         break;
+   }
+
+   closeRasterReader(&r);
+   fclose(InFile);
+
+   if (n < 0) {
+      fprintf(stderr, "ERROR (raster2spikes): '%s' is corrupted.\n", ArgV[1]);
+      return EXIT_FAILURE;
+   }
+   fprintf(stderr, "%ld spikes converted.\n", NumSpikes);
+
+   return 0;
+}
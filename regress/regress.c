@@ -0,0 +1,763 @@
+/*
+ *
+ *   regress.c
+ *
+ *   Regression test of the dynamics of the simulator: runs the
+ *   reference configurations listed in 'cases.txt' and compares
+ *   their outputs with the ones stored in the repository.
+ *
+ *      regress [-p <perseo>] [-r] [-s] [<case> ...]
+ *
+ *   Each row of 'cases.txt' is a case:
+ *
+ *      <case> <EXACT|STAT> <rate_tol> <cv_tol> <syn_tol> [<Name>=<Value> ...]
+ *
+ *   ('#' starts a comment). The directory <case> holds the
+ *   definition files of a network with fixed NeuronsSeed and
+ *   SynapsesSeed (perseo.ini, modules.ini, connectivity.ini
+ *   and protocol.ini), whose protocol saves the final state
+ *   with CHECKPOINT in STATE_FILE, and in ref/ the reference
+ *   outputs. The case runs in <case>/run, with the definitions
+ *   <Name>=<Value> on the command line. With -r the outputs
+ *   of the run become the new references: the log files as
+ *   they are and STATE_FILE as its size and hash (.sum).
+ *
+ *   An EXACT case passes if each log file is identical to its
+ *   reference, reporting the first differing line, and the
+ *   final state has the same hash. A STAT case, or any case
+ *   with -s (e.g. for an engine intentionally not identical),
+ *   passes if for each population the rate and the CV of the
+ *   ISIs, from the spikes in SPIKES_FILE over Life, differ
+ *   from the reference ones less than <rate_tol> (relative)
+ *   and <cv_tol>, and the fractions of synapses in each long-
+ *   term state, from the synstruct files, less than <syn_tol>.
+ *   All the cases run without arguments. The exit status is
+ *   the number of failed cases.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define CASES_FILE   "cases.txt"   /* List of the cases. */
+#define STATE_FILE   "final.dat"   /* Checkpoint of the final state. */
+#define SPIKES_FILE  "spikes.dat"  /* Spikes of all the neurons. */
+#define SYNSTRUCT    "synstruct"   /* Prefix of the counts of the synaptic states. */
+#define MAX_ARGS     64            /* Maximum definitions of a case. */
+#define MAX_STATES   16            /* Maximum long-term states of a synapse. */
+#define BUFFER_DIM   1024          /* Maximum static string size. */
+
+/**
+ *  The statistics of the spikes of a run.
+ */
+
+typedef struct {
+   int    NumPopulations; /* Number of populations. */
+   double         *Rates; /* Emission rate of each population in Hz. */
+   double           *CVs; /* Coefficient of variation of the ISIs of each population. */
+} spike_stats;
+
+static char *InputFiles[] = {"perseo.ini", "modules.ini", "connectivity.ini", "protocol.ini", NULL};
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------*
+ *  allocate  *
+ *------------*/
+
+/**
+ *  Allocates <Size> zeroed bytes, exiting if out of memory.
+ */
+
+static void *allocate(size_t Size)
+{
+   void *p;
+
+   if ((p = calloc(1, Size)) == NULL) {
+      fprintf(stderr, "ERROR (regress): out of memory.\n");
+      exit(EXIT_FAILURE);
+   }
+   return p;
+}
+
+
+/*------------*
+ *  copyFile  *
+ *------------*/
+
+/**
+ *  Copies the file <From> in <To>. Returns 1 on error, 0
+ *  otherwise.
+ */
+
+static int copyFile(char *From,
+                    char   *To)
+{
+   char Buffer[BUFFER_DIM * 64];
+   FILE *In, *Out;
+   size_t n;
+   int Error = 0;
+
+   if ((In = fopen(From, "rb")) == NULL)
+      return 1;
+   if ((Out = fopen(To, "wb")) == NULL) {
+      fclose(In);
+      return 1;
+   }
+   while ((n = fread(Buffer, 1, sizeof(Buffer), In)) > 0)
+      if (fwrite(Buffer, 1, n, Out) != n)
+         Error = 1;
+   fclose(In);
+   return fclose(Out) != 0 || Error;
+}
+
+
+/*------------*
+ *  hashFile  *
+ *------------*/
+
+/**
+ *  Writes in <Sum> the size and the FNV-1a hash of the file
+ *  <Name>. Returns 1 if it cannot be read, 0 otherwise.
+ */
+
+static int hashFile(char *Name,
+                    char  *Sum)
+{
+   unsigned char Buffer[BUFFER_DIM * 64];
+   unsigned long long Hash = 14695981039346656037ULL;
+   long long Size = 0;
+   size_t n, k;
+   FILE *f;
+
+   if ((f = fopen(Name, "rb")) == NULL)
+      return 1;
+   while ((n = fread(Buffer, 1, sizeof(Buffer), f)) > 0) {
+      for (k=0; k<n; k++)
+         Hash = (Hash ^ Buffer[k]) * 1099511628211ULL;
+      Size += n;
+   }
+   fclose(f);
+   sprintf(Sum, "%lld %016llx\n", Size, Hash);
+   return 0;
+}
+
+
+/*---------------*
+ *  compareText  *
+ *---------------*/
+
+/**
+ *  Returns the first line differing in the files <Ref> and
+ *  <Run>, 0 if they are identical, -1 if <Run> is missing.
+ */
+
+static long compareText(char *Ref,
+                        char *Run)
+{
+   char Line1[BUFFER_DIM], Line2[BUFFER_DIM];
+   char *r1, *r2;
+   FILE *f1, *f2;
+   long n;
+
+   if ((f2 = fopen(Run, "rt")) == NULL)
+      return -1;
+   if ((f1 = fopen(Ref, "rt")) == NULL) {
+      fclose(f2);
+      return 1;
+   }
+   for (n=1; ; n++) {
+      r1 = fgets(Line1, BUFFER_DIM, f1);
+      r2 = fgets(Line2, BUFFER_DIM, f2);
+      if (r1 == NULL || r2 == NULL || strcmp(Line1, Line2) != 0)
+         break;
+   }
+   fclose(f1);
+   fclose(f2);
+
+   return r1 == NULL && r2 == NULL ? 0 : n;
+}
+
+
+/*------------*
+ *  readLife  *
+ *------------*/
+
+/**
+ *  Returns the Life set in the definition file <Name>, 0 if
+ *  missing.
+ */
+
+static double readLife(char *Name)
+{
+   char Line[BUFFER_DIM], Key[BUFFER_DIM];
+   double Life = 0.0;
+   FILE *f;
+
+   if ((f = fopen(Name, "rt")) == NULL)
+      return 0.0;
+   while (fgets(Line, BUFFER_DIM, f) != NULL)
+      if (sscanf(Line, " %255[A-Za-z] = %lf", Key, &Life) == 2 && strcasecmp(Key, "Life") == 0)
+         break;
+      else
+         Life = 0.0;
+   fclose(f);
+
+   return Life;
+}
+
+
+/*-------------------*
+ *  readPopulations  *
+ *-------------------*/
+
+/**
+ *  Reads from the modules file <Name> the number of neurons
+ *  of each population in <Sizes>, allocated. Returns the
+ *  number of populations.
+ */
+
+static int readPopulations(char   *Name,
+                           long **Sizes)
+{
+   char Line[BUFFER_DIM];
+   long N;
+   int P = 0;
+   FILE *f;
+
+   *Sizes = allocate(sizeof(long) * BUFFER_DIM);
+   if ((f = fopen(Name, "rt")) == NULL)
+      return 0;
+   while (fgets(Line, BUFFER_DIM, f) != NULL && P < BUFFER_DIM)
+      if (Line[strspn(Line, " \t")] != '#' && sscanf(Line, "%ld", &N) == 1)
+         (*Sizes)[P++] = N;
+   fclose(f);
+
+   return P;
+}
+
+
+/*--------------*
+ *  spikeStats  *
+ *--------------*/
+
+/**
+ *  Computes in <s> the rates and the CVs of the ISIs of the
+ *  <P> populations of <Sizes> neurons, from the spikes in
+ *  the file <Name> over <Life> ms. Returns 1 if the file is
+ *  missing, 0 otherwise.
+ */
+
+static int spikeStats(char        *Name,
+                      int             P,
+                      long       *Sizes,
+                      double       Life,
+                      spike_stats    *s)
+{
+   double *Last, *Sum, *Sum2, *Count, t, Isi, Mean;
+   long *Pop, *Spikes, NumNeurons, n, j;
+   char Line[BUFFER_DIM];
+   int k;
+   FILE *f;
+
+   if ((f = fopen(Name, "rt")) == NULL)
+      return 1;
+
+   for (NumNeurons = 0, k=0; k<P; k++)
+      NumNeurons += Sizes[k];
+   Pop    = allocate(sizeof(long) * NumNeurons);
+   Last   = allocate(sizeof(double) * NumNeurons);
+   Spikes = allocate(sizeof(long) * P);
+   Sum    = allocate(sizeof(double) * P);
+   Sum2   = allocate(sizeof(double) * P);
+   Count  = allocate(sizeof(double) * P);
+   for (n=0, k=0; k<P; k++)
+      for (j=0; j<Sizes[k]; j++) {
+         Pop[n] = k;
+         Last[n++] = -1.0;
+      }
+
+   /*** The ISIs are pooled over the neurons of a population. ***/
+   while (fgets(Line, BUFFER_DIM, f) != NULL) {
+      if (sscanf(Line, "%ld %lf", &n, &t) != 2 || n < 0 || n >= NumNeurons)
+         continue;
+      k = Pop[n];
+      Spikes[k]++;
+      if (Last[n] >= 0.0) {
+         Isi = t - Last[n];
+         Sum[k] += Isi;
+         Sum2[k] += Isi * Isi;
+         Count[k]++;
+      }
+      Last[n] = t;
+   }
+   fclose(f);
+
+   s->NumPopulations = P;
+   s->Rates = allocate(sizeof(double) * P);
+   s->CVs   = allocate(sizeof(double) * P);
+   for (k=0; k<P; k++) {
+      s->Rates[k] = Life > 0.0 ? Spikes[k] * 1000.0 / (Sizes[k] * Life) : 0.0;
+      Mean = Count[k] > 0 ? Sum[k] / Count[k] : 0.0;
+      s->CVs[k] = Count[k] > 1 && Mean > 0.0 ? sqrt(fmax(Sum2[k] / Count[k] - Mean * Mean, 0.0)) / Mean : 0.0;
+   }
+
+   free(Pop); free(Last); free(Spikes);
+   free(Sum); free(Sum2); free(Count);
+   return 0;
+}
+
+
+/*--------------*
+ *  readCounts  *
+ *--------------*/
+
+/**
+ *  Reads from the row <Line> of a synstruct file the post-
+ *  and pre-synaptic populations and the fractions of the
+ *  synapses in each long-term state in <Fractions>. Returns
+ *  the number of states.
+ */
+
+static int readCounts(char     *Line,
+                      int      *Post,
+                      int       *Pre,
+                      double *Fractions)
+{
+   char *p, *End;
+   double Sum;
+   int k, m;
+
+   *Post = (int)strtol(Line, &p, 10);
+   *Pre  = (int)strtol(p, &p, 10);
+   for (Sum = 0.0, m=0; m<MAX_STATES; m++, p=End) {
+      Fractions[m] = strtod(p, &End);
+      if (End == p)
+         break;
+      Sum += Fractions[m];
+   }
+   for (k=0; k<m; k++)
+      Fractions[k] = Sum > 0.0 ? Fractions[k] / Sum : 0.0;
+
+   return m;
+}
+
+
+/*-----------------*
+ *  compareStruct  *
+ *-----------------*/
+
+/**
+ *  Compares the fractions of synapses in each long-term state
+ *  in the synstruct files <Ref> and <Run>, printing the ones
+ *  differing more than <Tol>. Returns the number of them, 1
+ *  if <Run> is missing.
+ */
+
+static int compareStruct(char *Ref,
+                         char *Run,
+                         double Tol)
+{
+   char Line1[BUFFER_DIM], Line2[BUFFER_DIM];
+   double f1[MAX_STATES], f2[MAX_STATES];
+   int Post, Pre, k, m1, m2, Failed = 0;
+   FILE *File1, *File2;
+
+   if ((File2 = fopen(Run, "rt")) == NULL)
+      return 1;
+   if ((File1 = fopen(Ref, "rt")) == NULL) {
+      fclose(File2);
+      return 1;
+   }
+   while (fgets(Line1, BUFFER_DIM, File1) != NULL) {
+      if (fgets(Line2, BUFFER_DIM, File2) == NULL) {
+         printf("   %s is shorter than %s\n", Run, Ref);
+         Failed++;
+         break;
+      }
+      m1 = readCounts(Line1, &Post, &Pre, f1);
+      m2 = readCounts(Line2, &Post, &Pre, f2);
+      for (k=0; k<m1 && k<m2; k++)
+         if (fabs(f2[k] - f1[k]) > Tol) {
+            printf("   synapses %d <- %d in the state %d: %.4f instead of %.4f\n", Post, Pre, k, f2[k], f1[k]);
+            Failed++;
+         }
+   }
+   fclose(File1);
+   fclose(File2);
+
+   return Failed;
+}
+
+
+/*-------------*
+ *  runPerseo  *
+ *-------------*/
+
+/**
+ *  Runs <Perseo> in the directory <Dir> with the definitions
+ *  <Defs>, the output in perseo.out. Returns the exit status,
+ *  -1 if it could not be run.
+ */
+
+static int runPerseo(char *Perseo,
+                     char    *Dir,
+                     char  **Defs,
+                     int  NumDefs)
+{
+   char *Args[MAX_ARGS + 2];
+   pid_t Pid;
+   int Status, Fd, k;
+
+   if ((Pid = fork()) < 0)
+      return -1;
+
+   if (Pid == 0) {
+      if (chdir(Dir) != 0)
+         _exit(127);
+      if ((Fd = open("/dev/null", O_RDONLY)) >= 0)
+         dup2(Fd, STDIN_FILENO);
+      if ((Fd = open("perseo.out", O_WRONLY | O_CREAT | O_TRUNC, 0644)) >= 0) {
+         dup2(Fd, STDOUT_FILENO);
+         dup2(Fd, STDERR_FILENO);
+      }
+      Args[0] = Perseo;
+      for (k=0; k<NumDefs; k++)
+         Args[k + 1] = Defs[k];
+      Args[NumDefs + 1] = NULL;
+      execv(Perseo, Args);
+      _exit(127);
+   }
+
+   while (waitpid(Pid, &Status, 0) < 0)
+      if (errno != EINTR)
+         return -1;
+   return WIFEXITED(Status) ? WEXITSTATUS(Status) : -1;
+}
+
+
+/*------------*
+ *  isOutput  *
+ *------------*/
+
+/**
+ *  Returns true if <Name> in the directory of a run is an
+ *  output to compare: neither a definition file nor the log
+ *  of the run, which holds its timings.
+ */
+
+static int isOutput(char *Name)
+{
+   size_t Len = strlen(Name);
+
+   return Name[0] != '.' && strcmp(Name, "perseo.log") != 0 && strcmp(Name, "perseo.out") != 0 &&
+          (Len < 4 || strcmp(Name + Len - 4, ".ini") != 0);
+}
+
+
+/*--------------*
+ *  recordCase  *
+ *--------------*/
+
+/**
+ *  Replaces the references of the case <Case> with the
+ *  outputs of its run. Returns 1 on error, 0 otherwise.
+ */
+
+static int recordCase(char *Case)
+{
+   char From[BUFFER_DIM], To[BUFFER_DIM], Sum[BUFFER_DIM];
+   struct dirent *Entry;
+   DIR *Dir;
+   FILE *f;
+   int Error = 0;
+
+   snprintf(To, BUFFER_DIM, "%s/ref", Case);
+   mkdir(To, 0755);
+   if ((Dir = opendir(To)) != NULL) {
+      while ((Entry = readdir(Dir)) != NULL)
+         if (Entry->d_name[0] != '.') {
+            snprintf(From, BUFFER_DIM, "%s/ref/%s", Case, Entry->d_name);
+            remove(From);
+         }
+      closedir(Dir);
+   }
+
+   snprintf(From, BUFFER_DIM, "%s/run", Case);
+   if ((Dir = opendir(From)) == NULL)
+      return 1;
+   while ((Entry = readdir(Dir)) != NULL) {
+      if (!isOutput(Entry->d_name))
+         continue;
+      snprintf(From, BUFFER_DIM, "%s/run/%s", Case, Entry->d_name);
+      if (strcmp(Entry->d_name, STATE_FILE) == 0) {
+         snprintf(To, BUFFER_DIM, "%s/ref/%s.sum", Case, Entry->d_name);
+         if (hashFile(From, Sum) || (f = fopen(To, "wt")) == NULL)
+            Error = 1;
+         else {
+            fputs(Sum, f);
+            fclose(f);
+         }
+      } else {
+         snprintf(To, BUFFER_DIM, "%s/ref/%s", Case, Entry->d_name);
+         Error |= copyFile(From, To);
+      }
+   }
+   closedir(Dir);
+
+   return Error;
+}
+
+
+/*----------------*
+ *  compareExact  *
+ *----------------*/
+
+/**
+ *  Compares the outputs of the run of the case <Case> with
+ *  its references, printing the differences. Returns the
+ *  number of differing files.
+ */
+
+static int compareExact(char *Case)
+{
+   char Ref[BUFFER_DIM], Run[BUFFER_DIM], Sum1[BUFFER_DIM], Sum2[BUFFER_DIM];
+   struct dirent *Entry;
+   size_t Len;
+   long Line;
+   DIR *Dir;
+   FILE *f;
+   int Failed = 0;
+
+   snprintf(Ref, BUFFER_DIM, "%s/ref", Case);
+   if ((Dir = opendir(Ref)) == NULL) {
+      printf("   no references (record them with -r)\n");
+      return 1;
+   }
+   while ((Entry = readdir(Dir)) != NULL) {
+      if (Entry->d_name[0] == '.')
+         continue;
+      Len = strlen(Entry->d_name);
+      snprintf(Ref, BUFFER_DIM, "%s/ref/%s", Case, Entry->d_name);
+      snprintf(Run, BUFFER_DIM, "%s/run/%.*s", Case, (int)(Len > 4 && strcmp(Entry->d_name + Len - 4, ".sum") == 0 ? Len - 4 : Len), Entry->d_name);
+
+      /*** The final state is compared through its hash. ***/
+      if (Len > 4 && strcmp(Entry->d_name + Len - 4, ".sum") == 0) {
+         Sum1[0] = '\0';
+         if ((f = fopen(Ref, "rt")) != NULL) {
+            if (fgets(Sum1, BUFFER_DIM, f) == NULL)
+               Sum1[0] = '\0';
+            fclose(f);
+         }
+         if (hashFile(Run, Sum2)) {
+            printf("   %s missing\n", Run);
+            Failed++;
+         } else if (strcmp(Sum1, Sum2) != 0) {
+            printf("   %s differs (size and hash %.*s instead of %.*s)\n", Run,
+                   (int)strcspn(Sum2, "\n"), Sum2, (int)strcspn(Sum1, "\n"), Sum1);
+            Failed++;
+         }
+      } else if ((Line = compareText(Ref, Run)) != 0) {
+         if (Line < 0)
+            printf("   %s missing\n", Run);
+         else
+            printf("   %s differs from line %ld\n", Run, Line);
+         Failed++;
+      }
+   }
+   closedir(Dir);
+
+   return Failed;
+}
+
+
+/*----------------*
+ *  compareStats  *
+ *----------------*/
+
+/**
+ *  Compares the statistics of the run of the case <Case> with
+ *  the ones of its references, within the tolerances <Tol>
+ *  (rates, CVs and synaptic states). Returns the number of
+ *  them out of tolerance.
+ */
+
+static int compareStats(char *Case,
+                        double *Tol)
+{
+   char Ref[BUFFER_DIM], Run[BUFFER_DIM];
+   spike_stats s1, s2;
+   struct dirent *Entry;
+   long *Sizes;
+   double Life;
+   int P, k, Failed = 0;
+   DIR *Dir;
+
+   snprintf(Ref, BUFFER_DIM, "%s/perseo.ini", Case);
+   Life = readLife(Ref);
+   snprintf(Ref, BUFFER_DIM, "%s/modules.ini", Case);
+   P = readPopulations(Ref, &Sizes);
+
+   snprintf(Ref, BUFFER_DIM, "%s/ref/%s", Case, SPIKES_FILE);
+   snprintf(Run, BUFFER_DIM, "%s/run/%s", Case, SPIKES_FILE);
+   if (spikeStats(Ref, P, Sizes, Life, &s1) || spikeStats(Run, P, Sizes, Life, &s2)) {
+      printf("   %s or %s missing\n", Ref, Run);
+      free(Sizes);
+      return 1;
+   }
+   for (k=0; k<P; k++) {
+      if (fabs(s2.Rates[k] - s1.Rates[k]) > Tol[0] * s1.Rates[k]) {
+         printf("   population %d: rate %.4g Hz instead of %.4g Hz\n", k, s2.Rates[k], s1.Rates[k]);
+         Failed++;
+      }
+      if (fabs(s2.CVs[k] - s1.CVs[k]) > Tol[1]) {
+         printf("   population %d: CV of the ISIs %.4f instead of %.4f\n", k, s2.CVs[k], s1.CVs[k]);
+         Failed++;
+      }
+   }
+   free(s1.Rates); free(s1.CVs);
+   free(s2.Rates); free(s2.CVs);
+   free(Sizes);
+
+   /*** Synaptic states. ***/
+   snprintf(Ref, BUFFER_DIM, "%s/ref", Case);
+   if ((Dir = opendir(Ref)) != NULL) {
+      while ((Entry = readdir(Dir)) != NULL)
+         if (strncmp(Entry->d_name, SYNSTRUCT, strlen(SYNSTRUCT)) == 0) {
+            snprintf(Ref, BUFFER_DIM, "%s/ref/%s", Case, Entry->d_name);
+            snprintf(Run, BUFFER_DIM, "%s/run/%s", Case, Entry->d_name);
+            Failed += compareStruct(Ref, Run, Tol[2]);
+         }
+      closedir(Dir);
+   }
+
+   return Failed;
+}
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   char *Perseo, PerseoPath[PATH_MAX];
+   char Line[BUFFER_DIM], Case[BUFFER_DIM], Mode[BUFFER_DIM];
+   char From[BUFFER_DIM], To[BUFFER_DIM];
+   char *Defs[MAX_ARGS], *Token;
+   double Tol[3];
+   int Record, Stat, Opt, NumDefs, Selected, Failed, NumCases, NumFailed;
+   int k, Status;
+   FILE *Cases;
+
+   Perseo = "../perseo";
+   Record = Stat = 0;
+   while ((Opt = getopt(ArgC, ArgV, "p:rs")) != -1)
+      switch (Opt) {
+         case 'p': Perseo = optarg; break;
+         case 'r': Record = 1; break;
+         case 's': Stat = 1; break;
+         default:
+            fprintf(stderr, "Usage: %s [-p <perseo>] [-r] [-s] [<case> ...]\n", ArgV[0]);
+            return EXIT_FAILURE;
+      }
+   if (realpath(Perseo, PerseoPath) == NULL) {
+      fprintf(stderr, "ERROR (regress): '%s' not found.\n", Perseo);
+      return EXIT_FAILURE;
+   }
+   if ((Cases = fopen(CASES_FILE, "rt")) == NULL) {
+      fprintf(stderr, "ERROR (regress): unable to open '%s'.\n", CASES_FILE);
+      return EXIT_FAILURE;
+   }
+
+   NumCases = NumFailed = 0;
+   while (fgets(Line, BUFFER_DIM, Cases) != NULL) {
+      Line[strcspn(Line, "#\r\n")] = '\0';
+      if (sscanf(Line, "%255s %255s %lf %lf %lf", Case, Mode, &Tol[0], &Tol[1], &Tol[2]) != 5)
+         continue;
+      for (Selected = optind == ArgC, k=optind; k<ArgC; k++)
+         if (strcmp(ArgV[k], Case) == 0)
+            Selected = 1;
+      if (!Selected)
+         continue;
+      NumCases++;
+
+      /*** The definitions follow the tolerances. ***/
+      NumDefs = 0;
+      strtok(Line, " \t");
+      for (k=0; k<4; k++)
+         strtok(NULL, " \t");
+      while ((Token = strtok(NULL, " \t")) != NULL && NumDefs < MAX_ARGS)
+         Defs[NumDefs++] = strdup(Token);
+
+      /*** The case runs on a copy of its definition files. ***/
+      printf("%s: ", Case);
+      fflush(stdout);
+      snprintf(To, BUFFER_DIM, "%s/run", Case);
+      mkdir(To, 0755);
+      for (k=0; InputFiles[k] != NULL; k++) {
+         snprintf(From, BUFFER_DIM, "%s/%s", Case, InputFiles[k]);
+         snprintf(To, BUFFER_DIM, "%s/run/%s", Case, InputFiles[k]);
+         copyFile(From, To);
+      }
+      snprintf(To, BUFFER_DIM, "%s/run", Case);
+      Status = runPerseo(PerseoPath, To, Defs, NumDefs);
+      for (k=0; k<NumDefs; k++)
+         free(Defs[k]);
+      if (Status != 0) {
+         printf("FAILED (perseo exited with %d, see '%s/perseo.out')\n", Status, To);
+         NumFailed++;
+         continue;
+      }
+
+      if (Record) {
+         Failed = recordCase(Case);
+         printf("%s\n", Failed ? "FAILED (references not recorded)" : "references recorded");
+      } else if (Stat || strcasecmp(Mode, "STAT") == 0) {
+         printf("statistical\n");
+         Failed = compareStats(Case, Tol);
+         printf("   %s\n", Failed ? "FAILED" : "passed");
+      } else {
+         printf("exact\n");
+         Failed = compareExact(Case);
+         printf("   %s\n", Failed ? "FAILED" : "passed");
+      }
+      NumFailed += Failed > 0;
+   }
+   fclose(Cases);
+
+   printf("%d cases, %d failed.\n", NumCases, NumFailed);
+   return NumFailed;
+}
+
+
+
+#undef CASES_FILE
+#undef STATE_FILE
+#undef SPIKES_FILE
+#undef SYNSTRUCT
+#undef MAX_ARGS
+#undef MAX_STATES
+#undef BUFFER_DIM
@@ -0,0 +1,508 @@
+/*
+ *
+ *   replay.c
+ *
+ *   Library of functions to drive the network with recorded
+ *   spike trains, streamed from binary files mapped in memory
+ *   and merged with the external and recurrent spikes.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "perseo.h"
+#include "modules.h"
+#include "traces.h"
+#include "replay.h"
+#include "checkpoint.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_SIZE       16 /* Size of the buffer for the replay array. */
+#define MAP_BUFFER_SIZE 4096 /* Size of the buffer for the map pairs. */
+#define RELEASE_SIZE   65536 /* Number of records read before to release their memory (1 Mbyte). */
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+PERSEO_LOCAL spike   ReplaySpike;        /* The oldest replayed spike to deliver. */
+PERSEO_LOCAL boolean ReplayEmpty = true; /* It is true if no replayed spikes have to be delivered. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+PERSEO_LOCAL replay *Replays = NULL; /* Array of the replay sources. */
+PERSEO_LOCAL int  NumReplays = 0;    /* Length of the Replays array. */
+PERSEO_LOCAL int OldestReplay = -1;  /* The replay with the oldest spike to deliver. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-------------*
+ *  addReplay  *
+ *-------------*/
+
+/**
+ *  Appends an empty element to the replay array.
+ */
+
+static void addReplay ()
+{
+   replay *r;
+
+   if (NumReplays % BUFFER_SIZE == 0) { // More memory is needed?
+      Replays = (replay *)resizeMemory(Replays, sizeof(replay) * NumReplays, sizeof(replay) * (NumReplays + BUFFER_SIZE),
+                                       MEMORY_OTHER, "ERROR (addReplay): Out of memory.");
+   }
+   r = &(Replays[NumReplays++]);
+   r->Records = NULL;
+   r->MapStart = NULL;
+   r->MapTargets = NULL;
+   r->FileName = NULL;
+   r->Empty = true;
+}
+
+
+/*-------------------*
+ *  loadReplaySpike  *
+ *-------------------*/
+
+/**
+ *  Loads in the field Spike of <r> the next spike to deliver.
+ *  Returns 1 if the replay is ended, 0 otherwise.
+ */
+
+int loadReplaySpike(replay *r)
+{
+   replay_record *Rec;
+   double           t;
+
+   /*** Looks for the next record with at least a target. ***/
+   while (r->NextTarget >= r->LastTarget) {
+      if (r->Cursor >= r->NumRecords)
+         return 1;
+      Rec = &(r->Records[r->Cursor++]);
+
+      if (r->MapStart == NULL) {
+         r->Single = Rec->Neuron;
+         r->Targets = &(r->Single);
+         r->NextTarget = 0;
+         r->LastTarget = r->Offset + Rec->Neuron < NumNeurons ? 1 : 0;
+      } else if (Rec->Neuron < r->NumSources) {
+         r->Targets = r->MapTargets;
+         r->NextTarget = r->MapStart[Rec->Neuron];
+         r->LastTarget = r->MapStart[Rec->Neuron + 1];
+      }
+
+      /*** Records out of order are delivered late. ***/
+      t = r->T0 + Rec->Time;
+      if (t < r->LastTime)
+         t = r->LastTime;
+      r->LastTime = t;
+      doubleToTimex(t, r->Spike.Emission);
+
+      /*** Releases the memory pages already read. ***/
+      if (r->Cursor - r->Released >= RELEASE_SIZE) {
+         releaseMappedFile(r->Records, r->Released * sizeof(replay_record), r->Cursor * sizeof(replay_record));
+         r->Released = r->Cursor;
+      }
+   }
+
+   r->Spike.Neuron = r->Offset + r->Targets[r->NextTarget++];
+
+   return 0;
+}
+
+
+/*---------------*
+ *  closeReplay  *
+ *---------------*/
+
+/**
+ *  Unmaps the replay file of <r> and frees its map.
+ */
+
+void closeReplay(replay *r)
+{
+   if (r->Records != NULL)
+      unmapFile(r->Records, r->Size);
+   r->Records = NULL;
+   if (r->MapStart != NULL) {
+      releaseMemory(sizeof(indexn) * r->MapStart[r->NumSources], MEMORY_OTHER);
+      releaseMemory(sizeof(indexn) * (r->NumSources + 1), MEMORY_OTHER);
+      free(r->MapStart);
+      free(r->MapTargets);
+   }
+   r->MapStart = NULL;
+   r->MapTargets = NULL;
+   if (r->FileName != NULL) {
+      releaseMemory(strlen(r->FileName) + 1, MEMORY_OTHER);
+      free(r->FileName);
+   }
+   r->FileName = NULL;
+   r->Empty = true;
+}
+
+
+/*--------------------*
+ *  findOldestReplay  *
+ *--------------------*/
+
+/**
+ *  Sets ReplaySpike to the oldest spike of the active replays.
+ */
+
+void findOldestReplay ()
+{
+   int k;
+
+   OldestReplay = -1;
+   for (k=0; k<NumReplays; k++)
+      if (!Replays[k].Empty)
+         if (OldestReplay < 0 || diffTimex(ReplaySpike.Emission, Replays[k].Spike.Emission) > 0.0) {
+            OldestReplay = k;
+            ReplaySpike = Replays[k].Spike;
+         }
+
+   ReplayEmpty = OldestReplay < 0;
+}
+
+
+/*-----------*
+ *  loadMap  *
+ *-----------*/
+
+/**
+ *  Loads the map from source to target neurons of the replay
+ *  <r> from the text file <MapFileName>, a pair "source target"
+ *  per row.
+ *  Returns 1 if the file cannot be loaded, 0 otherwise.
+ */
+
+int loadMap(replay *r, char *MapFileName, indexn Offset)
+{
+   FILE    *MapFile;
+   unsigned int s, t;
+   indexn *Sources = NULL;
+   indexn *Targets = NULL;
+   indexn *Cursors;
+   size_t  NumPairs = 0;
+   size_t         k;
+
+   if ((MapFile = fopen(MapFileName, "rt")) == NULL)
+      return 1;
+
+   /*** Reads the pairs. ***/
+   r->NumSources = 0;
+   while (fscanf(MapFile, "%u %u", &s, &t) == 2) {
+      if (Offset + t >= NumNeurons) { // Is the target outside the network?
+         fclose(MapFile);
+         free(Sources);
+         free(Targets);
+         return 1;
+      }
+      if (NumPairs % MAP_BUFFER_SIZE == 0) { // More memory is needed?
+         Sources = (indexn *)realloc(Sources, sizeof(indexn) * (NumPairs + MAP_BUFFER_SIZE));
+         Targets = (indexn *)realloc(Targets, sizeof(indexn) * (NumPairs + MAP_BUFFER_SIZE));
+         if (Sources == NULL || Targets == NULL)
+            printFatalError("loadMap", "Out of memory.");
+      }
+      Sources[NumPairs] = s;
+      Targets[NumPairs++] = t;
+      if (s >= r->NumSources)
+         r->NumSources = s + 1;
+   }
+   fclose(MapFile);
+   if (NumPairs == 0)
+      return 1;
+
+   /*** Sorts the targets by source (compressed rows). ***/
+   r->MapStart = (indexn *)getMemory(sizeof(indexn) * (r->NumSources + 1), "ERROR (loadMap): Out of memory.");
+   r->MapTargets = (indexn *)getMemory(sizeof(indexn) * NumPairs, "ERROR (loadMap): Out of memory.");
+   Cursors = (indexn *)calloc(r->NumSources, sizeof(indexn));
+   if (Cursors == NULL)
+      printFatalError("loadMap", "Out of memory.");
+   for (k=0; k<NumPairs; k++)
+      Cursors[Sources[k]]++;
+   r->MapStart[0] = 0;
+   for (s=0; s<r->NumSources; s++) {
+      r->MapStart[s+1] = r->MapStart[s] + Cursors[s];
+      Cursors[s] = r->MapStart[s];
+   }
+   for (k=0; k<NumPairs; k++)
+      r->MapTargets[Cursors[Sources[k]]++] = Targets[k];
+
+   free(Cursors);
+   free(Sources);
+   free(Targets);
+
+   return 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*--------------*
+ *  openReplay  *
+ *--------------*/
+
+/**
+ *  Maps in memory the replay file <FileName> starting at time
+ *  <T0>. Source neuron s is delivered to the neuron Offset + s,
+ *  or if <MapFileName> is not NULL to the neurons Offset + t
+ *  for each row "s t" of the text file <MapFileName>.
+ *  Returns 1 if the files cannot be loaded, 0 otherwise.
+ */
+
+int openReplay(char    *FileName, /* Name of the binary replay file. */
+               double         T0, /* Absolute time when the replay starts. */
+               indexn     Offset, /* Index of the first target neuron. */
+               char *MapFileName) /* Name of the map file, or NULL. */
+{
+   replay *r;
+   int     k;
+
+   /*** Looks for a free element of the replay array. ***/
+   for (k=0; k<NumReplays; k++)
+      if (Replays[k].Empty)
+         break;
+   if (k == NumReplays)
+      addReplay();
+   r = &(Replays[k]);
+   r->NumSources = 0;
+
+   /*** Maps the file in memory. ***/
+   if ((r->Records = (replay_record *)mapFile(FileName, &(r->Size))) == NULL)
+      return 1;
+   r->NumRecords = r->Size / sizeof(replay_record);
+   if (Offset >= NumNeurons || (MapFileName != NULL && loadMap(r, MapFileName, Offset))) {
+      closeReplay(r);
+      return 1;
+   }
+
+   r->Cursor = 0;
+   r->Released = 0;
+   r->T0 = T0;
+   r->LastTime = T0;
+   r->Offset = Offset;
+   r->NextTarget = r->LastTarget = 0;
+   r->Spike.ISI = 0.0;
+   r->FileName = getMemory(strlen(FileName) + 1, "ERROR (openReplay): Out of memory.");
+   strcpy(r->FileName, FileName);
+
+   /*** Loads the first spike. ***/
+   if (loadReplaySpike(r)) {
+      closeReplay(r);
+      return 0;
+   }
+   r->Empty = false;
+   findOldestReplay();
+
+   return 0;
+}
+
+
+/*-------------------*
+ *  nextReplaySpike  *
+ *-------------------*/
+
+/**
+ *  Moves ReplaySpike to the next replayed spike to deliver,
+ *  once the current one is managed.
+ */
+
+void nextReplaySpike ()
+{
+   replay *r = &(Replays[OldestReplay]);
+
+   /*** The next target of the same record keeps the time, and the replay ***
+    *** stays the oldest one: only the neuron is updated.                 ***/
+   if (r->NextTarget < r->LastTarget) {
+      ReplaySpike.Neuron = r->Spike.Neuron = r->Offset + r->Targets[r->NextTarget++];
+      return;
+   }
+
+   /*** Is the replay of the delivered spike ended? ***/
+   if (loadReplaySpike(r))
+      closeReplay(r);
+
+   /*** A single replay has not to be compared with the others. ***/
+   if (NumReplays == 1 && !Replays[0].Empty) {
+      ReplaySpike.Emission = r->Spike.Emission;
+      ReplaySpike.Neuron = r->Spike.Neuron;
+      return;
+   }
+
+   findOldestReplay();
+}
+
+
+/*------------------*
+ *  releaseReplays  *
+ *------------------*/
+
+/**
+ *  Closes all the replays and frees their array.
+ */
+
+void releaseReplays ()
+{
+   int k;
+
+   for (k=0; k<NumReplays; k++)
+      closeReplay(&(Replays[k]));
+   if (NumReplays > 0) {
+      free(Replays);
+      releaseMemory(sizeof(replay) * ((NumReplays + BUFFER_SIZE - 1) / BUFFER_SIZE * BUFFER_SIZE), MEMORY_OTHER);
+   }
+   Replays = NULL;
+   NumReplays = 0;
+   OldestReplay = -1;
+   ReplayEmpty = true;
+}
+
+
+/*---------------------*
+ *  checkpointReplays  *
+ *---------------------*/
+
+/**
+ *  Writes on <File> the active replays with their maps and
+ *  cursors. Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointReplays(FILE *File)
+{
+   replay *r;
+   indexn  n;
+   int     k;
+
+   if (writeCheckpointData(File, &NumReplays, sizeof(NumReplays)))
+      return 1;
+   for (k=0; k<NumReplays; k++) {
+      r = &(Replays[k]);
+      if (r->Empty) {
+         if (writeCheckpointString(File, ""))
+            return 1;
+         continue;
+      }
+      n = r->MapStart != NULL ? r->MapStart[r->NumSources] : 0;
+      if (writeCheckpointString(File, r->FileName) ||
+          writeCheckpointData(File, &(r->Cursor), sizeof(r->Cursor)) ||
+          writeCheckpointData(File, &(r->T0), sizeof(r->T0)) ||
+          writeCheckpointData(File, &(r->LastTime), sizeof(r->LastTime)) ||
+          writeCheckpointData(File, &(r->Offset), sizeof(r->Offset)) ||
+          writeCheckpointData(File, &(r->NextTarget), sizeof(r->NextTarget)) ||
+          writeCheckpointData(File, &(r->LastTarget), sizeof(r->LastTarget)) ||
+          writeCheckpointData(File, &(r->Single), sizeof(r->Single)) ||
+          writeCheckpointData(File, &(r->Spike), sizeof(r->Spike)) ||
+          writeCheckpointData(File, &(r->NumSources), sizeof(r->NumSources)) ||
+          writeCheckpointData(File, &n, sizeof(n)))
+         return 1;
+      if (n > 0)
+         if (writeCheckpointData(File, r->MapStart, sizeof(indexn) * (r->NumSources + 1)) ||
+             writeCheckpointData(File, r->MapTargets, sizeof(indexn) * n))
+            return 1;
+   }
+
+   return 0;
+}
+
+
+/*------------------*
+ *  restoreReplays  *
+ *------------------*/
+
+/**
+ *  Reads from <File> the replays written by checkpointReplays,
+ *  mapping again their files in the same elements of the
+ *  replay array. Returns 1 on error, 0 otherwise.
+ */
+
+int restoreReplays(FILE *File)
+{
+   replay *r;
+   char *FileName;
+   indexn n;
+   int k, Num;
+
+   for (k=0; k<NumReplays; k++)
+      if (!Replays[k].Empty)
+         closeReplay(&(Replays[k]));
+   if (readCheckpointData(File, &Num, sizeof(Num)) || Num < 0)
+      return 1;
+   while (NumReplays < Num)
+      addReplay();
+
+   for (k=0; k<Num; k++) {
+      r = &(Replays[k]);
+      if ((FileName = readCheckpointString(File)) == NULL)
+         return 1;
+      if (FileName[0] == '\0') {
+         releaseMemory(1, MEMORY_OTHER);
+         free(FileName);
+         continue;
+      }
+
+      /*** Maps the file and loads the map and the cursors. ***/
+      r->FileName = FileName;
+      if ((r->Records = (replay_record *)mapFile(FileName, &(r->Size))) == NULL)
+         return 1;
+      r->NumRecords = r->Size / sizeof(replay_record);
+      r->Released = 0;
+      if (readCheckpointData(File, &(r->Cursor), sizeof(r->Cursor)) ||
+          readCheckpointData(File, &(r->T0), sizeof(r->T0)) ||
+          readCheckpointData(File, &(r->LastTime), sizeof(r->LastTime)) ||
+          readCheckpointData(File, &(r->Offset), sizeof(r->Offset)) ||
+          readCheckpointData(File, &(r->NextTarget), sizeof(r->NextTarget)) ||
+          readCheckpointData(File, &(r->LastTarget), sizeof(r->LastTarget)) ||
+          readCheckpointData(File, &(r->Single), sizeof(r->Single)) ||
+          readCheckpointData(File, &(r->Spike), sizeof(r->Spike)) ||
+          readCheckpointData(File, &(r->NumSources), sizeof(r->NumSources)) ||
+          readCheckpointData(File, &n, sizeof(n)) ||
+          r->Cursor > r->NumRecords)
+         return 1;
+      if (n > 0) {
+         r->MapStart = (indexn *)getMemory(sizeof(indexn) * (r->NumSources + 1), "ERROR (restoreReplays): Out of memory.");
+         r->MapTargets = (indexn *)getMemory(sizeof(indexn) * n, "ERROR (restoreReplays): Out of memory.");
+         if (readCheckpointData(File, r->MapStart, sizeof(indexn) * (r->NumSources + 1)) ||
+             readCheckpointData(File, r->MapTargets, sizeof(indexn) * n))
+            return 1;
+      }
+      r->Targets = r->MapStart != NULL ? r->MapTargets : &(r->Single);
+      r->Empty = false;
+   }
+
+   findOldestReplay();
+
+   return 0;
+}
+
+
+
+#undef RELEASE_SIZE
+#undef MAP_BUFFER_SIZE
+#undef BUFFER_SIZE
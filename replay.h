@@ -0,0 +1,129 @@
+/*
+ *
+ *   replay.h
+ *
+ *   Library of functions to drive the network with recorded
+ *   spike trains, streamed from binary files mapped in memory
+ *   and merged with the external and recurrent spikes.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "types.h"
+#include "invar.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  A record of a replay file. The file has no header and
+ *  is a sequence of records sorted in increasing time.
+ *  Records out of order are delivered at the time of the
+ *  preceding one.
+ */
+
+typedef struct {
+   double         Time; /* Emission time in ms from the start of the replay. */
+   unsigned int Neuron; /* Source neuron. */
+   unsigned int   Zero; /* Padding to 16 bytes, it has to be 0. */
+} replay_record;
+
+
+/**
+ *  A source of replayed spikes. Each source neuron is mapped
+ *  onto one or more target neurons of the network receiving
+ *  the spike as if it comes from outside.
+ */
+
+typedef struct {
+   replay_record *Records; /* The records mapped in memory. */
+   size_t      NumRecords; /* Number of records in the file. */
+   size_t          Cursor; /* Index of the next record to read. */
+   size_t        Released; /* Records already read and released from memory. */
+   size_t            Size; /* Size in bytes of the mapped file. */
+   double              T0; /* Absolute time when the replay starts. */
+   double        LastTime; /* Absolute time of the last record read. */
+   indexn          Offset; /* Index of the first target neuron. */
+   indexn      NumSources; /* Number of source neurons in the map (0 if no map is given). */
+   indexn       *MapStart; /* Targets of source s are MapTargets[MapStart[s]...MapStart[s+1]-1]. */
+   indexn     *MapTargets; /* Target neurons, relative to Offset. */
+   indexn       *Targets;  /* Targets of the record under management. */
+   indexn     NextTarget;  /* Next element of Targets to deliver. */
+   indexn     LastTarget;  /* Element following the last one of Targets. */
+   indexn         Single;  /* The only target when no map is given. */
+   spike           Spike;  /* The next spike to deliver. */
+   boolean         Empty;  /* It is true if the replay is ended. */
+   char        *FileName;  /* Name of the replay file. */
+} replay;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+extern PERSEO_LOCAL spike   ReplaySpike; /* The oldest replayed spike to deliver. */
+extern PERSEO_LOCAL boolean ReplayEmpty; /* It is true if no replayed spikes have to be delivered. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Maps in memory the replay file <FileName> starting at time
+ *  <T0>. Source neuron s is delivered to the neuron Offset + s,
+ *  or if <MapFileName> is not NULL to the neurons Offset + t
+ *  for each row "s t" of the text file <MapFileName>.
+ *  Returns 1 if the files cannot be loaded, 0 otherwise.
+ */
+
+int openReplay(char    *FileName, /* Name of the binary replay file. */
+               double         T0, /* Absolute time when the replay starts. */
+               indexn     Offset, /* Index of the first target neuron. */
+               char *MapFileName); /* Name of the map file, or NULL. */
+
+
+/**
+ *  Moves ReplaySpike to the next replayed spike to deliver,
+ *  once the current one is managed.
+ */
+
+void nextReplaySpike ();
+
+
+/**
+ *  Closes all the replays and frees their array.
+ */
+
+void releaseReplays ();
+
+
+/**
+ *  Writes on <File> the active replays with their maps and
+ *  cursors, and reads them back mapping again the files, so
+ *  that a replay keeps its index. Returns 1 on error, 0
+ *  otherwise (see checkpoint.h).
+ */
+
+int checkpointReplays(FILE *File);
+int restoreReplays(FILE *File);
+
+
+
+#endif /* __REPLAY_H__ */
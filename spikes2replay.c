@@ -0,0 +1,80 @@
+/*
+ *
+ *   spikes2replay.c
+ *
+ *   Converts the spikes logged by Perseo (a text file with
+ *   a row "neuron time" per spike, like spikes.dat) into a
+ *   binary file to replay with the REPLAY_SPIKES command.
+ *
+ *      spikes2replay <in_file_name> <out_file_name> [<t0>]
+ *
+ *   The time <t0> (0 by default) is subtracted to the spike
+ *   times, so that the replay starts at the spikes emitted
+ *   from <t0> on. Spikes before <t0> are neglected.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "replay.h"
+
+
+
+int main (int ArgC, char * ArgV[])
+{
+   FILE      *InFile;
+   FILE     *OutFile;
+   replay_record Rec;
+   unsigned int    n;
+   double       t, t0;
+   double      tLast;
+   long    NumSpikes;
+   long  NumUnsorted;
+
+   if (ArgC < 3 || ArgC > 4) {
+      fprintf(stderr, "Usage: %s <in_file_name> <out_file_name> [<t0>]\n", ArgV[0]);
+      return EXIT_FAILURE;
+   }
+   t0 = ArgC == 4 ? atof(ArgV[3]) : 0.0;
+
+   if ((InFile = fopen(ArgV[1], "rt")) == NULL) {
+      fprintf(stderr, "ERROR (spikes2replay): unable to open '%s'.\n", ArgV[1]);
+      return EXIT_FAILURE;
+   }
+   if ((OutFile = fopen(ArgV[2], "wb")) == NULL) {
+      fprintf(stderr, "ERROR (spikes2replay): unable to open '%s'.\n", ArgV[2]);
+      fclose(InFile);
+      return EXIT_FAILURE;
+   }
+
+   /*** Converts a spike per row. ***/
+   NumSpikes = NumUnsorted = 0;
+   tLast = 0.0;
+   Rec.Zero = 0;
+   while (fscanf(InFile, "%u %lf", &n, &t) == 2) {
+      if (t < t0)
+         continue;
+      Rec.Neuron = n;
+      Rec.Time = t - t0;
+      if (Rec.Time < tLast)
+         NumUnsorted++;
+      else
+         tLast = Rec.Time;
+      fwrite(&Rec, sizeof(replay_record), 1, OutFile);
+      NumSpikes++;
+   }
+
+   fclose(InFile);
+   fclose(OutFile);
+
+   fprintf(stderr, "%ld spikes converted.\n", NumSpikes);
+   if (NumUnsorted > 0)
+      fprintf(stderr, "WARNING: %ld spikes are not sorted in time.\n", NumUnsorted);
+
+   return 0;
+}
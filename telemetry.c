@@ -0,0 +1,368 @@
+/*
+ *
+ *   telemetry.c
+ *
+ *   Library publishing the progress of a running simulation
+ *   in a shared memory segment, updated in place with no I/O
+ *   and no locks (see telemetry.h).
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+#include "types.h"
+
+#include "perseo.h"
+#include "queue.h"
+#include "events.h"
+#include "modules.h"
+#include "connectivity.h"
+#include "delays.h"
+#include "results.h"
+#include "profile.h"
+#include "telemetry.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_DIM 256 /* Maximum static string size in the module. */
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+PERSEO_LOCAL double NextTelemetry = 1e37; /* Network time of the next update in ms. */
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL boolean         Telemetry = false; /* If true the telemetry segment is published. */
+PERSEO_LOCAL real    TelemetrySampling = 10.0;  /* Period of the updates in ms of network time. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL telemetry     *Segment = NULL; /* The segment of the simulation. */
+static PERSEO_LOCAL char SegmentName[BUFFER_DIM];  /* Its name. */
+static PERSEO_LOCAL double       LastTime = 0.0;   /* Network time of the last update. */
+static PERSEO_LOCAL double       LastWall = 0.0;   /* Wall-clock time of the last update. */
+static PERSEO_LOCAL uint64_t   LastSpikes = 0;     /* Spikes managed at the last update. */
+static PERSEO_LOCAL long  *LastSpikeTotal = NULL;  /* Spikes emitted by each population at the last update. */
+
+static int NumSegments = 0; /* Segments created by the process. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*-------------*
+ *  wallClock  *
+ *-------------*/
+
+/**
+ *  Returns the wall-clock time in s from the Epoch.
+ */
+
+static double wallClock()
+{
+#ifndef _WIN32
+   struct timespec ts;
+
+   clock_gettime(CLOCK_REALTIME, &ts);
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+   return (double)time(NULL);
+#endif
+}
+
+
+/*-----------------*
+ *  createSegment  *
+ *-----------------*/
+
+/**
+ *  Creates and maps the segment of the simulation, labelled
+ *  with the working directory and <Prefix>. Returns 1 on
+ *  error, reporting the reason in <Error>, 0 otherwise.
+ */
+
+static int createSegment(char *Prefix,
+                         char  *Error)
+{
+#ifndef _WIN32
+   char Label[BUFFER_DIM];
+   size_t Size, Len;
+   int Fd, k;
+
+   Size = sizeof(telemetry) + sizeof(double) * NumPopulations + sizeof(int32_t) * DelayNumber;
+   sprintf(SegmentName, "%s%d.%d", TELEMETRY_PREFIX, (int)getpid(), __sync_fetch_and_add(&NumSegments, 1));
+   shm_unlink(SegmentName);
+   if ((Fd = shm_open(SegmentName, O_RDWR | O_CREAT | O_EXCL, 0644)) < 0) {
+      sprintf(Error, "%s", strerror(errno));
+      return 1;
+   }
+   if (ftruncate(Fd, Size) != 0 ||
+       (Segment = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0)) == MAP_FAILED) {
+      sprintf(Error, "%s", strerror(errno));
+      Segment = NULL;
+      close(Fd);
+      shm_unlink(SegmentName);
+      return 1;
+   }
+   close(Fd);
+
+   /*** The label keeps the end of the directory, if too long. ***/
+   if (getcwd(Label, BUFFER_DIM - 1) == NULL)
+      strcpy(Label, "?");
+   if (Prefix != NULL && strlen(Label) + strlen(Prefix) + 2 < BUFFER_DIM)
+      strcat(strcat(Label, "/"), Prefix);
+   Len = strlen(Label);
+
+   /*** The readers neglect the segment until the magic is set. ***/
+   memset(Segment, 0, Size);
+   Segment->Sequence = 1;
+   Segment->Version = TELEMETRY_VERSION;
+   Segment->Size    = (uint32_t)Size;
+   Segment->Pid     = (int32_t)getpid();
+   Segment->Status  = TELEMETRY_RUNNING;
+   strcpy(Segment->Label, Label + (Len < TELEMETRY_LABEL ? 0 : Len - TELEMETRY_LABEL + 1));
+   Segment->Life           = Life;
+   Segment->StartWall      = wallClock();
+   Segment->NumPopulations = NumPopulations;
+   Segment->NumLayers      = DelayNumber;
+   Segment->NumMemory      = MEMORY_AREAS + 1;
+   strcpy(Segment->MemoryName[0], "Total");
+   for (k=0; k<MEMORY_AREAS; k++)
+      strcpy(Segment->MemoryName[k+1], MemoryAreaNames[k]);
+   Segment->Magic = TELEMETRY_MAGIC;
+   __sync_synchronize();
+   Segment->Sequence = 2;
+
+   return 0;
+#else
+   sprintf(Error, "shared memory is not available on this system");
+   return 1;
+#endif
+}
+
+
+/*-----------------*
+ *  deleteSegment  *
+ *-----------------*/
+
+/**
+ *  Unmaps the segment, removing it if <Remove> is true.
+ */
+
+static void deleteSegment(boolean Remove)
+{
+#ifndef _WIN32
+   munmap(Segment, Segment->Size);
+   if (Remove)
+      shm_unlink(SegmentName);
+#endif
+   Segment = NULL;
+}
+
+
+/*---------------*
+ *  resetPeriod  *
+ *---------------*/
+
+/**
+ *  Starts a new period at the network time <Time>.
+ */
+
+static void resetPeriod(double Time)
+{
+   int k;
+
+   LastTime = Time;
+   LastWall = wallClock();
+#ifdef PRINT_PROFILE
+   LastSpikes = Profile.Iterations;
+#endif
+   for (k=0; k<NumPopulations; k++)
+      LastSpikeTotal[k] = Populations[k].SpikeTotal;
+   NextTelemetry = Time + TelemetrySampling;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*------------------*
+ *  startTelemetry  *
+ *------------------*/
+
+/**
+ *  Creates the segment of the simulation, if Telemetry is
+ *  set, and starts the first period at the network time
+ *  <Time>.
+ */
+
+void startTelemetry (double Time)
+{
+   char Error[BUFFER_DIM];
+
+   NextTelemetry = 1e37;
+   if (!Telemetry)
+      return;
+
+   if (createSegment(NULL, Error)) {
+      fprintf(DocFile, "#----------\n");
+      fprintf(DocFile, "# Telemetry not available (%s): the run goes on without it.\n\n", Error);
+      return;
+   }
+
+   fprintf(DocFile, "#----------\n");
+   fprintf(DocFile, "# Telemetry segment: '%s' (updated every %g ms)\n\n", SegmentName, TelemetrySampling);
+
+   LastSpikeTotal = getMemory(sizeof(long) * NumPopulations, "ERROR (startTelemetry): Out of memory.");
+   resetPeriod(Time);
+   updateTelemetry(Time);
+}
+
+
+/*-------------------*
+ *  updateTelemetry  *
+ *-------------------*/
+
+/**
+ *  Writes in the segment the state of the simulation at the
+ *  network time <Time>: the rates are the ones in the period
+ *  from the last update. The sequence number is odd during
+ *  the writing, so that the readers can detect a torn copy.
+ */
+
+void updateTelemetry (double Time)
+{
+   double Wall, dWall, dTime, *Rates;
+   int32_t *Queues;
+   int k;
+
+   if (Segment == NULL)
+      return;
+
+   Wall  = wallClock();
+   dWall = Wall - LastWall;
+   dTime = Time - LastTime;
+   Rates  = telemetryRates(Segment);
+   Queues = telemetryQueues(Segment);
+
+   Segment->Sequence++;
+   __sync_synchronize();
+
+   Segment->NetworkTime = Time;
+   Segment->Wall        = Wall;
+   if (dWall > 0.0 && dTime > 0.0) {
+      Segment->Speed     = dTime / dWall;
+      Segment->SpikeRate = 0.0;
+#ifdef PRINT_PROFILE
+      Segment->ManagedSpikes = Profile.Iterations;
+      Segment->SpikeRate     = (double)(Profile.Iterations - LastSpikes) / dWall;
+#endif
+      Segment->ETA = Life > Time ? (Life - Time) / Segment->Speed : 0.0;
+      for (k=0; k<NumPopulations; k++)
+         Rates[k] = (Populations[k].SpikeTotal - LastSpikeTotal[k]) * 1000.0 / (Populations[k].N * dTime);
+   }
+   for (k=0; k<DelayNumber; k++)
+      Queues[k] = SynapticMatrix[k].Empty ? 0 : elementNumber(SynapticMatrix[k].Queue) + 1;
+   Segment->PendingEvents = pendingEvents();
+   Segment->Memory[0] = MemoryAmount;
+   for (k=0; k<MEMORY_AREAS; k++)
+      Segment->Memory[k+1] = MemoryUsage[k].Bytes;
+
+   __sync_synchronize();
+   Segment->Sequence++;
+
+   if (dTime > 0.0)
+      resetPeriod(Time);
+}
+
+
+/*-----------------*
+ *  forkTelemetry  *
+ *-----------------*/
+
+/**
+ *  In a process forked by the simulation, unmaps the segment
+ *  of the parent, still in use, and creates a new one.
+ */
+
+void forkTelemetry (char *Prefix)
+{
+   char Error[BUFFER_DIM];
+   double Time;
+
+   if (Segment == NULL)
+      return;
+
+   Time = Segment->NetworkTime;
+   deleteSegment(false);
+   if (createSegment(Prefix, Error)) {
+      NextTelemetry = 1e37;
+      fprintf(DocFile, "# Telemetry not available (%s): the branch goes on without it.\n\n", Error);
+      return;
+   }
+   resetPeriod(Time);
+   updateTelemetry(Time);
+}
+
+
+/*----------------*
+ *  endTelemetry  *
+ *----------------*/
+
+/**
+ *  Writes the final state at the network time <Time>,
+ *  marking the simulation as ended, and removes the segment.
+ */
+
+void endTelemetry (double Time)
+{
+   if (Segment == NULL)
+      return;
+
+   updateTelemetry(Time);
+   Segment->Sequence++;
+   __sync_synchronize();
+   Segment->Status = TELEMETRY_ENDED;
+   __sync_synchronize();
+   Segment->Sequence++;
+
+   deleteSegment(true);
+   NextTelemetry = 1e37;
+
+   free(LastSpikeTotal);
+   releaseMemory(sizeof(long) * NumPopulations, MEMORY_OTHER);
+   LastSpikeTotal = NULL;
+}
+
+
+
+#undef BUFFER_DIM
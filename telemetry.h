@@ -0,0 +1,163 @@
+/*
+ *
+ *   telemetry.h
+ *
+ *   Library publishing the progress of a running simulation
+ *   in a shared memory segment, updated in place at each
+ *   TelemetrySampling ms of network time: network and wall
+ *   time, spikes managed per second, rates of the populations,
+ *   length of the queues, memory and estimated time of arrival.
+ *   The simulation only writes the memory of the segment, with
+ *   no I/O and no locks: the readers (see perseo-top.c) copy
+ *   it and retry if the sequence number changed meanwhile.
+ *   The segment is named TELEMETRY_PREFIX<pid>.<k>, where k
+ *   counts the simulations of the process, and it is removed
+ *   at the end of the run.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+
+
+#include <stdint.h>
+
+#include "types.h"
+#include "perseo.h"
+
+
+
+/*--------------------*
+ *  GLOBAL CONSTANTS  *
+ *--------------------*/
+
+#define TELEMETRY_PREFIX  "/perseo." /* Prefix of the name of the segments. */
+#define TELEMETRY_MAGIC   0x50525354 /* First word of a segment ("PRST"). */
+#define TELEMETRY_VERSION 1          /* Version of the layout of the segment. */
+#define TELEMETRY_LABEL   128        /* Size of the label of a simulation. */
+#define TELEMETRY_MEMORY  16         /* Maximum number of memory items. */
+#define TELEMETRY_NAME    16         /* Size of the name of a memory item. */
+
+/*** Status of a simulation. ***/
+#define TELEMETRY_RUNNING 0 /* The evolution is going on. */
+#define TELEMETRY_ENDED   1 /* The final outputs are written. */
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  Header of a telemetry segment. It is followed by the
+ *  rates of the NumPopulations populations (double, in Hz)
+ *  and by the lengths of the queues of the NumLayers delay
+ *  layers (int32_t). Sequence is odd while the simulation
+ *  writes the segment.
+ */
+
+typedef struct {
+   uint32_t           Magic; /* TELEMETRY_MAGIC. */
+   uint32_t         Version; /* TELEMETRY_VERSION. */
+   uint32_t            Size; /* Size of the segment in bytes. */
+   volatile uint32_t Sequence; /* Number of the update, odd during an update. */
+   int32_t              Pid; /* Process running the simulation. */
+   int32_t           Status; /* TELEMETRY_RUNNING or TELEMETRY_ENDED. */
+   char Label[TELEMETRY_LABEL]; /* Working directory and prefix of the log files. */
+   double              Life; /* Life time of the simulation in ms. */
+   double       NetworkTime; /* Network time reached in ms. */
+   double         StartWall; /* Wall-clock time of the start of the run (s from the Epoch). */
+   double              Wall; /* Wall-clock time of the last update (s from the Epoch). */
+   double             Speed; /* Network ms per wall-clock s in the last period. */
+   double         SpikeRate; /* Spikes managed per wall-clock s in the last period. */
+   double               ETA; /* Estimated wall-clock s to reach Life. */
+   uint64_t  ManagedSpikes; /* Spikes managed since the start (0 without PRINT_PROFILE). */
+   int32_t    PendingEvents; /* Events in the queue of the protocol. */
+   int32_t   NumPopulations; /* Number of populations. */
+   int32_t        NumLayers; /* Number of delay layers. */
+   int32_t        NumMemory; /* Number of memory items. */
+   char MemoryName[TELEMETRY_MEMORY][TELEMETRY_NAME]; /* Name of each memory item. */
+   uint64_t Memory[TELEMETRY_MEMORY]; /* Bytes of each memory item, the first being the total. */
+} telemetry;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+extern PERSEO_LOCAL double NextTelemetry; /* Network time of the next update in ms. */
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL boolean         Telemetry; /* If true the telemetry segment is published. */
+extern PERSEO_LOCAL real    TelemetrySampling; /* Period of the updates in ms of network time. */
+
+
+
+/*-----------------*
+ *  GLOBAL MACROS  *
+ *-----------------*/
+
+/**
+ *  Returns the rates and the queue lengths following the
+ *  header <T> of a segment.
+ */
+
+#define telemetryRates(T)  ((double *)((char *)(T) + sizeof(telemetry)))
+#define telemetryQueues(T) ((int32_t *)(telemetryRates(T) + (T)->NumPopulations))
+
+
+/**
+ *  Updates the segment at the network time <Time>, if a
+ *  period elapsed.
+ */
+
+#define telemetrySample(Time) ((Time) >= NextTelemetry ? updateTelemetry(Time) : (void)0)
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Creates the segment of the simulation, labelled with the
+ *  working directory, if Telemetry is set, starting at the
+ *  network time <Time>. If it cannot be created, the run goes
+ *  on without it and the reason is reported in LogFile.
+ */
+
+void startTelemetry (double Time);
+
+
+/**
+ *  Writes in the segment the state of the simulation at the
+ *  network time <Time>, and schedules the next update.
+ */
+
+void updateTelemetry (double Time);
+
+
+/**
+ *  In a process forked by the simulation, leaves the segment
+ *  of the parent and creates a new one, labelled with <Prefix>.
+ */
+
+void forkTelemetry (char *Prefix);
+
+
+/**
+ *  Writes the final state at the network time <Time>,
+ *  marking the simulation as ended, and removes the segment.
+ */
+
+void endTelemetry (double Time);
+
+
+
+#endif /* __TELEMETRY_H__ */
@@ -0,0 +1,417 @@
+/*
+ *
+ *   traces.c
+ *
+ *   Library of functions to stream sampled traces (for
+ *   instance recorded population rates) from binary files
+ *   mapped in memory, without loading them in the heap.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "types.h"
+#include "perseo.h"
+#include "traces.h"
+#include "checkpoint.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define BUFFER_SIZE       16 /* Size of the buffer for the trace array. */
+#define RELEASE_SIZE  131072 /* Number of samples read before to release their memory (1 Mbyte). */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+PERSEO_LOCAL trace *Traces = NULL; /* Array of the opened traces. */
+PERSEO_LOCAL int NumTraces = 0;    /* Length of the Traces array. */
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------*
+ *  addTrace  *
+ *------------*/
+
+/**
+ *  Appends a free element to the trace array.
+ */
+
+static void addTrace ()
+{
+   if (NumTraces % BUFFER_SIZE == 0) { // More memory is needed?
+      Traces = (trace *)resizeMemory(Traces, sizeof(trace) * NumTraces, sizeof(trace) * (NumTraces + BUFFER_SIZE),
+                                     MEMORY_OTHER, "ERROR (addTrace): Out of memory.");
+   }
+   Traces[NumTraces++].Values = NULL;
+}
+
+
+/*------------*
+ *  mapTrace  *
+ *------------*/
+
+/**
+ *  Maps in the trace <t> the file <FileName>, sampled every
+ *  <Dt> ms from the time <T0>.
+ *  Returns 1 if the file cannot be opened or is empty, 0
+ *  otherwise.
+ */
+
+static int mapTrace(trace     *t, /* Free element of the trace array. */
+                    char *FileName, /* Name of the binary trace file. */
+                    double      T0, /* Time of the first sample. */
+                    double      Dt) /* Sampling period in ms. */
+{
+   if ((t->Values = (double *)mapFile(FileName, &(t->Size))) == NULL)
+      return 1;
+   if (t->Size < sizeof(double)) {
+      unmapFile(t->Values, t->Size);
+      t->Values = NULL;
+      return 1;
+   }
+
+   t->NumValues = t->Size / sizeof(double);
+   t->Cursor = 0;
+   t->Released = 0;
+   t->T0 = T0;
+   t->Dt = Dt;
+   t->FileName = getMemory(strlen(FileName) + 1, "ERROR (mapTrace): Out of memory.");
+   strcpy(t->FileName, FileName);
+
+   return 0;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*-----------*
+ *  mapFile  *
+ *-----------*/
+
+/**
+ *  Maps in memory, read-only, the file <FileName> returning 
+ *  the pointer to its content and its size in bytes in <*Size>.
+ *  Without memory mapping (_WIN32) the file is loaded in the heap.
+ *  Returns NULL if the file cannot be opened or is empty.
+ */
+
+void *mapFile(char *FileName, /* Name of the file to map. */
+              size_t   *Size) /* Returned size of the file. */
+{
+   void *Data;
+#ifndef _WIN32
+   int         fd;
+   struct stat st;
+
+   if ((fd = open(FileName, O_RDONLY)) < 0)
+      return NULL;
+   if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+      close(fd);
+      return NULL;
+   }
+   *Size = (size_t)st.st_size;
+   Data = mmap(NULL, *Size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (Data == MAP_FAILED)
+      return NULL;
+   madvise(Data, *Size, MADV_SEQUENTIAL);
+#else
+   FILE *InFile;
+
+   if ((InFile = fopen(FileName, "rb")) == NULL)
+      return NULL;
+   fseek(InFile, 0, SEEK_END);
+   *Size = (size_t)ftell(InFile);
+   fseek(InFile, 0, SEEK_SET);
+   if (*Size == 0) {
+      fclose(InFile);
+      return NULL;
+   }
+   Data = getMemory(*Size, "ERROR (mapFile): Out of memory.");
+   fread(Data, 1, *Size, InFile);
+   fclose(InFile);
+#endif
+
+   return Data;
+}
+
+
+/*---------------------*
+ *  releaseMappedFile  *
+ *---------------------*/
+
+/**
+ *  Gives back to the operating system the memory pages of the 
+ *  mapped file <Data> in the byte range [<From>, <To>), which
+ *  will be read again from the disk if accessed.
+ */
+
+void releaseMappedFile(void  *Data, /* Mapped file. */
+                       size_t From, /* First byte to release. */
+                       size_t   To) /* Byte following the last to release. */
+{
+#ifndef _WIN32
+   static PERSEO_LOCAL size_t PageSize = 0;
+
+   if (PageSize == 0)
+      PageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+   /*** The page containing <To> is kept, being still in use. ***/
+   From = From / PageSize * PageSize;
+   To = To / PageSize * PageSize;
+   if (To > From)
+      madvise((char *)Data + From, To - From, MADV_DONTNEED);
+#endif
+}
+
+
+/*-------------*
+ *  unmapFile  *
+ *-------------*/
+
+/**
+ *  Unmaps the file <Data> of <Size> bytes.
+ */
+
+void unmapFile(void  *Data, /* Mapped file. */
+               size_t Size) /* Size of the file. */
+{
+#ifndef _WIN32
+   munmap(Data, Size);
+#else
+   free(Data);
+   releaseMemory(Size, MEMORY_OTHER);
+#endif
+}
+
+
+/*-------------*
+ *  openTrace  *
+ *-------------*/
+
+/**
+ *  Maps in memory the trace file <FileName>, sampled every
+ *  <Dt> ms from the time <T0>.
+ *  Returns the index of the opened trace, or -1 if the file
+ *  cannot be opened or is empty.
+ */
+
+int openTrace(char *FileName, /* Name of the binary trace file. */
+              double      T0, /* Time of the first sample. */
+              double      Dt) /* Sampling period in ms. */
+{
+   int k;
+
+   /*** Looks for a free element of the trace array. ***/
+   for (k=0; k<NumTraces; k++)
+      if (Traces[k].Values == NULL)
+         break;
+   if (k == NumTraces)
+      addTrace();
+   if (mapTrace(&(Traces[k]), FileName, T0, Dt))
+      return -1;
+
+   return k;
+}
+
+
+/*------------*
+ *  getTrace  *
+ *------------*/
+
+/**
+ *  Returns the pointer to the trace with index <k>.
+ */
+
+trace *getTrace(int k)
+{
+   return &(Traces[k]);
+}
+
+
+/*----------------*
+ *  advanceTrace  *
+ *----------------*/
+
+/**
+ *  Moves the cursor of the trace <k> to the next sample
+ *  with a value different from the current one. Memory
+ *  pages of samples already read are given back to the
+ *  operating system, in order to keep constant the memory
+ *  used whatever is the length of the trace.
+ *  Returns 1 if the end of the trace is reached, 0 otherwise.
+ */
+
+int advanceTrace(int k)
+{
+   trace *t;
+   double v;
+
+   t = &(Traces[k]);
+
+   /*** Skips the samples with the same value. ***/
+   v = t->Values[t->Cursor];
+   for (t->Cursor++; t->Cursor < t->NumValues; t->Cursor++)
+      if (t->Values[t->Cursor] != v)
+         break;
+
+   /*** Releases the memory pages already read. ***/
+   if (t->Cursor - t->Released >= RELEASE_SIZE) {
+      releaseMappedFile(t->Values, t->Released * sizeof(double), t->Cursor * sizeof(double));
+      t->Released = t->Cursor;
+   }
+
+   return t->Cursor >= t->NumValues;
+}
+
+
+/*--------------*
+ *  closeTrace  *
+ *--------------*/
+
+/**
+ *  Unmaps the trace <k>.
+ */
+
+void closeTrace(int k)
+{
+   if (Traces[k].Values == NULL)
+      return;
+
+   unmapFile(Traces[k].Values, Traces[k].Size);
+   Traces[k].Values = NULL;
+   releaseMemory(strlen(Traces[k].FileName) + 1, MEMORY_OTHER);
+   free(Traces[k].FileName);
+}
+
+
+/*-----------------*
+ *  releaseTraces  *
+ *-----------------*/
+
+/**
+ *  Unmaps all the traces and frees their array.
+ */
+
+void releaseTraces ()
+{
+   int k;
+
+   for (k=0; k<NumTraces; k++)
+      closeTrace(k);
+   if (NumTraces > 0) {
+      free(Traces);
+      releaseMemory(sizeof(trace) * ((NumTraces + BUFFER_SIZE - 1) / BUFFER_SIZE * BUFFER_SIZE), MEMORY_OTHER);
+   }
+   Traces = NULL;
+   NumTraces = 0;
+}
+
+
+/*--------------------*
+ *  checkpointTraces  *
+ *--------------------*/
+
+/**
+ *  Writes on <File> the opened traces with their cursors.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointTraces(FILE *File)
+{
+   trace *t;
+   int    k;
+
+   if (writeCheckpointData(File, &NumTraces, sizeof(NumTraces)))
+      return 1;
+   for (k=0; k<NumTraces; k++) {
+      t = &(Traces[k]);
+      if (t->Values == NULL) {
+         if (writeCheckpointString(File, ""))
+            return 1;
+      } else
+         if (writeCheckpointString(File, t->FileName) ||
+             writeCheckpointData(File, &(t->Cursor), sizeof(t->Cursor)) ||
+             writeCheckpointData(File, &(t->T0), sizeof(t->T0)) ||
+             writeCheckpointData(File, &(t->Dt), sizeof(t->Dt)))
+            return 1;
+   }
+
+   return 0;
+}
+
+
+/*-----------------*
+ *  restoreTraces  *
+ *-----------------*/
+
+/**
+ *  Reads from <File> the traces written by checkpointTraces,
+ *  mapping again their files in the same elements of the
+ *  trace array. Returns 1 on error, 0 otherwise.
+ */
+
+int restoreTraces(FILE *File)
+{
+   trace *t;
+   char *FileName;
+   int k, n;
+
+   for (k=0; k<NumTraces; k++)
+      closeTrace(k);
+   if (readCheckpointData(File, &n, sizeof(n)) || n < 0)
+      return 1;
+   while (NumTraces < n)
+      addTrace();
+
+   /*** Opened traces are mapped again, each in its element. ***/
+   for (k=0; k<n; k++) {
+      if ((FileName = readCheckpointString(File)) == NULL)
+         return 1;
+      if (FileName[0] != '\0') {
+         t = &(Traces[k]);
+         if (mapTrace(t, FileName, 0.0, 0.0) ||
+             readCheckpointData(File, &(t->Cursor), sizeof(t->Cursor)) ||
+             readCheckpointData(File, &(t->T0), sizeof(t->T0)) ||
+             readCheckpointData(File, &(t->Dt), sizeof(t->Dt)) ||
+             t->Cursor >= t->NumValues)
+            return 1;
+      }
+      releaseMemory(strlen(FileName) + 1, MEMORY_OTHER);
+      free(FileName);
+   }
+
+   return 0;
+}
+
+
+
+#undef RELEASE_SIZE
+#undef BUFFER_SIZE
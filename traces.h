@@ -0,0 +1,142 @@
+/*
+ *
+ *   traces.h
+ *
+ *   Library of functions to stream sampled traces (for
+ *   instance recorded population rates) from binary files
+ *   mapped in memory, without loading them in the heap.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __TRACES_H__
+#define __TRACES_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "types.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  A trace is a binary file without header, containing a
+ *  sequence of values in native double precision format
+ *  (8 bytes), each one sampled every Dt ms from the time
+ *  T0 when the streaming starts.
+ */
+
+typedef struct {
+   double   *Values; /* The samples mapped in memory. */
+   size_t NumValues; /* Number of samples in the trace. */
+   size_t    Cursor; /* Index of the next sample to read. */
+   size_t  Released; /* Samples already read and released from memory. */
+   size_t      Size; /* Size in bytes of the mapped file. */
+   double        T0; /* Absolute time of the first sample. */
+   double        Dt; /* Sampling period in ms. */
+   char   *FileName; /* Name of the trace file. */
+} trace;
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Maps in memory, read-only, the file <FileName> returning 
+ *  the pointer to its content and its size in bytes in <*Size>.
+ *  Without memory mapping (_WIN32) the file is loaded in the heap.
+ *  Returns NULL if the file cannot be opened or is empty.
+ */
+
+void *mapFile(char *FileName, /* Name of the file to map. */
+              size_t   *Size); /* Returned size of the file. */
+
+
+/**
+ *  Gives back to the operating system the memory pages of the 
+ *  mapped file <Data> in the byte range [<From>, <To>), which
+ *  will be read again from the disk if accessed.
+ */
+
+void releaseMappedFile(void  *Data, /* Mapped file. */
+                       size_t From, /* First byte to release. */
+                       size_t   To); /* Byte following the last to release. */
+
+
+/**
+ *  Unmaps the file <Data> of <Size> bytes.
+ */
+
+void unmapFile(void  *Data, /* Mapped file. */
+               size_t Size); /* Size of the file. */
+
+
+/**
+ *  Maps in memory the trace file <FileName>, sampled every
+ *  <Dt> ms from the time <T0>.
+ *  Returns the index of the opened trace, or -1 if the file
+ *  cannot be opened or is empty.
+ */
+
+int openTrace(char *FileName, /* Name of the binary trace file. */
+              double      T0, /* Time of the first sample. */
+              double      Dt); /* Sampling period in ms. */
+
+
+/**
+ *  Returns the pointer to the trace with index <k>.
+ */
+
+trace *getTrace(int k);
+
+
+/**
+ *  Moves the cursor of the trace <k> to the next sample
+ *  with a value different from the current one. Memory
+ *  pages of samples already read are given back to the
+ *  operating system, in order to keep constant the memory
+ *  used whatever is the length of the trace.
+ *  Returns 1 if the end of the trace is reached, 0 otherwise.
+ */
+
+int advanceTrace(int k);
+
+
+/**
+ *  Unmaps the trace <k>.
+ */
+
+void closeTrace(int k);
+
+
+/**
+ *  Unmaps all the traces and frees their array.
+ */
+
+void releaseTraces ();
+
+
+/**
+ *  Writes on <File> the opened traces with their cursors, and 
+ *  reads them back mapping again the files, so that a trace
+ *  keeps its index. Returns 1 on error, 0 otherwise (see
+ *  checkpoint.h).
+ */
+
+int checkpointTraces(FILE *File);
+int restoreTraces(FILE *File);
+
+
+
+#endif /* __TRACES_H__ */
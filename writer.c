@@ -0,0 +1,783 @@
+/*
+ *
+ *   writer.c
+ *
+ *   Library of functions to write the result streams
+ *   asynchronously. The simulation loop stores binary records
+ *   in a lock-free ring buffer per stream, while a background
+ *   thread formats them and writes the log files in large
+ *   blocks. Each side sleeps on a condition variable when it
+ *   cannot proceed (empty rings or full ring) and is woken
+ *   by the other one only when it is asleep.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "types.h"
+#include "perseo.h"
+#include "writer.h"
+#include "checkpoint.h"
+
+
+
+/*---------------------*
+ *  LOCAL DEFINITIONS  *
+ *---------------------*/
+
+#define MAX_STREAMS              16 /* Maximum number of output streams. */
+#define MIN_RING_SIZE         65536 /* Minimum size in bytes of a ring buffer. */
+#define FILE_BUFFER_SIZE    1048576 /* Size in bytes of the buffer of a log file. */
+#define COPY_BUFFER_SIZE      65536 /* Size of the buffer copying a moved log file. */
+
+/*** Atomic access to the ring counters (GCC builtins). ***/
+#if defined(__GNUC__) && !defined(_WIN32)
+#define loadAcquire(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define storeRelease(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define fullFence()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define loadAcquire(p)     (*(p))
+#define storeRelease(p, v) (*(p) = (v))
+#define fullFence()
+#endif
+
+/**
+ *  The streams served by the writer thread, which cannot
+ *  reach the variables of its simulation (local to the
+ *  simulation thread, see PERSEO_LOCAL), and the condition
+ *  variables on which the two threads sleep. A thread sets
+ *  its flag under Lock before checking the rings and going
+ *  to sleep, while the other one tests the flag after a
+ *  full fence following its update of Head or Tail, so that
+ *  no wake-up is lost and no call is made while both run.
+ */
+
+typedef struct {
+   out_stream *Streams; /* The opened output streams. */
+   int      NumStreams; /* Number of opened streams. */
+   int           *Stop; /* Set to 1 to ask the writer thread to end. */
+#ifndef _WIN32
+   pthread_mutex_t Lock; /* Mutex of the condition variables. */
+   pthread_cond_t  Work; /* Signaled when records are stored or the end is asked. */
+   pthread_cond_t  Room; /* Signaled when records are written. */
+   memory_usage Memory[MEMORY_AREAS]; /* Memory left allocated by the writer thread. */
+#endif
+   int        Sleeping; /* 1 while the writer waits on Work. */
+   int         Waiting; /* 1 while the simulation waits on Room. */
+} writer_args;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+PERSEO_LOCAL boolean     AsyncOutput = true;    /* If true the log files are written by a background thread. */
+PERSEO_LOCAL int       OutBufferSize = 4;       /* Size in Mbytes of the ring buffer per stream. */
+PERSEO_LOCAL char   *OutBackPressure = "BLOCK"; /* With full ring buffer, 'BLOCK' waits for the writer, 'DROP' neglects the record. */
+
+
+
+/*-------------------*
+ *  LOCAL VARIABLES  *
+ *-------------------*/
+
+static PERSEO_LOCAL out_stream Streams[MAX_STREAMS]; /* The opened output streams. */
+static PERSEO_LOCAL int     NumStreams = 0;          /* Number of opened streams. */
+static PERSEO_LOCAL boolean   Running = false;       /* It is true if the writer thread is running. */
+static PERSEO_LOCAL boolean  DropFull = false;       /* It is true if the records are dropped with full rings. */
+static PERSEO_LOCAL int          Stop = 0;           /* Set to 1 to ask the writer thread to end. */
+#ifndef _WIN32
+static PERSEO_LOCAL pthread_t  Writer;               /* The writer thread. */
+static PERSEO_LOCAL writer_args WriterArgs;          /* The streams served by the writer thread. */
+static pthread_once_t       AtExit = PTHREAD_ONCE_INIT; /* Registers joinWriter at exit once per process. */
+#endif
+
+
+
+/*-------------------*
+ *  LOCAL FUNCTIONS  *
+ *-------------------*/
+
+/*------------*
+ *  ringSize  *
+ *------------*/
+
+/**
+ *  Returns the size in bytes of the ring buffer of a stream:
+ *  OutBufferSize Mbytes rounded to a power of 2.
+ */
+
+static size_t ringSize()
+{
+   size_t Size;
+
+   for (Size = MIN_RING_SIZE; Size < (size_t)OutBufferSize << 20; Size <<= 1);
+
+   return Size;
+}
+
+
+/*---------------*
+ *  drainStream  *
+ *---------------*/
+
+/**
+ *  Prints all the records stored in the ring of <s>,
+ *  waking the simulation thread of <w> if it waits for
+ *  room. Returns the number of printed records.
+ */
+
+static int drainStream(out_stream *s, writer_args *w)
+{
+   out_record Rec;
+   double *Values;
+   size_t  Head, Tail, Pos, Len;
+   int     n = 0;
+
+   Head = loadAcquire(&s->Head);
+   for (Tail = s->Tail; Tail != Head; n++) {
+
+      /*** Reads the record from the ring, which may wrap around. ***/
+      Pos = Tail & (s->Size - 1);
+      if (Pos + sizeof(out_record) <= s->Size)
+         memcpy(&Rec, s->Ring + Pos, sizeof(out_record));
+      else {
+         memcpy(&Rec, s->Ring + Pos, s->Size - Pos);
+         memcpy((char *)&Rec + (s->Size - Pos), s->Ring, sizeof(out_record) - (s->Size - Pos));
+      }
+      Pos = (Pos + sizeof(out_record)) & (s->Size - 1);
+      Len = sizeof(double) * Rec.NumValues;
+      if (Pos + Len <= s->Size)
+         Values = (double *)(s->Ring + Pos);
+      else {
+         if (Len > s->ScratchSize) { // Wrapped values are joined in the scratch buffer.
+            if ((s->Scratch = (double *)realloc(s->Scratch, Len)) == NULL)
+               printFatalError("drainStream", "Out of memory.");
+            s->ScratchSize = Len;
+         }
+         Values = s->Scratch;
+         memcpy(Values, s->Ring + Pos, s->Size - Pos);
+         memcpy((char *)Values + (s->Size - Pos), s->Ring, Len - (s->Size - Pos));
+      }
+
+      (*s->format)(s->File, &Rec, Values, s->Data);
+
+      /*** The space is given back only once the record is printed. ***/
+      Tail += sizeof(out_record) + Len;
+      storeRelease(&s->Tail, Tail);
+#ifndef _WIN32
+      fullFence();
+      if (loadAcquire(&w->Waiting)) {
+         pthread_mutex_lock(&w->Lock);
+         pthread_cond_signal(&w->Room);
+         pthread_mutex_unlock(&w->Lock);
+      }
+#endif
+   }
+
+   return n;
+}
+
+
+#ifndef _WIN32
+
+/*------------------*
+ *  pendingRecords  *
+ *------------------*/
+
+/**
+ *  Returns 1 if a ring of the streams in <w> holds
+ *  records, 0 otherwise.
+ */
+
+static int pendingRecords(writer_args *w)
+{
+   int k;
+
+   for (k=0; k<w->NumStreams; k++)
+      if (loadAcquire(&w->Streams[k].Head) != w->Streams[k].Tail)
+         return 1;
+
+   return 0;
+}
+
+
+/*--------------*
+ *  writerLoop  *
+ *--------------*/
+
+/**
+ *  Body of the writer thread: drains the rings of the
+ *  streams in <Arg> (a writer_args) until the end is asked
+ *  and nothing remains to write. With empty rings it sleeps
+ *  on Work.
+ */
+
+static void *writerLoop(void *Arg)
+{
+   writer_args *w = (writer_args *)Arg;
+   int Stopping, Work, k;
+
+   do {
+      Stopping = loadAcquire(w->Stop);
+      for (Work = 0, k=0; k<w->NumStreams; k++)
+         Work += drainStream(&w->Streams[k], w);
+      if (Work == 0 && !Stopping) {
+         pthread_mutex_lock(&w->Lock);
+         storeRelease(&w->Sleeping, 1);
+         fullFence();
+         while (!pendingRecords(w) && !loadAcquire(w->Stop))
+            pthread_cond_wait(&w->Work, &w->Lock);
+         storeRelease(&w->Sleeping, 0);
+         pthread_mutex_unlock(&w->Lock);
+      }
+   } while (Work > 0 || !Stopping);
+
+   /*** Hands the memory left allocated here (the chunks of the container) to the simulation thread. ***/
+   memcpy(w->Memory, MemoryUsage, sizeof(MemoryUsage));
+
+   return NULL;
+}
+
+
+/*--------------*
+ *  wakeWriter  *
+ *--------------*/
+
+/**
+ *  Wakes the writer thread if it sleeps on Work, after
+ *  new records are stored or the end is asked.
+ */
+
+static void wakeWriter ()
+{
+   fullFence();
+   if (loadAcquire(&WriterArgs.Sleeping)) {
+      pthread_mutex_lock(&WriterArgs.Lock);
+      pthread_cond_signal(&WriterArgs.Work);
+      pthread_mutex_unlock(&WriterArgs.Lock);
+   }
+}
+
+
+/*--------------*
+ *  waitWriter  *
+ *--------------*/
+
+/**
+ *  Sleeps on Room until the ring of <s> has <Len> bytes
+ *  free (or is empty, with <Len> equal to its size).
+ */
+
+static void waitWriter(out_stream *s, /* Output stream. */
+                       size_t    Len) /* Bytes needed. */
+{
+   pthread_mutex_lock(&WriterArgs.Lock);
+   storeRelease(&WriterArgs.Waiting, 1);
+   fullFence();
+   while (s->Size - (s->Head - loadAcquire(&s->Tail)) < Len)
+      pthread_cond_wait(&WriterArgs.Room, &WriterArgs.Lock);
+   storeRelease(&WriterArgs.Waiting, 0);
+   pthread_mutex_unlock(&WriterArgs.Lock);
+}
+
+#endif
+
+
+/*--------------*
+ *  joinWriter  *
+ *--------------*/
+
+/**
+ *  Asks the writer thread to end once the rings are empty,
+ *  and waits for it. It is also called at exit, so that the
+ *  stored records are not lost after a fatal error.
+ */
+
+static void joinWriter ()
+{
+   if (!Running)
+      return;
+
+#ifndef _WIN32
+   storeRelease(&Stop, 1);
+   wakeWriter();
+   pthread_join(Writer, NULL);
+   mergeMemoryUsage(WriterArgs.Memory);
+   pthread_cond_destroy(&WriterArgs.Room);
+   pthread_cond_destroy(&WriterArgs.Work);
+   pthread_mutex_destroy(&WriterArgs.Lock);
+#endif
+   Running = false;
+}
+
+
+/*------------------*
+ *  registerAtExit  *
+ *------------------*/
+
+/**
+ *  Registers joinWriter at exit, called once per process
+ *  through AtExit however many writers are started.
+ */
+
+#ifndef _WIN32
+static void registerAtExit ()
+{
+   atexit(joinWriter);
+}
+#endif
+
+
+/*------------*
+ *  moveFile  *
+ *------------*/
+
+/**
+ *  Moves the opened log file <File>, named <Name>, to a new
+ *  file <NewName> starting with its present content. The
+ *  same FILE is reopened, so that its holders are unaware of
+ *  the move, with <FileBuffer> as buffer if not NULL.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+static int moveFile(FILE       *File, /* Opened log file. */
+                    char       *Name, /* Name of the log file. */
+                    char    *NewName, /* Name of the new log file. */
+                    char *FileBuffer) /* Buffer of FILE_BUFFER_SIZE bytes, or NULL. */
+{
+   char Buffer[COPY_BUFFER_SIZE];
+   FILE    *In;
+   long Length;
+   size_t  Len;
+   int   Error;
+
+   if (strcmp(Name, NewName) == 0 || fflush(File) != 0 || (Length = ftell(File)) < 0)
+      return 1;
+   if ((In = fopen(Name, "rb")) == NULL)
+      return 1;
+   if (freopen(NewName, "wb", File) == NULL) {
+      fclose(In);
+      return 1;
+   }
+   if (FileBuffer != NULL)
+      setvbuf(File, FileBuffer, _IOFBF, FILE_BUFFER_SIZE);
+
+   for (Error = 0; Length > 0 && !Error; Length -= (long)Len) {
+      Len = Length < COPY_BUFFER_SIZE ? (size_t)Length : COPY_BUFFER_SIZE;
+      Error = fread(Buffer, 1, Len, In) != Len || fwrite(Buffer, 1, Len, File) != Len;
+   }
+   fclose(In);
+
+   return Error;
+}
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/*-----------------*
+ *  openOutStream  *
+ *-----------------*/
+
+/**
+ *  Returns a new output stream writing on the opened file
+ *  <File> named <Name>, whose records are printed by <Format>.
+ *  The file is given a large buffer, so that the writes on
+ *  disk are done in big blocks. <File> is NULL if the records
+ *  are written elsewhere by <Format>.
+ */
+
+out_stream *openOutStream(FILE          *File, /* Opened log file. */
+                          char          *Name, /* Name of the log file. */
+                          format_func  Format) /* Function printing a record. */
+{
+   out_stream *s;
+
+   if (NumStreams == MAX_STREAMS)
+      printFatalError("openOutStream", "Too many output streams.");
+   s = &Streams[NumStreams++];
+
+   s->File = File;
+   s->Name = Name;
+   s->format = Format;
+   s->end = NULL;
+   s->Tag = 0;
+   s->Data = NULL;
+   s->Head = s->Tail = 0;
+   s->Dropped = 0;
+   s->Scratch = NULL;
+   s->ScratchSize = 0;
+   s->FileBuffer = NULL;
+   if (File != NULL) {
+      s->FileBuffer = (char *)getAreaMemory(FILE_BUFFER_SIZE, MEMORY_OUTPUT, "ERROR (openOutStream): Out of memory.");
+      setvbuf(File, s->FileBuffer, _IOFBF, FILE_BUFFER_SIZE);
+   }
+
+   /*** The ring size is rounded to a power of 2. ***/
+   s->Size = 0;
+   s->Ring = NULL;
+   if (AsyncOutput) {
+      s->Size = ringSize();
+      s->Ring = (char *)getAreaMemory(s->Size, MEMORY_OUTPUT, "ERROR (openOutStream): Out of memory.");
+   }
+
+   return s;
+}
+
+
+/*-------------------*
+ *  outStreamMemory  *
+ *-------------------*/
+
+/**
+ *  Returns the memory in bytes that openOutStream takes for
+ *  a stream, with a log file if <File> is true.
+ */
+
+size_t outStreamMemory(boolean File)
+{
+   return (File ? FILE_BUFFER_SIZE : 0) + (AsyncOutput ? ringSize() : 0);
+}
+
+
+/*-------------------*
+ *  setOutStreamEnd  *
+ *-------------------*/
+
+/**
+ *  Sets <End> as the function completing the file of the
+ *  stream <s> before its closure.
+ */
+
+void setOutStreamEnd(out_stream *s, /* Output stream. */
+                     end_func  End) /* Function completing the file. */
+{
+   s->end = End;
+}
+
+
+/*-------------------*
+ *  setOutStreamTag  *
+ *-------------------*/
+
+/**
+ *  Sets <Tag> as the tag of the records of the stream <s>.
+ */
+
+void setOutStreamTag(out_stream *s, /* Output stream. */
+                     int       Tag) /* Tag of the records. */
+{
+   s->Tag = Tag;
+}
+
+
+/*--------------------*
+ *  setOutStreamData  *
+ *--------------------*/
+
+/**
+ *  Sets <Data> as the data given to the format and end
+ *  functions of the stream <s>.
+ */
+
+void setOutStreamData(out_stream *s, /* Output stream. */
+                      void   *Data) /* Data of the stream. */
+{
+   s->Data = Data;
+}
+
+
+/*---------------*
+ *  startWriter  *
+ *---------------*/
+
+/**
+ *  Starts the writer thread serving the opened streams,
+ *  if AsyncOutput is true. Otherwise, the records are
+ *  printed as soon as they are written. The signals are
+ *  blocked in the writer thread, so that they reach the
+ *  simulation. The mutex and the condition variables are
+ *  initialized anew, as after a fork() they may be left
+ *  in use by the writer thread of the parent.
+ */
+
+void startWriter ()
+{
+#ifndef _WIN32
+   sigset_t All, Old;
+   int Error;
+#endif
+
+   DropFull = strcmp(OutBackPressure, "DROP") == 0;
+
+#ifndef _WIN32
+   if (AsyncOutput && NumStreams > 0) {
+      Stop = 0;
+      WriterArgs.Streams = Streams;
+      WriterArgs.NumStreams = NumStreams;
+      WriterArgs.Stop = &Stop;
+      WriterArgs.Sleeping = 0;
+      WriterArgs.Waiting = 0;
+      pthread_mutex_init(&WriterArgs.Lock, NULL);
+      pthread_cond_init(&WriterArgs.Work, NULL);
+      pthread_cond_init(&WriterArgs.Room, NULL);
+      sigfillset(&All);
+      pthread_sigmask(SIG_SETMASK, &All, &Old);
+      Error = pthread_create(&Writer, NULL, writerLoop, &WriterArgs);
+      pthread_sigmask(SIG_SETMASK, &Old, NULL);
+      if (Error != 0)
+         printFatalError("startWriter", "Unable to start the writer thread.");
+      Running = true;
+      pthread_once(&AtExit, registerAtExit);
+   }
+#endif
+}
+
+
+/*---------------*
+ *  writeRecord  *
+ *---------------*/
+
+/**
+ *  Writes on the stream <s> the record with time <Time>,
+ *  indexes <i> and <j> and the <NumValues> values in
+ *  <Values>.
+ */
+
+void writeRecord(out_stream    *s, /* Output stream. */
+                 double      Time, /* Time label. */
+                 indexn         i, /* First index. */
+                 indexn         j, /* Second index. */
+                 int    NumValues, /* Number of values. */
+                 double  *Values) /* Values of the record. */
+{
+   out_record Rec;
+   size_t Head, Len, Pos;
+
+   Rec.Time = Time;
+   Rec.i = i;
+   Rec.j = j;
+   Rec.NumValues = NumValues;
+   Rec.Tag = s->Tag;
+
+   /*** Without writer thread the record is printed at once. ***/
+   if (!Running) {
+      (*s->format)(s->File, &Rec, Values, s->Data);
+      return;
+   }
+
+   /*** Waits for room in the ring, or drops the record. ***/
+   Len = sizeof(out_record) + sizeof(double) * NumValues;
+   if (Len > s->Size)
+      printFatalError("writeRecord", "Record larger than the output buffer.");
+   Head = s->Head;
+   if (s->Size - (Head - loadAcquire(&s->Tail)) < Len) {
+      if (DropFull) {
+         s->Dropped++;
+         return;
+      }
+#ifndef _WIN32
+      waitWriter(s, Len);
+#endif
+   }
+
+   /*** Copies the record in the ring, which may wrap around. ***/
+   Pos = Head & (s->Size - 1);
+   if (Pos + sizeof(out_record) <= s->Size)
+      memcpy(s->Ring + Pos, &Rec, sizeof(out_record));
+   else {
+      memcpy(s->Ring + Pos, &Rec, s->Size - Pos);
+      memcpy(s->Ring, (char *)&Rec + (s->Size - Pos), sizeof(out_record) - (s->Size - Pos));
+   }
+   Pos = (Pos + sizeof(out_record)) & (s->Size - 1);
+   Len -= sizeof(out_record);
+   if (Pos + Len <= s->Size)
+      memcpy(s->Ring + Pos, Values, Len);
+   else {
+      memcpy(s->Ring + Pos, Values, s->Size - Pos);
+      memcpy(s->Ring, (char *)Values + (s->Size - Pos), Len - (s->Size - Pos));
+   }
+
+   storeRelease(&s->Head, Head + sizeof(out_record) + Len);
+#ifndef _WIN32
+   wakeWriter();
+#endif
+}
+
+
+/*-------------------*
+ *  flushOutStreams  *
+ *-------------------*/
+
+/**
+ *  Waits that all the records stored in the streams are
+ *  written, and flushes the log files.
+ */
+
+void flushOutStreams ()
+{
+   int k;
+
+   for (k=0; k<NumStreams; k++) {
+#ifndef _WIN32
+      if (Running && loadAcquire(&Streams[k].Tail) != Streams[k].Head)
+         waitWriter(&Streams[k], Streams[k].Size);
+#endif
+      if (Streams[k].File != NULL)
+         fflush(Streams[k].File);
+   }
+}
+
+
+/*------------------------*
+ *  checkpointOutStreams  *
+ *------------------------*/
+
+/**
+ *  Writes on <File> the names of the log files of the streams
+ *  with the lengths they have once all the stored records are
+ *  written. Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointOutStreams(FILE *File)
+{
+   int k, n;
+   long Length;
+
+   flushOutStreams();
+
+   for (n=k=0; k<NumStreams; k++)
+      if (Streams[k].File != NULL)
+         n++;
+   if (writeCheckpointData(File, &n, sizeof(n)))
+      return 1;
+
+   for (k=0; k<NumStreams; k++)
+      if (Streams[k].File != NULL) {
+         if ((Length = ftell(Streams[k].File)) < 0 ||
+             writeCheckpointString(File, Streams[k].Name) ||
+             writeCheckpointData(File, &Length, sizeof(Length)))
+            return 1;
+      }
+
+   return 0;
+}
+
+
+/*---------------*
+ *  moveLogFile  *
+ *---------------*/
+
+/**
+ *  Moves the opened log file <File>, named <Name>, to a new
+ *  file <NewName> starting with its present content, so that
+ *  the following writes on <File> go in the new file.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int moveLogFile(FILE    *File, /* Opened log file. */
+                char    *Name, /* Name of the log file. */
+                char *NewName) /* Name of the new log file. */
+{
+   return moveFile(File, Name, NewName, NULL);
+}
+
+
+/*------------------*
+ *  forkOutStreams  *
+ *------------------*/
+
+/**
+ *  In a process forked by the simulation, moves the log files
+ *  of the streams to new files named as the old ones with
+ *  <Prefix> in front, and starts again the writer thread,
+ *  which is not inherited by fork(). The streams have to be
+ *  flushed before the fork. Returns 1 on error, 0 otherwise.
+ */
+
+int forkOutStreams(char *Prefix)
+{
+   char *Name;
+   int k;
+
+   Running = false;
+
+   for (k=0; k<NumStreams; k++)
+      if (Streams[k].File != NULL) {
+         Name = getMemory(strlen(Prefix) + strlen(Streams[k].Name) + 1, "ERROR (forkOutStreams): Out of memory.");
+         sprintf(Name, "%s%s", Prefix, Streams[k].Name);
+         if (moveFile(Streams[k].File, Streams[k].Name, Name, Streams[k].FileBuffer))
+            return 1;
+         Streams[k].Name = Name;
+      }
+
+   startWriter();
+
+   return 0;
+}
+
+
+/*--------------*
+ *  stopWriter  *
+ *--------------*/
+
+/**
+ *  Writes all the stored records, stops the writer thread
+ *  and closes the streams. The number of dropped records
+ *  is reported in <DocFile>.
+ */
+
+void stopWriter (FILE *DocFile)
+{
+   int k;
+
+   joinWriter();
+
+   for (k=0; k<NumStreams; k++) {
+      if (Streams[k].Dropped > 0) {
+         fprintf(DocFile, "#----------\n");
+         fprintf(DocFile, "# WARNING: %ld records dropped in '%s' (full output buffer).\n\n",
+                 Streams[k].Dropped, Streams[k].Name);
+         fprintf(stderr, "WARNING: %ld records dropped in '%s'.\n", Streams[k].Dropped, Streams[k].Name);
+      }
+      if (Streams[k].end != NULL)
+         (*Streams[k].end)(Streams[k].File, Streams[k].Tag, Streams[k].Data);
+      free(Streams[k].Scratch);
+      if (Streams[k].File != NULL) {
+         fclose(Streams[k].File);
+         free(Streams[k].FileBuffer);
+         releaseMemory(FILE_BUFFER_SIZE, MEMORY_OUTPUT);
+      }
+      if (Streams[k].Ring != NULL) {
+         free(Streams[k].Ring);
+         releaseMemory(Streams[k].Size, MEMORY_OUTPUT);
+      }
+   }
+   NumStreams = 0;
+}
+
+
+
+#undef fullFence
+#undef storeRelease
+#undef loadAcquire
+#undef COPY_BUFFER_SIZE
+#undef FILE_BUFFER_SIZE
+#undef MIN_RING_SIZE
+#undef MAX_STREAMS
@@ -0,0 +1,229 @@
+/*
+ *
+ *   writer.h
+ *
+ *   Library of functions to write the result streams
+ *   asynchronously. The simulation loop stores binary records
+ *   in a lock-free ring buffer per stream, while a background
+ *   thread formats them and writes the log files in large
+ *   blocks.
+ *
+ *   Project: PERSEO 2.x
+ *
+ */
+
+
+
+#ifndef __WRITER_H__
+#define __WRITER_H__
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "types.h"
+
+
+
+/*----------------------*
+ *  GLOBAL DEFINITIONS  *
+ *----------------------*/
+
+/**
+ *  The header of a record in the ring buffer, followed by
+ *  NumValues doubles. Its meaning is given by the format
+ *  function of the stream.
+ */
+
+typedef struct {
+   double      Time; /* Time label of the record in ms. */
+   indexn         i; /* First index (for instance the post-synaptic neuron). */
+   indexn         j; /* Second index (for instance the pre-synaptic neuron). */
+   int    NumValues; /* Number of doubles following the header. */
+   int          Tag; /* Tag of the stream (see setOutStreamTag). */
+} out_record;
+
+
+/**
+ *  Function printing the record <Rec> with values <Values>
+ *  on the file <File>, given the data <Data> of the stream.
+ *  It runs in the writer thread, so it has to reach the
+ *  state of the simulation only through <Data>.
+ */
+
+typedef void (*format_func)(FILE *File, out_record *Rec, double *Values, void *Data);
+
+
+/**
+ *  Function completing the file <File> of the stream with tag
+ *  <Tag> and data <Data> once all the records are printed
+ *  (for instance the last block of a binary file).
+ */
+
+typedef void (*end_func)(FILE *File, int Tag, void *Data);
+
+
+/**
+ *  An output stream: a log file fed by a single-producer
+ *  single-consumer ring buffer. Head and Tail count the bytes
+ *  ever written and read, so that their difference is the
+ *  amount of bytes waiting to be written on file.
+ */
+
+typedef struct {
+   FILE           *File; /* Log file. */
+   char           *Name; /* Name of the log file. */
+   format_func   format; /* Function printing a record. */
+   end_func         end; /* Function completing the file, or NULL. */
+   int              Tag; /* Tag given to the records, for instance an index in a shared file. */
+   void           *Data; /* Data given to the format and end functions. */
+   char           *Ring; /* The ring buffer. */
+   size_t          Size; /* Size in bytes of the ring buffer (a power of 2). */
+   size_t          Head; /* Bytes stored by the simulation thread. */
+   size_t          Tail; /* Bytes consumed by the writer thread. */
+   long         Dropped; /* Number of records dropped with a full ring. */
+   double      *Scratch; /* Values of a record wrapped around the end of the ring. */
+   size_t   ScratchSize; /* Size in bytes of Scratch. */
+   char     *FileBuffer; /* Buffer of the log file. */
+} out_stream;
+
+
+
+/*--------------------*
+ *  GLOBAL VARIABLES  *
+ *--------------------*/
+
+/*** Global parameters to set in INIT_FILE. ***/
+extern PERSEO_LOCAL boolean     AsyncOutput; /* If true the log files are written by a background thread. */
+extern PERSEO_LOCAL int       OutBufferSize; /* Size in Mbytes of the ring buffer per stream. */
+extern PERSEO_LOCAL char   *OutBackPressure; /* With full ring buffer, 'BLOCK' waits for the writer, 'DROP' neglects the record. */
+
+
+
+/*--------------------*
+ *  GLOBAL FUNCTIONS  *
+ *--------------------*/
+
+/**
+ *  Returns a new output stream writing on the opened file
+ *  <File> named <Name>, whose records are printed by <Format>.
+ *  The file is given a large buffer, so that the writes on
+ *  disk are done in big blocks. <File> is NULL if the records
+ *  are written elsewhere by <Format>.
+ */
+
+out_stream *openOutStream(FILE          *File, /* Opened log file. */
+                          char          *Name, /* Name of the log file. */
+                          format_func  Format); /* Function printing a record. */
+
+
+/**
+ *  Returns the memory in bytes that openOutStream takes for
+ *  a stream, with a log file if <File> is true.
+ */
+
+size_t outStreamMemory(boolean File);
+
+
+/**
+ *  Sets <End> as the function completing the file of the
+ *  stream <s> before its closure.
+ */
+
+void setOutStreamEnd(out_stream *s, /* Output stream. */
+                     end_func  End); /* Function completing the file. */
+
+
+/**
+ *  Sets <Tag> as the tag of the records of the stream <s>.
+ */
+
+void setOutStreamTag(out_stream *s, /* Output stream. */
+                     int       Tag); /* Tag of the records. */
+
+
+/**
+ *  Sets <Data> as the data given to the format and end
+ *  functions of the stream <s>.
+ */
+
+void setOutStreamData(out_stream *s, /* Output stream. */
+                      void   *Data); /* Data of the stream. */
+
+
+/**
+ *  Starts the writer thread serving the opened streams,
+ *  if AsyncOutput is true. Otherwise, the records are
+ *  printed as soon as they are written.
+ */
+
+void startWriter ();
+
+
+/**
+ *  Writes on the stream <s> the record with time <Time>,
+ *  indexes <i> and <j> and the <NumValues> values in
+ *  <Values>.
+ */
+
+void writeRecord(out_stream    *s, /* Output stream. */
+                 double      Time, /* Time label. */
+                 indexn         i, /* First index. */
+                 indexn         j, /* Second index. */
+                 int    NumValues, /* Number of values. */
+                 double  *Values); /* Values of the record. */
+
+
+/**
+ *  Waits that all the records stored in the streams are
+ *  written, and flushes the log files.
+ */
+
+void flushOutStreams ();
+
+
+/**
+ *  Writes on <File> the names of the log files of the streams
+ *  with the lengths they have once all the stored records are
+ *  written (see checkpoint.h). Returns 1 on error, 0 otherwise.
+ */
+
+int checkpointOutStreams(FILE *File);
+
+
+/**
+ *  Moves the opened log file <File>, named <Name>, to a new
+ *  file <NewName> starting with its present content, so that
+ *  the following writes on <File> go in the new file.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int moveLogFile(FILE    *File, /* Opened log file. */
+                char    *Name, /* Name of the log file. */
+                char *NewName); /* Name of the new log file. */
+
+
+/**
+ *  In a process forked by the simulation, moves the log files
+ *  of the streams to new files named as the old ones with
+ *  <Prefix> in front (see moveLogFile), and starts again the
+ *  writer thread, which is not inherited by fork(). The
+ *  streams have to be flushed before the fork.
+ *  Returns 1 on error, 0 otherwise.
+ */
+
+int forkOutStreams(char *Prefix);
+
+
+/**
+ *  Writes all the stored records, stops the writer thread
+ *  and closes the streams. The number of dropped records
+ *  is reported in <DocFile>.
+ */
+
+void stopWriter (FILE *DocFile);
+
+
+
+#endif /* __WRITER_H__ */